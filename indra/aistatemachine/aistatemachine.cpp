@@ -34,6 +34,7 @@
 #include "linden_common.h"
 #include "aistatemachine.h"
 #include "aicondition.h"
+#include "llfasttimer.h"
 #include "lltimer.h"
 
 //==================================================================
@@ -1367,6 +1368,8 @@ AIEngine gMainThreadEngine("gMainThreadEngine");
 AIEngine gStateMachineThreadEngine("gStateMachineThreadEngine");
 
 // State Machine Thread main loop.
+static LLTrace::BlockTimerStatHandle FTM_STATE_MACHINE_THREAD("State Machine Thread");
+
 void AIEngine::threadloop(void)
 {
   queued_type::iterator queued_element, end;
@@ -1386,7 +1389,10 @@ void AIEngine::threadloop(void)
   do
   {
 	AIStateMachine& state_machine(queued_element->statemachine());
-	state_machine.multiplex(AIStateMachine::normal_run);
+	{
+	  LL_RECORD_BLOCK_TIME(FTM_STATE_MACHINE_THREAD);
+	  state_machine.multiplex(AIStateMachine::normal_run);
+	}
 	bool active = state_machine.active(this);		// This locks mState shortly, so it must be called before locking mEngineState because add() locks mEngineState while holding mState.
 	engine_state_type_wat engine_state_w(mEngineState);
 	if (!active)
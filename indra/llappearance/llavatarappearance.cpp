@@ -1430,6 +1430,32 @@ LLPolyMesh* LLAvatarAppearance::getMesh( LLPolyMeshSharedData *shared_data )
 	return NULL;
 }
 
+//-----------------------------------------------------------------------------
+// hasPendingMorphs()
+//-----------------------------------------------------------------------------
+bool LLAvatarAppearance::hasPendingMorphs() const
+{
+	for (polymesh_map_t::const_iterator i = mPolyMeshes.begin(); i != mPolyMeshes.end(); ++i)
+	{
+		if (i->second->hasPendingMorphs())
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// applyPendingMorphs()
+//-----------------------------------------------------------------------------
+void LLAvatarAppearance::applyPendingMorphs()
+{
+	for (polymesh_map_t::iterator i = mPolyMeshes.begin(); i != mPolyMeshes.end(); ++i)
+	{
+		i->second->applyPendingMorphs();
+	}
+}
+
 // static
 void LLAvatarAppearance::getMeshInfo (mesh_info_t* mesh_info)
 {
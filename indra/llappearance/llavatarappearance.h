@@ -261,6 +261,10 @@ public:
 public:
 	virtual void	updateMeshTextures() = 0;
 	virtual void	dirtyMesh() = 0; // Dirty the avatar mesh
+	// Morphs of the meshes queued by updateVisualParams(). Applying them
+	// only touches the vertex data of this avatar.
+	bool			hasPendingMorphs() const;
+	void			applyPendingMorphs();
 protected:
 	virtual void	dirtyMesh(S32 priority) = 0; // Dirty the avatar mesh, with priority
 
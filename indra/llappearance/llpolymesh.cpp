@@ -750,6 +750,7 @@ LLPolyMesh::LLPolyMesh(LLPolyMeshSharedData *shared_data, LLPolyMesh *reference_
 
 	mSharedData = shared_data;
 	mReferenceMesh = reference_mesh;
+	mMorphedMesh = this;
 	mAvatarp = NULL;
 	mVertexData = NULL;
 
@@ -761,6 +762,7 @@ LLPolyMesh::LLPolyMesh(LLPolyMeshSharedData *shared_data, LLPolyMesh *reference_
 
 	if (shared_data->isLOD() && reference_mesh)
 	{
+		mMorphedMesh = reference_mesh;
 		mCoords = reference_mesh->mCoords;
 		mNormals = reference_mesh->mNormals;
 		mScaledNormals = reference_mesh->mScaledNormals;
@@ -805,6 +807,10 @@ LLPolyMesh::LLPolyMesh(LLPolyMeshSharedData *shared_data, LLPolyMesh *reference_
 //-----------------------------------------------------------------------------
 LLPolyMesh::~LLPolyMesh()
 {
+	for (std::vector<PendingMorph>::iterator it = mPendingMorphs.begin(); it != mPendingMorphs.end(); ++it)
+	{
+		it->mMorph->mQueued = false;
+	}
 	delete_and_clear(mJointRenderData);
 	ll_aligned_free_16(mVertexData);
 }
@@ -1501,6 +1507,7 @@ BOOL LLPolyMesh::setSharedFromCurrent()
 	// there is no easy way to reapply the morphs, so we just compute
 	// the change in the base mesh and apply that.
 
+	flushMorphs();
 	LLPolyMesh delta(mSharedData, NULL);
 	U32 nverts = delta.getNumVertices();
 
@@ -1657,6 +1664,7 @@ void LLPolyMesh::dumpDiagInfo(void*)
 //-----------------------------------------------------------------------------
 LLVector4a *LLPolyMesh::getWritableCoords()
 {
+	flushMorphs();
 	return mCoords;
 }
 
@@ -1665,6 +1673,7 @@ LLVector4a *LLPolyMesh::getWritableCoords()
 //-----------------------------------------------------------------------------
 LLVector4a *LLPolyMesh::getWritableNormals()
 {
+	flushMorphs();
 	return mNormals;
 }
 
@@ -1673,6 +1682,7 @@ LLVector4a *LLPolyMesh::getWritableNormals()
 //-----------------------------------------------------------------------------
 LLVector4a *LLPolyMesh::getWritableBinormals()
 {
+	flushMorphs();
 	return mBinormals;
 }
 
@@ -1682,6 +1692,7 @@ LLVector4a *LLPolyMesh::getWritableBinormals()
 //-----------------------------------------------------------------------------
 LLVector4a       *LLPolyMesh::getWritableClothingWeights()
 {
+	flushMorphs();
 	return mClothingWeights;
 }
 
@@ -1690,6 +1701,7 @@ LLVector4a       *LLPolyMesh::getWritableClothingWeights()
 //-----------------------------------------------------------------------------
 LLVector2	*LLPolyMesh::getWritableTexCoords()
 {
+	flushMorphs();
 	return mTexCoords;
 }
 
@@ -1698,6 +1710,7 @@ LLVector2	*LLPolyMesh::getWritableTexCoords()
 //-----------------------------------------------------------------------------
 LLVector4a *LLPolyMesh::getScaledNormals()
 {
+	flushMorphs();
 	return mScaledNormals;
 }
 
@@ -1706,10 +1719,95 @@ LLVector4a *LLPolyMesh::getScaledNormals()
 //-----------------------------------------------------------------------------
 LLVector4a *LLPolyMesh::getScaledBinormals()
 {
+	flushMorphs();
 	return mScaledBinormals;
 }
 
 
+//-----------------------------------------------------------------------------
+// queueMorph()
+//-----------------------------------------------------------------------------
+void LLPolyMesh::queueMorph(LLPolyMorphTarget* morph, F32 delta_weight)
+{
+	llassert(mMorphedMesh == this);
+	if (morph->mQueued)
+	{
+		// The changes are linear in the weight.
+		for (std::vector<PendingMorph>::iterator it = mPendingMorphs.begin(); it != mPendingMorphs.end(); ++it)
+		{
+			if (it->mMorph == morph)
+			{
+				it->mDeltaWeight += delta_weight;
+				return;
+			}
+		}
+	}
+	PendingMorph pending = { morph, delta_weight };
+	mPendingMorphs.push_back(pending);
+	morph->mQueued = true;
+}
+
+//-----------------------------------------------------------------------------
+// cancelMorph()
+//-----------------------------------------------------------------------------
+void LLPolyMesh::cancelMorph(LLPolyMorphTarget* morph)
+{
+	for (std::vector<PendingMorph>::iterator it = mPendingMorphs.begin(); it != mPendingMorphs.end(); ++it)
+	{
+		if (it->mMorph == morph)
+		{
+			// Keep the order: clothing morphs overwrite each other's weights.
+			mPendingMorphs.erase(it);
+			break;
+		}
+	}
+	morph->mQueued = false;
+}
+
+//-----------------------------------------------------------------------------
+// applyPendingMorphs()
+//-----------------------------------------------------------------------------
+void LLPolyMesh::applyPendingMorphs()
+{
+	if (mPendingMorphs.empty() || !mSharedData)
+	{
+		return;
+	}
+
+	const U32 num_vertices = mSharedData->mNumVertices;
+	mMorphedVertices.resize(num_vertices);
+	U8* morphed_vertices = &mMorphedVertices[0];
+
+	for (std::vector<PendingMorph>::iterator it = mPendingMorphs.begin(); it != mPendingMorphs.end(); ++it)
+	{
+		it->mMorph->mQueued = false;
+		it->mMorph->addVertexDeltas(it->mDeltaWeight, mCoords, mScaledNormals, mScaledBinormals,
+									mTexCoords, mClothingWeights, morphed_vertices);
+	}
+	mPendingMorphs.clear();
+
+	// Output normals and binormals only depend on the final scaled ones.
+	for (U32 vert = 0; vert < num_vertices; ++vert)
+	{
+		if (!morphed_vertices[vert])
+		{
+			continue;
+		}
+		morphed_vertices[vert] = 0;
+
+		// calculate new normals based on half angles
+		LLVector4a norm = mScaledNormals[vert];
+		norm.normalize3fast();
+		mNormals[vert] = norm;
+
+		LLVector4a tangent;
+		tangent.setCross3(mScaledBinormals[vert], norm);
+		LLVector4a& binormal = mBinormals[vert];
+		binormal.setCross3(norm, tangent);
+		binormal.normalize3fast();
+	}
+}
+
 //-----------------------------------------------------------------------------
 // initializeForMorph()
 //-----------------------------------------------------------------------------
@@ -29,6 +29,7 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include "llstl.h"
 
 #include "v3math.h"
@@ -235,6 +236,7 @@ public:
 
 	// Get coords
 	const LLVector4a	*getCoords() const{
+		flushMorphs();
 		return mCoords;
 	}
 
@@ -243,11 +245,13 @@ public:
 
 	// Get normals
 	const LLVector4a	*getNormals() const{ 
+		flushMorphs();
 		return mNormals; 
 	}
 
 	// Get normals
 	const LLVector4a	*getBinormals() const{ 
+		flushMorphs();
 		return mBinormals; 
 	}
 
@@ -272,6 +276,7 @@ public:
 
 	// Get texCoords
 	const LLVector2	*getTexCoords() const { 
+		flushMorphs();
 		return mTexCoords; 
 	}
 
@@ -296,6 +301,7 @@ public:
 
 	const LLVector4a		*getClothingWeights()
 	{
+		flushMorphs();
 		return mClothingWeights;	
 	}
 
@@ -353,9 +359,30 @@ public:
 	// Dumps diagnostic information about the global mesh table
 	static void dumpDiagInfo(void*);
 
+	//--------------------------------------------------------------------
+	// Pending morphs
+	//--------------------------------------------------------------------
+	// LLPolyMorphTarget::apply() only queues the vertex changes of a morph.
+	// applyPendingMorphs() makes those of all queued morphs in one pass and
+	// renormalizes each changed vertex once. It only touches this mesh, so
+	// the meshes of different avatars can be done on different threads.
+	// The vertex data accessors apply the pending morphs first.
+	void queueMorph(LLPolyMorphTarget* morph, F32 delta_weight);
+	void cancelMorph(LLPolyMorphTarget* morph);
+	bool hasPendingMorphs() const	{ return !mPendingMorphs.empty(); }
+	void applyPendingMorphs();
+
 private:
 	void initializeForMorph();
 
+	void flushMorphs() const
+	{
+		if (!mMorphedMesh->mPendingMorphs.empty())
+		{
+			mMorphedMesh->applyPendingMorphs();
+		}
+	}
+
 protected:
 	// mesh data shared across all instances of a given mesh
 	LLPolyMeshSharedData	*mSharedData;
@@ -377,6 +404,17 @@ protected:
 	LLVector2				*mTexCoords;
 	
 	LLPolyMesh				*mReferenceMesh;
+	// the mesh owning the vertex data, the reference mesh of a LOD
+	LLPolyMesh				*mMorphedMesh;
+
+	struct PendingMorph
+	{
+		LLPolyMorphTarget*	mMorph;
+		F32					mDeltaWeight;
+	};
+	std::vector<PendingMorph>	mPendingMorphs;
+	// vertices changed by the pending morphs, in applyPendingMorphs()
+	std::vector<U8>				mMorphedVertices;
 
 	// global mesh list
 	typedef std::map<std::string, LLPolyMeshSharedData*> LLPolyMeshSharedDataTable; 
@@ -618,6 +618,7 @@ LLPolyMorphTarget::LLPolyMorphTarget(LLPolyMesh *poly_mesh)
 	mVertMask(NULL),
 	mLastSex(SEX_FEMALE),
 	mNumMorphMasksPending(0),
+	mQueued(false),
 	mVolumeMorphs()
 {
 }
@@ -632,6 +633,7 @@ LLPolyMorphTarget::LLPolyMorphTarget(const LLPolyMorphTarget& pOther)
 	mVertMask(pOther.mVertMask == NULL ? NULL : new LLPolyVertexMask(*pOther.mVertMask)),
 	mLastSex(pOther.mLastSex),
 	mNumMorphMasksPending(pOther.mNumMorphMasksPending),
+	mQueued(false),
 	mVolumeMorphs(pOther.mVolumeMorphs)
 {
 }
@@ -641,6 +643,10 @@ LLPolyMorphTarget::LLPolyMorphTarget(const LLPolyMorphTarget& pOther)
 //-----------------------------------------------------------------------------
 LLPolyMorphTarget::~LLPolyMorphTarget()
 {
+	if (mQueued)
+	{
+		mMesh->cancelMorph(this);
+	}
 	delete mVertMask;
 	mVertMask = NULL;
 }
@@ -866,75 +872,7 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
 	if (delta_weight != 0.f)
 	{
 		llassert(!mMesh->isLOD());
-		LLVector4a *coords = mMesh->getWritableCoords();
-
-		LLVector4a *scaled_normals = mMesh->getScaledNormals();
-		LLVector4a *normals = mMesh->getWritableNormals();
-
-		LLVector4a *scaled_binormals = mMesh->getScaledBinormals();
-		LLVector4a *binormals = mMesh->getWritableBinormals();
-
-		LLVector4a *clothing_weights = mMesh->getWritableClothingWeights();
-		LLVector2 *tex_coords = mMesh->getWritableTexCoords();
-
-		F32 *maskWeightArray = (mVertMask) ? mVertMask->getMorphMaskWeights() : NULL;
-
-		for(U32 vert_index_morph = 0; vert_index_morph < mMorphData->mNumIndices; vert_index_morph++)
-		{
-			S32 vert_index_mesh = mMorphData->mVertexIndices[vert_index_morph];
-
-			F32 maskWeight = 1.f;
-			if (maskWeightArray)
-			{
-				maskWeight = maskWeightArray[vert_index_morph];
-			}
-
-
-			LLVector4a pos = mMorphData->mCoords[vert_index_morph];
-			pos.mul(delta_weight*maskWeight);
-			coords[vert_index_mesh].add(pos);
-
-			if (getInfo()->mIsClothingMorph && clothing_weights)
-			{
-				LLVector4a clothing_offset = mMorphData->mCoords[vert_index_morph];
-				clothing_offset.mul(delta_weight * maskWeight);
-				LLVector4a* clothing_weight = &clothing_weights[vert_index_mesh];
-				clothing_weight->add(clothing_offset);
-				clothing_weight->getF32ptr()[VW] = maskWeight;
-			}
-
-			// calculate new normals based on half angles
-			LLVector4a norm = mMorphData->mNormals[vert_index_morph];
-			norm.mul(delta_weight*maskWeight*NORMAL_SOFTEN_FACTOR);
-			scaled_normals[vert_index_mesh].add(norm);
-			norm = scaled_normals[vert_index_mesh];
-
-			// guard against degenerate input data before we create NaNs below!
-			//
-			norm.normalize3fast();
-			normals[vert_index_mesh] = norm;
-
-			// calculate new binormals
-			LLVector4a binorm = mMorphData->mBinormals[vert_index_morph];
-
-			// guard against degenerate input data before we create NaNs below!
-			//
-			if (!binorm.isFinite3() || (binorm.dot3(binorm).getF32() <= F_APPROXIMATELY_ZERO))
-			{
-				binorm.set(1,0,0,1);
-			}
-
-			binorm.mul(delta_weight*maskWeight*NORMAL_SOFTEN_FACTOR);
-			scaled_binormals[vert_index_mesh].add(binorm);
-			LLVector4a tangent;
-			tangent.setCross3(scaled_binormals[vert_index_mesh], norm);
-			LLVector4a& normalized_binormal = binormals[vert_index_mesh];
-
-			normalized_binormal.setCross3(norm, tangent); 			
-			normalized_binormal.normalize3fast();
-			
-			tex_coords[vert_index_mesh] += mMorphData->mTexCoords[vert_index_morph] * delta_weight * maskWeight;
-		}
+		mMesh->queueMorph(this, delta_weight);
 
 		// now apply volume changes
 		for( volume_list_t::iterator iter = mVolumeMorphs.begin(); iter != mVolumeMorphs.end(); ++iter )
@@ -954,6 +892,76 @@ void LLPolyMorphTarget::apply( ESex avatar_sex )
 	}
 }
 
+//-----------------------------------------------------------------------------
+// addVertexDeltas()
+//-----------------------------------------------------------------------------
+void LLPolyMorphTarget::addVertexDeltas(F32 delta_weight, LLVector4a* coords, LLVector4a* scaled_normals,
+										LLVector4a* scaled_binormals, LLVector2* tex_coords,
+										LLVector4a* clothing_weights, U8* morphed_vertices) const
+{
+	const F32* mask_weights = mVertMask ? mVertMask->getMorphMaskWeights() : NULL;
+	if (!getInfo()->mIsClothingMorph)
+	{
+		clothing_weights = NULL;
+	}
+
+	const U32* vertex_indices = mMorphData->mVertexIndices;
+	const LLVector4a* morph_coords = mMorphData->mCoords;
+	const LLVector4a* morph_normals = mMorphData->mNormals;
+	const LLVector4a* morph_binormals = mMorphData->mBinormals;
+	const LLVector2* morph_tex_coords = mMorphData->mTexCoords;
+
+	LLVector4a default_binormal(1.f, 0.f, 0.f, 1.f);
+	LLVector4a weight;
+	LLVector4a soft_weight;
+	weight.splat(delta_weight);
+	soft_weight.splat(delta_weight * NORMAL_SOFTEN_FACTOR);
+
+	for (U32 i = 0; i < mMorphData->mNumIndices; ++i)
+	{
+		const U32 vert = vertex_indices[i];
+		F32 mask_weight = 1.f;
+		F32 vert_weight = delta_weight;
+		if (mask_weights)
+		{
+			mask_weight = mask_weights[i];
+			vert_weight = delta_weight * mask_weight;
+			weight.splat(vert_weight);
+			soft_weight.splat(vert_weight * NORMAL_SOFTEN_FACTOR);
+		}
+
+		LLVector4a offset;
+		offset.setMul(morph_coords[i], weight);
+		coords[vert].add(offset);
+
+		if (clothing_weights)
+		{
+			clothing_weights[vert].add(offset);
+			clothing_weights[vert].getF32ptr()[VW] = mask_weight;
+		}
+
+		offset.setMul(morph_normals[i], soft_weight);
+		scaled_normals[vert].add(offset);
+
+		// guard against degenerate input data before we create NaNs
+		// when renormalizing
+		const LLVector4a& binorm = morph_binormals[i];
+		if (!binorm.isFinite3() || (binorm.dot3(binorm).getF32() <= F_APPROXIMATELY_ZERO))
+		{
+			offset.setMul(default_binormal, soft_weight);
+		}
+		else
+		{
+			offset.setMul(binorm, soft_weight);
+		}
+		scaled_binormals[vert].add(offset);
+
+		tex_coords[vert] += morph_tex_coords[i] * delta_weight * mask_weight;
+
+		morphed_vertices[vert] = 1;
+	}
+}
+
 //-----------------------------------------------------------------------------
 // applyMask()
 //-----------------------------------------------------------------------------
@@ -1021,6 +1029,7 @@ void	LLPolyMorphTarget::applyMask(U8 *maskTextureData, S32 width, S32 height, S3
 
 	// set last weight to 0, since we've removed the effect of this morph
 	mLastWeight = 0.f;
+	markDirty();
 
 	mVertMask->generateMask(maskTextureData, width, height, num_components, invert, clothing_weights);
 
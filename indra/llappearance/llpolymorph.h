@@ -160,6 +160,7 @@ protected:
 //-----------------------------------------------------------------------------
 class LLPolyMorphTarget : public LLViewerVisualParam
 {
+	friend class LLPolyMesh;
 public:
 	LLPolyMorphTarget(LLPolyMesh *poly_mesh);
 	~LLPolyMorphTarget();
@@ -201,12 +202,20 @@ public:
 protected:
 	LLPolyMorphTarget(const LLPolyMorphTarget& pOther);
 
+	// Adds the vertex changes of delta_weight to the mesh data and flags
+	// the changed vertices, for LLPolyMesh::applyPendingMorphs().
+	void addVertexDeltas(F32 delta_weight, LLVector4a* coords, LLVector4a* scaled_normals,
+						 LLVector4a* scaled_binormals, LLVector2* tex_coords,
+						 LLVector4a* clothing_weights, U8* morphed_vertices) const;
+
 	LLPolyMorphData*				mMorphData;
 	LLPolyMesh*						mMesh;
 	LLPolyVertexMask *				mVertMask;
 	ESex							mLastSex;
 	// number of morph masks that haven't been generated, must be 0 before this morph is applied
 	BOOL							mNumMorphMasksPending;	
+	// queued in mMesh, see LLPolyMesh::queueMorph()
+	bool							mQueued;
 
 	typedef std::vector<LLPolyVolumeMorph> volume_list_t;
 	volume_list_t 					mVolumeMorphs;
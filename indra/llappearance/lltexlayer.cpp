@@ -31,6 +31,7 @@
 #include "llavatarappearance.h"
 #include "llcrc.h"
 #include "imageids.h"
+#include "llimagecompositor.h"
 #include "llimagej2c.h"
 #include "llimagetga.h"
 #include "lldir.h"
@@ -52,6 +53,15 @@ using namespace LLAvatarAppearanceDefines;
 // runway consolidate
 extern std::string self_av_string();
 
+// GL clamps the colors it draws with
+static LLColor4U to_color4u(const LLColor4& color)
+{
+	return LLColor4U((U8)ll_round(llclamp(color.mV[VRED], 0.f, 1.f) * 255.f),
+					 (U8)ll_round(llclamp(color.mV[VGREEN], 0.f, 1.f) * 255.f),
+					 (U8)ll_round(llclamp(color.mV[VBLUE], 0.f, 1.f) * 255.f),
+					 (U8)ll_round(llclamp(color.mV[VALPHA], 0.f, 1.f) * 255.f));
+}
+
 class LLTexLayerInfo
 {
 	friend class LLTexLayer;
@@ -608,6 +618,77 @@ void LLTexLayerSet::renderAlphaMaskTextures(S32 x, S32 y, S32 width, S32 height,
 	gGL.setSceneBlendType(LLRender::BT_ALPHA);
 }
 
+BOOL LLTexLayerSet::addToCompositor(LLImageCompositor& compositor)
+{
+	BOOL success = TRUE;
+	bool visible = true;
+	for (layer_list_t::iterator iter = mMaskLayerList.begin(); iter != mMaskLayerList.end(); ++iter)
+	{
+		if ((*iter)->isInvisibleAlphaMask())
+		{
+			visible = false;
+		}
+	}
+
+	compositor.addRect(LLColor4U(0, 0, 0, 255), LLImageCompositor::BLEND_REPLACE, false);
+	if (visible)
+	{
+		for (layer_list_t::iterator iter = mLayerList.begin(); iter != mLayerList.end(); ++iter)
+		{
+			LLTexLayerInterface* layer = *iter;
+			if (layer->getRenderPass() == LLTexLayer::RP_COLOR)
+			{
+				success &= layer->addToCompositor(compositor);
+			}
+		}
+		success &= addAlphaMaskTexturesToCompositor(compositor, false);
+	}
+	else
+	{
+		compositor.addRect(LLColor4U(0, 0, 0, 0), LLImageCompositor::BLEND_REPLACE, false);
+	}
+	return success;
+}
+
+BOOL LLTexLayerSet::addAlphaMaskTexturesToCompositor(LLImageCompositor& compositor, bool forceClear)
+{
+	BOOL success = TRUE;
+	const LLTexLayerSetInfo *info = getInfo();
+
+	if (!info->mStaticAlphaFileName.empty())
+	{
+		LLImageRaw* raw = LLTexLayerStaticImageList::getInstance()->getImageRaw(info->mStaticAlphaFileName);
+		if (raw)
+		{
+			compositor.addImage(raw, LLColor4U::white, LLImageCompositor::BLEND_REPLACE, true, true, true);
+		}
+	}
+	else if (forceClear || info->mClearAlpha || (mMaskLayerList.size() > 0))
+	{
+		compositor.addRect(LLColor4U(0, 0, 0, 255), LLImageCompositor::BLEND_REPLACE, false, true);
+	}
+
+	for (layer_list_t::iterator iter = mMaskLayerList.begin(); iter != mMaskLayerList.end(); ++iter)
+	{
+		success &= (*iter)->addAlphaToCompositor(compositor);
+	}
+	return success;
+}
+
+static LLTrace::BlockTimerStatHandle FTM_CREATE_COMPOSITOR("createCompositor");
+LLImageCompositor* LLTexLayerSet::createCompositor()
+{
+	LL_RECORD_BLOCK_TIME(FTM_CREATE_COMPOSITOR);
+	LLImageCompositor* compositor = new LLImageCompositor(mInfo->getWidth(), mInfo->getHeight());
+	if (!addToCompositor(*compositor))
+	{
+		LL_DEBUGS("Avatar") << "waiting for images to composite " << getBodyRegionName() << LL_ENDL;
+		delete compositor;
+		compositor = NULL;
+	}
+	return compositor;
+}
+
 void LLTexLayerSet::applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components)
 {
 	mAvatarAppearance->applyMorphMask(tex_data, width, height, num_components, mBakedTexIndex);
@@ -1570,11 +1651,16 @@ void LLTexLayer::renderMorphMasks(S32 x, S32 y, S32 width, S32 height, const LLC
 				mAlphaCache.erase(iter2);
 			}
 			alpha_data = new U8[width * height];
-			U8* pixels_tmp = new U8[width * height * 4];
-			glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels_tmp);
-			for (int i = 0; i < width * height; ++i)
-				alpha_data[i] = pixels_tmp[i * 4 + 3];
-			delete[] pixels_tmp;
+			// Only read the frame buffer back when the mask can't be
+			// built from the images on the CPU.
+			if (!composeMorphMask(width, height, layer_color, alpha_data))
+			{
+				U8* pixels_tmp = new U8[width * height * 4];
+				glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels_tmp);
+				for (int i = 0; i < width * height; ++i)
+					alpha_data[i] = pixels_tmp[i * 4 + 3];
+				delete[] pixels_tmp;
+			}
 			mAlphaCache[cache_index] = alpha_data;
 		}
 		
@@ -1603,15 +1689,182 @@ void LLTexLayer::addAlphaMask(U8 *data, S32 originX, S32 originY, S32 width, S32
 	}
 	if (alphaData)
 	{
-		for( S32 i = 0; i < size; i++ )
+		LLImageCompositor::scaleMask(data, alphaData, size);
+	}
+}
+
+BOOL LLTexLayer::getLocalTextureRaw(LLPointer<LLImageRaw>& raw, bool request_save) const
+{
+	raw = NULL;
+	LLGLTexture* tex = mLocalTextureObject ? mLocalTextureObject->getImage() : NULL;
+	if (!tex)
+	{
+		// Nothing to draw
+		return TRUE;
+	}
+	llassert(gTextureManagerBridgep);
+	raw = gTextureManagerBridgep->getRawImage(tex, request_save);
+	return raw.notNull();
+}
+
+/*virtual*/ BOOL LLTexLayer::addToCompositor(LLImageCompositor& compositor)
+{
+	LLColor4 net_color;
+	BOOL color_specified = findNetColor(&net_color);
+	if (mTexLayerSet->getAvatarAppearance()->mIsDummy)
+	{
+		color_specified = true;
+		net_color = LLAvatarAppearance::getDummyColor();
+	}
+
+	// If you can't see the layer, don't render it.
+	if (is_approx_zero(net_color.mV[VW]))
+	{
+		return TRUE;
+	}
+
+	BOOL success = TRUE;
+	const LLColor4U color = to_color4u(net_color);
+	LLImageCompositor::EBlend blend = LLImageCompositor::BLEND_ALPHA;
+	if (!mParamAlphaList.empty())
+	{
+		success &= addMorphMasksToCompositor(compositor, net_color, true);
+		blend = LLImageCompositor::BLEND_DEST_ALPHA;
+	}
+	if (getInfo()->mWriteAllChannels)
+	{
+		blend = LLImageCompositor::BLEND_REPLACE;
+	}
+
+	if ((getInfo()->mLocalTexture != -1) && !getInfo()->mUseLocalTextureAlphaOnly)
+	{
+		LLPointer<LLImageRaw> raw;
+		if (mLocalTextureObject && mLocalTextureObject->getID() != IMG_DEFAULT_AVATAR)
+		{
+			success &= getLocalTextureRaw(raw, true);
+		}
+		if (raw.notNull())
+		{
+			compositor.addImage(raw, color, blend, !getInfo()->mWriteAllChannels);
+		}
+	}
+
+	if (!getInfo()->mStaticImageFileName.empty())
+	{
+		LLImageRaw* raw = LLTexLayerStaticImageList::getInstance()->getImageRaw(getInfo()->mStaticImageFileName);
+		if (raw)
+		{
+			compositor.addImage(raw, color, blend, true, false, getInfo()->mStaticImageIsMask);
+		}
+		else
 		{
-			U8 curAlpha = data[i];
-			U16 resultAlpha = curAlpha;
-			resultAlpha *= ( ((U16)alphaData[i]) + 1);
-			resultAlpha = resultAlpha >> 8;
-			data[i] = (U8)resultAlpha;
+			success = FALSE;
 		}
 	}
+
+	if (((-1 == getInfo()->mLocalTexture) || getInfo()->mUseLocalTextureAlphaOnly) &&
+		getInfo()->mStaticImageFileName.empty() &&
+		color_specified)
+	{
+		compositor.addRect(color, blend, false);
+	}
+
+	return success;
+}
+
+/*virtual*/ BOOL LLTexLayer::addAlphaToCompositor(LLImageCompositor& compositor)
+{
+	if (!getInfo()->mStaticImageFileName.empty())
+	{
+		LLImageRaw* raw = LLTexLayerStaticImageList::getInstance()->getImageRaw(getInfo()->mStaticImageFileName);
+		if (!raw)
+		{
+			return FALSE;
+		}
+		compositor.addImage(raw, LLColor4U::white, LLImageCompositor::BLEND_MULT_ALPHA, false, true, getInfo()->mStaticImageIsMask);
+		return TRUE;
+	}
+
+	if (getInfo()->mLocalTexture >= 0 && getInfo()->mLocalTexture < TEX_NUM_INDICES)
+	{
+		LLPointer<LLImageRaw> raw;
+		BOOL success = getLocalTextureRaw(raw, true);
+		if (raw.notNull())
+		{
+			compositor.addImage(raw, LLColor4U::white, LLImageCompositor::BLEND_MULT_ALPHA, false, true);
+		}
+		return success;
+	}
+	return TRUE;
+}
+
+// Mirrors renderMorphMasks(), without the readback.
+BOOL LLTexLayer::addMorphMasksToCompositor(LLImageCompositor& compositor, const LLColor4 &layer_color, bool request_save)
+{
+	llassert(!mParamAlphaList.empty());
+	BOOL success = TRUE;
+
+	// If the first param is a multiply, it multiplies against the current
+	// buffer's alpha
+	LLTexLayerParamAlpha* first_param = *mParamAlphaList.begin();
+	if (!first_param || !first_param->getMultiplyBlend())
+	{
+		compositor.addRect(LLColor4U(0, 0, 0, 0), LLImageCompositor::BLEND_REPLACE, false, true);
+	}
+
+	for (param_alpha_list_t::iterator iter = mParamAlphaList.begin(); iter != mParamAlphaList.end(); ++iter)
+	{
+		success &= (*iter)->addToCompositor(compositor);
+	}
+
+	// Accumulate the alpha component of the texture
+	if (getInfo()->mLocalTexture != -1)
+	{
+		LLPointer<LLImageRaw> raw;
+		success &= getLocalTextureRaw(raw, request_save);
+		if (raw.notNull() && raw->getComponents() == 4)
+		{
+			compositor.addImage(raw, LLColor4U::white, LLImageCompositor::BLEND_MULT_ALPHA, false, true);
+		}
+	}
+
+	if (!getInfo()->mStaticImageFileName.empty() && getInfo()->mStaticImageIsMask)
+	{
+		LLImageRaw* raw = LLTexLayerStaticImageList::getInstance()->getImageRaw(getInfo()->mStaticImageFileName);
+		if (raw && (raw->getComponents() == 4 || raw->getComponents() == 1))
+		{
+			compositor.addImage(raw, LLColor4U::white, LLImageCompositor::BLEND_MULT_ALPHA, false, true, true);
+		}
+	}
+
+	// Multiply the alpha by the layer color's alpha.
+	if (!is_approx_equal(layer_color.mV[VW], 1.f))
+	{
+		compositor.addRect(to_color4u(layer_color), LLImageCompositor::BLEND_MULT_ALPHA, false, true);
+	}
+
+	return success;
+}
+
+static LLTrace::BlockTimerStatHandle FTM_COMPOSE_MORPH_MASK("composeMorphMask");
+BOOL LLTexLayer::composeMorphMask(S32 width, S32 height, const LLColor4 &layer_color, U8* alpha_data)
+{
+	LL_RECORD_BLOCK_TIME(FTM_COMPOSE_MORPH_MASK);
+	LLTexLayerParamAlpha* first_param = *mParamAlphaList.begin();
+	if (first_param && first_param->getMultiplyBlend())
+	{
+		return FALSE;
+	}
+
+	LLImageCompositor compositor(width, height);
+	if (!addMorphMasksToCompositor(compositor, layer_color, false))
+	{
+		return FALSE;
+	}
+	S32 capture = compositor.addCapture();
+	compositor.composite();
+	memcpy(alpha_data, compositor.getCapture(capture), width * height);	/* Flawfinder: ignore */
+	return TRUE;
 }
 
 /*virtual*/ BOOL LLTexLayer::isInvisibleAlphaMask() const
@@ -1792,6 +2045,45 @@ LLTexLayer* LLTexLayerTemplate::getLayer(U32 i) const
 	}
 }
 
+/*virtual*/ BOOL LLTexLayerTemplate::addToCompositor(LLImageCompositor& compositor)
+{
+	if (!mInfo)
+	{
+		return FALSE;
+	}
+
+	BOOL success = TRUE;
+	updateWearableCache();
+	for (wearable_cache_t::const_iterator iter = mWearableCache.begin(); iter != mWearableCache.end(); ++iter)
+	{
+		LLWearable* wearable = *iter;
+		LLLocalTextureObject *lto = wearable ? wearable->getLocalTextureObject(mInfo->mLocalTexture) : NULL;
+		LLTexLayer *layer = lto ? lto->getTexLayer(getName()) : NULL;
+		if (layer)
+		{
+			wearable->writeToAvatar(mAvatarAppearance);
+			layer->setLTO(lto);
+			success &= layer->addToCompositor(compositor);
+		}
+	}
+	return success;
+}
+
+/*virtual*/ BOOL LLTexLayerTemplate::addAlphaToCompositor(LLImageCompositor& compositor)
+{
+	BOOL success = TRUE;
+	U32 num_wearables = updateWearableCache();
+	for (U32 i = 0; i < num_wearables; i++)
+	{
+		LLTexLayer *layer = getLayer(i);
+		if (layer)
+		{
+			success &= layer->addAlphaToCompositor(compositor);
+		}
+	}
+	return success;
+}
+
 /*virtual*/ void LLTexLayerTemplate::setHasMorph(BOOL newval)
 { 
 	mHasMorph = newval;
@@ -1889,6 +2181,7 @@ void LLTexLayerSet::cloneTemplates(LLLocalTextureObject *lto, LLAvatarAppearance
 LLTexLayerStaticImageList::LLTexLayerStaticImageList() :
 	mGLBytes(0),
 	mTGABytes(0),
+	mRawBytes(0),
 	mImageNames(16384)
 {
 }
@@ -1902,24 +2195,28 @@ void LLTexLayerStaticImageList::dumpByteCount() const
 {
 	LL_INFOS() << "Avatar Static Textures " <<
 		"KB GL:" << (mGLBytes / 1024) <<
-		"KB TGA:" << (mTGABytes / 1024) << "KB" << LL_ENDL;
+		"KB TGA:" << (mTGABytes / 1024) <<
+		"KB Raw:" << (mRawBytes / 1024) << "KB" << LL_ENDL;
 }
 
 void LLTexLayerStaticImageList::deleteCachedImages()
 {
-	if( mGLBytes || mTGABytes )
+	if( mGLBytes || mTGABytes || mRawBytes )
 	{
 		LL_INFOS() << "Clearing Static Textures " <<
 			"KB GL:" << (mGLBytes / 1024) <<
-			"KB TGA:" << (mTGABytes / 1024) << "KB" << LL_ENDL;
+			"KB TGA:" << (mTGABytes / 1024) <<
+			"KB Raw:" << (mRawBytes / 1024) << "KB" << LL_ENDL;
 
 		//mStaticImageLists uses LLPointers, clear() will cause deletion
 		
 		mStaticImageListTGA.clear();
 		mStaticImageList.clear();
+		mStaticImageListRaw.clear();
 		
 		mGLBytes = 0;
 		mTGABytes = 0;
+		mRawBytes = 0;
 	}
 }
 
@@ -2007,6 +2304,29 @@ LLGLTexture* LLTexLayerStaticImageList::getTexture(const std::string& file_name,
 	return tex;
 }
 
+// Returns the decoded data from a tga file named file_name, for compositing
+// on the CPU. Caches the result to speed identical subsequent requests.
+static LLTrace::BlockTimerStatHandle FTM_LOAD_STATIC_RAW("getImageRaw");
+LLImageRaw* LLTexLayerStaticImageList::getImageRaw(const std::string& file_name)
+{
+	LL_RECORD_BLOCK_TIME(FTM_LOAD_STATIC_RAW);
+	const char *namekey = mImageNames.addString(file_name);
+	image_raw_map_t::const_iterator iter = mStaticImageListRaw.find(namekey);
+	if( iter != mStaticImageListRaw.end() )
+	{
+		return iter->second;
+	}
+
+	LLPointer<LLImageRaw> image_raw = new LLImageRaw;
+	if( !loadImageRaw( file_name, image_raw ) )
+	{
+		return NULL;
+	}
+	mStaticImageListRaw[ namekey ] = image_raw;
+	mRawBytes += image_raw->getDataSize();
+	return image_raw;
+}
+
 // Reads a .tga file, decodes it, and puts the decoded data in image_raw.
 // Returns TRUE if successful.
 static LLTrace::BlockTimerStatHandle FTM_LOAD_IMAGE_RAW("loadImageRaw");
@@ -34,6 +34,7 @@
 #include "lltexlayerparams.h"
 
 class LLAvatarAppearance;
+class LLImageCompositor;
 class LLImageTGA;
 class LLImageRaw;
 class LLLocalTextureObject;
@@ -69,6 +70,10 @@ public:
 	virtual void			deleteCaches() = 0;
 	virtual BOOL			blendAlphaTexture(S32 x, S32 y, S32 width, S32 height) = 0;
 	virtual BOOL			isInvisibleAlphaMask() const = 0;
+	// CPU versions of render() and blendAlphaTexture(), FALSE if an
+	// image is not available on the CPU.
+	virtual BOOL			addToCompositor(LLImageCompositor& compositor) = 0;
+	virtual BOOL			addAlphaToCompositor(LLImageCompositor& compositor) = 0;
 
 	const LLTexLayerInfo* 	getInfo() const 			{ return mInfo; }
 	virtual BOOL			setInfo(const LLTexLayerInfo *info, LLWearable* wearable); // sets mInfo, calls initialization functions
@@ -125,6 +130,8 @@ public:
 	/*virtual*/ BOOL		setInfo(const LLTexLayerInfo *info, LLWearable* wearable); // This sets mInfo and calls initialization functions
 	/*virtual*/ BOOL		blendAlphaTexture(S32 x, S32 y, S32 width, S32 height); // Multiplies a single alpha texture against the frame buffer
 	/*virtual*/ void		gatherAlphaMasks(U8 *data, S32 originX, S32 originY, S32 width, S32 height);
+	/*virtual*/ BOOL		addToCompositor(LLImageCompositor& compositor);
+	/*virtual*/ BOOL		addAlphaToCompositor(LLImageCompositor& compositor);
 	/*virtual*/ void		setHasMorph(BOOL newval);
 	/*virtual*/ void		deleteCaches();
 	/*virtual*/ BOOL		isInvisibleAlphaMask() const;
@@ -163,6 +170,9 @@ public:
 	void					renderMorphMasks(S32 x, S32 y, S32 width, S32 height, const LLColor4 &layer_color, bool force_render);
 	void					addAlphaMask(U8 *data, S32 originX, S32 originY, S32 width, S32 height);
 	/*virtual*/ BOOL		isInvisibleAlphaMask() const;
+	/*virtual*/ BOOL		addToCompositor(LLImageCompositor& compositor);
+	/*virtual*/ BOOL		addAlphaToCompositor(LLImageCompositor& compositor);
+	BOOL					addMorphMasksToCompositor(LLImageCompositor& compositor, const LLColor4 &layer_color, bool request_save);
 
 	void					setLTO(LLLocalTextureObject *lto) 	{ mLocalTextureObject = lto; }
 	LLLocalTextureObject* 	getLTO() 							{ return mLocalTextureObject; }
@@ -172,6 +182,12 @@ public:
 	static void 			calculateTexLayerColor(const param_color_list_t &param_list, LLColor4 &net_color);
 protected:
 	LLUUID					getUUID() const;
+	// The local texture's pixels; FALSE if it has a texture that is not
+	// on the CPU.
+	BOOL					getLocalTextureRaw(LLPointer<LLImageRaw>& raw, bool request_save) const;
+	// The morph mask from the CPU instead of a frame buffer readback,
+	// FALSE if an image is missing or the mask starts from the buffer.
+	BOOL					composeMorphMask(S32 width, S32 height, const LLColor4 &layer_color, U8* alpha_data);
 	typedef std::map<U32, U8*> alpha_cache_t;
 	alpha_cache_t			mAlphaCache;
 	LLLocalTextureObject* 	mLocalTextureObject;
@@ -202,6 +218,14 @@ public:
 	BOOL						render(S32 x, S32 y, S32 width, S32 height);
 	void						renderAlphaMaskTextures(S32 x, S32 y, S32 width, S32 height, bool forceClear = false);
 
+	// Queues the same drawing as render() on compositor. Returns FALSE,
+	// after asking for them, if some images are not on the CPU yet.
+	BOOL						addToCompositor(LLImageCompositor& compositor);
+	BOOL						addAlphaMaskTexturesToCompositor(LLImageCompositor& compositor, bool forceClear = false);
+	// A compositor for the whole layer set, for previews that don't need
+	// GL; run it with a LLImageCompositeThread. NULL if an image is missing.
+	LLImageCompositor*			createCompositor();
+
 	BOOL						isBodyRegion(const std::string& region) const;
 	void						applyMorphMask(U8* tex_data, S32 width, S32 height, S32 num_components);
 	BOOL						isMorphValid() const;
@@ -298,6 +322,8 @@ public:
 	~LLTexLayerStaticImageList();
 	LLGLTexture*		getTexture(const std::string& file_name, BOOL is_mask);
 	LLImageTGA*			getImageTGA(const std::string& file_name);
+	// The decoded image that getTexture() uploads
+	LLImageRaw*			getImageRaw(const std::string& file_name);
 	void				deleteCachedImages();
 	void				dumpByteCount() const;
 protected:
@@ -308,8 +334,11 @@ private:
 	texture_map_t 		mStaticImageList;
 	typedef std::map<const char*, LLPointer<LLImageTGA> > image_tga_map_t;
 	image_tga_map_t 	mStaticImageListTGA;
+	typedef std::map<const char*, LLPointer<LLImageRaw> > image_raw_map_t;
+	image_raw_map_t 	mStaticImageListRaw;
 	S32 				mGLBytes;
 	S32 				mTGABytes;
+	S32 				mRawBytes;
 };
 
 #endif  // LL_LLTEXLAYER_H
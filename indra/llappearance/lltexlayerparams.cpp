@@ -29,6 +29,7 @@
 #include "lltexlayerparams.h"
 
 #include "llavatarappearance.h"
+#include "llimagecompositor.h"
 #include "llimagetga.h"
 #include "llquantize.h"
 #include "lltexlayer.h"
@@ -372,6 +373,51 @@ BOOL LLTexLayerParamAlpha::render(S32 x, S32 y, S32 width, S32 height)
 	return success;
 }
 
+BOOL LLTexLayerParamAlpha::addToCompositor(LLImageCompositor& compositor)
+{
+	if (!mTexLayer || getSkip())
+	{
+		return TRUE;
+	}
+
+	F32 effective_weight = (mTexLayer->getTexLayerSet()->getAvatarAppearance()->getSex() & getSex()) ? mCurWeight : getDefaultWeight();
+	LLTexLayerParamAlphaInfo *info = (LLTexLayerParamAlphaInfo *)getInfo();
+	// Multiplication approximates a min() function, addition a max()
+	const LLImageCompositor::EBlend blend = info->mMultiplyBlend ? LLImageCompositor::BLEND_MULT_ALPHA : LLImageCompositor::BLEND_ADD;
+
+	if (!info->mStaticImageFileName.empty() && !mStaticImageInvalid)
+	{
+		if (mStaticImageTGA.isNull())
+		{
+			mStaticImageTGA = LLTexLayerStaticImageList::getInstance()->getImageTGA(info->mStaticImageFileName);
+			LLTexLayerSet::sHasCaches |= mStaticImageTGA.notNull() ? TRUE : FALSE;
+			if (mStaticImageTGA.isNull())
+			{
+				LL_WARNS() << "Unable to load static file: " << info->mStaticImageFileName << LL_ENDL;
+				mStaticImageInvalid = TRUE; // don't try again.
+				return FALSE;
+			}
+		}
+
+		// Shares the processed image with render(), which uploads it again
+		// when it was rebuilt here.
+		if (mStaticImageRaw.isNull() || (effective_weight != mCachedEffectiveWeight))
+		{
+			mCachedEffectiveWeight = effective_weight;
+			mStaticImageRaw = new LLImageRaw;
+			mStaticImageTGA->decodeAndProcess(mStaticImageRaw, info->mDomain, effective_weight);
+			mNeedsCreateTexture = TRUE;
+		}
+		compositor.addImage(mStaticImageRaw, LLColor4U::white, blend, false, true, true);
+	}
+	else
+	{
+		compositor.addRect(LLColor4U(0, 0, 0, (U8)ll_round(llclamp(effective_weight, 0.f, 1.f) * 255.f)), blend, false, true);
+	}
+
+	return TRUE;
+}
+
 //-----------------------------------------------------------------------------
 // LLTexLayerParamAlphaInfo
 //-----------------------------------------------------------------------------
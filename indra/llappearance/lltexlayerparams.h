@@ -32,6 +32,7 @@
 #include "llviewervisualparam.h"
 
 class LLAvatarAppearance;
+class LLImageCompositor;
 class LLImageRaw;
 class LLImageTGA;
 class LLTexLayer;
@@ -100,6 +101,8 @@ public:
 
 	// New functions
 	BOOL					render( S32 x, S32 y, S32 width, S32 height );
+	// Same as render(), on the CPU
+	BOOL					addToCompositor(LLImageCompositor& compositor);
 	BOOL					getSkip() const;
 	void					deleteCaches();
 	BOOL					getMultiplyBlend() const;
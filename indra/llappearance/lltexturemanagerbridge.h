@@ -40,6 +40,9 @@ public:
 	virtual LLPointer<LLGLTexture> getLocalTexture(BOOL usemipmaps = TRUE, BOOL generate_gl_tex = TRUE) = 0;
 	virtual LLPointer<LLGLTexture> getLocalTexture(const U32 width, const U32 height, const U8 components, BOOL usemipmaps, BOOL generate_gl_tex = TRUE) = 0;
 	virtual LLGLTexture* getFetchedTexture(const LLUUID &image_id) = 0;
+	// The texture's pixels if they are kept on the CPU, else NULL. With
+	// request_save set, a fetched texture starts keeping them.
+	virtual LLImageRaw* getRawImage(LLGLTexture* tex, bool request_save) = 0;
 };
 
 extern LLTextureManagerBridge* gTextureManagerBridgep;
@@ -1820,6 +1820,11 @@ bool LLAudioData::load()
 		return false;
 	}
 	mBufferp->mAudioDatap = this;
+
+	// Buffers are reused, account for the difference with the previous sound.
+	S64 bytes = (S64)mBufferp->getLength() * 2;
+	LLMemTag::add(LLMemTag::MT_AUDIO, bytes - mBufferp->mAccountedBytes);
+	mBufferp->mAccountedBytes = bytes;
 	return true;
 }
 
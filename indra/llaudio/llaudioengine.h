@@ -36,6 +36,7 @@
 #include "lltimer.h"
 #include "lluuid.h"
 #include "llframetimer.h"
+#include "llmemtag.h"
 #include "llassettype.h"
 #include "llextendedstatus.h"
 
@@ -477,10 +478,10 @@ protected:
 class LLAudioBuffer
 {
 public:
-	LLAudioBuffer() : mInUse(true), mAudioDatap(NULL) { mLastUseTimer.reset(); }
-	virtual ~LLAudioBuffer() {};
+	LLAudioBuffer() : mInUse(true), mAudioDatap(NULL), mAccountedBytes(0) { mLastUseTimer.reset(); }
+	virtual ~LLAudioBuffer() { LLMemTag::sub(LLMemTag::MT_AUDIO, mAccountedBytes); }
 	virtual bool loadWAV(const std::string& filename) = 0;
-	virtual U32 getLength() = 0;
+	virtual U32 getLength() = 0;	// In 16-bit samples.
 
 	friend class LLAudioEngine;
 	friend class LLAudioChannel;
@@ -489,6 +490,8 @@ protected:
 	bool mInUse;
 	LLAudioData *mAudioDatap;
 	LLFrameTimer mLastUseTimer;
+	// Size of the loaded sound, as reported to LLMemTag::MT_AUDIO.
+	S64 mAccountedBytes;
 };
 
 
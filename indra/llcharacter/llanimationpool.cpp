@@ -0,0 +1,197 @@
+/**
+ * @file llanimationpool.cpp
+ * @brief Evaluates the motions of many characters on worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llanimationpool.h"
+
+#include <atomic>
+
+#include "llcharacter.h"
+#include "llthread.h"
+
+namespace
+{
+class Worker : public LLThread
+{
+public:
+	Worker(S32 index)
+	:	LLThread(llformat("Animation %d", index))
+	{
+	}
+
+protected:
+	/*virtual*/ void run();
+};
+
+std::vector<Worker*>				sWorkers;
+LLCondition*						sStartCondition = NULL;		// guards sBatch and sGeneration
+LLCondition*						sDoneCondition = NULL;		// guards sBusyWorkers
+const std::vector<LLCharacter*>*	sBatch = NULL;
+LLAnimationPool::function_t			sFunction = NULL;
+U32									sGeneration = 0;
+S32									sBusyWorkers = 0;
+std::atomic<size_t>					sNextCharacter(0);
+
+void evaluate_motions(LLCharacter* character)
+{
+	character->evaluateMotions();
+}
+
+void process_batch(const std::vector<LLCharacter*>& batch, LLAnimationPool::function_t function)
+{
+	const size_t count = batch.size();
+	for (size_t i = sNextCharacter.fetch_add(1, std::memory_order_relaxed); i < count;
+		 i = sNextCharacter.fetch_add(1, std::memory_order_relaxed))
+	{
+		function(batch[i]);
+	}
+}
+}
+
+void Worker::run()
+{
+	U32 generation = 0;
+	while (true)
+	{
+		sStartCondition->lock();
+		while (sGeneration == generation && !isQuitting())
+		{
+			sStartCondition->wait();
+		}
+		if (isQuitting())
+		{
+			sStartCondition->unlock();
+			break;
+		}
+		generation = sGeneration;
+		const std::vector<LLCharacter*>* batch = sBatch;
+		LLAnimationPool::function_t function = sFunction;
+		sStartCondition->unlock();
+
+		process_batch(*batch, function);
+
+		sDoneCondition->lock();
+		if (--sBusyWorkers == 0)
+		{
+			sDoneCondition->signal();
+		}
+		sDoneCondition->unlock();
+	}
+}
+
+//static
+void LLAnimationPool::initClass(S32 thread_count)
+{
+	llassert(!sStartCondition);
+	sStartCondition = new LLCondition;
+	sDoneCondition = new LLCondition;
+	for (S32 i = 0; i < thread_count; ++i)
+	{
+		Worker* worker = new Worker(i);
+		sWorkers.push_back(worker);
+		worker->start();
+	}
+	LL_INFOS() << "Started " << thread_count << " animation threads" << LL_ENDL;
+}
+
+//static
+void LLAnimationPool::cleanupClass()
+{
+	if (!sStartCondition) return;
+
+	for (std::vector<Worker*>::iterator it = sWorkers.begin(); it != sWorkers.end(); ++it)
+	{
+		(*it)->setQuitting();
+	}
+	sStartCondition->lock();
+	sStartCondition->broadcast();
+	sStartCondition->unlock();
+	for (std::vector<Worker*>::iterator it = sWorkers.begin(); it != sWorkers.end(); ++it)
+	{
+		(*it)->shutdown();
+		delete *it;
+	}
+	sWorkers.clear();
+	// New workers start waiting for generation 1.
+	sGeneration = 0;
+
+	delete sStartCondition;
+	sStartCondition = NULL;
+	delete sDoneCondition;
+	sDoneCondition = NULL;
+}
+
+//static
+S32 LLAnimationPool::getThreadCount()
+{
+	return (S32)sWorkers.size();
+}
+
+static LLTrace::BlockTimerStatHandle FTM_ANIMATION_POOL("Animation Pool");
+
+//static
+void LLAnimationPool::evaluate(const std::vector<LLCharacter*>& characters)
+{
+	LL_RECORD_BLOCK_TIME(FTM_ANIMATION_POOL);
+	process(characters, evaluate_motions);
+}
+
+//static
+void LLAnimationPool::process(const std::vector<LLCharacter*>& characters, function_t function)
+{
+	if (sWorkers.empty() || characters.size() < 2)
+	{
+		for (std::vector<LLCharacter*>::const_iterator it = characters.begin(); it != characters.end(); ++it)
+		{
+			function(*it);
+		}
+		return;
+	}
+
+	sNextCharacter.store(0, std::memory_order_relaxed);
+	sDoneCondition->lock();
+	sBusyWorkers = (S32)sWorkers.size();
+	sDoneCondition->unlock();
+
+	sStartCondition->lock();
+	sBatch = &characters;
+	sFunction = function;
+	++sGeneration;
+	sStartCondition->broadcast();
+	sStartCondition->unlock();
+
+	process_batch(characters, function);
+
+	sDoneCondition->lock();
+	while (sBusyWorkers > 0)
+	{
+		sDoneCondition->wait();
+	}
+	sDoneCondition->unlock();
+	sBatch = NULL;
+	sFunction = NULL;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file llanimationpool.h
+ * @brief Evaluates the motions of many characters on worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLANIMATIONPOOL_H
+#define LL_LLANIMATIONPOOL_H
+
+#include <vector>
+
+class LLCharacter;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLAnimationPool
+//
+//   Runs LLCharacter::evaluateMotions() for a batch of characters whose
+//   motions were updated with a deferred evaluation: keyframe curves, pose
+//   blending and world matrices. Each character only touches its own motions
+//   and joints, so the batch is shared out over the worker threads and the
+//   calling thread, one character at a time. evaluate() returns once the
+//   whole batch is done, so whatever reads the final pose can run serially
+//   right after it.
+//
+//   With no worker threads the batch is evaluated on the calling thread.
+//
+//   process() shares out other work the same way, for instance applying the
+//   queued vertex morphs of each avatar.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLAnimationPool
+{
+public:
+	static void initClass(S32 thread_count);
+	static void cleanupClass();
+
+	static S32 getThreadCount();
+
+	static void evaluate(const std::vector<LLCharacter*>& characters);
+
+	typedef void (*function_t)(LLCharacter* character);
+	// function must only touch the character it is called for.
+	static void process(const std::vector<LLCharacter*>& characters, function_t function);
+};
+
+#endif // LL_LLANIMATIONPOOL_H
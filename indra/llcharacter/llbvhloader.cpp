@@ -28,13 +28,12 @@
 
 #include "llbvhloader.h"
 
-#include <boost/tokenizer.hpp>
-
 #include "lldatapacker.h"
 #include "lldir.h"
 #include "llkeyframemotion.h"
 #include "llquantize.h"
 #include "llstl.h"
+#include "lltimer.h"
 
 #define INCHES_TO_METERS 0.02540005f
 
@@ -44,6 +43,13 @@ const F32 ROTATION_KEYFRAME_THRESHOLD = 0.01f;
 const F32 POSITION_MOTION_THRESHOLD_SQUARED = 0.001f * 0.001f;
 const F32 ROTATION_MOTION_THRESHOLD = 0.001f;
 
+// Share of the load done once the frames are parsed and once their
+// rotations are converted.
+const F32 PARSE_PROGRESS = 0.7f;
+const F32 CONVERT_PROGRESS = 0.9f;
+// Frames parsed between progress updates.
+const S32 PROGRESS_FRAMES = 256;
+
 char gInFile[1024];		/* Flawfinder: ignore */
 char gOutFile[1024];		/* Flawfinder: ignore */
 /*
@@ -95,6 +101,68 @@ const char *find_next_whitespace(const char *p)
 }
 
 
+//------------------------------------------------------------------------
+// next_line()
+//
+// Finds the next line that is not empty at or after p, the way the file
+// used to be tokenized on "\r\n". Returns false at the end of the buffer.
+//------------------------------------------------------------------------
+static bool next_line(const char*& p, const char*& begin, const char*& end)
+{
+	while (*p == '\r' || *p == '\n') p++;
+	if (!*p)
+	{
+		return false;
+	}
+	begin = p;
+	while (*p && *p != '\r' && *p != '\n') p++;
+	end = p;
+	return true;
+}
+
+static bool next_line(const char*& p, std::string& line)
+{
+	const char *begin, *end;
+	if (!next_line(p, begin, end))
+	{
+		return false;
+	}
+	line.assign(begin, end);
+	return true;
+}
+
+//------------------------------------------------------------------------
+// parse_values()
+//
+// Reads count numbers off the line that ends at end, moving p past them.
+//------------------------------------------------------------------------
+static bool parse_values(const char*& p, const char* end, F32* values, S32 count)
+{
+	for (S32 i = 0; i < count; i++)
+	{
+		while (p < end && isspace((unsigned char)*p)) p++;
+		if (p >= end)
+		{
+			return false;
+		}
+		char* next;
+		values[i] = strtof(p, &next);
+		if (next == p)
+		{
+			return false;
+		}
+		p = next;
+	}
+	return true;
+}
+
+static void copy_error_line(char* error_text, const char* begin, const char* end)
+{
+	size_t length = llmin((size_t)(end - begin), (size_t)127);
+	memcpy(error_text, begin, length);		/* Flawfinder: ignore */
+	error_text[length] = '\0';
+}
+
 //------------------------------------------------------------------------
 // bvhStringToOrder()
 //
@@ -153,7 +221,8 @@ LLQuaternion::Order bvhStringToOrder( char *str )
 	mInitialized = TRUE;
 }
 */
-LLBVHLoader::LLBVHLoader(const char* buffer, ELoadStatus &loadStatus, S32 &errorLine)
+LLBVHLoader::LLBVHLoader(const char* buffer, ELoadStatus &loadStatus, S32 &errorLine, LLBVHProgress* progress)
+:	mProgress(progress)
 {
 	reset();
 	errorLine = 0;
@@ -191,6 +260,13 @@ LLBVHLoader::LLBVHLoader(const char* buffer, ELoadStatus &loadStatus, S32 &error
 	
 	applyTranslations();
 	optimize();
+
+	if (isCancelled())
+	{
+		mStatus = E_ST_EOF;
+		loadStatus = mStatus;
+		return;
+	}
 	
 	mInitialized = TRUE;
 }
@@ -666,16 +742,11 @@ ELoadStatus LLBVHLoader::loadTranslationTable(const char *fileName)
 ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &err_line)
 {
 	std::string line;
+	const char* p = buffer;
 
 	err_line = 0;
 	error_text[127] = '\0';
 
-	std::string str(buffer);
-	typedef boost::tokenizer<boost::char_separator<char> > tokenizer;
-	boost::char_separator<char> sep("\r\n");
-	tokenizer tokens(str, sep);
-	tokenizer::iterator iter = tokens.begin();
-
 	mLineNumber = 0;
 	mJoints.clear();
 
@@ -684,9 +755,8 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 	//--------------------------------------------------------------------
 	// consume  hierarchy
 	//--------------------------------------------------------------------
-	if (iter == tokens.end())
+	if (!next_line(p, line))
 		return E_ST_EOF;
-	line = (*(iter++));
 	err_line++;
 
 	if ( !strstr(line.c_str(), "HIERARCHY") )
@@ -703,9 +773,8 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 		//----------------------------------------------------------------
 		// get next line
 		//----------------------------------------------------------------
-		if (iter == tokens.end())
+		if (!next_line(p, line))
 			return E_ST_EOF;
-		line = (*(iter++));
 		err_line++;
 
 		//----------------------------------------------------------------
@@ -737,8 +806,8 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 		}
 		else if ( strstr(line.c_str(), "End Site") )
 		{
-			iter++; // {
-			iter++; //     OFFSET
+			next_line(p, line); // {
+			next_line(p, line); //     OFFSET
 			S32 depth = 0;
 			for (S32 j = (S32)parent_joints.size() - 1; j >= 0; j--)
 			{
@@ -798,11 +867,10 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 		//----------------------------------------------------------------
 		// get next line
 		//----------------------------------------------------------------
-		if (iter == tokens.end())
+		if (!next_line(p, line))
 		{
 			return E_ST_EOF;
 		}
-		line = (*(iter++));
 		err_line++;
 
 		//----------------------------------------------------------------
@@ -821,11 +889,10 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 		//----------------------------------------------------------------
 		// get next line
 		//----------------------------------------------------------------
-		if (iter == tokens.end())
+		if (!next_line(p, line))
 		{
 			return E_ST_EOF;
 		}
-		line = (*(iter++));
 		err_line++;
 
 		//----------------------------------------------------------------
@@ -840,11 +907,10 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 		//----------------------------------------------------------------
 		// get next line
 		//----------------------------------------------------------------
-		if (iter == tokens.end())
+		if (!next_line(p, line))
 		{
 			return E_ST_EOF;
 		}
-		line = (*(iter++));
 		err_line++;
 
 		//----------------------------------------------------------------
@@ -859,17 +925,17 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 		//----------------------------------------------------------------
 		// get rotation order
 		//----------------------------------------------------------------
-		const char *p = line.c_str();
+		const char *r = line.c_str();
 		for (S32 i=0; i<3; i++)
 		{
-			p = strstr(p, "rotation");
-			if (!p)
+			r = strstr(r, "rotation");
+			if (!r)
 			{
 				strncpy(error_text, line.c_str(), 127);		/*Flawfinder: ignore*/
 				return E_ST_NO_ROTATION;
 			}
 
-			const char axis = *(p - 1);
+			const char axis = *(r - 1);
 			if ((axis != 'X') && (axis != 'Y') && (axis != 'Z'))
 			{
 				strncpy(error_text, line.c_str(), 127);		/*Flawfinder: ignore*/
@@ -878,7 +944,7 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 
 			joint->mOrder[i] = axis;
 
-			p++;
+			r++;
 		}
 	}
 
@@ -894,11 +960,10 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 	//--------------------------------------------------------------------
 	// get number of frames
 	//--------------------------------------------------------------------
-	if (iter == tokens.end())
+	if (!next_line(p, line))
 	{
 		return E_ST_EOF;
 	}
-	line = (*(iter++));
 	err_line++;
 
 	if ( !strstr(line.c_str(), "Frames:") )
@@ -916,11 +981,10 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 	//--------------------------------------------------------------------
 	// get frame time
 	//--------------------------------------------------------------------
-	if (iter == tokens.end())
+	if (!next_line(p, line))
 	{
 		return E_ST_EOF;
 	}
-	line = (*(iter++));
 	err_line++;
 
 	if ( !strstr(line.c_str(), "Frame Time:") )
@@ -944,18 +1008,40 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 	//--------------------------------------------------------------------
 	// load frames
 	//--------------------------------------------------------------------
+	// The values are read straight off the buffer. A frame needs at least
+	// two characters per value, which bounds what a bad frame count could
+	// make us reserve.
+	if (mNumFrames > 0)
+	{
+		size_t values = 3 + 3 * mJoints.size();
+		size_t max_frames = strlen(p) / (2 * values) + 1;
+		for (U32 j=0; j<mJoints.size(); j++)
+		{
+			mJoints[j]->mKeys.reserve(llmin((size_t)mNumFrames, max_frames));
+		}
+	}
+
 	for (S32 i=0; i<mNumFrames; i++)
 	{
+		if (i % PROGRESS_FRAMES == 0)
+		{
+			if (isCancelled())
+			{
+				return E_ST_EOF;
+			}
+			setProgress(PARSE_PROGRESS * (F32)i / (F32)mNumFrames);
+		}
+
 		// get next line
-		if (iter == tokens.end())
+		const char *begin, *end;
+		if (!next_line(p, begin, end))
 		{
 			return E_ST_EOF;
 		}
-		line = (*(iter++));
 		err_line++;
 
 		// read and store values
-		const char *p = line.c_str();
+		const char *v = begin;
 		for (U32 j=0; j<mJoints.size(); j++)
 		{
 			Joint *joint = mJoints[j];
@@ -965,49 +1051,28 @@ ELoadStatus LLBVHLoader::loadBVHFile(const char *buffer, char* error_text, S32 &
 			// get 3 pos values for root joint only
 			if (j==0)
 			{
-				if ( sscanf(p, "%f %f %f", key.mPos, key.mPos+1, key.mPos+2) != 3 )
+				if (!parse_values(v, end, key.mPos, 3))
 				{
-					strncpy(error_text, line.c_str(), 127);	/*Flawfinder: ignore*/
+					copy_error_line(error_text, begin, end);
 					return E_ST_NO_POS;
 				}
 			}
 
-			// skip to next 3 values in the line
-			p = find_next_whitespace(p);
-			if (!p) 
-			{
-				strncpy(error_text, line.c_str(), 127);		/*Flawfinder: ignore*/
-				return E_ST_NO_ROT;
-			}
-			p = find_next_whitespace(++p);
-			if (!p) 
-			{
-				strncpy(error_text, line.c_str(), 127);		/*Flawfinder: ignore*/
-				return E_ST_NO_ROT;
-			}
-			p = find_next_whitespace(++p);
-			if (!p)
-			{
-				strncpy(error_text, line.c_str(), 127);		/*Flawfinder: ignore*/
-				return E_ST_NO_ROT;
-			}
-
 			// get 3 rot values for joint
 			F32 rot[3];
-			if ( sscanf(p, " %f %f %f", rot, rot+1, rot+2) != 3 )
+			if (!parse_values(v, end, rot, 3))
 			{
-				strncpy(error_text, line.c_str(), 127);		/*Flawfinder: ignore*/
+				copy_error_line(error_text, begin, end);
 				return E_ST_NO_ROT;
 			}
 
-			p++;
-
 			key.mRot[ joint->mOrder[0]-'X' ] = rot[0];
 			key.mRot[ joint->mOrder[1]-'X' ] = rot[1];
 			key.mRot[ joint->mOrder[2]-'X' ] = rot[2];
 		}
 	}
 
+	setProgress(PARSE_PROGRESS);
 	return E_ST_OK;
 }
 
@@ -1121,11 +1186,62 @@ void LLBVHLoader::applyTranslations()
 	}
 }
 
+//-----------------------------------------------------------------------------
+// LLBVHLoader::convertRotations()
+//-----------------------------------------------------------------------------
+ELoadStatus LLBVHLoader::convertRotations()
+{
+	// Ignored joints are only needed to merge with.
+	std::set<std::string> merged;
+	JointVector::iterator ji;
+	for (ji = mJoints.begin(); ji != mJoints.end(); ++ji)
+	{
+		Joint *joint = *ji;
+		if (!joint->mIgnore)
+		{
+			merged.insert(joint->mMergeParentName);
+			merged.insert(joint->mMergeChildName);
+		}
+	}
+
+	F32 joints = (F32)llmax((S32)mJoints.size(), 1);
+	for (ji = mJoints.begin(); ji != mJoints.end(); ++ji)
+	{
+		if (isCancelled())
+		{
+			return E_ST_EOF;
+		}
+
+		Joint *joint = *ji;
+		joint->mRotations.clear();
+		if (joint->mIgnore && !merged.count(joint->mName))
+		{
+			continue;
+		}
+
+		LLQuaternion::Order order = bvhStringToOrder( joint->mOrder );
+		joint->mRotations.reserve(joint->mKeys.size());
+		for (KeyVector::iterator ki = joint->mKeys.begin(); ki != joint->mKeys.end(); ++ki)
+		{
+			joint->mRotations.push_back(mayaQ( ki->mRot[0], ki->mRot[1], ki->mRot[2], order));
+		}
+
+		setProgress(PARSE_PROGRESS + (CONVERT_PROGRESS - PARSE_PROGRESS) * (F32)(ji - mJoints.begin() + 1) / joints);
+	}
+
+	return E_ST_OK;
+}
+
 //-----------------------------------------------------------------------------
 // LLBVHLoader::optimize()
 //-----------------------------------------------------------------------------
 void LLBVHLoader::optimize()
 {
+	if (convertRotations() != E_ST_OK)
+	{
+		return;
+	}
+
 	//RN: assumes motion blend, which is the default now
 	if (!mLoop && mEaseIn + mEaseOut > mDuration && mDuration != 0.f)
 	{
@@ -1145,7 +1261,6 @@ void LLBVHLoader::optimize()
 		{
 			joint->mNumPosKeys = 0;
 			joint->mNumRotKeys = 0;
-			LLQuaternion::Order order = bvhStringToOrder( joint->mOrder );
 
 			KeyVector::iterator first_key = joint->mKeys.begin();
 
@@ -1156,8 +1271,11 @@ void LLBVHLoader::optimize()
 				continue;
 			}
 
+			// indexed like mKeys
+			const LLQuaternion* rotations = &joint->mRotations[0];
+
 			LLVector3 first_frame_pos(first_key->mPos);
-			LLQuaternion first_frame_rot = mayaQ( first_key->mRot[0], first_key->mRot[1], first_key->mRot[2], order);
+			const LLQuaternion& first_frame_rot = rotations[0];
 	
 			// skip first key
 			KeyVector::iterator ki = joint->mKeys.begin();
@@ -1224,7 +1342,7 @@ void LLBVHLoader::optimize()
 				if (ki_prev == ki_last_good_rot)
 				{
 					joint->mNumRotKeys++;
-					LLQuaternion test_rot = mayaQ( ki_prev->mRot[0], ki_prev->mRot[1], ki_prev->mRot[2], order);
+					const LLQuaternion& test_rot = rotations[ki_prev - first_key];
 					F32 x_delta = dist_vec(LLVector3::x_axis * first_frame_rot, LLVector3::x_axis * test_rot);
 					F32 y_delta = dist_vec(LLVector3::y_axis * first_frame_rot, LLVector3::y_axis * test_rot);
 					F32 rot_test = x_delta + y_delta;
@@ -1237,9 +1355,9 @@ void LLBVHLoader::optimize()
 				else
 				{
 					//check rotation for noticeable effect
-					LLQuaternion test_rot = mayaQ( ki_prev->mRot[0], ki_prev->mRot[1], ki_prev->mRot[2], order);
-					LLQuaternion last_good_rot = mayaQ( ki_last_good_rot->mRot[0], ki_last_good_rot->mRot[1], ki_last_good_rot->mRot[2], order);
-					LLQuaternion current_rot = mayaQ( ki->mRot[0], ki->mRot[1], ki->mRot[2], order);
+					const LLQuaternion& test_rot = rotations[ki_prev - first_key];
+					const LLQuaternion& last_good_rot = rotations[ki_last_good_rot - first_key];
+					const LLQuaternion& current_rot = rotations[ki - first_key];
 					LLQuaternion interp_rot = lerp(1.f / (F32)numRotFramesConsidered, current_rot, last_good_rot);
 
 					F32 x_delta;
@@ -1308,6 +1426,8 @@ void LLBVHLoader::optimize()
 			joint->mIgnore = TRUE;
 		}
 	}
+
+	setProgress(CONVERT_PROGRESS);
 }
 
 void LLBVHLoader::reset()
@@ -1329,6 +1449,19 @@ void LLBVHLoader::reset()
 	mEmoteName = "";
 }
 
+void LLBVHLoader::setProgress(F32 fraction)
+{
+	if (mProgress)
+	{
+		mProgress->mFraction = fraction;
+	}
+}
+
+bool LLBVHLoader::isCancelled() const
+{
+	return mProgress && mProgress->mCancel;
+}
+
 //------------------------------------------------------------------------
 // LLBVHLoader::getLine()
 //------------------------------------------------------------------------
@@ -1425,7 +1558,6 @@ BOOL LLBVHLoader::serialize(LLDataPacker& dp)
 
 		dp.packS32(joint->mNumRotKeys, "num_rot_keys");
 
-		LLQuaternion::Order order = bvhStringToOrder( joint->mOrder );
 		S32 outcount = 0;
 		S32 frame = 1;
 		for (	ki = joint->mKeys.begin();
@@ -1434,7 +1566,7 @@ BOOL LLBVHLoader::serialize(LLDataPacker& dp)
 		{
 			if ((frame == 1) && joint->mRelativeRotationKey)
 			{
-				first_frame_rot = mayaQ( ki->mRot[0], ki->mRot[1], ki->mRot[2], order);
+				first_frame_rot = joint->mRotations[0];
 				
 				fixup_rot.shortestArc(LLVector3::z_axis * first_frame_rot * frameRot, LLVector3::z_axis);
 			}
@@ -1449,10 +1581,7 @@ BOOL LLBVHLoader::serialize(LLDataPacker& dp)
 
 			if (mergeParent)
 			{
-				mergeParentRot = mayaQ(	mergeParent->mKeys[frame-1].mRot[0], 
-										mergeParent->mKeys[frame-1].mRot[1],
-										mergeParent->mKeys[frame-1].mRot[2],
-										bvhStringToOrder(mergeParent->mOrder) );
+				mergeParentRot = mergeParent->mRotations[frame-1];
 				LLQuaternion parentFrameRot( mergeParent->mFrameMatrix );
 				LLQuaternion parentOffsetRot( mergeParent->mOffsetMatrix );
 				mergeParentRot = ~parentFrameRot * mergeParentRot * parentFrameRot * parentOffsetRot;
@@ -1464,10 +1593,7 @@ BOOL LLBVHLoader::serialize(LLDataPacker& dp)
 
 			if (mergeChild)
 			{
-				mergeChildRot = mayaQ(	mergeChild->mKeys[frame-1].mRot[0], 
-										mergeChild->mKeys[frame-1].mRot[1],
-										mergeChild->mKeys[frame-1].mRot[2],
-										bvhStringToOrder(mergeChild->mOrder) );
+				mergeChildRot = mergeChild->mRotations[frame-1];
 				LLQuaternion childFrameRot( mergeChild->mFrameMatrix );
 				LLQuaternion childOffsetRot( mergeChild->mOffsetMatrix );
 				mergeChildRot = ~childFrameRot * mergeChildRot * childFrameRot * childOffsetRot;
@@ -1478,7 +1604,7 @@ BOOL LLBVHLoader::serialize(LLDataPacker& dp)
 				mergeChildRot.loadIdentity();
 			}
 
-			LLQuaternion inRot = mayaQ( ki->mRot[0], ki->mRot[1], ki->mRot[2], order);
+			const LLQuaternion& inRot = joint->mRotations[frame-1];
 
 			LLQuaternion outRot =  frameRotInv* mergeChildRot * inRot * mergeParentRot * ~first_frame_rot * frameRot * offsetRot;
 
@@ -1577,3 +1703,31 @@ BOOL LLBVHLoader::serialize(LLDataPacker& dp)
 
 	return TRUE;
 }
+
+//------------------------------------------------------------------------
+// LLBVHLoadThread
+//------------------------------------------------------------------------
+LLBVHLoadThread::LLBVHLoadThread(const std::string& buffer)
+:	LLThread("BVH loader"),
+	mBuffer(buffer),
+	mStatus(E_ST_OK),
+	mErrorLine(0),
+	mDuration(0.f),
+	mLoadTime(0.f)
+{
+}
+
+void LLBVHLoadThread::run()
+{
+	LLTimer timer;
+	LLBVHLoader loader(mBuffer.c_str(), mStatus, mErrorLine, &mProgress);
+	mDuration = loader.getDuration();
+	if (loader.isInitialized() && mDuration <= MAX_ANIM_DURATION)
+	{
+		mData.resize(loader.getOutputSize());
+		LLDataPackerBinaryBuffer dp(&mData[0], (S32)mData.size());
+		loader.serialize(dp);
+	}
+	mProgress.mFraction = 1.f;
+	mLoadTime = timer.getElapsedTimeF32();
+}
@@ -27,9 +27,13 @@
 #ifndef LL_LLBVHLOADER_H
 #define LL_LLBVHLOADER_H
 
+#include <atomic>
+
 #include "v3math.h"
 #include "m3math.h"
 #include "llmath.h"
+#include "llquaternion.h"
+#include "llthread.h"
 #include "llbvhconsts.h"
 
 const S32 BVH_PARSER_LINE_SIZE = 2048;
@@ -98,6 +102,8 @@ struct Joint
 	std::string		mMergeChildName;
 	char			mOrder[4];			/* Flawfinder: ignore */
 	KeyVector		mKeys;
+	// The rotation of each key, see LLBVHLoader::convertRotations()
+	std::vector<LLQuaternion> mRotations;
 	S32				mNumPosKeys;
 	S32				mNumRotKeys;
 	S32				mChildTreeMaxDepth;
@@ -199,13 +205,27 @@ typedef enum e_load_status
 //------------------------------------------------------------------------
 typedef std::map<std::string, Translation> TranslationMap;
 
+//------------------------------------------------------------------------
+// LLBVHProgress
+//
+// Lets another thread follow a load or cancel it. A cancelled load
+// fails with E_ST_EOF.
+//------------------------------------------------------------------------
+struct LLBVHProgress
+{
+	LLBVHProgress() : mFraction(0.f), mCancel(false) {}
+
+	std::atomic<F32>	mFraction;
+	std::atomic<bool>	mCancel;
+};
+
 class LLBVHLoader
 {
 	friend class LLKeyframeMotion;
 public:
 	// Constructor
 //	LLBVHLoader(const char* buffer);
-	LLBVHLoader(const char* buffer, ELoadStatus &loadStatus, S32 &errorLine);
+	LLBVHLoader(const char* buffer, ELoadStatus &loadStatus, S32 &errorLine, LLBVHProgress* progress = NULL);
 	~LLBVHLoader();
 
 /*	
@@ -279,6 +299,13 @@ protected:
 	// Consumes one line of input from file.
 	BOOL getLine(llifstream& stream);
 
+	// Computes the rotation of every key once, for optimize() and
+	// serialize() to share.
+	ELoadStatus convertRotations();
+
+	void setProgress(F32 fraction);
+	bool isCancelled() const;
+
 	// parser state
 	char		mLine[BVH_PARSER_LINE_SIZE];		/* Flawfinder: ignore */
 	S32			mLineNumber;
@@ -301,9 +328,46 @@ protected:
 
 	BOOL				mInitialized;
 	ELoadStatus			mStatus;
+	LLBVHProgress*		mProgress;
 
 	// computed values
 	F32	mDuration;
 };
 
+//------------------------------------------------------------------------
+// LLBVHLoadThread
+//
+// Loads a BVH file and serializes the animation on its own thread. The
+// main thread follows getProgress(), polls isStopped() and then takes
+// the animation from getData().
+//------------------------------------------------------------------------
+class LLBVHLoadThread : public LLThread
+{
+public:
+	LLBVHLoadThread(const std::string& buffer);
+
+	F32 getProgress() const				{ return mProgress.mFraction; }
+	// The thread still has to be waited for.
+	void cancel()						{ mProgress.mCancel = true; }
+
+	ELoadStatus getStatus() const		{ return mStatus; }
+	S32 getErrorLine() const			{ return mErrorLine; }
+	F32 getDuration() const				{ return mDuration; }
+	F32 getLoadTime() const				{ return mLoadTime; }
+	// Empty unless the file loaded and is short enough to upload.
+	std::vector<U8>& getData()			{ return mData; }
+
+protected:
+	/*virtual*/ void run();
+
+private:
+	std::string		mBuffer;
+	LLBVHProgress	mProgress;
+	ELoadStatus		mStatus;
+	S32				mErrorLine;
+	F32				mDuration;
+	F32				mLoadTime;
+	std::vector<U8>	mData;
+};
+
 #endif // LL_LLBVHLOADER_H
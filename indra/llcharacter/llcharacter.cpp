@@ -38,6 +38,8 @@
 LLStringTable LLCharacter::sVisualParamNames(1024);
 
 std::vector< LLCharacter* > LLCharacter::sInstances;
+U32 LLCharacter::sVisualParamsChecked = 0;
+U32 LLCharacter::sVisualParamsApplied = 0;
 
 //-----------------------------------------------------------------------------
 // LLCharacter()
@@ -176,7 +178,7 @@ static LLTrace::BlockTimerStatHandle FTM_UPDATE_ANIMATION("Update Animation");
 static LLTrace::BlockTimerStatHandle FTM_UPDATE_HIDDEN_ANIMATION("Update Hidden Anim");
 static LLTrace::BlockTimerStatHandle FTM_UPDATE_MOTIONS("Update Motions");
 
-void LLCharacter::updateMotions(e_update_t update_type)
+void LLCharacter::updateMotions(e_update_t update_type, bool defer_evaluation)
 {
 	if (update_type == HIDDEN_UPDATE)
 	{
@@ -209,11 +211,27 @@ void LLCharacter::updateMotions(e_update_t update_type)
 		bool force_update = (update_type == FORCE_UPDATE);
 		{
 			LL_RECORD_BLOCK_TIME(FTM_UPDATE_MOTIONS);
-			mMotionController.updateMotions(force_update);
+			mMotionController.updateMotions(force_update, defer_evaluation);
 		}
 	}
 }
 
+//-----------------------------------------------------------------------------
+// evaluateMotions()
+//-----------------------------------------------------------------------------
+static LLTrace::BlockTimerStatHandle FTM_EVALUATE_MOTIONS("Evaluate Motions");
+
+void LLCharacter::evaluateMotions()
+{
+	LL_RECORD_BLOCK_TIME(FTM_EVALUATE_MOTIONS);
+	mMotionController.evaluate();
+	LLJoint* root = getRootJoint();
+	if (root)
+	{
+		root->updateWorldMatrixChildren();
+	}
+}
+
 
 //-----------------------------------------------------------------------------
 // deactivateAllMotions()
@@ -483,6 +501,9 @@ void LLCharacter::addVisualParam(LLVisualParam *param)
 	
 	mVisualParamSortedVector[index] = param;
 
+	param->setCharacter(this);
+	param->markDirty();
+
 	if (param->getInfo())
 	{
 		// Add name map
@@ -504,14 +525,37 @@ void LLCharacter::addVisualParam(LLVisualParam *param)
 //-----------------------------------------------------------------------------
 // updateVisualParams()
 //-----------------------------------------------------------------------------
+static bool visual_param_id_less(const LLVisualParam* a, const LLVisualParam* b)
+{
+	return a->getID() < b->getID();
+}
+
+static LLTrace::BlockTimerStatHandle FTM_UPDATE_VISUAL_PARAMS("Update Visual Params");
 void LLCharacter::updateVisualParams()
 {
-	for (LLVisualParam *param = getFirstVisualParam(); 
-		param;
-		param = getNextVisualParam())
+	if (mDirtyVisualParams.empty())
 	{
+		return;
+	}
+	LL_RECORD_BLOCK_TIME(FTM_UPDATE_VISUAL_PARAMS);
+
+	// Setting a weight marks the param and, through LLDriverParam::setWeight(),
+	// every param it drives whose weight moved, so the list holds all the
+	// params that a walk over all of them would apply. Apply them in the
+	// same order as that walk.
+	visual_param_list_t dirty;
+	dirty.swap(mDirtyVisualParams);
+	std::sort(dirty.begin(), dirty.end(), visual_param_id_less);
+	sVisualParamsChecked += dirty.size();
+
+	for (visual_param_list_t::iterator iter = dirty.begin(); iter != dirty.end(); ++iter)
+	{
+		LLVisualParam* param = *iter;
+		param->clearDirty();
 		if (param->isAnimating())
 		{
+			// Applied once it stops
+			param->markDirty();
 			continue;
 		}
 		// only apply parameters whose effective weight has changed
@@ -519,8 +563,36 @@ void LLCharacter::updateVisualParams()
 		if (effective_weight != param->getLastWeight())
 		{
 			param->apply( mSex );
+			++sVisualParamsApplied;
+			if (effective_weight != param->getLastWeight())
+			{
+				// Deferred, e.g. a morph still waiting for its masks
+				param->markDirty();
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// setSex()
+//-----------------------------------------------------------------------------
+void LLCharacter::setSex( ESex sex )
+{
+	if (sex == mSex)
+	{
+		return;
+	}
+	// Params for one sex only go back to their default weight
+	for (visual_param_sorted_vec_t::iterator iter = mVisualParamSortedVector.begin();
+		 iter != mVisualParamSortedVector.end(); ++iter)
+	{
+		LLVisualParam* param = iter->second;
+		if (!(param->getSex() & sex) != !(param->getSex() & mSex))
+		{
+			param->markDirty();
 		}
 	}
+	mSex = sex;
 }
  
 LLAnimPauseRequest LLCharacter::requestPause()
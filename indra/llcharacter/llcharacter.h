@@ -116,7 +116,8 @@ public:
 	// gets agent local coordinates from global coordinates
 	virtual LLVector3	getPosAgentFromGlobal(const LLVector3d &position) = 0;
 
-	// updates all visual parameters for this character
+	// applies the visual parameters whose weights changed since the last
+	// update, and the ones they drive
 	virtual void updateVisualParams();
 
 	virtual void addDebugText( const std::string& text ) = 0;
@@ -155,8 +156,17 @@ public:
 	virtual void requestStopMotion( LLMotion* motion );
 	
 	// periodic update function, steps the motion controller
+	// With defer_evaluation, a visible update leaves evaluating the motions
+	// to evaluateMotions().
 	enum e_update_t { NORMAL_UPDATE, HIDDEN_UPDATE, FORCE_UPDATE };
-	void updateMotions(e_update_t update_type);
+	void updateMotions(e_update_t update_type, bool defer_evaluation = false);
+
+	// Evaluates the motions of a deferred update, applies the pose and
+	// updates the world matrices of the skeleton. Only touches the motions
+	// and joints of this character, so several characters can be evaluated
+	// at once on different threads.
+	void evaluateMotions();
+	bool isEvaluationPending() const { return mMotionController.isEvaluationPending(); }
 
 	LLAnimPauseRequest requestPause();
 	void requestPause(std::vector<LLAnimPauseRequest>& avatar_pause_handles);
@@ -195,6 +205,9 @@ public:
 	void addVisualParam(LLVisualParam *param);
 	void addSharedVisualParam(LLVisualParam *param);
 
+	// Queues param for the next updateVisualParams(), see LLVisualParam::markDirty()
+	void addDirtyVisualParam(LLVisualParam *param) { mDirtyVisualParams.push_back(param); }
+
 	virtual BOOL setVisualParamWeight(const LLVisualParam *which_param, F32 weight, bool upload_bake = false );
 	virtual BOOL setVisualParamWeight(const char* param_name, F32 weight, bool upload_bake = false );
 	virtual BOOL setVisualParamWeight(S32 index, F32 weight, bool upload_bake = false );
@@ -258,7 +271,7 @@ public:
 
 
 	ESex getSex() const			{ return mSex; }
-	void setSex( ESex sex )		{ mSex = sex; }
+	void setSex( ESex sex );
 
 	U32				getAppearanceSerialNum() const		{ return mAppearanceSerialNum; }
 	void			setAppearanceSerialNum( U32 num )	{ mAppearanceSerialNum = num; }
@@ -268,6 +281,10 @@ public:
 
 	static std::vector< LLCharacter* > sInstances;
 
+	// updateVisualParams() counts, reset by whoever reads them
+	static U32 sVisualParamsChecked;
+	static U32 sVisualParamsApplied;
+
 	virtual void	setHoverOffset(const LLVector3& hover_offset, bool send_update=true) { mHoverOffset = hover_offset; }
 	const LLVector3& getHoverOffset() const { return mHoverOffset; }
 
@@ -296,6 +313,10 @@ private:
 	visual_param_name_map_t  						mVisualParamNameMap;
 	static LLStringTable sVisualParamNames;	
 
+	// Params whose effective weight may differ from their last applied one
+	typedef std::vector<LLVisualParam*>				visual_param_list_t;
+	visual_param_list_t								mDirtyVisualParams;
+
 	LLVector3 mHoverOffset;
 };
 
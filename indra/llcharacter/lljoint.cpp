@@ -34,8 +34,8 @@
 #include "llmath.h"
 #include <boost/algorithm/string.hpp>
 
-S32 LLJoint::sNumUpdates = 0;
-S32 LLJoint::sNumTouches = 0;
+thread_local S32 LLJoint::sNumUpdates = 0;
+thread_local S32 LLJoint::sNumTouches = 0;
 
 template <class T> 
 bool attachment_map_iter_compare_key(const T& a, const T& b)
@@ -49,10 +49,9 @@ bool LLVector3OverrideMap::findActiveOverride(LLUUID& mesh_id, LLVector3& pos) c
 	mesh_id = LLUUID();
 	bool found = false;
 	
-	map_type::const_iterator it = std::max_element(m_map.begin(),
-												   m_map.end(),
-												   attachment_map_iter_compare_key<map_type::value_type>);
-	if (it != m_map.end())
+	// The map is ordered by mesh id, so the winner is its last entry.
+	map_type::const_reverse_iterator it = m_map.rbegin();
+	if (it != m_map.rend())
 	{
 		found = true;
 		pos = it->second;
@@ -110,6 +109,7 @@ void LLJoint::init()
 	mUpdateXform = TRUE;
 	mSupport = SUPPORT_BASE;
 	mEnd = LLVector3(0.0f, 0.0f, 0.0f);
+	mPendingOverrides = 0;
 }
 
 LLJoint::LLJoint() :
@@ -417,7 +417,7 @@ bool LLJoint::aboveJointScaleThreshold(const LLVector3& scale) const
 //--------------------------------------------------------------------
 // addAttachmentPosOverride()
 //--------------------------------------------------------------------
-void LLJoint::addAttachmentPosOverride( const LLVector3& pos, const LLUUID& mesh_id, const std::string& av_info, bool& active_override_changed )
+void LLJoint::addAttachmentPosOverride( const LLVector3& pos, const LLUUID& mesh_id, const std::string& av_info, bool& active_override_changed, bool defer )
 {
     active_override_changed = false;
 	if (mesh_id.isNull())
@@ -434,7 +434,9 @@ void LLJoint::addAttachmentPosOverride( const LLVector3& pos, const LLUUID& mesh
     LLVector3 before_pos;
     LLUUID before_mesh_id;
     bool has_active_override_before = hasAttachmentPosOverride( before_pos, before_mesh_id );
-	if (!m_attachmentPosOverrides.count())
+	// With a deferred update pending the position is still the last
+	// winner's, m_posBeforeOverrides already holds the value to restore.
+	if (!m_attachmentPosOverrides.count() && !(mPendingOverrides & PENDING_POS_OVERRIDE))
 	{
 		if (do_debug_joint(getName()))
 		{
@@ -453,14 +455,21 @@ void LLJoint::addAttachmentPosOverride( const LLVector3& pos, const LLUUID& mesh
         {
             LL_DEBUGS("Avatar") << "av " << av_info << " joint " << getName() << " addAttachmentPosOverride for mesh " << mesh_id << " pos " << pos << LL_ENDL;
         }
-        updatePos(av_info);
+        if (defer)
+        {
+            mPendingOverrides |= PENDING_POS_OVERRIDE;
+        }
+        else
+        {
+            updatePos(av_info);
+        }
     }
 }
 
 //--------------------------------------------------------------------
 // removeAttachmentPosOverride()
 //--------------------------------------------------------------------
-void LLJoint::removeAttachmentPosOverride( const LLUUID& mesh_id, const std::string& av_info, bool& active_override_changed )
+void LLJoint::removeAttachmentPosOverride( const LLUUID& mesh_id, const std::string& av_info, bool& active_override_changed, bool defer )
 {
     active_override_changed = false;
 	if (mesh_id.isNull())
@@ -484,7 +493,14 @@ void LLJoint::removeAttachmentPosOverride( const LLUUID& mesh_id, const std::str
                                     << " removeAttachmentPosOverride for " << mesh_id << LL_ENDL;
                 showJointPosOverrides(*this, "remove", av_info);
             }
-            updatePos(av_info);
+            if (defer)
+            {
+                mPendingOverrides |= PENDING_POS_OVERRIDE;
+            }
+            else
+            {
+                updatePos(av_info);
+            }
         }
 	}
 }
@@ -502,11 +518,12 @@ bool LLJoint::hasAttachmentPosOverride( LLVector3& pos, LLUUID& mesh_id ) const
 //--------------------------------------------------------------------
 void LLJoint::clearAttachmentPosOverrides()
 {
-	if (m_attachmentPosOverrides.count())
+	if (m_attachmentPosOverrides.count() || (mPendingOverrides & PENDING_POS_OVERRIDE))
 	{
 		m_attachmentPosOverrides.clear();
 		setPosition(m_posBeforeOverrides);
 	}
+	mPendingOverrides &= ~PENDING_POS_OVERRIDE;
 }
 
 //--------------------------------------------------------------------
@@ -604,6 +621,7 @@ void LLJoint::updatePos(const std::string& av_info)
 		pos = m_posBeforeOverrides;
 	}
 	setPosition(pos);
+	mPendingOverrides &= ~PENDING_POS_OVERRIDE;
 }
 
 //--------------------------------------------------------------------
@@ -630,18 +648,39 @@ void LLJoint::updateScale(const std::string& av_info)
 		scale = m_scaleBeforeOverrides;
 	}
 	setScale(scale);
+	mPendingOverrides &= ~PENDING_SCALE_OVERRIDE;
+}
+
+//--------------------------------------------------------------------
+// resolveAttachmentOverrides()
+//--------------------------------------------------------------------
+bool LLJoint::resolveAttachmentOverrides(const std::string& av_info)
+{
+	if (!mPendingOverrides)
+	{
+		return false;
+	}
+	if (mPendingOverrides & PENDING_POS_OVERRIDE)
+	{
+		updatePos(av_info);
+	}
+	if (mPendingOverrides & PENDING_SCALE_OVERRIDE)
+	{
+		updateScale(av_info);
+	}
+	return true;
 }
 
 //--------------------------------------------------------------------
 // addAttachmentScaleOverride()
 //--------------------------------------------------------------------
-void LLJoint::addAttachmentScaleOverride( const LLVector3& scale, const LLUUID& mesh_id, const std::string& av_info )
+void LLJoint::addAttachmentScaleOverride( const LLVector3& scale, const LLUUID& mesh_id, const std::string& av_info, bool defer )
 {
 	if (mesh_id.isNull())
 	{
 		return;
 	}
-	if (!m_attachmentScaleOverrides.count())
+	if (!m_attachmentScaleOverrides.count() && !(mPendingOverrides & PENDING_SCALE_OVERRIDE))
 	{
 		if (do_debug_joint(getName()))
 		{
@@ -654,13 +693,20 @@ void LLJoint::addAttachmentScaleOverride( const LLVector3& scale, const LLUUID&
 	{
 		LL_DEBUGS("Avatar") << "av " << av_info << " joint " << getName() << " addAttachmentScaleOverride for mesh " << mesh_id << " scale " << scale << LL_ENDL;
 	}
-	updateScale(av_info);
+	if (defer)
+	{
+		mPendingOverrides |= PENDING_SCALE_OVERRIDE;
+	}
+	else
+	{
+		updateScale(av_info);
+	}
 }
 
 //--------------------------------------------------------------------
 // removeAttachmentScaleOverride()
 //--------------------------------------------------------------------
-void LLJoint::removeAttachmentScaleOverride( const LLUUID& mesh_id, const std::string& av_info )
+void LLJoint::removeAttachmentScaleOverride( const LLUUID& mesh_id, const std::string& av_info, bool defer )
 {
 	if (mesh_id.isNull())
 	{
@@ -674,7 +720,14 @@ void LLJoint::removeAttachmentScaleOverride( const LLUUID& mesh_id, const std::s
 								<< " removeAttachmentScaleOverride for " << mesh_id << LL_ENDL;
 			showJointScaleOverrides(*this, "remove", av_info);
 		}
-		updateScale(av_info);
+		if (defer)
+		{
+			mPendingOverrides |= PENDING_SCALE_OVERRIDE;
+		}
+		else
+		{
+			updateScale(av_info);
+		}
 	}
 }
 
@@ -691,11 +744,12 @@ bool LLJoint::hasAttachmentScaleOverride( LLVector3& scale, LLUUID& mesh_id ) co
 //--------------------------------------------------------------------
 void LLJoint::clearAttachmentScaleOverrides()
 {
-	if (m_attachmentScaleOverrides.count())
+	if (m_attachmentScaleOverrides.count() || (mPendingOverrides & PENDING_SCALE_OVERRIDE))
 	{
 		m_attachmentScaleOverrides.clear();
 		setScale(m_scaleBeforeOverrides);
 	}
+	mPendingOverrides &= ~PENDING_SCALE_OVERRIDE;
 }
 
 //--------------------------------------------------------------------
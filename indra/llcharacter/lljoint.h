@@ -142,9 +142,10 @@ public:
 	typedef std::list<LLJoint*> child_list_t;
 	child_list_t mChildren;
 
-	// debug statics
-	static S32		sNumTouches;
-	static S32		sNumUpdates;
+	// debug statics, counted per thread as characters may be evaluated
+	// concurrently (see LLAnimationPool)
+	static thread_local S32	sNumTouches;
+	static thread_local S32	sNumUpdates;
     typedef std::set<std::string> debug_joint_name_t;
     static debug_joint_name_t s_debugJointNames;
     static void setDebugJointNames(const debug_joint_name_t& names);
@@ -161,6 +162,15 @@ public:
 	void updatePos(const std::string& av_info);
 	void updateScale(const std::string& av_info);
 
+private:
+	// Overrides changed with defer set, applied by resolveAttachmentOverrides()
+	enum PendingOverrides
+	{
+		PENDING_POS_OVERRIDE = 0x1 << 0,
+		PENDING_SCALE_OVERRIDE = 0x1 << 1
+	};
+	U8 mPendingOverrides;
+
 public:
 	LLJoint();
 	LLJoint(S32 joint_num);
@@ -259,18 +269,25 @@ public:
 
 	virtual BOOL isAnimatable() const { return TRUE; }
 
-	void addAttachmentPosOverride( const LLVector3& pos, const LLUUID& mesh_id, const std::string& av_info, bool& active_override_changed );
-	void removeAttachmentPosOverride( const LLUUID& mesh_id, const std::string& av_info, bool& active_override_changed );
+	// With defer set the joint is only marked, so that an avatar changing
+	// many overrides at once moves each joint a single time when it calls
+	// resolveAttachmentOverrides().
+	void addAttachmentPosOverride( const LLVector3& pos, const LLUUID& mesh_id, const std::string& av_info, bool& active_override_changed, bool defer = false );
+	void removeAttachmentPosOverride( const LLUUID& mesh_id, const std::string& av_info, bool& active_override_changed, bool defer = false );
 	bool hasAttachmentPosOverride( LLVector3& pos, LLUUID& mesh_id ) const;
 	void clearAttachmentPosOverrides();
     void showAttachmentPosOverrides(const std::string& av_info) const;
 
-	void addAttachmentScaleOverride( const LLVector3& scale, const LLUUID& mesh_id, const std::string& av_info );
-	void removeAttachmentScaleOverride( const LLUUID& mesh_id, const std::string& av_info );
+	void addAttachmentScaleOverride( const LLVector3& scale, const LLUUID& mesh_id, const std::string& av_info, bool defer = false );
+	void removeAttachmentScaleOverride( const LLUUID& mesh_id, const std::string& av_info, bool defer = false );
 	bool hasAttachmentScaleOverride( LLVector3& scale, LLUUID& mesh_id ) const;
 	void clearAttachmentScaleOverrides();
     void showAttachmentScaleOverrides(const std::string& av_info) const;
 
+	bool hasPendingOverrides() const { return mPendingOverrides != 0; }
+	// Applies the deferred override changes, returns true if there were any.
+	bool resolveAttachmentOverrides(const std::string& av_info);
+
     void getAllAttachmentPosOverrides(S32& num_pos_overrides,
                                       std::set<LLVector3>& distinct_pos_overrides);
     void getAllAttachmentScaleOverrides(S32& num_scale_overrides,
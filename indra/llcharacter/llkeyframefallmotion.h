@@ -70,6 +70,9 @@ public:
 	virtual F32 getEaseInDuration();
 	virtual BOOL onUpdate(F32 activeTime, U8* joint_mask);
 
+	// onUpdate() adjusts the joint states the base class set.
+	virtual BOOL hasDeferredEvaluation() { return FALSE; }
+
 protected:
 	//-------------------------------------------------------------------------
 	// Member Data
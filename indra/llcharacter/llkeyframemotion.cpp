@@ -49,6 +49,11 @@
 //-----------------------------------------------------------------------------
 LLVFS*				LLKeyframeMotion::sVFS = NULL;
 LLKeyframeDataCache::keyframe_data_map_t	LLKeyframeDataCache::sKeyframeDataMap;
+// Defined after sKeyframeDataMap: destroying it releases entries of the map.
+LLKeyframeDataCache::retained_vec_t		LLKeyframeDataCache::sRetained;
+U32										LLKeyframeDataCache::sRetainedBytes = 0;
+U32										LLKeyframeDataCache::sRetainLimit = 8 * 1024 * 1024;
+U32										LLKeyframeDataCache::sUseCount = 0;
 
 //-----------------------------------------------------------------------------
 // Globals
@@ -63,6 +68,21 @@ static F32 MIN_ACCELERATION_SQUARED = 0.0005f * 0.0005f;
 
 static F32 MAX_CONSTRAINTS = 10;
 
+typedef std::vector<std::pair<F32, LLKeyframeMotion::QuantizedKey> > timed_key_vec_t;
+
+// Stores the keys read from an asset in the curve, in time order.
+template<typename CURVE>
+static void fill_curve(CURVE& curve, timed_key_vec_t& keys)
+{
+	std::stable_sort(keys.begin(), keys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	curve.mTimes.reserve(keys.size());
+	curve.mValues.reserve(keys.size());
+	for (timed_key_vec_t::const_iterator it = keys.begin(); it != keys.end(); ++it)
+	{
+		curve.addKey(it->first, it->second);
+	}
+}
+
 //-----------------------------------------------------------------------------
 // JointMotionList
 //-----------------------------------------------------------------------------
@@ -75,7 +95,11 @@ LLKeyframeMotion::JointMotionList::JointMotionList()
 	  mEaseOutDuration(0.f),
 	  mBasePriority(LLJoint::LOW_PRIORITY),
 	  mHandPose(LLHandMotion::HAND_POSE_SPREAD),
-	  mMaxPriority(LLJoint::LOW_PRIORITY)
+	  mMaxPriority(LLJoint::LOW_PRIORITY),
+	  mDecoded(false),
+	  mRetained(false),
+	  mLastUsed(0),
+	  mMemoryUsage(0)
 {
 }
 
@@ -103,27 +127,27 @@ U32 LLKeyframeMotion::JointMotionList::dumpDiagInfo(bool silent) const
 			if (!silent)
 			{
 				LL_INFOS() << "\t" << joint_motion_p->mScaleCurve.mNumKeys << " scale keys at "
-				<< joint_motion_p->mScaleCurve.mNumKeys * sizeof(ScaleKey) << " bytes" << LL_ENDL;
+				<< joint_motion_p->mScaleCurve.getMemoryUsage() << " bytes" << LL_ENDL;
 			}
-			total_size += joint_motion_p->mScaleCurve.mNumKeys * sizeof(ScaleKey);
+			total_size += joint_motion_p->mScaleCurve.getMemoryUsage();
 		}
 		if (joint_motion_p->mUsage & LLJointState::ROT)
 		{
 			if (!silent)
 			{
 				LL_INFOS() << "\t" << joint_motion_p->mRotationCurve.mNumKeys << " rotation keys at "
-				<< joint_motion_p->mRotationCurve.mNumKeys * sizeof(RotationKey) << " bytes" << LL_ENDL;
+				<< joint_motion_p->mRotationCurve.getMemoryUsage() << " bytes" << LL_ENDL;
 			}
-			total_size += joint_motion_p->mRotationCurve.mNumKeys * sizeof(RotationKey);
+			total_size += joint_motion_p->mRotationCurve.getMemoryUsage();
 		}
 		if (joint_motion_p->mUsage & LLJointState::POS)
 		{
 			if (!silent)
 			{
 				LL_INFOS() << "\t" << joint_motion_p->mPositionCurve.mNumKeys << " position keys at "
-				<< joint_motion_p->mPositionCurve.mNumKeys * sizeof(PositionKey) << " bytes" << LL_ENDL;
+				<< joint_motion_p->mPositionCurve.getMemoryUsage() << " bytes" << LL_ENDL;
 			}
-			total_size += joint_motion_p->mPositionCurve.mNumKeys * sizeof(PositionKey);
+			total_size += joint_motion_p->mPositionCurve.getMemoryUsage();
 		}
 	}
 	//Singu: Also add memory used by the constraints.
@@ -301,34 +325,10 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 
 	LLKeyframeMotion::JointMotionListPtr joint_motion_list = LLKeyframeDataCache::getKeyframeData(getID());
 
-	if(joint_motion_list)
+	if(joint_motion_list && joint_motion_list->mDecoded)
 	{
 		// motion already existed in cache, so grab it
-		mJointMotionList = joint_motion_list;
-
-		mJointStates.reserve(mJointMotionList->getNumJointMotions());
-		
-		// don't forget to allocate joint states
-		// set up joint states to point to character joints
-		for(U32 i = 0; i < mJointMotionList->getNumJointMotions(); i++)
-		{
-			JointMotion* joint_motion = mJointMotionList->getJointMotion(i);
-			if (LLJoint *joint = mCharacter->getJoint(joint_motion->mJointName))
-			{
-				LLPointer<LLJointState> joint_state = new LLJointState;
-				mJointStates.push_back(joint_state);
-				joint_state->setJoint(joint);
-				joint_state->setUsage(joint_motion->mUsage);
-				joint_state->setPriority(joint_motion->mPriority);
-			}
-			else
-			{
-				// add dummy joint state with no associated joint
-				mJointStates.push_back(new LLJointState);
-			}
-		}
-		mAssetStatus = ASSET_LOADED;
-		setupPose();
+		initializeFromCache(joint_motion_list);
 		return STATUS_SUCCESS;
 	}
 
@@ -389,6 +389,40 @@ LLMotion::LLMotionInitStatus LLKeyframeMotion::onInitialize(LLCharacter *charact
 	return STATUS_SUCCESS;
 }
 
+//-----------------------------------------------------------------------------
+// initializeFromCache()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::initializeFromCache(const JointMotionListPtr& joint_motion_list)
+{
+	mJointMotionList = joint_motion_list;
+	LLKeyframeDataCache::retain(mJointMotionList);
+
+	mJointStates.clear();
+	mJointStates.reserve(mJointMotionList->getNumJointMotions());
+	
+	// don't forget to allocate joint states
+	// set up joint states to point to character joints
+	for(U32 i = 0; i < mJointMotionList->getNumJointMotions(); i++)
+	{
+		JointMotion* joint_motion = mJointMotionList->getJointMotion(i);
+		if (LLJoint *joint = mCharacter->getJoint(joint_motion->mJointName))
+		{
+			LLPointer<LLJointState> joint_state = new LLJointState;
+			mJointStates.push_back(joint_state);
+			joint_state->setJoint(joint);
+			joint_state->setUsage(joint_motion->mUsage);
+			joint_state->setPriority(joint_motion->mPriority);
+		}
+		else
+		{
+			// add dummy joint state with no associated joint
+			mJointStates.push_back(new LLJointState);
+		}
+	}
+	mAssetStatus = ASSET_LOADED;
+	setupPose();
+}
+
 //-----------------------------------------------------------------------------
 // setupPose()
 //-----------------------------------------------------------------------------
@@ -493,7 +527,15 @@ BOOL LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 		mLastLoopedTime = time;
 	}
 
-	applyKeyframes(mLastLoopedTime);
+	if (hasDeferredEvaluation())
+	{
+		// evaluate() applies the curves at mLastLoopedTime.
+		applyHandPose();
+	}
+	else
+	{
+		applyKeyframes(mLastLoopedTime);
+	}
 
 	applyConstraints(mLastLoopedTime, joint_mask);
 
@@ -502,10 +544,37 @@ BOOL LLKeyframeMotion::onUpdate(F32 time, U8* joint_mask)
 	return mLastLoopedTime <= mJointMotionList->mDuration;
 }
 
+//-----------------------------------------------------------------------------
+// hasDeferredEvaluation()
+//-----------------------------------------------------------------------------
+BOOL LLKeyframeMotion::hasDeferredEvaluation()
+{
+	// Constraints look at the joints of the character, which are only
+	// meaningful right after the curves were applied.
+	return mJointMotionList && mJointMotionList->mConstraints.empty();
+}
+
+//-----------------------------------------------------------------------------
+// evaluate()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::evaluate()
+{
+	applyCurves(mLastLoopedTime);
+}
+
 //-----------------------------------------------------------------------------
 // applyKeyframes()
 //-----------------------------------------------------------------------------
 void LLKeyframeMotion::applyKeyframes(F32 time)
+{
+	applyCurves(time);
+	applyHandPose();
+}
+
+//-----------------------------------------------------------------------------
+// applyCurves()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::applyCurves(F32 time)
 {
 	llassert_always (mJointMotionList->getNumJointMotions() <= mJointStates.size());
 	for (U32 i=0; i<mJointMotionList->getNumJointMotions(); i++)
@@ -514,7 +583,13 @@ void LLKeyframeMotion::applyKeyframes(F32 time)
 													  time, 
 													  mJointMotionList->mDuration );
 	}
+}
 
+//-----------------------------------------------------------------------------
+// applyHandPose()
+//-----------------------------------------------------------------------------
+void LLKeyframeMotion::applyHandPose()
+{
 	LLJoint::JointPriority* pose_priority = (LLJoint::JointPriority* )mCharacter->getAnimationData("Hand Pose Priority");
 	if (pose_priority)
 	{
@@ -1373,6 +1448,8 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 		// scan rotation curve keys
 		//---------------------------------------------------------------------
 		RotationCurve *rCurve = &joint_motion->mRotationCurve;
+		timed_key_vec_t keys;
+		keys.reserve(joint_motion->mRotationCurve.mNumKeys);
 
 		for (S32 k = 0; k < joint_motion->mRotationCurve.mNumKeys; k++)
 		{
@@ -1413,6 +1490,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 			rot_key.mTime = time;
 			LLVector3 rot_angles;
 			U16 x, y, z;
+			QuantizedKey quantized;
 
 			BOOL success = TRUE;
 
@@ -1422,6 +1500,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 
 				LLQuaternion::Order ro = StringToOrder("ZYX");
 				rot_key.mValue = mayaQ(rot_angles.mV[VX], rot_angles.mV[VY], rot_angles.mV[VZ], ro);
+				quantized = encodeKey(rot_key.mValue, 1.f);
 			}
 			else
 			{
@@ -1429,11 +1508,10 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 				success &= dp.unpackU16(y, "rot_angle_y");
 				success &= dp.unpackU16(z, "rot_angle_z");
 
-				LLVector3 rot_vec;
-				rot_vec.mV[VX] = U16_to_F32(x, -1.f, 1.f);
-				rot_vec.mV[VY] = U16_to_F32(y, -1.f, 1.f);
-				rot_vec.mV[VZ] = U16_to_F32(z, -1.f, 1.f);
-				rot_key.mValue.unpackFromVector3(rot_vec);
+				quantized.mV[VX] = x;
+				quantized.mV[VY] = y;
+				quantized.mV[VZ] = z;
+				decodeKey(quantized, 1.f, rot_key.mValue);
 			}
 
 			if( !(rot_key.mValue.isFinite()) )
@@ -1450,10 +1528,10 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 				return FALSE;
 			}
 
-			rCurve->mKeys.emplace_back(time, rot_key);
+			keys.emplace_back(time, quantized);
 		}
 
-		std::sort(rCurve->mKeys.begin(), rCurve->mKeys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		fill_curve(*rCurve, keys);
 
 		//---------------------------------------------------------------------
 		// scan position curve header
@@ -1475,11 +1553,15 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 		// scan position curve keys
 		//---------------------------------------------------------------------
 		PositionCurve *pCurve = &joint_motion->mPositionCurve;
+		pCurve->mRange = LL_MAX_PELVIS_OFFSET;
+		keys.clear();
+		keys.reserve(joint_motion->mPositionCurve.mNumKeys);
 		BOOL is_pelvis = joint_motion->mJointName == "mPelvis";
 		for (S32 k = 0; k < joint_motion->mPositionCurve.mNumKeys; k++)
 		{
 			U16 time_short;
 			PositionKey pos_key;
+			QuantizedKey quantized;
 
 			if (old_version)
 			{
@@ -1514,6 +1596,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
                 pos_key.mValue.mV[VY] = llclamp( pos_key.mValue.mV[VY], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
                 pos_key.mValue.mV[VZ] = llclamp( pos_key.mValue.mV[VZ], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
                 
+				quantized = encodeKey(pos_key.mValue, LL_MAX_PELVIS_OFFSET);
 			}
 			else
 			{
@@ -1523,9 +1606,10 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 				success &= dp.unpackU16(y, "pos_y");
 				success &= dp.unpackU16(z, "pos_z");
 
-				pos_key.mValue.mV[VX] = U16_to_F32(x, -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-				pos_key.mValue.mV[VY] = U16_to_F32(y, -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-				pos_key.mValue.mV[VZ] = U16_to_F32(z, -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
+				quantized.mV[VX] = x;
+				quantized.mV[VY] = y;
+				quantized.mV[VZ] = z;
+				decodeKey(quantized, LL_MAX_PELVIS_OFFSET, pos_key.mValue);
 			}
 			
 			if( !(pos_key.mValue.isFinite()) )
@@ -1542,7 +1626,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 				return FALSE;
 			}
 			
-			pCurve->mKeys.emplace_back(pos_key.mTime, pos_key);
+			keys.emplace_back(pos_key.mTime, quantized);
 
 			if (is_pelvis)
 			{
@@ -1551,7 +1635,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 
 		}
 
-		std::sort(pCurve->mKeys.begin(), pCurve->mKeys.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+		fill_curve(*pCurve, keys);
 
 		joint_motion->mUsage = joint_state->getUsage();
 	}
@@ -1740,7 +1824,7 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 			
 			if (singu_new_joint_motion_list)
 			{
-				mJointMotionList->mConstraints.push_front(watcher.release());
+				mJointMotionList->mConstraints.insert(mJointMotionList->mConstraints.begin(), watcher.release());
 			}
 			
 			LLJoint* joint = mCharacter->findCollisionVolume(constraintp->mSourceConstraintVolume);
@@ -1790,6 +1874,13 @@ BOOL LLKeyframeMotion::deserialize(LLDataPacker& dp, const LLUUID& asset_id)
 
 	mAssetStatus = ASSET_LOADED;
 
+	if (singu_new_joint_motion_list)
+	{
+		mJointMotionList->mMemoryUsage = mJointMotionList->dumpDiagInfo(true);
+		mJointMotionList->mDecoded = true;
+	}
+	LLKeyframeDataCache::retain(mJointMotionList);
+
 	setupPose();
 
 	return TRUE;
@@ -1838,45 +1929,34 @@ BOOL LLKeyframeMotion::serialize(LLDataPacker& dp) const
 		success &= dp.packS32(joint_motionp->mRotationCurve.mNumKeys, "num_rot_keys");
 
 		LL_DEBUGS("BVH") << "Joint " << joint_motionp->mJointName << LL_ENDL;
-		for (RotationCurve::key_map_t::iterator iter = joint_motionp->mRotationCurve.mKeys.begin();
-			 iter != joint_motionp->mRotationCurve.mKeys.end(); ++iter)
+		const RotationCurve& rot_curve = joint_motionp->mRotationCurve;
+		for (U32 k = 0; k < rot_curve.mTimes.size(); ++k)
 		{
-			RotationKey& rot_key = iter->second;
-			U16 time_short = F32_to_U16(rot_key.mTime, 0.f, mJointMotionList->mDuration);
+			U16 time_short = F32_to_U16(rot_curve.mTimes[k], 0.f, mJointMotionList->mDuration);
 			success &= dp.packU16(time_short, "time");
 
-			LLVector3 rot_angles = rot_key.mValue.packToVector3();
-			
-			U16 x, y, z;
-			rot_angles.quantize16(-1.f, 1.f, -1.f, 1.f);
-			x = F32_to_U16(rot_angles.mV[VX], -1.f, 1.f);
-			y = F32_to_U16(rot_angles.mV[VY], -1.f, 1.f);
-			z = F32_to_U16(rot_angles.mV[VZ], -1.f, 1.f);
-			success &= dp.packU16(x, "rot_angle_x");
-			success &= dp.packU16(y, "rot_angle_y");
-			success &= dp.packU16(z, "rot_angle_z");
-
-			LL_DEBUGS("BVH") << "  rot: t " << rot_key.mTime << " angles " << rot_angles.mV[VX] <<","<< rot_angles.mV[VY] <<","<< rot_angles.mV[VZ] << LL_ENDL;
+			// The keys are kept as quantized in the asset.
+			const QuantizedKey& key = rot_curve.mValues[k];
+			success &= dp.packU16(key.mV[VX], "rot_angle_x");
+			success &= dp.packU16(key.mV[VY], "rot_angle_y");
+			success &= dp.packU16(key.mV[VZ], "rot_angle_z");
+
+			LL_DEBUGS("BVH") << "  rot: t " << rot_curve.mTimes[k] << " angles " << key.mV[VX] <<","<< key.mV[VY] <<","<< key.mV[VZ] << LL_ENDL;
 		}
 
 		success &= dp.packS32(joint_motionp->mPositionCurve.mNumKeys, "num_pos_keys");
-		for (PositionCurve::key_map_t::iterator iter = joint_motionp->mPositionCurve.mKeys.begin();
-			 iter != joint_motionp->mPositionCurve.mKeys.end(); ++iter)
+		const PositionCurve& pos_curve = joint_motionp->mPositionCurve;
+		for (U32 k = 0; k < pos_curve.mTimes.size(); ++k)
 		{
-			PositionKey& pos_key = iter->second;
-			U16 time_short = F32_to_U16(pos_key.mTime, 0.f, mJointMotionList->mDuration);
+			U16 time_short = F32_to_U16(pos_curve.mTimes[k], 0.f, mJointMotionList->mDuration);
 			success &= dp.packU16(time_short, "time");
 
-			U16 x, y, z;
-			pos_key.mValue.quantize16(-LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET, -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-			x = F32_to_U16(pos_key.mValue.mV[VX], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-			y = F32_to_U16(pos_key.mValue.mV[VY], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-			z = F32_to_U16(pos_key.mValue.mV[VZ], -LL_MAX_PELVIS_OFFSET, LL_MAX_PELVIS_OFFSET);
-			success &= dp.packU16(x, "pos_x");
-			success &= dp.packU16(y, "pos_y");
-			success &= dp.packU16(z, "pos_z");
-
-			LL_DEBUGS("BVH") << "  pos: t " << pos_key.mTime << " pos " << pos_key.mValue.mV[VX] <<","<< pos_key.mValue.mV[VY] <<","<< pos_key.mValue.mV[VZ] << LL_ENDL;
+			const QuantizedKey& key = pos_curve.mValues[k];
+			success &= dp.packU16(key.mV[VX], "pos_x");
+			success &= dp.packU16(key.mV[VY], "pos_y");
+			success &= dp.packU16(key.mV[VZ], "pos_z");
+
+			LL_DEBUGS("BVH") << "  pos: t " << pos_curve.mTimes[k] << " pos " << pos_curve.getKeyValue(k) << LL_ENDL;
 		}
 	}	
 
@@ -2128,6 +2208,14 @@ void LLKeyframeMotion::onLoadComplete(LLVFS *vfs,
 				// asset already loaded
 				return;
 			}
+			// Each avatar that wanted the animation while it was downloading
+			// gets here; only the first one needs to decode it.
+			JointMotionListPtr joint_motion_list = LLKeyframeDataCache::getKeyframeData(asset_uuid);
+			if (joint_motion_list && joint_motion_list->mDecoded)
+			{
+				motionp->initializeFromCache(joint_motion_list);
+				return;
+			}
 			LLVFile file(vfs, asset_uuid, type, LLVFile::READ);
 			S32 size = file.getSize();
 			
@@ -2236,6 +2324,26 @@ LLKeyframeMotion::JointMotionListPtr LLKeyframeDataCache::createKeyframeData(LLU
 void LLKeyframeDataCache::removeKeyframeData(const LLUUID& id)
 {
 	keyframe_data_map_t::iterator found_data = sKeyframeDataMap.find(id);
+	if (found_data == sKeyframeDataMap.end())
+	{
+		return;
+	}
+
+	// Let go of the retained reference first, which may remove it already.
+	const LLKeyframeMotion::JointMotionList* data = found_data->get();
+	for (retained_vec_t::iterator it = sRetained.begin(); it != sRetained.end(); ++it)
+	{
+		if (&**it == data)
+		{
+			(*it)->mRetained = false;
+			sRetainedBytes -= (*it)->mMemoryUsage;
+			*it = sRetained.back();
+			sRetained.pop_back();
+			break;
+		}
+	}
+
+	found_data = sKeyframeDataMap.find(id);
 	if (found_data != sKeyframeDataMap.end())
 	{
 		sKeyframeDataMap.erase(found_data);
@@ -2268,9 +2376,59 @@ LLKeyframeDataCache::~LLKeyframeDataCache()
 //-----------------------------------------------------------------------------
 void LLKeyframeDataCache::clear()
 {
+	sRetained.clear();
+	sRetainedBytes = 0;
 	sKeyframeDataMap.clear();
 }
 
+//--------------------------------------------------------------------
+// LLKeyframeDataCache::setRetainLimit()
+//--------------------------------------------------------------------
+void LLKeyframeDataCache::setRetainLimit(U32 bytes)
+{
+	sRetainLimit = bytes;
+	trimRetained();
+}
+
+//--------------------------------------------------------------------
+// LLKeyframeDataCache::retain()
+//--------------------------------------------------------------------
+void LLKeyframeDataCache::retain(LLKeyframeMotion::JointMotionListPtr data)
+{
+	data->mLastUsed = ++sUseCount;
+	if (!data->mRetained)
+	{
+		data->mRetained = true;
+		sRetained.push_back(data);
+		sRetainedBytes += data->mMemoryUsage;
+		trimRetained();
+	}
+}
+
+//--------------------------------------------------------------------
+// LLKeyframeDataCache::trimRetained()
+//--------------------------------------------------------------------
+void LLKeyframeDataCache::trimRetained()
+{
+	// Drop the least recently used ones. Those still playing stay in the
+	// cache as long as a motion uses them.
+	while (sRetainedBytes > sRetainLimit && !sRetained.empty())
+	{
+		retained_vec_t::iterator oldest = sRetained.begin();
+		for (retained_vec_t::iterator it = sRetained.begin(); it != sRetained.end(); ++it)
+		{
+			if ((*it)->mLastUsed < (*oldest)->mLastUsed)
+			{
+				oldest = it;
+			}
+		}
+		(*oldest)->mRetained = false;
+		sRetainedBytes -= (*oldest)->mMemoryUsage;
+		*oldest = sRetained.back();
+		sRetained.pop_back();
+	}
+}
+
 //-----------------------------------------------------------------------------
 // JointConstraint()
 //-----------------------------------------------------------------------------
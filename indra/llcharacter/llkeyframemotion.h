@@ -38,13 +38,16 @@
 // Header files
 //-----------------------------------------------------------------------------
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include "llassetstorage.h"
 #include "llbboxlocal.h"
 #include "llhandmotion.h"
 #include "lljointstate.h"
 #include "llmotion.h"
+#include "llquantize.h"
 #include "llquaternion.h"
 #include "v3dmath.h"
 #include "v3math.h"
@@ -267,6 +270,11 @@ public:
 	// must return FALSE when the motion is completed.
 	virtual BOOL onUpdate(F32 time, U8* joint_mask);
 
+	// The curves of motions without constraints are evaluated in evaluate().
+	// Subclasses that read their joint states in onUpdate() must return FALSE.
+	virtual BOOL hasDeferredEvaluation();
+	virtual void evaluate();
+
 	// called when a motion is deactivated
 	virtual void onDeactivate();
 
@@ -386,6 +394,10 @@ protected:
 
 	void applyKeyframes(F32 time);
 
+	void applyCurves(F32 time);
+
+	void applyHandPose();
+
 	void applyConstraints(F32 time, U8* joint_mask);
 
 	void activateConstraint(JointConstraint* constraintp);
@@ -403,6 +415,41 @@ public:
 
 	enum InterpolationType { IT_STEP, IT_LINEAR, IT_SPLINE };
 
+	// A key value as stored in the asset: x, y and z quantized to U16
+	// over [-range, range]. Rotations keep x, y and z of a unit quaternion.
+	struct QuantizedKey
+	{
+		U16			mV[3];
+	};
+
+	static void decodeKey(const QuantizedKey& key, F32 range, LLVector3& value)
+	{
+		value.mV[VX] = U16_to_F32(key.mV[VX], -range, range);
+		value.mV[VY] = U16_to_F32(key.mV[VY], -range, range);
+		value.mV[VZ] = U16_to_F32(key.mV[VZ], -range, range);
+	}
+
+	static void decodeKey(const QuantizedKey& key, F32 range, LLQuaternion& value)
+	{
+		LLVector3 vec;
+		decodeKey(key, range, vec);
+		value.unpackFromVector3(vec);
+	}
+
+	static QuantizedKey encodeKey(const LLVector3& value, F32 range)
+	{
+		QuantizedKey key;
+		key.mV[VX] = F32_to_U16(value.mV[VX], -range, range);
+		key.mV[VY] = F32_to_U16(value.mV[VY], -range, range);
+		key.mV[VZ] = F32_to_U16(value.mV[VZ], -range, range);
+		return key;
+	}
+
+	static QuantizedKey encodeKey(const LLQuaternion& value, F32 range)
+	{
+		return encodeKey(value.packToVector3(), range);
+	}
+
 	template<typename T>
 	struct Curve
 	{
@@ -414,63 +461,70 @@ public:
 			T			mValue;
 		};
 
-		T interp(F32 u, Key& before, Key& after)
+		T interp(F32 u, const T& before, const T& after) const
 		{
 			switch (mInterpolationType)
 			{
 			case IT_STEP:
-				return before.mValue;
+				return before;
 			default:
 			case IT_LINEAR:
 			case IT_SPLINE:
-				return LLKeyframeMotionLerp::lerp(u, before.mValue, after.mValue);
+				return LLKeyframeMotionLerp::lerp(u, before, after);
 			}
 		}
 
-		T getValue(F32 time, F32 duration)
+		T getKeyValue(U32 index) const
 		{
-			if (mKeys.empty())
+			T value;
+			decodeKey(mValues[index], mRange, value);
+			return value;
+		}
+
+		T getValue(F32 time, F32 duration) const
+		{
+			if (mTimes.empty())
 			{
 				return T();
 			}
 
-			T value;
-			typename key_map_t::iterator right = std::lower_bound(mKeys.begin(), mKeys.end(), time, [](const auto& a, const auto& b) { return a.first < b; });
-			if (right == mKeys.end())
+			U32 right = std::lower_bound(mTimes.begin(), mTimes.end(), time) - mTimes.begin();
+			if (right == mTimes.size())
 			{
 				// Past last key
-				--right;
-				value = right->second.mValue;
+				return getKeyValue(right - 1);
 			}
-			else if (right == mKeys.begin() || right->first == time)
+			if (right == 0 || mTimes[right] == time)
 			{
 				// Before first key or exactly on a key
-				value = right->second.mValue;
-			}
-			else
-			{
-				// Between two keys
-				typename key_map_t::iterator left = right; --left;
-				F32 index_before = left->first;
-				F32 index_after = right->first;
-				Key& pos_before = left->second;
-				Key& pos_after = right->second;
-				if (right == mKeys.end())
-				{
-					pos_after = mLoopInKey;
-					index_after = duration;
-				}
-
-				F32 u = (time - index_before) / (index_after - index_before);
-				value = interp(u, pos_before, pos_after);
+				return getKeyValue(right);
 			}
-			return value;
+
+			// Between two keys
+			F32 index_before = mTimes[right - 1];
+			F32 index_after = mTimes[right];
+			F32 u = (time - index_before) / (index_after - index_before);
+			return interp(u, getKeyValue(right - 1), getKeyValue(right));
+		}
+
+		// Keys must be added in time order.
+		void addKey(F32 time, const QuantizedKey& value)
+		{
+			mTimes.push_back(time);
+			mValues.push_back(value);
+		}
+
+		U32 getMemoryUsage() const
+		{
+			return mTimes.capacity() * sizeof(F32) + mValues.capacity() * sizeof(QuantizedKey);
 		}
 
 		InterpolationType	mInterpolationType = LLKeyframeMotion::IT_LINEAR;
 		S32					mNumKeys = 0;
-		typedef std::vector< std::pair<F32, Key> > key_map_t;
-		key_map_t 			mKeys;
+		F32					mRange = 1.f;
+		// The key times, sorted, and the key values in the same order.
+		std::vector<F32>	mTimes;
+		std::vector<QuantizedKey> mValues;
 		Key					mLoopInKey;
 		Key					mLoopOutKey;
 	};
@@ -514,13 +568,19 @@ public:
 		LLJoint::JointPriority	mBasePriority;
 		LLHandMotion::eHandPose mHandPose;
 		LLJoint::JointPriority  mMaxPriority;
-		typedef std::list<JointConstraintSharedData*> constraint_list_t;
+		typedef std::vector<JointConstraintSharedData*> constraint_list_t;
 		constraint_list_t		mConstraints;
 		LLBBoxLocal				mPelvisBBox;
 		// mEmoteName is a facial motion, but it's necessary to appear here so that it's cached.
 		// TODO: LLKeyframeDataCache::getKeyframeData should probably return a class containing 
 		// JointMotionList and mEmoteName, see LLKeyframeMotion::onInitialize.
 		std::string				mEmoteName; 
+		// Set once deserialize() filled it in; other instances share it from then on.
+		bool					mDecoded;
+		// Bookkeeping of LLKeyframeDataCache::retain().
+		bool					mRetained;
+		U32						mLastUsed;
+		U32						mMemoryUsage;
 	public:
 		JointMotionList();
 		~JointMotionList();
@@ -534,6 +594,9 @@ public:
 	typedef AICachedPointerPtr<LLUUID, JointMotionList> JointMotionListPtr;
 
 protected:
+	// Sets up the joint states for data another instance decoded.
+	void	initializeFromCache(const JointMotionListPtr& joint_motion_list);
+
 	static LLVFS*				sVFS;
 
 	//-------------------------------------------------------------------------
@@ -569,9 +632,25 @@ public:
 
 	static void removeKeyframeData(const LLUUID& id);
 
+	// Keeps the most recently used animations decoded after their last
+	// motion is gone, up to a total size of curves, so that avatars coming
+	// back into view or a dance HUD cycling through its set decode nothing.
+	static void setRetainLimit(U32 bytes);
+	static void retain(LLKeyframeMotion::JointMotionListPtr data);
+	static U32 getRetainedBytes()	{ return sRetainedBytes; }
+
 	//print out diagnostic info
 	static void dumpDiagInfo(int quiet = 0);	// singu: added param 'quiet'.
 	static void clear();
+
+private:
+	static void trimRetained();
+
+	typedef std::vector<LLKeyframeMotion::JointMotionListPtr> retained_vec_t;
+	static retained_vec_t sRetained;
+	static U32 sRetainedBytes;
+	static U32 sRetainLimit;
+	static U32 sUseCount;
 };
 
 #endif // LL_LLKEYFRAMEMOTION_H
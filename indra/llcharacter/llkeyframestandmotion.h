@@ -81,6 +81,9 @@ public:
 	void	onDeactivate();
 	virtual BOOL onUpdate(F32 time, U8* joint_mask);
 
+	// onUpdate() adjusts the joint states the base class set.
+	virtual BOOL hasDeferredEvaluation() { return FALSE; }
+
 public:
 	//-------------------------------------------------------------------------
 	// Member Data
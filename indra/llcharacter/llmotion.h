@@ -235,6 +235,13 @@ public:
 	// must return FALSE when the motion is completed.
 	virtual BOOL onUpdate(F32 activeTime, U8* joint_mask) = 0;
 
+	// Motions returning TRUE leave setting their joint states to evaluate(),
+	// which the controller calls once the onUpdate() of every motion is done,
+	// possibly on another thread (see LLAnimationPool). evaluate() may only
+	// write the motion's own joint states.
+	virtual BOOL hasDeferredEvaluation() { return FALSE; }
+	virtual void evaluate() {}
+
 	// called when a motion is deactivated
 	virtual void onDeactivate() = 0;
 
@@ -141,6 +141,8 @@ LLMotionController::LLMotionController()
 	  mTimeStep(0.f),
 	  mTimeStepCount(0),
 	  mLastInterp(0.f),
+	  mEvaluationPending(false),
+	  mCacheBlend(false),
 	  mIsSelf(FALSE)
 {
 }
@@ -169,6 +171,13 @@ void LLMotionController::incMotionCounts(S32& num_motions, S32& num_loading_moti
 //-----------------------------------------------------------------------------
 void LLMotionController::deleteAllMotions()
 {
+	// Drop a pending evaluation: the joints may be gone already.
+	mDeferredMotions.clear();
+	if (mEvaluationPending)
+	{
+		mEvaluationPending = false;
+		mPoseBlender.clearBlenders();
+	}
 	mLoadingMotions.clear();
 	mLoadedMotions.clear();
 	mActiveMotions.clear();
@@ -333,6 +342,11 @@ void LLMotionController::removeMotionInstance(LLMotion* motionp)
 	if (motionp)
 	{
 		llassert(findMotion(motionp->getID()) != motionp);
+		std::vector<LLMotion*>::iterator deferred_it = std::find(mDeferredMotions.begin(), mDeferredMotions.end(), motionp);
+		if (deferred_it != mDeferredMotions.end())
+		{
+			mDeferredMotions.erase(deferred_it);
+		}
 		mLoadingMotions.erase(motionp);
 		mLoadedMotions.erase(motionp);
 		mActiveMotions.remove(motionp);
@@ -781,6 +795,11 @@ void LLMotionController::updateMotionsByType(LLMotion::LLMotionBlendType anim_ty
 
 		}
 
+		if (motionp->hasDeferredEvaluation())
+		{
+			mDeferredMotions.push_back(motionp);
+		}
+
 		// even if onupdate returns FALSE, add this motion in to the blend one last time
 		mPoseBlender.addMotion(motionp);
 	}
@@ -851,8 +870,11 @@ void LLMotionController::updateLoadingMotions()
 //-----------------------------------------------------------------------------
 // updateMotion()
 //-----------------------------------------------------------------------------
-void LLMotionController::updateMotions(bool force_update)
+void LLMotionController::updateMotions(bool force_update, bool defer_evaluation)
 {
+	// Finish the previous update if nobody did.
+	evaluate();
+
 	BOOL use_quantum = (mTimeStep != 0.f);
 
 	// Always update mPrevTimerElapsed
@@ -928,18 +950,45 @@ void LLMotionController::updateMotions(bool force_update)
 		// update all regular motions
 		updateRegularMotions();
 
-		if (use_quantum)
-		{
-			mPoseBlender.blendAndCache(TRUE);
-		}
-		else
-		{
-			mPoseBlender.blendAndApply();
-		}
+		mEvaluationPending = true;
+		mCacheBlend = use_quantum;
 	}
 
 	mHasRunOnce = TRUE;
 //	LL_INFOS() << "Motion controller time " << motionTimer.getElapsedTimeF32() << LL_ENDL;
+
+	if (!defer_evaluation)
+	{
+		evaluate();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// evaluate()
+//-----------------------------------------------------------------------------
+void LLMotionController::evaluate()
+{
+	if (!mEvaluationPending)
+	{
+		return;
+	}
+	mEvaluationPending = false;
+
+	for (std::vector<LLMotion*>::iterator iter = mDeferredMotions.begin();
+		 iter != mDeferredMotions.end(); ++iter)
+	{
+		(*iter)->evaluate();
+	}
+	mDeferredMotions.clear();
+
+	if (mCacheBlend)
+	{
+		mPoseBlender.blendAndCache(TRUE);
+	}
+	else
+	{
+		mPoseBlender.blendAndApply();
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -948,6 +997,8 @@ void LLMotionController::updateMotions(bool force_update)
 //-----------------------------------------------------------------------------
 void LLMotionController::updateMotionsMinimal()
 {
+	evaluate();
+
 	// Always update mPrevTimerElapsed
 	mPrevTimerElapsed = mTimer.getElapsedTimeF32();
 
@@ -39,6 +39,7 @@
 #include <string>
 #include <map>
 #include <deque>
+#include <vector>
 
 #include "llmotion.h"
 #include "llpose.h"
@@ -138,7 +139,14 @@ public:
 	// invokes the update handlers for each active motion
 	// activates sequenced motions
 	// deactivates terminated motions`
-	void updateMotions(bool force_update = false);
+	// With defer_evaluation, the deferred motions and the pose blend are
+	// left to a call to evaluate().
+	void updateMotions(bool force_update = false, bool defer_evaluation = false);
+
+	// Evaluates the deferred motions and blends and applies the pose.
+	// Only touches the motions and joints of this controller's character.
+	void evaluate();
+	bool isEvaluationPending() const { return mEvaluationPending; }
 
 	// minimal update (e.g. while hidden)
 	void updateMotionsMinimal();
@@ -259,6 +267,11 @@ protected:
 
 	U8					mJointSignature[2][LL_CHARACTER_MAX_ANIMATED_JOINTS];
 
+	// Motions updated since the last evaluate() that have a deferred evaluation.
+	std::vector<LLMotion*>	mDeferredMotions;
+	bool				mEvaluationPending;
+	bool				mCacheBlend;			// blend into the joint cache (mTimeStep != 0)
+
 	//<singu>
 public:
 	// Internal administration for AISync.
@@ -47,19 +47,32 @@ LLPose::~LLPose()
 }
 
 //-----------------------------------------------------------------------------
-// getFirstJointState()
+// findIndex()
 //-----------------------------------------------------------------------------
-LLJointState* LLPose::getFirstJointState()
+S32 LLPose::findIndex(const LLJoint* joint) const
 {
-	mListIter = mJointMap.begin();
-	if (mListIter == mJointMap.end())
+	S32 joint_num = joint->getJointNum();
+	if (joint_num >= 0)
 	{
-		return NULL;
+		return joint_num < (S32)mJointIndex.size() ? mJointIndex[joint_num] : -1;
 	}
-	else
+	for (U32 i = 0; i < mJointStates.size(); ++i)
 	{
-		return mListIter->second;
+		if (mJointStates[i]->getJoint() == joint)
+		{
+			return i;
+		}
 	}
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+// getFirstJointState()
+//-----------------------------------------------------------------------------
+LLJointState* LLPose::getFirstJointState()
+{
+	mListIter = 0;
+	return mJointStates.empty() ? NULL : mJointStates[0].get();
 }
 
 //-----------------------------------------------------------------------------
@@ -67,15 +80,11 @@ LLJointState* LLPose::getFirstJointState()
 //-----------------------------------------------------------------------------
 LLJointState *LLPose::getNextJointState()
 {
-	mListIter++;
-	if (mListIter == mJointMap.end())
+	if (++mListIter >= mJointStates.size())
 	{
 		return NULL;
 	}
-	else
-	{
-		return mListIter->second;
-	}
+	return mJointStates[mListIter];
 }
 
 //-----------------------------------------------------------------------------
@@ -84,9 +93,19 @@ LLJointState *LLPose::getNextJointState()
 BOOL LLPose::addJointState(const LLPointer<LLJointState>& jointState)
 {
 	llassert_always(jointState.notNull());
-	if (mJointMap.find(jointState->getJoint()->getName()) == mJointMap.end())
+	const LLJoint* joint = jointState->getJoint();
+	if (findIndex(joint) < 0)
 	{
-		mJointMap[jointState->getJoint()->getName()] = jointState;
+		S32 joint_num = joint->getJointNum();
+		if (joint_num >= 0)
+		{
+			if (joint_num >= (S32)mJointIndex.size())
+			{
+				mJointIndex.resize(joint_num + 1, -1);
+			}
+			mJointIndex[joint_num] = (S32)mJointStates.size();
+		}
+		mJointStates.push_back(jointState);
 	}
 	return TRUE;
 }
@@ -96,7 +115,29 @@ BOOL LLPose::addJointState(const LLPointer<LLJointState>& jointState)
 //-----------------------------------------------------------------------------
 BOOL LLPose::removeJointState(const LLPointer<LLJointState>& jointState)
 {
-	mJointMap.erase(jointState->getJoint()->getName());
+	const LLJoint* joint = jointState->getJoint();
+	S32 index = findIndex(joint);
+	if (index < 0)
+	{
+		return TRUE;
+	}
+
+	// Move the last joint state into the hole.
+	S32 last = (S32)mJointStates.size() - 1;
+	if (index != last)
+	{
+		mJointStates[index] = mJointStates[last];
+		S32 moved_num = mJointStates[index]->getJoint()->getJointNum();
+		if (moved_num >= 0)
+		{
+			mJointIndex[moved_num] = index;
+		}
+	}
+	mJointStates.pop_back();
+	if (joint->getJointNum() >= 0)
+	{
+		mJointIndex[joint->getJointNum()] = -1;
+	}
 	return TRUE;
 }
 
@@ -105,7 +146,8 @@ BOOL LLPose::removeJointState(const LLPointer<LLJointState>& jointState)
 //-----------------------------------------------------------------------------
 BOOL LLPose::removeAllJointStates()
 {
-	mJointMap.clear();
+	mJointStates.clear();
+	mJointIndex.clear();
 	return TRUE;
 }
 
@@ -114,16 +156,8 @@ BOOL LLPose::removeAllJointStates()
 //-----------------------------------------------------------------------------
 LLJointState* LLPose::findJointState(LLJoint *joint)
 {
-	joint_map_iterator iter = mJointMap.find(joint->getName());
-
-	if (iter == mJointMap.end())
-	{
-		return NULL;
-	}
-	else
-	{
-		return iter->second;
-	}
+	S32 index = findIndex(joint);
+	return index < 0 ? NULL : mJointStates[index].get();
 }
 
 //-----------------------------------------------------------------------------
@@ -131,16 +165,14 @@ LLJointState* LLPose::findJointState(LLJoint *joint)
 //-----------------------------------------------------------------------------
 LLJointState* LLPose::findJointState(const std::string &name)
 {
-	joint_map_iterator iter = mJointMap.find(name);
-
-	if (iter == mJointMap.end())
+	for (joint_state_vec_t::iterator iter = mJointStates.begin(); iter != mJointStates.end(); ++iter)
 	{
-		return NULL;
-	}
-	else
-	{
-		return iter->second;
+		if ((*iter)->getJoint()->getName() == name)
+		{
+			return *iter;
+		}
 	}
+	return NULL;
 }
 
 //-----------------------------------------------------------------------------
@@ -148,16 +180,13 @@ LLJointState* LLPose::findJointState(const std::string &name)
 //-----------------------------------------------------------------------------
 void LLPose::setWeight(F32 weight)
 {
-	joint_map_iterator iter;
-	for(iter = mJointMap.begin(); 
-		iter != mJointMap.end();
-		++iter)
+	for (joint_state_vec_t::iterator iter = mJointStates.begin(); iter != mJointStates.end(); ++iter)
 	{
 		// <edit>
 		// there was a crash here
 		// </edit>
-		llassert_always(iter->second.notNull());
-		iter->second->setWeight(weight);
+		llassert_always(iter->notNull());
+		(*iter)->setWeight(weight);
 	}
 	mWeight = weight;
 }
@@ -175,14 +204,47 @@ F32 LLPose::getWeight() const
 //-----------------------------------------------------------------------------
 S32 LLPose::getNumJointStates() const
 {
-	return (S32)mJointMap.size();
+	return (S32)mJointStates.size();
 }
 
 //-----------------------------------------------------------------------------
 // LLJointStateBlender
 //-----------------------------------------------------------------------------
 
+namespace
+{
+// nlerp() for LLQuaternion2: a normalized lerp of quaternions in the same
+// hemisphere, slerp() otherwise.
+inline void nlerp4a(F32 t, const LLQuaternion2& a, const LLQuaternion2& b, LLQuaternion2& result)
+{
+	if (a.getVector4a().dot4(b.getVector4a()).getF32() < 0.f)
+	{
+		result = slerp(t, LLQuaternion(a.getVector4a().getF32ptr()), LLQuaternion(b.getVector4a().getF32ptr()));
+	}
+	else
+	{
+		result.getVector4aRw().setLerp(a.getVector4a(), b.getVector4a(), t);
+		result.getVector4aRw().normalize4();
+	}
+}
+
+inline void load_joint(LLJoint* joint, LLVector4a& pos, LLQuaternion2& rot, LLVector4a& scale)
+{
+	pos.load3(joint->getPosition().mV);
+	rot = joint->getRotation();
+	scale.load3(joint->getScale().mV);
+}
+
+inline void apply_joint(LLJoint* joint, const LLVector4a& pos, const LLQuaternion2& rot, const LLVector4a& scale)
+{
+	joint->setPosition(LLVector3(pos.getF32ptr()));
+	joint->setRotation(LLQuaternion(rot.getVector4a().getF32ptr()));
+	joint->setScale(LLVector3(scale.getF32ptr()));
+}
+}
+
 LLJointStateBlender::LLJointStateBlender()
+:	mActive(false)
 {
 	for(S32 i = 0; i < JSB_NUM_JOINT_STATES; i++)
 	{
@@ -242,18 +304,16 @@ BOOL LLJointStateBlender::addJointState(const LLPointer<LLJointState>& joint_sta
 //-----------------------------------------------------------------------------
 // blendJointStates()
 //-----------------------------------------------------------------------------
-void LLJointStateBlender::blendJointStates(BOOL apply_now)
+bool LLJointStateBlender::blendJointStates(LLVector4a& blended_pos, LLQuaternion2& blended_rot, LLVector4a& blended_scale) const
 {
 	// we need at least one joint to blend
 	// if there is one, it will be in slot zero according to insertion logic
 	// instead of resetting joint state to default, just leave it unchanged from last frame
 	if (mJointStates[0].isNull())
 	{
-		return;
+		return false;
 	}
 
-	LLJoint* target_joint = apply_now ? mJointStates[0]->getJoint() : &mJointCache;
-
 	const S32 POS_WEIGHT = 0;
 	const S32 ROT_WEIGHT = 1;
 	const S32 SCALE_WEIGHT = 2;
@@ -261,25 +321,26 @@ void LLJointStateBlender::blendJointStates(BOOL apply_now)
 	F32				sum_weights[3];
 	U32				sum_usage = 0;
 
-	LLVector3		blended_pos = target_joint->getPosition();
-	LLQuaternion	blended_rot = target_joint->getRotation();
-	LLVector3		blended_scale = target_joint->getScale();
-
-	LLVector3		added_pos;
+	LLVector4a		added_pos;
 	LLQuaternion	added_rot;
-	LLVector3		added_scale;
+	LLVector4a		added_scale;
+	bool			has_added_rot = false;
 
-	//S32				joint_state_index;
+	added_pos.clear();
+	added_scale.clear();
 
 	sum_weights[POS_WEIGHT] = 0.f;
 	sum_weights[ROT_WEIGHT] = 0.f;
 	sum_weights[SCALE_WEIGHT] = 0.f;
 
+	LLVector4a		value;
+	LLQuaternion2	rot;
+
 	for(S32 joint_state_index = 0; 
 		joint_state_index < JSB_NUM_JOINT_STATES && mJointStates[joint_state_index].notNull();
 		joint_state_index++)
 	{
-		LLJointState* jsp = mJointStates[joint_state_index];
+		const LLJointState* jsp = mJointStates[joint_state_index];
 		U32 current_usage = jsp->getUsage();
 		F32 current_weight = jsp->getWeight();
 
@@ -295,7 +356,9 @@ void LLJointStateBlender::blendJointStates(BOOL apply_now)
 				F32 new_weight_sum = llmin(1.f, current_weight + sum_weights[POS_WEIGHT]);
 
 				// add in pos for this jointstate modulated by weight
-				added_pos += jsp->getPosition() * (new_weight_sum - sum_weights[POS_WEIGHT]);
+				value.load3(jsp->getPosition().mV);
+				value.mul(new_weight_sum - sum_weights[POS_WEIGHT]);
+				added_pos.add(value);
 			}
 
 			if(current_usage & LLJointState::SCALE)
@@ -303,7 +366,9 @@ void LLJointStateBlender::blendJointStates(BOOL apply_now)
 				F32 new_weight_sum = llmin(1.f, current_weight + sum_weights[SCALE_WEIGHT]);
 
 				// add in scale for this jointstate modulated by weight
-				added_scale += jsp->getScale() * (new_weight_sum - sum_weights[SCALE_WEIGHT]);
+				value.load3(jsp->getScale().mV);
+				value.mul(new_weight_sum - sum_weights[SCALE_WEIGHT]);
+				added_scale.add(value);
 			}
 
 			if (current_usage & LLJointState::ROT)
@@ -312,6 +377,7 @@ void LLJointStateBlender::blendJointStates(BOOL apply_now)
 
 				// add in rotation for this jointstate modulated by weight
 				added_rot = nlerp((new_weight_sum - sum_weights[ROT_WEIGHT]), added_rot, jsp->getRotation()) * added_rot;
+				has_added_rot = true;
 			}
 		}
 		else
@@ -326,13 +392,14 @@ void LLJointStateBlender::blendJointStates(BOOL apply_now)
 					F32 new_weight_sum = llmin(1.f, current_weight + sum_weights[POS_WEIGHT]);
 
 					// blend positions from both
-					blended_pos = lerp(jsp->getPosition(), blended_pos, sum_weights[POS_WEIGHT] / new_weight_sum);
+					value.load3(jsp->getPosition().mV);
+					blended_pos.setLerp(value, blended_pos, sum_weights[POS_WEIGHT] / new_weight_sum);
 					sum_weights[POS_WEIGHT] = new_weight_sum;
 				} 
 				else
 				{
 					// copy position from current
-					blended_pos = jsp->getPosition();
+					blended_pos.load3(jsp->getPosition().mV);
 					sum_weights[POS_WEIGHT] = current_weight;
 				}
 			}
@@ -345,13 +412,14 @@ void LLJointStateBlender::blendJointStates(BOOL apply_now)
 					F32 new_weight_sum = llmin(1.f, current_weight + sum_weights[SCALE_WEIGHT]);
 
 					// blend scales from both
-					blended_scale = lerp(jsp->getScale(), blended_scale, sum_weights[SCALE_WEIGHT] / new_weight_sum);
+					value.load3(jsp->getScale().mV);
+					blended_scale.setLerp(value, blended_scale, sum_weights[SCALE_WEIGHT] / new_weight_sum);
 					sum_weights[SCALE_WEIGHT] = new_weight_sum;
 				} 
 				else
 				{
 					// copy scale from current
-					blended_scale = jsp->getScale();
+					blended_scale.load3(jsp->getScale().mV);
 					sum_weights[SCALE_WEIGHT] = current_weight;
 				}
 			}
@@ -364,7 +432,8 @@ void LLJointStateBlender::blendJointStates(BOOL apply_now)
 					F32 new_weight_sum = llmin(1.f, current_weight + sum_weights[ROT_WEIGHT]);
 
 					// blend rotations from both
-					blended_rot = nlerp(sum_weights[ROT_WEIGHT] / new_weight_sum, jsp->getRotation(), blended_rot);
+					rot = jsp->getRotation();
+					nlerp4a(sum_weights[ROT_WEIGHT] / new_weight_sum, rot, blended_rot, blended_rot);
 					sum_weights[ROT_WEIGHT] = new_weight_sum;
 				} 
 				else
@@ -380,51 +449,23 @@ void LLJointStateBlender::blendJointStates(BOOL apply_now)
 		}
 	}
 
-	if (!added_scale.isFinite())
+	if (!added_scale.isFinite3())
 	{
-		added_scale.clearVec();
+		added_scale.clear();
 	}
 
-	if (!blended_scale.isFinite())
+	if (!blended_scale.isFinite3())
 	{
-		blended_scale.setVec(1,1,1);
+		blended_scale.set(1.f, 1.f, 1.f);
 	}
 
-	// apply transforms
-	target_joint->setPosition(blended_pos + added_pos);
-	target_joint->setScale(blended_scale + added_scale);
-	target_joint->setRotation(added_rot * blended_rot);
-
-	if (apply_now)
+	blended_pos.add(added_pos);
+	blended_scale.add(added_scale);
+	if (has_added_rot)
 	{
-		// now clear joint states
-		for(S32 i = 0; i < JSB_NUM_JOINT_STATES; i++)
-		{
-			mJointStates[i] = NULL;
-		}
+		blended_rot = added_rot * LLQuaternion(blended_rot.getVector4a().getF32ptr());
 	}
-}
-
-//-----------------------------------------------------------------------------
-// interpolate()
-//-----------------------------------------------------------------------------
-void LLJointStateBlender::interpolate(F32 u)
-{
-	// only interpolate if we have a joint state
-	if (!mJointStates[0])
-	{
-		return;
-	}
-	LLJoint* target_joint = mJointStates[0]->getJoint();
-
-	if (!target_joint)
-	{
-		return;
-	}
-
-	target_joint->setPosition(lerp(target_joint->getPosition(), mJointCache.getPosition(), u));
-	target_joint->setScale(lerp(target_joint->getScale(), mJointCache.getScale(), u));
-	target_joint->setRotation(nlerp(u, target_joint->getRotation(), mJointCache.getRotation()));
+	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -439,21 +480,6 @@ void LLJointStateBlender::clear()
 	}
 }
 
-//-----------------------------------------------------------------------------
-// resetCachedJoint()
-//-----------------------------------------------------------------------------
-void LLJointStateBlender::resetCachedJoint()
-{
-	if (!mJointStates[0])
-	{
-		return;
-	}
-	LLJoint* source_joint = mJointStates[0]->getJoint();
-	mJointCache.setPosition(source_joint->getPosition());
-	mJointCache.setScale(source_joint->getScale());
-	mJointCache.setRotation(source_joint->getRotation());
-}
-
 //-----------------------------------------------------------------------------
 // LLPoseBlender
 //-----------------------------------------------------------------------------
@@ -465,7 +491,40 @@ LLPoseBlender::LLPoseBlender()
 
 LLPoseBlender::~LLPoseBlender()
 {
-	for_each(mJointStateBlenderPool.begin(), mJointStateBlenderPool.end(), DeletePairedPointer());
+	for_each(mBlenders.begin(), mBlenders.end(), DeletePointer());
+}
+
+//-----------------------------------------------------------------------------
+// getSlot()
+//-----------------------------------------------------------------------------
+S32 LLPoseBlender::getSlot(LLJoint* joint)
+{
+	S32 joint_num = joint->getJointNum();
+	S32* slotp;
+	if (joint_num >= 0)
+	{
+		if (joint_num >= (S32)mSlotByJointNum.size())
+		{
+			mSlotByJointNum.resize(joint_num + 1, -1);
+		}
+		slotp = &mSlotByJointNum[joint_num];
+	}
+	else
+	{
+		slotp = &mUnnumberedSlots.insert(slot_map_t::value_type(joint, -1)).first->second;
+	}
+
+	if (*slotp < 0)
+	{
+		// this is the first time we are animating this joint
+		// so create new jointblender and add it to our pool
+		*slotp = (S32)mBlenders.size();
+		mBlenders.push_back(new LLJointStateBlender());
+		mCachedPositions.resize(mBlenders.size());
+		mCachedRotations.resize(mBlenders.size());
+		mCachedScales.resize(mBlenders.size());
+	}
+	return *slotp;
 }
 
 //-----------------------------------------------------------------------------
@@ -474,36 +533,27 @@ LLPoseBlender::~LLPoseBlender()
 BOOL LLPoseBlender::addMotion(LLMotion* motion)
 {
 	LLPose* pose = motion->getPose();
+	BOOL additive = motion->getBlendType() == LLMotion::ADDITIVE_BLEND;
 
 	for(LLJointState* jsp = pose->getFirstJointState(); jsp; jsp = pose->getNextJointState())
 	{
-		LLJoint *jointp = jsp->getJoint();
-		LLJointStateBlender* joint_blender;
-		if (mJointStateBlenderPool.find(jointp) == mJointStateBlenderPool.end())
-		{
-			// this is the first time we are animating this joint
-			// so create new jointblender and add it to our pool
-			joint_blender = new LLJointStateBlender();
-			mJointStateBlenderPool[jointp] = joint_blender;
-		}
-		else
-		{
-			joint_blender = mJointStateBlenderPool[jointp];
-		}
+		S32 slot = getSlot(jsp->getJoint());
+		LLJointStateBlender* joint_blender = mBlenders[slot];
 
 		if (jsp->getPriority() == LLJoint::USE_MOTION_PRIORITY)
 		{
-			joint_blender->addJointState(jsp, motion->getPriority(), motion->getBlendType() == LLMotion::ADDITIVE_BLEND);
+			joint_blender->addJointState(jsp, motion->getPriority(), additive);
 		}
 		else
 		{
-			joint_blender->addJointState(jsp, jsp->getPriority(), motion->getBlendType() == LLMotion::ADDITIVE_BLEND);
+			joint_blender->addJointState(jsp, jsp->getPriority(), additive);
 		}
 
 		// add it to our list of active blenders
-		if (std::find(mActiveBlenders.begin(), mActiveBlenders.end(), joint_blender) == mActiveBlenders.end())
+		if (!joint_blender->mActive)
 		{
-			mActiveBlenders.push_front(joint_blender);
+			joint_blender->mActive = true;
+			mActiveBlenders.push_back(slot);
 		}
 	}
 	return TRUE;
@@ -514,11 +564,21 @@ BOOL LLPoseBlender::addMotion(LLMotion* motion)
 //-----------------------------------------------------------------------------
 void LLPoseBlender::blendAndApply()
 {
-	for (blender_list_t::iterator iter = mActiveBlenders.begin();
+	LLVector4a pos, scale;
+	LLQuaternion2 rot;
+	for (std::vector<S32>::iterator iter = mActiveBlenders.begin();
 		 iter != mActiveBlenders.end(); ++iter)
 	{
-		LLJointStateBlender* jsbp = *iter;
-		jsbp->blendJointStates();
+		LLJointStateBlender* jsbp = mBlenders[*iter];
+		LLJoint* joint = jsbp->getJoint();
+		if (joint)
+		{
+			load_joint(joint, pos, rot, scale);
+			jsbp->blendJointStates(pos, rot, scale);
+			apply_joint(joint, pos, rot, scale);
+		}
+		jsbp->clear();
+		jsbp->mActive = false;
 	}
 
 	// we're done now so there are no more active blenders for this frame
@@ -530,15 +590,21 @@ void LLPoseBlender::blendAndApply()
 //-----------------------------------------------------------------------------
 void LLPoseBlender::blendAndCache(BOOL reset_cached_joints)
 {
-	for (blender_list_t::iterator iter = mActiveBlenders.begin();
+	for (std::vector<S32>::iterator iter = mActiveBlenders.begin();
 		 iter != mActiveBlenders.end(); ++iter)
 	{
-		LLJointStateBlender* jsbp = *iter;
+		S32 slot = *iter;
+		LLJointStateBlender* jsbp = mBlenders[slot];
+		LLJoint* joint = jsbp->getJoint();
+		if (!joint)
+		{
+			continue;
+		}
 		if (reset_cached_joints)
 		{
-			jsbp->resetCachedJoint();
+			load_joint(joint, mCachedPositions[slot], mCachedRotations[slot], mCachedScales[slot]);
 		}
-		jsbp->blendJointStates(FALSE);
+		jsbp->blendJointStates(mCachedPositions[slot], mCachedRotations[slot], mCachedScales[slot]);
 	}
 }
 
@@ -547,11 +613,23 @@ void LLPoseBlender::blendAndCache(BOOL reset_cached_joints)
 //-----------------------------------------------------------------------------
 void LLPoseBlender::interpolate(F32 u)
 {
-	for (blender_list_t::iterator iter = mActiveBlenders.begin();
+	LLVector4a pos, scale;
+	LLQuaternion2 rot;
+	for (std::vector<S32>::iterator iter = mActiveBlenders.begin();
 		 iter != mActiveBlenders.end(); ++iter)
 	{
-		LLJointStateBlender* jsbp = *iter;
-		jsbp->interpolate(u);
+		S32 slot = *iter;
+		// only interpolate if we have a joint state
+		LLJoint* joint = mBlenders[slot]->getJoint();
+		if (!joint)
+		{
+			continue;
+		}
+		load_joint(joint, pos, rot, scale);
+		pos.setLerp(pos, mCachedPositions[slot], u);
+		scale.setLerp(scale, mCachedScales[slot], u);
+		nlerp4a(u, rot, mCachedRotations[slot], rot);
+		apply_joint(joint, pos, rot, scale);
 	}
 }
 
@@ -560,13 +638,13 @@ void LLPoseBlender::interpolate(F32 u)
 //-----------------------------------------------------------------------------
 void LLPoseBlender::clearBlenders()
 {
-	for (blender_list_t::iterator iter = mActiveBlenders.begin();
+	for (std::vector<S32>::iterator iter = mActiveBlenders.begin();
 		 iter != mActiveBlenders.end(); ++iter)
 	{
-		LLJointStateBlender* jsbp = *iter;
+		LLJointStateBlender* jsbp = mBlenders[*iter];
 		jsbp->clear();
+		jsbp->mActive = false;
 	}
 
 	mActiveBlenders.clear();
 }
-
@@ -39,11 +39,13 @@
 
 #include "lljointstate.h"
 #include "lljoint.h"
+#include "llalignedarray.h"
 #include "llmap.h"
 #include "llpointer.h"
 
 #include <map>
 #include <string>
+#include <vector>
 
 
 //-----------------------------------------------------------------------------
@@ -53,13 +55,16 @@ class LLPose
 {
 	friend class LLPoseBlender;
 protected:
-	typedef std::map<std::string, LLPointer<LLJointState> > joint_map;
-	typedef joint_map::iterator joint_map_iterator;
-	typedef joint_map::value_type joint_map_value_type;
-	
-	joint_map					mJointMap;
+	typedef std::vector<LLPointer<LLJointState> > joint_state_vec_t;
+
+	// The joint states in the order they were added and, by joint number,
+	// their index in there. Joints without a number are searched for.
+	joint_state_vec_t			mJointStates;
+	std::vector<S32>			mJointIndex;
 	F32							mWeight;
-	joint_map_iterator			mListIter;
+	U32							mListIter;
+
+	S32 findIndex(const LLJoint* joint) const;
 public:
 	// Iterate through jointStates
 	LLJointState* getFirstJointState();
@@ -68,7 +73,7 @@ public:
 	LLJointState* findJointState(const std::string &name);
 public:
 	// Constructor
-	LLPose() : mWeight(0.f) {}
+	LLPose() : mWeight(0.f), mListIter(0) {}
 	// Destructor
 	~LLPose();
 	// add a joint state in this pose
@@ -96,24 +101,18 @@ protected:
 public:
 	LLJointStateBlender();
 	~LLJointStateBlender();
-	void* operator new(size_t size)
-	{
-		return ll_aligned_malloc_16(size);
-	}
 
-	void operator delete(void* ptr)
-	{
-		ll_aligned_free_16(ptr);
-	}
-
-	void blendJointStates(BOOL apply_now = TRUE);
+	// Blends the joint states, by priority, over the position, rotation and
+	// scale passed in. Returns false when there is no joint state.
+	bool blendJointStates(LLVector4a& pos, LLQuaternion2& rot, LLVector4a& scale) const;
 	BOOL addJointState(const LLPointer<LLJointState>& joint_state, S32 priority, BOOL additive_blend);
-	void interpolate(F32 u);
 	void clear();
-	void resetCachedJoint();
+
+	// The joint of the highest priority joint state, if any.
+	LLJoint* getJoint() const	{ return mJointStates[0].notNull() ? mJointStates[0]->getJoint() : NULL; }
 
 public:
-	LLJoint mJointCache;
+	bool mActive;	// in LLPoseBlender::mActiveBlenders
 };
 
 class LLMotion;
@@ -121,13 +120,25 @@ class LLMotion;
 class LLPoseBlender
 {
 protected:
-	typedef std::list<LLJointStateBlender*> blender_list_t;
-	typedef std::map<LLJoint*,LLJointStateBlender*> blender_map_t;
-	blender_map_t mJointStateBlenderPool;
-	blender_list_t mActiveBlenders;
+	typedef std::map<LLJoint*, S32> slot_map_t;
+
+	// A blender per joint ever animated, and the joint's slot in the
+	// cached pose arrays, found by joint number or, for the joints without
+	// one, in mUnnumberedSlots.
+	std::vector<LLJointStateBlender*> mBlenders;
+	std::vector<S32> mSlotByJointNum;
+	slot_map_t mUnnumberedSlots;
+	std::vector<S32> mActiveBlenders;
+
+	// The pose blendAndCache() computed, by slot.
+	LLAlignedArray<LLVector4a, 16> mCachedPositions;
+	LLAlignedArray<LLQuaternion2, 16> mCachedRotations;
+	LLAlignedArray<LLVector4a, 16> mCachedScales;
 
 	S32			mNextPoseSlot;
 	LLPose		mBlendedPose;
+
+	S32 getSlot(LLJoint* joint);
 public:
 	// Constructor
 	LLPoseBlender();
@@ -30,6 +30,7 @@
 #include "linden_common.h"
 
 #include "llvisualparam.h"
+#include "llcharacter.h"
 
 //-----------------------------------------------------------------------------
 // LLVisualParamInfo()
@@ -168,7 +169,9 @@ LLVisualParam::LLVisualParam()
 	mIsDummy(FALSE),
 	mID( -1 ),
 	mInfo( 0 ),
-	mParamLocation(LOC_UNKNOWN)
+	mParamLocation(LOC_UNKNOWN),
+	mCharacter(NULL),
+	mIsDirty(FALSE)
 {
 }
 
@@ -184,7 +187,9 @@ LLVisualParam::LLVisualParam(const LLVisualParam& pOther)
 	mIsDummy(pOther.mIsDummy),
 	mID(pOther.mID),
 	mInfo(pOther.mInfo),
-	mParamLocation(pOther.mParamLocation)
+	mParamLocation(pOther.mParamLocation),
+	mCharacter(NULL),
+	mIsDirty(FALSE)
 {
 }
 
@@ -238,6 +243,7 @@ BOOL LLVisualParam::parseData(LLXmlTreeNode *node)
 //-----------------------------------------------------------------------------
 void LLVisualParam::setWeight(F32 weight, bool upload_bake)
 {
+	F32 old_weight = mCurWeight;
 	if (mIsAnimating)
 	{
 		//RN: allow overshoot
@@ -251,6 +257,11 @@ void LLVisualParam::setWeight(F32 weight, bool upload_bake)
 	{
 		mCurWeight = weight;
 	}
+
+	if (mCurWeight != old_weight)
+	{
+		markDirty();
+	}
 	
 	if (mNext)
 	{
@@ -328,10 +339,37 @@ void LLVisualParam::stopAnimating(bool upload_bake)
 	if (mIsAnimating && isTweakable())
 	{
 		mIsAnimating = FALSE; 
+		// Skipped by updateVisualParams() while it animated
+		markDirty();
 		setWeight(mTargetWeight, upload_bake);
 	}
 }
 
+//-----------------------------------------------------------------------------
+// setAnimating()
+//-----------------------------------------------------------------------------
+void LLVisualParam::setAnimating(BOOL is_animating)
+{
+	BOOL was_animating = mIsAnimating;
+	mIsAnimating = is_animating && !mIsDummy;
+	if (was_animating && !mIsAnimating)
+	{
+		markDirty();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// markDirty()
+//-----------------------------------------------------------------------------
+void LLVisualParam::markDirty()
+{
+	if (mCharacter && !mIsDirty)
+	{
+		mIsDirty = TRUE;
+		mCharacter->addDirtyVisualParam(this);
+	}
+}
+
 //virtual
 BOOL LLVisualParam::linkDrivenParams(visual_param_mapper mapper, BOOL only_cross_params)
 {
@@ -62,6 +62,8 @@ const std::string param_location_name(const EParamLocation& loc);
 
 const S32 MAX_TRANSMITTED_VISUAL_PARAMS = 255;
 
+class LLCharacter;
+
 //-----------------------------------------------------------------------------
 // LLVisualParamInfo
 // Contains shared data for VisualParams
@@ -168,7 +170,7 @@ public:
 	void					setNextParam( LLVisualParam *next );
 	void					clearNextParam();
 	
-	virtual void			setAnimating(BOOL is_animating) { mIsAnimating = is_animating && !mIsDummy; }
+	virtual void			setAnimating(BOOL is_animating);
 	BOOL					getAnimating() const { return mIsAnimating; }
 
 	void					setIsDummy(BOOL is_dummy) { mIsDummy = is_dummy; }
@@ -176,6 +178,13 @@ public:
 	void					setParamLocation(EParamLocation loc);
 	EParamLocation			getParamLocation() const { return mParamLocation; }
 
+	// The character that applies this param in updateVisualParams(). It is
+	// told whenever the effective weight of the param may have changed.
+	void					setCharacter(LLCharacter* character) { mCharacter = character; }
+	void					markDirty();
+	BOOL					isDirty() const		{ return mIsDirty; }
+	void					clearDirty()		{ mIsDirty = FALSE; }
+
 	// Singu extensions. Used for dumping the archtype.
 	virtual char const*		getTypeString(void) const = 0;
 	virtual std::string		getDumpWearableTypeName(void) const = 0;
@@ -194,6 +203,8 @@ protected:
 	S32					mID;				// id for storing weight/morphtarget compares compactly
 	LLVisualParamInfo	*mInfo;
 	EParamLocation		mParamLocation;		// where does this visual param live?
+	LLCharacter*		mCharacter;			// not copied, clones belong to wearables
+	BOOL				mIsDirty;			// queued for the next updateVisualParams()
 } LL_ALIGN_POSTFIX(16);
 
 #endif // LL_LLVisualParam_H
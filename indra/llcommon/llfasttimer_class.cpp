@@ -151,7 +151,9 @@
 #include "llsingleton.h"
 #include "lltreeiterators.h"
 #include "llsdserialize.h"
+#include "llthread.h"
 
+#include <atomic>
 #include <boost/bind.hpp>
 
 
@@ -316,6 +318,14 @@ private:
 	LLFastTimer::FrameState*		mRootFrameState;		// Points to memory allocated with new, so this pointer is not invalidated.
 };
 
+// NamedTimers by thread index. Timers are declared during static
+// initialization, hence the function static.
+static std::vector<LLFastTimer::NamedTimer*>& get_thread_index_timers()
+{
+	static std::vector<LLFastTimer::NamedTimer*> sTimers;
+	return sTimers;
+}
+
 void update_cached_pointers_if_changed()
 {
 	// detect when elements have moved and update cached pointers
@@ -433,6 +443,10 @@ LLFastTimer::NamedTimer::NamedTimer(const std::string& name)
 	mCallAverage(0),
 	mNeedsSorting(false)
 {
+	std::vector<NamedTimer*>& thread_index_timers = get_thread_index_timers();
+	mThreadIndex = thread_index_timers.size();
+	thread_index_timers.push_back(this);
+
 	info_list_t& frame_state_list = getFrameStateList();
 	mFrameStateIndex = frame_state_list.size();
 	getFrameStateList().push_back(FrameState(this));
@@ -855,6 +869,8 @@ void LLFastTimer::nextFrame()
 		LL_INFOS() << "Slow frame, fast timers inaccurate" << LL_ENDL;
 	}
 
+	collectThreadTimes(!sPauseHistory && sCurFrameIndex >= 0);
+	LLTraceRecorder::nextFrame();
 	if (!sPauseHistory)
 	{
 		NamedTimer::processTimes();
@@ -905,6 +921,7 @@ void LLFastTimer::dumpCurTimes()
 void LLFastTimer::reset()
 {
 	NamedTimer::reset();
+	resetThreadTimes();
 }
 
 
@@ -926,6 +943,318 @@ const LLFastTimer::NamedTimer* LLFastTimer::getTimerByName(const std::string& na
 	return NamedTimerFactory::instance().getTimerByName(name);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+// Worker thread timers
+//
+// Each thread outside the main thread keeps its timer stack in a thread local
+// CurTimerData, the counterpart of sCurTimerData, and accumulates self time
+// and calls into the slots of its ThreadLane, one slot per NamedTimer. The
+// slots are atomics written only by their thread; once per frame the main
+// thread swaps them with zero and builds the thread's tree from the last
+// caller each slot recorded. Neither side ever waits for the other.
+
+namespace
+{
+	// Slots per lane; timers declared beyond this are not shown in the lanes.
+	const U32 MAX_THREAD_TIMERS = 1024;
+
+	struct ThreadTimerSlot
+	{
+		std::atomic<U32>	mSelfTime;
+		std::atomic<U32>	mCalls;
+		std::atomic<U32>	mCaller;		// thread index + 1 of the last caller, 0 for none
+
+		ThreadTimerSlot() : mSelfTime(0), mCalls(0), mCaller(0) { }
+	};
+
+	// Main thread only
+	struct ThreadTimerHistory
+	{
+		U32					mCaller;
+		U32					mSelfTime;		// of the frame being collected
+		U32					mCalls;
+		U32					mTotalTime;
+		F64					mCountAverage;
+		F64					mCallAverage;
+		std::vector<U32>	mCountHistory;
+		std::vector<U32>	mCallHistory;
+
+		ThreadTimerHistory()
+		:	mCaller(0), mSelfTime(0), mCalls(0), mTotalTime(0), mCountAverage(0), mCallAverage(0),
+			mCountHistory(LLFastTimer::NamedTimer::HISTORY_NUM),
+			mCallHistory(LLFastTimer::NamedTimer::HISTORY_NUM)
+		{
+		}
+	};
+
+	struct ThreadLane
+	{
+		std::string			mName;
+		bool				mActive;		// guarded by sThreadLaneMutex
+		ThreadTimerSlot		mSlots[MAX_THREAD_TIMERS];
+		// Main thread only
+		typedef std::map<U32, ThreadTimerHistory> history_map_t;
+		history_map_t		mHistory;
+	};
+
+	struct ThreadTimerState
+	{
+		ThreadLane*					mLane;
+		LLFastTimer::CurTimerData	mCur;
+	};
+
+	LL_THREAD_LOCAL ThreadTimerState* tThreadTimerState = NULL;
+
+	LLGlobalMutex sThreadLaneMutex;				// guards sThreadLanes and ThreadLane::mActive
+	std::vector<ThreadLane*> sThreadLanes;		// never shrinks: lanes are reused by name
+
+	ThreadTimerState* register_thread(const std::string& name)
+	{
+		ThreadLane* lane = NULL;
+		{
+			LLMutexLock lock(sThreadLaneMutex);
+			for (std::vector<ThreadLane*>::iterator it = sThreadLanes.begin(); it != sThreadLanes.end(); ++it)
+			{
+				if (!(*it)->mActive && (*it)->mName == name)
+				{
+					lane = *it;
+					break;
+				}
+			}
+			if (!lane)
+			{
+				lane = new ThreadLane;
+				lane->mName = name;
+				sThreadLanes.push_back(lane);
+			}
+			lane->mActive = true;
+		}
+		ThreadTimerState* state = new ThreadTimerState;
+		state->mLane = lane;
+		state->mCur.mCurTimer = NULL;
+		state->mCur.mNamedTimer = NULL;
+		state->mCur.mFrameState = NULL;
+		state->mCur.mChildTime = 0;
+		tThreadTimerState = state;
+		return state;
+	}
+}
+
+//static
+void LLFastTimer::registerThread(const std::string& name)
+{
+	if (!tThreadTimerState)
+	{
+		register_thread(name);
+	}
+	LLTraceRecorder::registerThread(name);
+}
+
+//static
+void LLFastTimer::unregisterThread()
+{
+	ThreadTimerState* state = tThreadTimerState;
+	if (state)
+	{
+		tThreadTimerState = NULL;
+		LLMutexLock lock(sThreadLaneMutex);
+		state->mLane->mActive = false;
+		delete state;
+	}
+	LLTraceRecorder::unregisterThread();
+}
+
+void LLFastTimer::startThreadTimer(NamedTimer& timer)
+{
+	ThreadTimerState* state = tThreadTimerState;
+	if (!state)
+	{
+		state = register_thread("Unnamed thread");
+	}
+	mFrameState = NULL;		// marks this as a thread timer
+	mStartTime = getCPUClockCount32();
+	mLastTimerData = state->mCur;
+	state->mCur.mCurTimer = this;
+	state->mCur.mNamedTimer = &timer;
+	state->mCur.mChildTime = 0;
+	if (LL_UNLIKELY(LLTraceRecorder::isActive()))
+	{
+		LLTraceRecorder::begin(timer.getName());
+	}
+}
+
+void LLFastTimer::stopThreadTimer()
+{
+	ThreadTimerState* state = tThreadTimerState;
+	U32 total_time = getCPUClockCount32() - mStartTime;
+	NamedTimer* timer = state->mCur.mNamedTimer;
+	const U32 index = timer->mThreadIndex;
+	if (index < MAX_THREAD_TIMERS)
+	{
+		ThreadTimerSlot& slot = state->mLane->mSlots[index];
+		slot.mSelfTime.fetch_add(total_time - state->mCur.mChildTime, std::memory_order_relaxed);
+		slot.mCalls.fetch_add(1, std::memory_order_relaxed);
+		NamedTimer* caller = mLastTimerData.mNamedTimer;
+		// Recursion would make the timer its own parent.
+		if (caller != timer)
+		{
+			slot.mCaller.store(caller ? caller->mThreadIndex + 1 : 0, std::memory_order_relaxed);
+		}
+	}
+	mLastTimerData.mChildTime += total_time;
+	if (LL_UNLIKELY(LLTraceRecorder::isActive()))
+	{
+		LLTraceRecorder::end(timer->getName());
+	}
+	state->mCur = mLastTimerData;
+}
+
+//static
+void LLFastTimer::collectThreadTimes(bool record)
+{
+	const U32 timer_count = llmin((U32)get_thread_index_timers().size(), MAX_THREAD_TIMERS);
+	const S32 hidx = record ? sCurFrameIndex % NamedTimer::HISTORY_NUM : 0;
+	const S32 weight = llmin(100, sCurFrameIndex);
+
+	LLMutexLock lock(sThreadLaneMutex);
+	for (std::vector<ThreadLane*>::iterator lit = sThreadLanes.begin(); lit != sThreadLanes.end(); ++lit)
+	{
+		ThreadLane* lane = *lit;
+		for (U32 i = 0; i < timer_count; ++i)
+		{
+			ThreadTimerSlot& slot = lane->mSlots[i];
+			if (!slot.mCalls.load(std::memory_order_relaxed))
+			{
+				continue;
+			}
+			const U32 self_time = slot.mSelfTime.exchange(0, std::memory_order_relaxed);
+			const U32 calls = slot.mCalls.exchange(0, std::memory_order_relaxed);
+			if (record)
+			{
+				ThreadTimerHistory& history = lane->mHistory[i];
+				history.mCaller = slot.mCaller.load(std::memory_order_relaxed);
+				history.mSelfTime = self_time;
+				history.mCalls = calls;
+			}
+		}
+		if (!record) continue;
+
+		// Totals: every timer adds its own time to all of its callers. The
+		// trees are shallow, so walking up is cheaper than sorting them.
+		for (ThreadLane::history_map_t::iterator it = lane->mHistory.begin(); it != lane->mHistory.end(); ++it)
+		{
+			it->second.mTotalTime = 0;
+		}
+		for (ThreadLane::history_map_t::iterator it = lane->mHistory.begin(); it != lane->mHistory.end(); ++it)
+		{
+			const U32 self_time = it->second.mSelfTime;
+			if (!self_time) continue;
+			it->second.mTotalTime += self_time;
+			U32 caller = it->second.mCaller;
+			for (U32 depth = 0; caller && depth < MAX_THREAD_TIMERS; ++depth)
+			{
+				ThreadLane::history_map_t::iterator parent = lane->mHistory.find(caller - 1);
+				if (parent == lane->mHistory.end() || parent == it) break;
+				parent->second.mTotalTime += self_time;
+				caller = parent->second.mCaller;
+			}
+		}
+		for (ThreadLane::history_map_t::iterator it = lane->mHistory.begin(); it != lane->mHistory.end(); ++it)
+		{
+			ThreadTimerHistory& history = it->second;
+			history.mCountHistory[hidx] = history.mTotalTime;
+			history.mCallHistory[hidx] = history.mCalls;
+			history.mCountAverage = (history.mCountAverage * weight + (F64)history.mTotalTime) / (weight + 1);
+			history.mCallAverage = (history.mCallAverage * weight + (F64)history.mCalls) / (weight + 1);
+			history.mSelfTime = 0;
+			history.mCalls = 0;
+		}
+	}
+}
+
+//static
+void LLFastTimer::resetThreadTimes()
+{
+	LLMutexLock lock(sThreadLaneMutex);
+	for (std::vector<ThreadLane*>::iterator it = sThreadLanes.begin(); it != sThreadLanes.end(); ++it)
+	{
+		(*it)->mHistory.clear();
+	}
+}
+
+//static
+S32 LLFastTimer::getThreadLaneCount()
+{
+	LLMutexLock lock(sThreadLaneMutex);
+	return (S32)sThreadLanes.size();
+}
+
+//static
+std::string LLFastTimer::getThreadLaneName(S32 lane)
+{
+	LLMutexLock lock(sThreadLaneMutex);
+	return lane >= 0 && lane < (S32)sThreadLanes.size() ? sThreadLanes[lane]->mName : LLStringUtil::null;
+}
+
+//static
+void LLFastTimer::getThreadLaneTimers(S32 lane, S32 history_index, std::vector<ThreadTimerInfo>& timers)
+{
+	timers.clear();
+	LLMutexLock lock(sThreadLaneMutex);
+	if (lane < 0 || lane >= (S32)sThreadLanes.size())
+	{
+		return;
+	}
+	const ThreadLane::history_map_t& histories = sThreadLanes[lane]->mHistory;
+	const S32 hidx = history_index < 0 ? -1 : (getLastFrameIndex() + history_index) % NamedTimer::HISTORY_NUM;
+
+	// Children of each caller; a caller that is gone makes its callees roots.
+	typedef std::multimap<U32, U32> child_map_t;
+	child_map_t children;
+	for (ThreadLane::history_map_t::const_iterator it = histories.begin(); it != histories.end(); ++it)
+	{
+		U32 caller = it->second.mCaller;
+		if (caller && (caller - 1 == it->first || !histories.count(caller - 1)))
+		{
+			caller = 0;
+		}
+		children.insert(std::make_pair(caller, it->first + 1));
+	}
+
+	// Depth first; a cycle left over from timers that moved cannot recurse
+	// past the number of timers.
+	std::vector<std::pair<U32, S32> > stack;
+	for (child_map_t::const_reverse_iterator it(children.upper_bound(0)); it != children.rend(); ++it)
+	{
+		stack.push_back(std::make_pair(it->second, 0));
+	}
+	while (!stack.empty() && timers.size() < histories.size())
+	{
+		const U32 node = stack.back().first;
+		const S32 depth = stack.back().second;
+		stack.pop_back();
+
+		const ThreadTimerHistory& history = histories.find(node - 1)->second;
+		ThreadTimerInfo info;
+		info.mTimer = get_thread_index_timers()[node - 1];
+		info.mDepth = depth;
+		info.mCount = hidx < 0 ? (U32)history.mCountAverage : history.mCountHistory[hidx];
+		info.mCalls = hidx < 0 ? (U32)history.mCallAverage : history.mCallHistory[hidx];
+		timers.push_back(info);
+
+		std::pair<child_map_t::const_iterator, child_map_t::const_iterator> range = children.equal_range(node);
+		std::vector<U32> kids;
+		for (child_map_t::const_iterator cit = range.first; cit != range.second; ++cit)
+		{
+			kids.push_back(cit->second);
+		}
+		for (std::vector<U32>::reverse_iterator kit = kids.rbegin(); kit != kids.rend(); ++kit)
+		{
+			stack.push_back(std::make_pair(*kit, depth + 1));
+		}
+	}
+}
+
 LLFastTimer::LLFastTimer(LLFastTimer::FrameState* state)
 :	mFrameState(state)
 {
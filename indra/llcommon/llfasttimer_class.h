@@ -31,11 +31,12 @@
 
 #define FAST_TIMER_ON 1
 #define TIME_FAST_TIMERS 0
-#define DEBUG_FAST_TIMER_THREADS 1
 
 class LLMutex;
 
 #include <queue>
+#include "aithreadid.h"
+#include "lltracerecorder.h"
 #include "llsd.h"
 
 #define LL_RECORD_BLOCK_TIME(timer_stat) LLFastTimer LL_GLUE_TOKENS(block_time_recorder, __LINE__)(timer_stat);
@@ -93,6 +94,8 @@ public:
 		static NamedTimer& getRootNamedTimer();
 
 		S32 getFrameStateIndex() const { return mFrameStateIndex; }
+		// Stable index of this timer in the worker thread lanes
+		U32 getThreadIndex() const { return mThreadIndex; }
 
 		FrameState& getFrameState() const;
 
@@ -119,6 +122,7 @@ public:
 		// members
 		//
 		S32			mFrameStateIndex;
+		U32			mThreadIndex;
 
 		std::string	mName;
 
@@ -161,6 +165,11 @@ public:
 		U64 timer_start = getCPUClockCount64();
 #endif
 #if FAST_TIMER_ON
+		if (LL_UNLIKELY(!AIThreadID::in_main_thread_inline()))
+		{
+			startThreadTimer(timer.mTimer);
+			return;
+		}
 		LLFastTimer::FrameState* frame_state = mFrameState;
 		mStartTime = getCPUClockCount32();
 
@@ -175,15 +184,14 @@ public:
 		cur_timer_data->mNamedTimer = &timer.mTimer;
 		cur_timer_data->mFrameState = frame_state;
 		cur_timer_data->mChildTime = 0;
+		if (LL_UNLIKELY(LLTraceRecorder::isActive()))
+		{
+			LLTraceRecorder::begin(timer.mTimer.getName());
+		}
 #endif
 #if TIME_FAST_TIMERS
 		U64 timer_end = getCPUClockCount64();
 		sTimerCycles += timer_end - timer_start;
-#endif
-#if DEBUG_FAST_TIMER_THREADS
-#if !LL_RELEASE
-		assert_main_thread();
-#endif
 #endif
 	}
 
@@ -194,6 +202,11 @@ public:
 #endif
 #if FAST_TIMER_ON
 		LLFastTimer::FrameState* frame_state = mFrameState;
+		if (LL_UNLIKELY(!frame_state))
+		{
+			stopThreadTimer();
+			return;
+		}
 		U32 total_time = getCPUClockCount32() - mStartTime;
 
 		frame_state->mSelfTimeCounter += total_time - LLFastTimer::sCurTimerData.mChildTime;
@@ -206,6 +219,10 @@ public:
 		// we are only tracking self time, so subtract our total time delta from parents
 		mLastTimerData.mChildTime += total_time;
 
+		if (LL_UNLIKELY(LLTraceRecorder::isActive()))
+		{
+			LLTraceRecorder::end(LLFastTimer::sCurTimerData.mNamedTimer->getName());
+		}
 		LLFastTimer::sCurTimerData = mLastTimerData;
 #endif
 #if TIME_FAST_TIMERS
@@ -250,6 +267,27 @@ public:
 	static void writeLog(std::ostream& os);
 	static const NamedTimer* getTimerByName(const std::string& name);
 
+	// Worker threads. Timers started outside the main thread go to a stack
+	// and a lane of their own; the main thread collects every lane's times
+	// in nextFrame(), giving each thread a timer tree with its own history.
+	// LLThread registers its threads by name; other threads get a lane on
+	// their first timer.
+	struct ThreadTimerInfo
+	{
+		NamedTimer*	mTimer;
+		S32			mDepth;		// 0 for timers at the bottom of the thread's stack
+		U32			mCount;		// total time, in countsPerSecond() units
+		U32			mCalls;
+	};
+	static void registerThread(const std::string& name);
+	static void unregisterThread();
+	// Main thread only
+	static S32 getThreadLaneCount();
+	static std::string getThreadLaneName(S32 lane);
+	// Depth first, children after their parent. A negative history_index
+	// gives the running averages.
+	static void getThreadLaneTimers(S32 lane, S32 history_index, std::vector<ThreadTimerInfo>& timers);
+
 	struct CurTimerData
 	{
 		LLFastTimer*	mCurTimer;
@@ -264,6 +302,11 @@ private:
 	static U32 getCPUClockCount32();
 	static U64 getCPUClockCount64();
 
+	void startThreadTimer(NamedTimer& timer);
+	void stopThreadTimer();
+	static void collectThreadTimes(bool record);
+	static void resetThreadTimes();
+
 	static S32				sCurFrameIndex;
 	static S32				sLastFrameIndex;
 	static U64				sLastFrameTime;
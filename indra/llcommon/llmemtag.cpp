@@ -0,0 +1,118 @@
+/**
+ * @file llmemtag.cpp
+ * @brief Live byte counters and high-water marks per subsystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llmemtag.h"
+
+// Zero initialized before any dynamic initialization takes place.
+std::atomic<S64> LLMemTag::sBytes[LLMemTag::MT_COUNT];
+std::atomic<S64> LLMemTag::sPeak[LLMemTag::MT_COUNT];
+
+namespace
+{
+	const char* const sTagNames[LLMemTag::MT_COUNT] =
+	{
+		"Texture Raw",
+		"Texture Formatted",
+		"Vertex Buffers",
+		"Index Buffers",
+		"Volumes",
+		"Octree",
+		"LLSD",
+		"UI",
+		"Audio",
+		"Mesh Repository"
+	};
+
+	// What addLocal() did not fold yet. Plain integers need no construction,
+	// so this works from static initializers and destructors as well.
+	thread_local S64 tLocalBytes[LLMemTag::MT_COUNT];
+}
+
+//static
+void LLMemTag::addLocal(ETag tag, S64 bytes)
+{
+	S64& local = tLocalBytes[tag];
+	local += bytes;
+	if (local >= LOCAL_FOLD_BYTES || local <= -LOCAL_FOLD_BYTES)
+	{
+		add(tag, local);
+		local = 0;
+	}
+}
+
+//static
+void LLMemTag::foldLocal()
+{
+	for (S32 i = 0; i < MT_COUNT; ++i)
+	{
+		if (tLocalBytes[i])
+		{
+			add((ETag)i, tLocalBytes[i]);
+			tLocalBytes[i] = 0;
+		}
+	}
+}
+
+//static
+S64 LLMemTag::getTotalBytes()
+{
+	S64 total = 0;
+	for (S32 i = 0; i < MT_COUNT; ++i)
+	{
+		total += getBytes((ETag)i);
+	}
+	return total;
+}
+
+//static
+const char* LLMemTag::getName(ETag tag)
+{
+	return tag < MT_COUNT ? sTagNames[tag] : "Unknown";
+}
+
+//static
+void LLMemTag::resetPeaks()
+{
+	for (S32 i = 0; i < MT_COUNT; ++i)
+	{
+		sPeak[i].store(sBytes[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+//static
+void LLMemTag::dumpToLog()
+{
+	std::string line;
+	for (S32 i = 0; i < MT_COUNT; ++i)
+	{
+		ETag tag = (ETag)i;
+		line += llformat("%s%s: %.1f (%.1f)", i ? ", " : "", getName(tag),
+						 getBytes(tag) / 1048576.0, getPeakBytes(tag) / 1048576.0);
+	}
+	LL_INFOS() << "MEMTAGS (MB, peak): " << line << LL_ENDL;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file llmemtag.h
+ * @brief Live byte counters and high-water marks per subsystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLMEMTAG_H
+#define LL_LLMEMTAG_H
+
+#include <atomic>
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLMemTag
+//
+//   One counter of live bytes per subsystem, plus the highest value it ever
+//   reached. The subsystems add what they allocate and subtract what they
+//   free at the places where they already account for their memory, so the
+//   figures are those the subsystem believes it owns, not what malloc
+//   actually handed out. Where only an estimate is practical (UI, LLSD), the
+//   counter only covers the size of the objects themselves.
+//
+//   The counters are plain atomics, usable from any thread and during
+//   static initialization. The objects counted one by one, many times a
+//   frame (LLSD, octree and XML nodes), go through addLocal() instead: it
+//   adds to a counter of the calling thread, and only folds that into the
+//   shared one and its peak once it reached LOCAL_FOLD_BYTES either way.
+//   Their figures may lag by that much per thread.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LL_COMMON_API LLMemTag
+{
+public:
+	enum ETag
+	{
+		MT_TEXTURE_RAW,
+		MT_TEXTURE_FORMATTED,
+		MT_VERTEX_BUFFER,
+		MT_INDEX_BUFFER,
+		MT_VOLUME,
+		MT_OCTREE,
+		MT_LLSD,
+		MT_UI,
+		MT_AUDIO,
+		MT_MESH,
+		MT_COUNT
+	};
+
+	static void add(ETag tag, S64 bytes)
+	{
+		S64 now = sBytes[tag].fetch_add(bytes, std::memory_order_relaxed) + bytes;
+		if (bytes > 0)
+		{
+			S64 peak = sPeak[tag].load(std::memory_order_relaxed);
+			while (now > peak &&
+				   !sPeak[tag].compare_exchange_weak(peak, now, std::memory_order_relaxed))
+			{
+			}
+		}
+	}
+	static void sub(ETag tag, S64 bytes)		{ add(tag, -bytes); }
+
+	enum { LOCAL_FOLD_BYTES = 65536 };
+
+	static void addLocal(ETag tag, S64 bytes);
+	static void subLocal(ETag tag, S64 bytes)	{ addLocal(tag, -bytes); }
+
+	// Folds what addLocal() kept for the calling thread. LLThread calls it
+	// when its thread ends.
+	static void foldLocal();
+
+	static S64 getBytes(ETag tag)				{ return sBytes[tag].load(std::memory_order_relaxed); }
+	static S64 getPeakBytes(ETag tag)			{ return sPeak[tag].load(std::memory_order_relaxed); }
+	static S64 getTotalBytes();
+	static const char* getName(ETag tag);
+
+	// Brings the high-water marks back down to the current values.
+	static void resetPeaks();
+
+	// One line with the current and peak MB of every tag.
+	static void dumpToLog();
+
+private:
+	static std::atomic<S64> sBytes[MT_COUNT];
+	static std::atomic<S64> sPeak[MT_COUNT];
+};
+
+#endif // LL_LLMEMTAG_H
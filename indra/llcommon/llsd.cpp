@@ -32,6 +32,7 @@
 
 #include "llerror.h"
 #include "llformat.h"
+#include "llmemtag.h"
 #include "llsdserialize.h"
 #include "stringize.h"
 
@@ -87,6 +88,15 @@ protected:
 	bool shared() const							{ return (mUseCount > 1) && (mUseCount != STATIC_USAGE_COUNT); }
 	
 	U32 mUseCount;
+	// Bytes reported to LLMemTag::MT_LLSD: the size of the object, not of
+	// what it refers to. 0 for the static instances.
+	U32 mAccountedSize;
+
+	void accountSize(U32 size)
+	{
+		mAccountedSize = size;
+		LLMemTag::addLocal(LLMemTag::MT_LLSD, size);
+	}
 
 public:
 	static void reset(Impl*& var, Impl* impl);
@@ -140,8 +150,8 @@ public:
 	virtual void erase(Integer)					{ }
 	virtual const LLSD& ref(Integer) const		{ return undef(); }
 
-	virtual const std::map<String, LLSD>& map() const { static const std::map<String, LLSD> empty; return empty; }
-	virtual std::map<String, LLSD>& map() { static std::map<String, LLSD> empty; return empty; }
+	virtual const LLSD::map_t& map() const { static const LLSD::map_t empty; return empty; }
+	virtual LLSD::map_t& map() { static LLSD::map_t empty; return empty; }
 	LLSD::map_const_iterator beginMap() const { return map().begin(); }
 	LLSD::map_const_iterator endMap() const { return map().end(); }
 	virtual const std::vector<LLSD>& array() const { static const std::vector<LLSD> empty; return empty; }
@@ -185,7 +195,7 @@ namespace
 		typedef ImplBase Base;
 
 	public:
-		ImplBase(DataRef value) : mValue(value) { }
+		ImplBase(DataRef value) : mValue(value)		{ accountSize(sizeof(*this)); }
 		
 		LLSD::Type type() const override { return T; }
 
@@ -364,15 +374,15 @@ namespace
 	class ImplMap final : public LLSD::Impl
 	{
 	private:
-		typedef std::map<LLSD::String, LLSD>	DataMap;
+		typedef LLSD::map_t						DataMap;
 		
 		DataMap mData;
 		
 	protected:
-		ImplMap(const DataMap& data) : mData(data) { }
+		ImplMap(const DataMap& data) : mData(data)	{ accountSize(sizeof(*this)); }
 		
 	public:
-		ImplMap() { }
+		ImplMap()									{ accountSize(sizeof(*this)); }
 		
 		ImplMap& makeMap(LLSD::Impl*&) override;
 
@@ -415,16 +425,17 @@ namespace
 		}
 	}
 	
+	// Lookups by key go through lookup() rather than find(), which would
+	// have to sort the map after out of order inserts.
 	bool ImplMap::has(const LLSD::String& k) const
 	{
-		DataMap::const_iterator i = mData.find(k);
-		return i != mData.end();
+		return mData.count(k) != 0;
 	}
 	
 	LLSD ImplMap::get(const LLSD::String& k) const
 	{
-		DataMap::const_iterator i = mData.find(k);
-		return (i != mData.end()) ? i->second : LLSD();
+		const LLSD* value = mData.lookup(k);
+		return value ? *value : LLSD();
 	}
 	
 	LLSD ImplMap::getKeys() const
@@ -441,7 +452,10 @@ namespace
 
 	void ImplMap::insert(const LLSD::String& k, const LLSD& v)
 	{
-		mData.insert(DataMap::value_type(k, v));
+		if (!mData.lookup(k))
+		{
+			mData[k] = v;
+		}
 	}
 	
 	void ImplMap::erase(const LLSD::String& k)
@@ -456,13 +470,8 @@ namespace
 	
 	const LLSD& ImplMap::ref(const LLSD::String& k) const
 	{
-		DataMap::const_iterator i = mData.lower_bound(k);
-		if (i == mData.end()  ||  mData.key_comp()(k, i->first))
-		{
-			return undef();
-		}
-		
-		return i->second;
+		const LLSD* value = mData.lookup(k);
+		return value ? *value : undef();
 	}
 
 	void ImplMap::dumpStats() const
@@ -501,10 +510,10 @@ namespace
 		DataVector mData;
 		
 	protected:
-		ImplArray(const DataVector& data) : mData(data) { }
+		ImplArray(const DataVector& data) : mData(data)	{ accountSize(sizeof(*this)); }
 		
 	public:
-		ImplArray() { }
+		ImplArray()										{ accountSize(sizeof(*this)); }
 		
 		ImplArray& makeArray(Impl*&) override;
 
@@ -640,20 +649,23 @@ namespace
 }
 
 LLSD::Impl::Impl()
-	: mUseCount(0)
+	: mUseCount(0),
+	  mAccountedSize(0)
 {
 	++sAllocationCount;
 	++sOutstandingCount;
 }
 
 LLSD::Impl::Impl(StaticAllocationMarker)
-	: mUseCount(0)
+	: mUseCount(0),
+	  mAccountedSize(0)
 {
 }
 
 LLSD::Impl::~Impl()
 {
 	--sOutstandingCount;
+	LLMemTag::subLocal(LLMemTag::MT_LLSD, mAccountedSize);
 }
 
 void LLSD::Impl::reset(Impl*& var, Impl* impl)
@@ -957,8 +969,8 @@ const char *LLSD::dump(const LLSD &llsd)
 	return llsd_dump(llsd, false);
 }
 
-std::map<LLSD::String, LLSD>& LLSD::map()           { return makeMap(impl).map(); }
-const std::map<LLSD::String, LLSD>& LLSD::map() const { return safe(impl).map(); }
+LLSD::map_t&                LLSD::map()             { return makeMap(impl).map(); }
+const LLSD::map_t&          LLSD::map() const       { return safe(impl).map(); }
 
 LLSD::map_iterator          LLSD::beginMap()        { return map().begin(); }
 LLSD::map_iterator          LLSD::endMap()          { return map().end(); }
@@ -34,6 +34,7 @@
 #include "stdtypes.h"
 
 #include "lldate.h"
+#include "llsdflatmap.h"
 #include "lluri.h"
 #include "lluuid.h"
 
@@ -317,11 +318,13 @@ public:
 	//@{
 		int size() const;
 
-		typedef std::map<String, LLSD>::iterator		map_iterator;
-		typedef std::map<String, LLSD>::const_iterator	map_const_iterator;
+		// Iterates by increasing key, like a std::map would.
+		typedef LLSDFlatMap<LLSD>						map_t;
+		typedef map_t::iterator							map_iterator;
+		typedef map_t::const_iterator					map_const_iterator;
 		
-		std::map<String, LLSD>& map();
-		const std::map<String, LLSD>& map() const;
+		map_t& map();
+		const map_t& map() const;
 		map_iterator		beginMap();
 		map_iterator		endMap();
 		map_const_iterator	beginMap() const;
@@ -0,0 +1,408 @@
+/**
+ * @file llsdasync.cpp
+ * @brief Parses and formats LLSD on a pool of worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llsdasync.h"
+
+#include <deque>
+#include <sstream>
+#include <vector>
+
+#include "llthread.h"
+
+namespace
+{
+struct Job
+{
+	AIThreadID							mCaller;
+	bool								mIsParse;
+	bool								mAutoDetect;
+	bool								mSuccess;
+	LLSDSerialize::ELLSD_Serialize		mType;
+	U32									mOptions;
+	std::string							mText;		// parse input or format output
+	LLSD								mData;		// parse output or format input
+	LLSDAsyncSerializer::parse_callback_t	mParseCallback;
+	LLSDAsyncSerializer::format_callback_t	mFormatCallback;
+};
+
+class Worker : public LLThread
+{
+public:
+	Worker(S32 index)
+	:	LLThread(llformat("LLSD serializer %d", index))
+	{
+	}
+
+protected:
+	/*virtual*/ void run();
+};
+
+typedef std::deque<Job*> job_queue_t;
+
+std::vector<Worker*>	sWorkers;
+LLCondition*			sQueueCondition = NULL;		// guards sQueue
+job_queue_t				sQueue;
+LLMutex*				sDoneMutex = NULL;			// guards sDone and sPending
+std::vector<Job*>		sDone;
+S32						sPending = 0;
+
+// LLSD reference counts are not atomic: give the workers a tree that
+// shares nothing with the caller's.
+LLSD deep_copy(const LLSD& value)
+{
+	switch (value.type())
+	{
+	case LLSD::TypeMap:
+	{
+		LLSD copy = LLSD::emptyMap();
+		for (LLSD::map_const_iterator it = value.beginMap(), end = value.endMap(); it != end; ++it)
+		{
+			copy.insert(it->first, deep_copy(it->second));
+		}
+		return copy;
+	}
+	case LLSD::TypeArray:
+	{
+		LLSD copy = LLSD::emptyArray();
+		for (LLSD::array_const_iterator it = value.beginArray(), end = value.endArray(); it != end; ++it)
+		{
+			copy.append(deep_copy(*it));
+		}
+		return copy;
+	}
+	case LLSD::TypeBoolean:	return LLSD(value.asBoolean());
+	case LLSD::TypeInteger:	return LLSD(value.asInteger());
+	case LLSD::TypeReal:	return LLSD(value.asReal());
+	case LLSD::TypeString:	return LLSD(value.asString());
+	case LLSD::TypeUUID:	return LLSD(value.asUUID());
+	case LLSD::TypeDate:	return LLSD(value.asDate());
+	case LLSD::TypeURI:		return LLSD(value.asURI());
+	case LLSD::TypeBinary:	return LLSD(LLSD::Binary(value.asBinary()));
+	default:				return LLSD();
+	}
+}
+}
+
+//static
+bool LLSDAsyncSerializer::parseBuffer(const std::string& buffer, LLSD& data)
+{
+	const S32 size = (S32)buffer.size();
+	std::string::size_type start = buffer.find_first_not_of(" \t\r\n");
+	if (start == std::string::npos)
+	{
+		data.clear();
+		return false;
+	}
+
+	if (!buffer.compare(start, 3, "<? "))
+	{
+		// Header written by LLSDSerialize::serialize()
+		return LLSDSerialize::deserialize(data, buffer.data(), buffer.size(), size);
+	}
+	if (buffer[start] == '<')
+	{
+		std::istringstream istr(buffer);
+		return LLSDSerialize::fromXMLDocument(data, istr) > 0;
+	}
+	// Binary and notation both open containers with the same characters;
+	// binary is the stricter of the two, so try it first.
+	if (LLSDSerialize::fromBinary(data, buffer.data(), buffer.size(), size) > 0)
+	{
+		return true;
+	}
+	return LLSDSerialize::fromNotation(data, buffer.data(), buffer.size(), size) > 0;
+}
+
+static void process_job(Job* job)
+{
+	if (job->mIsParse)
+	{
+		if (job->mAutoDetect)
+		{
+			job->mSuccess = LLSDAsyncSerializer::parseBuffer(job->mText, job->mData);
+		}
+		else
+		{
+			const std::string& text = job->mText;
+			const S32 size = (S32)text.size();
+			S32 count = LLSDParser::PARSE_FAILURE;
+			switch (job->mType)
+			{
+			case LLSDSerialize::LLSD_BINARY:
+				count = LLSDSerialize::fromBinary(job->mData, text.data(), text.size(), size);
+				break;
+			case LLSDSerialize::LLSD_XML:
+			{
+				std::istringstream istr(text);
+				count = LLSDSerialize::fromXMLDocument(job->mData, istr);
+				break;
+			}
+			case LLSDSerialize::LLSD_NOTATION:
+				count = LLSDSerialize::fromNotation(job->mData, text.data(), text.size(), size);
+				break;
+			}
+			job->mSuccess = count > 0;
+		}
+		// Free the input now rather than on the caller's thread.
+		std::string().swap(job->mText);
+	}
+	else
+	{
+		LLPointer<LLSDFormatter> formatter;
+		switch (job->mType)
+		{
+		case LLSDSerialize::LLSD_BINARY:
+			formatter = new LLSDBinaryFormatter;
+			break;
+		case LLSDSerialize::LLSD_XML:
+			formatter = new LLSDXMLFormatter;
+			break;
+		case LLSDSerialize::LLSD_NOTATION:
+			formatter = new LLSDNotationFormatter;
+			break;
+		}
+		std::ostringstream ostr;
+		job->mSuccess = formatter.notNull()
+			&& formatter->format(job->mData, ostr, job->mOptions) > 0;
+		job->mText = ostr.str();
+		job->mData.clear();
+	}
+}
+
+void Worker::run()
+{
+	while (true)
+	{
+		sQueueCondition->lock();
+		while (sQueue.empty() && !isQuitting())
+		{
+			sQueueCondition->wait();
+		}
+		if (sQueue.empty())
+		{
+			sQueueCondition->unlock();
+			break;
+		}
+		Job* job = sQueue.front();
+		sQueue.pop_front();
+		sQueueCondition->unlock();
+
+		process_job(job);
+
+		LLMutexLock lock(sDoneMutex);
+		sDone.push_back(job);
+	}
+}
+
+//static
+void LLSDAsyncSerializer::initClass(S32 thread_count)
+{
+	llassert(!sDoneMutex);
+	sQueueCondition = new LLCondition;
+	sDoneMutex = new LLMutex;
+	for (S32 i = 0; i < thread_count; ++i)
+	{
+		Worker* worker = new Worker(i);
+		sWorkers.push_back(worker);
+		worker->start();
+	}
+	LL_INFOS() << "Started " << thread_count << " LLSD serializer threads" << LL_ENDL;
+}
+
+//static
+void LLSDAsyncSerializer::cleanupClass()
+{
+	if (!sDoneMutex) return;
+
+	for (std::vector<Worker*>::iterator it = sWorkers.begin(); it != sWorkers.end(); ++it)
+	{
+		(*it)->setQuitting();
+	}
+	sQueueCondition->lock();
+	sQueueCondition->broadcast();
+	sQueueCondition->unlock();
+	for (std::vector<Worker*>::iterator it = sWorkers.begin(); it != sWorkers.end(); ++it)
+	{
+		(*it)->shutdown();
+		delete *it;
+	}
+	sWorkers.clear();
+
+	// Workers drain the queue before quitting; without any, the queue was
+	// never used.
+	for (job_queue_t::iterator it = sQueue.begin(); it != sQueue.end(); ++it)
+	{
+		delete *it;
+	}
+	sQueue.clear();
+	for (std::vector<Job*>::iterator it = sDone.begin(); it != sDone.end(); ++it)
+	{
+		delete *it;
+	}
+	sDone.clear();
+	sPending = 0;
+
+	delete sQueueCondition;
+	sQueueCondition = NULL;
+	delete sDoneMutex;
+	sDoneMutex = NULL;
+}
+
+static void queue_job(Job* job)
+{
+	if (!sDoneMutex)
+	{
+		// Not initialized: call back right away.
+		process_job(job);
+		if (job->mIsParse)
+		{
+			job->mParseCallback(job->mSuccess, job->mData);
+		}
+		else
+		{
+			job->mFormatCallback(job->mSuccess, job->mText);
+		}
+		delete job;
+		return;
+	}
+
+	{
+		LLMutexLock lock(sDoneMutex);
+		++sPending;
+	}
+
+	if (sWorkers.empty())
+	{
+		process_job(job);
+		LLMutexLock lock(sDoneMutex);
+		sDone.push_back(job);
+		return;
+	}
+
+	sQueueCondition->lock();
+	sQueue.push_back(job);
+	sQueueCondition->signal();
+	sQueueCondition->unlock();
+}
+
+//static
+void LLSDAsyncSerializer::parse(const std::string& buffer, const parse_callback_t& callback)
+{
+	Job* job = new Job;
+	job->mIsParse = true;
+	job->mAutoDetect = true;
+	job->mSuccess = false;
+	job->mType = LLSDSerialize::LLSD_XML;
+	job->mOptions = LLSDFormatter::OPTIONS_NONE;
+	job->mText = buffer;
+	job->mParseCallback = callback;
+	queue_job(job);
+}
+
+//static
+void LLSDAsyncSerializer::parse(const std::string& buffer, LLSDSerialize::ELLSD_Serialize type,
+								const parse_callback_t& callback)
+{
+	Job* job = new Job;
+	job->mIsParse = true;
+	job->mAutoDetect = false;
+	job->mSuccess = false;
+	job->mType = type;
+	job->mOptions = LLSDFormatter::OPTIONS_NONE;
+	job->mText = buffer;
+	job->mParseCallback = callback;
+	queue_job(job);
+}
+
+//static
+void LLSDAsyncSerializer::format(const LLSD& data, LLSDSerialize::ELLSD_Serialize type,
+								 const format_callback_t& callback, U32 options)
+{
+	Job* job = new Job;
+	job->mIsParse = false;
+	job->mAutoDetect = false;
+	job->mSuccess = false;
+	job->mType = type;
+	job->mOptions = options;
+	job->mData = deep_copy(data);
+	job->mFormatCallback = callback;
+	queue_job(job);
+}
+
+//static
+S32 LLSDAsyncSerializer::deliver()
+{
+	if (!sDoneMutex) return 0;
+
+	AIThreadID self;
+	std::vector<Job*> mine;
+	{
+		LLMutexLock lock(sDoneMutex);
+		if (sDone.empty()) return 0;
+
+		std::vector<Job*>::iterator out = sDone.begin();
+		for (std::vector<Job*>::iterator it = sDone.begin(); it != sDone.end(); ++it)
+		{
+			if ((*it)->mCaller == self)
+			{
+				mine.push_back(*it);
+			}
+			else
+			{
+				*out++ = *it;
+			}
+		}
+		sDone.erase(out, sDone.end());
+		sPending -= (S32)mine.size();
+	}
+
+	// Callbacks may queue new jobs, so the mutex is not held here.
+	for (std::vector<Job*>::iterator it = mine.begin(); it != mine.end(); ++it)
+	{
+		Job* job = *it;
+		if (job->mIsParse)
+		{
+			job->mParseCallback(job->mSuccess, job->mData);
+		}
+		else
+		{
+			job->mFormatCallback(job->mSuccess, job->mText);
+		}
+		delete job;
+	}
+	return (S32)mine.size();
+}
+
+//static
+S32 LLSDAsyncSerializer::getPendingCount()
+{
+	if (!sDoneMutex) return 0;
+
+	LLMutexLock lock(sDoneMutex);
+	return sPending;
+}
@@ -0,0 +1,86 @@
+/**
+ * @file llsdasync.h
+ * @brief Parses and formats LLSD on a pool of worker threads.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSDASYNC_H
+#define LL_LLSDASYNC_H
+
+#include <string>
+#include <boost/function.hpp>
+
+#include "llsd.h"
+#include "llsdserialize.h"
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLSDAsyncSerializer
+//
+//   Runs LLSDSerialize parse and format jobs on a small pool of worker
+//   threads. Callbacks are never called from a worker: each job remembers
+//   the thread that queued it, and that thread runs the callbacks of its
+//   finished jobs when it calls deliver(). The viewer does so for the main
+//   thread once per frame.
+//
+//   LLSD is not thread safe, so the data to format is deep copied before
+//   being queued, and a parsed tree is only touched by the worker until it
+//   is handed back.
+//
+//   With no worker threads, jobs run synchronously when queued but are still
+//   delivered through deliver(). Before initClass() the callback is called
+//   right away.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LL_COMMON_API LLSDAsyncSerializer
+{
+public:
+	typedef boost::function<void(bool success, const LLSD& data)> parse_callback_t;
+	typedef boost::function<void(bool success, const std::string& data)> format_callback_t;
+
+	static void initClass(S32 thread_count);
+	// Waits for the workers; undelivered results are dropped.
+	static void cleanupClass();
+
+	// Guesses the format from the buffer: an LLSDSerialize header, then
+	// XML, then binary or notation from the first character.
+	static void parse(const std::string& buffer, const parse_callback_t& callback);
+	static void parse(const std::string& buffer, LLSDSerialize::ELLSD_Serialize type,
+					  const parse_callback_t& callback);
+
+	// The result has no header, the same as the LLSDSerialize::toXXX()
+	// methods. Options are the LLSDFormatter ones.
+	static void format(const LLSD& data, LLSDSerialize::ELLSD_Serialize type,
+					   const format_callback_t& callback,
+					   U32 options = LLSDFormatter::OPTIONS_NONE);
+
+	// Calls back for the finished jobs queued by the calling thread.
+	// Returns the number of callbacks made.
+	static S32 deliver();
+
+	// Jobs queued but not delivered yet, all threads included.
+	static S32 getPendingCount();
+
+	// Synchronous equivalent of parse(buffer, callback).
+	static bool parseBuffer(const std::string& buffer, LLSD& data);
+};
+
+#endif // LL_LLSDASYNC_H
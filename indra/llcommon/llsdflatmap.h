@@ -0,0 +1,560 @@
+/**
+ * @file llsdflatmap.h
+ * @brief Sorted, hash indexed associative container used for LLSD maps.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLSDFLATMAP_H
+#define LL_LLSDFLATMAP_H
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "stdtypes.h"
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLSDFlatMap
+//
+//   The container behind LLSD maps, a replacement for std::map<std::string, V>
+//   for what LLSD and its callers use of it. Iteration goes by increasing key,
+//   as with std::map, so formatted LLSD and the code walking maps see the same
+//   order as before.
+//
+//   The entries live in chunks allocated a few at a time and never move:
+//   references to values stay valid until their entry is erased, as they did
+//   with std::map. A vector of pointers to them provides the iteration order.
+//   New entries are always appended to it and erased ones leave a NULL hole,
+//   so neither has to move the others. The vector is put back in key order,
+//   without holes, only when something iterates over the map after entries
+//   were added out of order; since serialized maps are sorted, the parsers
+//   append in order almost always. Holes are also squeezed out once they are
+//   half of the vector. Beyond SMALL_SIZE entries, lookups go through an open
+//   addressing (linear probing) table of the key hashes and their position in
+//   the vector; small maps are searched linearly.
+//
+//   Iterators are positions in the vector: inserting an entry, or erasing
+//   one, may move them to another entry. Since even const iteration may
+//   reorder the vector, a map must not be shared between threads (LLSD is
+//   not thread safe anyway).
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+template<class V>
+class LLSDFlatMap
+{
+public:
+	typedef std::string								key_type;
+	typedef V										mapped_type;
+	typedef std::pair<const std::string, V>			value_type;
+	typedef size_t									size_type;
+	typedef ptrdiff_t								difference_type;
+
+	// Maps up to this size have no hash table.
+	static const size_type SMALL_SIZE = 8;
+
+	template<bool CONST>
+	class Iterator
+	{
+	public:
+		typedef std::bidirectional_iterator_tag		iterator_category;
+		typedef typename LLSDFlatMap::value_type	value_type;
+		typedef ptrdiff_t							difference_type;
+		typedef typename std::conditional<CONST, const value_type*, value_type*>::type	pointer;
+		typedef typename std::conditional<CONST, const value_type&, value_type&>::type	reference;
+
+		Iterator() : mMap(NULL), mPos(0)						{ }
+		// iterator to const_iterator.
+		Iterator(const Iterator<false>& rhs) : mMap(rhs.mMap), mPos(rhs.mPos)	{ }
+
+		reference operator*() const								{ return *mMap->mOrder[mPos]; }
+		pointer operator->() const								{ return mMap->mOrder[mPos]; }
+
+		// Skip the holes left by erased entries.
+		Iterator& operator++()
+		{
+			mPos = mMap->skipErased(mPos + 1);
+			return *this;
+		}
+		Iterator& operator--()
+		{
+			do
+			{
+				--mPos;
+			}
+			while (mPos && !mMap->mOrder[mPos]);
+			return *this;
+		}
+		Iterator operator++(int)								{ Iterator tmp(*this); ++*this; return tmp; }
+		Iterator operator--(int)								{ Iterator tmp(*this); --*this; return tmp; }
+
+		friend bool operator==(const Iterator& a, const Iterator& b)	{ return a.mPos == b.mPos; }
+		friend bool operator!=(const Iterator& a, const Iterator& b)	{ return a.mPos != b.mPos; }
+
+	private:
+		friend class LLSDFlatMap;
+		friend class Iterator<true>;
+
+		Iterator(const LLSDFlatMap* map, size_type pos) : mMap(map), mPos(pos)	{ }
+
+		const LLSDFlatMap*	mMap;
+		size_type			mPos;
+	};
+
+	typedef Iterator<false>							iterator;
+	typedef Iterator<true>							const_iterator;
+	typedef std::reverse_iterator<iterator>			reverse_iterator;
+	typedef std::reverse_iterator<const_iterator>	const_reverse_iterator;
+
+	LLSDFlatMap() : mSorted(0), mErased(0), mChunks(NULL), mFreeList(NULL)	{ }
+	LLSDFlatMap(const LLSDFlatMap& rhs) : mSorted(0), mErased(0), mChunks(NULL), mFreeList(NULL)
+	{
+		copyFrom(rhs);
+	}
+	LLSDFlatMap(LLSDFlatMap&& rhs) : mSorted(0), mErased(0), mChunks(NULL), mFreeList(NULL)
+	{
+		swap(rhs);
+	}
+	~LLSDFlatMap()											{ clear(); }
+
+	LLSDFlatMap& operator=(const LLSDFlatMap& rhs)
+	{
+		if (this != &rhs)
+		{
+			LLSDFlatMap tmp(rhs);
+			swap(tmp);
+		}
+		return *this;
+	}
+	LLSDFlatMap& operator=(LLSDFlatMap&& rhs)
+	{
+		swap(rhs);
+		return *this;
+	}
+
+	void swap(LLSDFlatMap& rhs)
+	{
+		mOrder.swap(rhs.mOrder);
+		mIndex.swap(rhs.mIndex);
+		std::swap(mSorted, rhs.mSorted);
+		std::swap(mErased, rhs.mErased);
+		std::swap(mChunks, rhs.mChunks);
+		std::swap(mFreeList, rhs.mFreeList);
+	}
+
+	size_type size() const									{ return mOrder.size() - mErased; }
+	bool empty() const										{ return mOrder.size() == mErased; }
+
+	iterator begin()										{ sort(); return iterator(this, skipErased(0)); }
+	iterator end()											{ sort(); return iterator(this, mOrder.size()); }
+	const_iterator begin() const							{ sort(); return const_iterator(this, skipErased(0)); }
+	const_iterator end() const								{ sort(); return const_iterator(this, mOrder.size()); }
+	const_iterator cbegin() const							{ return begin(); }
+	const_iterator cend() const								{ return end(); }
+	reverse_iterator rbegin()								{ return reverse_iterator(end()); }
+	reverse_iterator rend()									{ return reverse_iterator(begin()); }
+	const_reverse_iterator rbegin() const					{ return const_reverse_iterator(end()); }
+	const_reverse_iterator rend() const						{ return const_reverse_iterator(begin()); }
+
+	iterator find(const key_type& key)						{ sort(); return iterator(this, findPos(key)); }
+	const_iterator find(const key_type& key) const			{ sort(); return const_iterator(this, findPos(key)); }
+	size_type count(const key_type& key) const				{ return findPos(key) != mOrder.size() ? 1 : 0; }
+
+	// Value of key, or NULL. Unlike find(), never sorts the map.
+	V* lookup(const key_type& key)
+	{
+		size_type pos = findPos(key);
+		return pos != mOrder.size() ? &mOrder[pos]->second : NULL;
+	}
+	const V* lookup(const key_type& key) const
+	{
+		size_type pos = findPos(key);
+		return pos != mOrder.size() ? &mOrder[pos]->second : NULL;
+	}
+
+	// Inserts V(args...) unless key is already present.
+	template<class... Args>
+	std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+	{
+		bool inserted = emplaceEntry(key, std::forward<Args>(args)...).second;
+		sort();
+		return std::make_pair(iterator(this, findPos(key)), inserted);
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value)	{ return try_emplace(value.first, value.second); }
+	std::pair<iterator, bool> emplace(const value_type& value)	{ return insert(value); }
+	std::pair<iterator, bool> emplace(const key_type& key, const V& value)
+	{
+		return try_emplace(key, value);
+	}
+
+	V& operator[](const key_type& key)						{ return emplaceEntry(key).first->second; }
+
+	size_type erase(const key_type& key)
+	{
+		size_type pos = findPos(key);
+		if (pos == mOrder.size())
+		{
+			return 0;
+		}
+		eraseAt(pos);
+		return 1;
+	}
+
+	// Returns the entry that followed it.
+	iterator erase(const_iterator it)
+	{
+		return iterator(this, skipErased(eraseAt(it.mPos)));
+	}
+
+	void clear()
+	{
+		for (value_type* entry : mOrder)
+		{
+			if (entry)
+			{
+				entry->~value_type();
+			}
+		}
+		std::vector<value_type*>().swap(mOrder);
+		std::vector<Bucket>().swap(mIndex);
+		mSorted = mErased = 0;
+		while (mChunks)
+		{
+			Chunk* next = mChunks->mNext;
+			::operator delete(mChunks);
+			mChunks = next;
+		}
+		mFreeList = NULL;
+	}
+
+private:
+	// Position in mOrder + 1 of an entry with that hash, 0 when unused.
+	struct Bucket
+	{
+		U32			mHash;
+		U32			mPos;
+	};
+
+	struct Chunk
+	{
+		Chunk*		mNext;
+		size_type	mCapacity;
+		size_type	mUsed;
+
+		value_type* entries()								{ return reinterpret_cast<value_type*>(this + 1); }
+	};
+
+	static U32 hashKey(const key_type& key)					{ return (U32)std::hash<key_type>()(key); }
+
+	static bool keyLess(const value_type* a, const value_type* b)	{ return a->first < b->first; }
+
+	size_type skipErased(size_type pos) const
+	{
+		while (pos < mOrder.size() && !mOrder[pos])
+		{
+			++pos;
+		}
+		return pos;
+	}
+
+	size_type findPos(const key_type& key) const
+	{
+		size_type count = mOrder.size();
+		if (mIndex.empty())
+		{
+			for (size_type i = 0; i < count; ++i)
+			{
+				if (mOrder[i] && mOrder[i]->first == key)
+				{
+					return i;
+				}
+			}
+			return count;
+		}
+
+		U32 hash = hashKey(key);
+		size_type mask = mIndex.size() - 1;
+		for (size_type i = hash & mask; mIndex[i].mPos; i = (i + 1) & mask)
+		{
+			const Bucket& bucket = mIndex[i];
+			if (bucket.mHash == hash && mOrder[bucket.mPos - 1]->first == key)
+			{
+				return bucket.mPos - 1;
+			}
+		}
+		return count;
+	}
+
+	// Returns the entry of key, inserting V(args...) when there is none, and
+	// whether it did. Leaves the map unsorted when the key sorts before the
+	// last one.
+	template<class... Args>
+	std::pair<value_type*, bool> emplaceEntry(const key_type& key, Args&&... args)
+	{
+		size_type pos = findPos(key);
+		if (pos != mOrder.size())
+		{
+			return std::make_pair(mOrder[pos], false);
+		}
+		value_type* entry = allocateEntry();
+		new (entry) value_type(std::piecewise_construct, std::forward_as_tuple(key),
+							   std::forward_as_tuple(std::forward<Args>(args)...));
+		link(entry);
+		return std::make_pair(entry, true);
+	}
+
+	value_type* allocateEntry()
+	{
+		if (mFreeList)
+		{
+			value_type* entry = mFreeList;
+			mFreeList = *reinterpret_cast<value_type**>(entry);
+			return entry;
+		}
+		if (!mChunks || mChunks->mUsed == mChunks->mCapacity)
+		{
+			// Grow the storage by about as much as is used already.
+			addChunk(std::max<size_type>(4, size()));
+		}
+		return mChunks->entries() + mChunks->mUsed++;
+	}
+
+	void addChunk(size_type capacity)
+	{
+		static_assert(sizeof(Chunk) % alignof(value_type) == 0, "Chunk header misaligns the entries");
+		Chunk* chunk = static_cast<Chunk*>(::operator new(sizeof(Chunk) + capacity * sizeof(value_type)));
+		chunk->mNext = mChunks;
+		chunk->mCapacity = capacity;
+		chunk->mUsed = 0;
+		mChunks = chunk;
+	}
+
+	// Appends a constructed entry to the order and adds it to the index.
+	void link(value_type* entry)
+	{
+		size_type pos = mOrder.size();
+		// The last entry is never a hole, see eraseAt().
+		if (mSorted == pos && (!pos || keyLess(mOrder.back(), entry)))
+		{
+			++mSorted;
+		}
+		mOrder.push_back(entry);
+
+		// Once built, the table is kept even if the map shrinks again.
+		if (size() > SMALL_SIZE || !mIndex.empty())
+		{
+			if (size() * 2 > mIndex.size())
+			{
+				rehash(std::max<size_type>(mIndex.size() * 2, 32));
+			}
+			else
+			{
+				index(pos, hashKey(entry->first));
+			}
+		}
+	}
+
+	// Destroys the entry at pos and returns where the entries after it now
+	// start.
+	size_type eraseAt(size_type pos)
+	{
+		value_type* entry = mOrder[pos];
+		if (!mIndex.empty())
+		{
+			unindex(pos, hashKey(entry->first));
+		}
+		mOrder[pos] = NULL;
+		++mErased;
+		entry->~value_type();
+		*reinterpret_cast<value_type**>(entry) = mFreeList;
+		mFreeList = entry;
+
+		if (empty())
+		{
+			clear();
+			return 0;
+		}
+		while (!mOrder.back())
+		{
+			mOrder.pop_back();
+			--mErased;
+		}
+		mSorted = std::min(mSorted, mOrder.size());
+		if (mErased * 2 > mOrder.size())
+		{
+			pos = compact(pos);
+			if (!mIndex.empty())
+			{
+				rehash(mIndex.size());
+			}
+		}
+		return std::min(pos, mOrder.size());
+	}
+
+	// Squeezes the holes out of mOrder, returns the new position of pos. The
+	// caller rebuilds the index.
+	size_type compact(size_type pos) const
+	{
+		size_type new_pos = 0;
+		size_type sorted = 0;
+		size_type count = 0;
+		for (size_type i = 0; i < mOrder.size(); ++i)
+		{
+			if (i == pos)
+			{
+				new_pos = count;
+			}
+			if (i == mSorted)
+			{
+				sorted = count;
+			}
+			if (mOrder[i])
+			{
+				mOrder[count++] = mOrder[i];
+			}
+		}
+		if (pos >= mOrder.size())
+		{
+			new_pos = count;
+		}
+		if (mSorted >= mOrder.size())
+		{
+			sorted = count;
+		}
+		mOrder.resize(count);
+		mSorted = sorted;
+		mErased = 0;
+		return new_pos;
+	}
+
+	// Puts mOrder back in key order, when entries were added out of order.
+	void sort() const
+	{
+		if (mSorted == mOrder.size())
+		{
+			return;
+		}
+		compact(mOrder.size());
+		std::sort(mOrder.begin() + mSorted, mOrder.end(), keyLess);
+		std::inplace_merge(mOrder.begin(), mOrder.begin() + mSorted, mOrder.end(), keyLess);
+		mSorted = mOrder.size();
+		if (!mIndex.empty())
+		{
+			rehash(mIndex.size());
+		}
+	}
+
+	void index(size_type pos, U32 hash) const
+	{
+		size_type mask = mIndex.size() - 1;
+		size_type i = hash & mask;
+		while (mIndex[i].mPos)
+		{
+			i = (i + 1) & mask;
+		}
+		mIndex[i].mHash = hash;
+		mIndex[i].mPos = (U32)pos + 1;
+	}
+
+	// Removes the bucket of pos, shifting back the buckets of the same run
+	// that would become unreachable.
+	void unindex(size_type pos, U32 hash)
+	{
+		size_type mask = mIndex.size() - 1;
+		size_type i = hash & mask;
+		while (mIndex[i].mPos != pos + 1)
+		{
+			i = (i + 1) & mask;
+		}
+		for (size_type j = (i + 1) & mask; mIndex[j].mPos; j = (j + 1) & mask)
+		{
+			// The entry in j may move to i unless its home lies in (i, j].
+			size_type home = mIndex[j].mHash & mask;
+			bool reachable = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+			if (!reachable)
+			{
+				mIndex[i] = mIndex[j];
+				i = j;
+			}
+		}
+		mIndex[i].mPos = 0;
+	}
+
+	void rehash(size_type buckets) const
+	{
+		mIndex.assign(buckets, Bucket());
+		for (size_type pos = 0; pos < mOrder.size(); ++pos)
+		{
+			if (mOrder[pos])
+			{
+				index(pos, hashKey(mOrder[pos]->first));
+			}
+		}
+	}
+
+	void copyFrom(const LLSDFlatMap& rhs)
+	{
+		if (rhs.empty())
+		{
+			return;
+		}
+		rhs.sort();
+		addChunk(rhs.size());
+		mOrder.reserve(rhs.size());
+		for (const value_type* entry : rhs.mOrder)
+		{
+			if (entry)
+			{
+				value_type* copy = mChunks->entries() + mChunks->mUsed++;
+				new (copy) value_type(*entry);
+				mOrder.push_back(copy);
+			}
+		}
+		mSorted = mOrder.size();
+		if (!rhs.mErased)
+		{
+			mIndex = rhs.mIndex;
+		}
+		else if (!rhs.mIndex.empty())
+		{
+			rehash(rhs.mIndex.size());
+		}
+	}
+
+private:
+	// Mutable because const iteration sorts them first.
+	mutable std::vector<value_type*>	mOrder;		// NULL where an entry was erased.
+	mutable std::vector<Bucket>			mIndex;		// Empty up to SMALL_SIZE entries.
+	mutable size_type					mSorted;	// Leading entries of mOrder in key order.
+	mutable size_type					mErased;	// Holes in mOrder.
+	Chunk*								mChunks;	// Last allocated first.
+	value_type*							mFreeList;	// Erased entries, linked through their storage.
+};
+
+#endif // LL_LLSDFLATMAP_H
@@ -193,6 +193,46 @@ fail:
 	return false;
 }
 
+// static
+bool LLSDSerialize::deserialize(LLSD& sd, const char* buffer, size_t size, S32 max_bytes)
+{
+	// The same header as above. Only binary and notation have a buffer
+	// parser, anything else goes through the stream version.
+	size_t hdr_len = 0;
+	while (hdr_len < size && hdr_len < MAX_HDR_LEN - 1 && buffer[hdr_len] != '\n')
+	{
+		++hdr_len;
+	}
+	std::string header(buffer, hdr_len);
+	header = header.substr(0, header.find_first_of(std::string("\r\n\0", 3)));
+
+	std::string::size_type start = header.find_first_not_of("<? ");
+	std::string::size_type end = std::string::npos;
+	if (start != std::string::npos)
+	{
+		end = header.find_first_of(" ?", start);
+	}
+	if ((start != std::string::npos) && (end != std::string::npos))
+	{
+		header = header.substr(start, end - start);
+		if ((header == LLSD_BINARY_HEADER) || (header == LLSD_NOTATION_HEADER))
+		{
+			size_t pos = hdr_len;
+			while (pos < size && isspace((unsigned char)buffer[pos]))
+			{
+				++pos;
+			}
+			LLSDBufferParser p(header == LLSD_BINARY_HEADER ? LLSDBufferParser::BINARY
+															: LLSDBufferParser::NOTATION);
+			p.parse(buffer + pos, size - pos, sd, max_bytes);
+			return true;
+		}
+	}
+
+	std::istringstream str(std::string(buffer, size));
+	return deserialize(sd, str, max_bytes);
+}
+
 /**
  * Endian handlers
  */
@@ -1229,6 +1269,357 @@ bool LLSDBinaryParser::parseString(
 }
 
 
+/**
+ * LLSDBinaryPullParser
+ */
+LLSDBinaryPullParser::LLSDBinaryPullParser(std::istream& istr, S32 max_bytes) :
+	mStream(istr),
+	mMaxBytesLeft(max_bytes),
+	mCheckLimits(max_bytes != LLSDSerialize::SIZE_UNLIMITED),
+	mStarted(false),
+	mEvent(EV_END_OF_DOCUMENT),
+	mSize(0)
+{
+}
+
+LLSDBinaryPullParser::EEvent LLSDBinaryPullParser::fail()
+{
+	mStack.clear();
+	mKey.clear();
+	mValue.clear();
+	mEvent = EV_ERROR;
+	return mEvent;
+}
+
+bool LLSDBinaryPullParser::read(char* buffer, S32 bytes)
+{
+	if(mCheckLimits && (bytes > mMaxBytesLeft))
+	{
+		return false;
+	}
+	S32 count = (S32)fullread(mStream, buffer, bytes);
+	if(mCheckLimits) mMaxBytesLeft -= count;
+	return count == bytes && !mStream.fail();
+}
+
+bool LLSDBinaryPullParser::readSize(S32& size)
+{
+	U32 size_nbo = 0;
+	if(!read((char*)&size_nbo, sizeof(U32)))
+	{
+		return false;
+	}
+	size = (S32)ntohl(size_nbo); // Can return negative size if > 2^31.
+	return size >= 0 && !(mCheckLimits && (size > mMaxBytesLeft));
+}
+
+bool LLSDBinaryPullParser::readString(std::string& value)
+{
+	S32 size = 0;
+	if(!readSize(size))
+	{
+		return false;
+	}
+	value.resize(size);
+	return !size || read(&value[0], size);
+}
+
+LLSDBinaryPullParser::EEvent LLSDBinaryPullParser::next()
+{
+	if(mEvent == EV_ERROR || (mStarted && mStack.empty()))
+	{
+		mEvent = mEvent == EV_ERROR ? EV_ERROR : EV_END_OF_DOCUMENT;
+		return mEvent;
+	}
+
+	mKey.clear();
+	mValue.clear();
+	mSize = 0;
+
+	char c = 0;
+	if(mStack.empty())
+	{
+		// The document element
+		mStarted = true;
+		if(!read(&c, 1))
+		{
+			mEvent = EV_END_OF_DOCUMENT;
+			return mEvent;
+		}
+		return readElement(c);
+	}
+
+	if(!read(&c, 1))
+	{
+		return fail();
+	}
+
+	Frame& frame = mStack.back();
+	const char end_marker = frame.mIsMap ? '}' : ']';
+	if(c == end_marker)
+	{
+		if(frame.mCount < frame.mSize)
+		{
+			// Fewer children than were said to be there.
+			return fail();
+		}
+		mEvent = frame.mIsMap ? EV_MAP_END : EV_ARRAY_END;
+		mStack.pop_back();
+		return mEvent;
+	}
+	if(frame.mCount >= frame.mSize)
+	{
+		return fail();
+	}
+	++frame.mCount;
+
+	if(frame.mIsMap)
+	{
+		switch(c)
+		{
+		case 'k':
+			if(!readString(mKey))
+			{
+				return fail();
+			}
+			break;
+		case '\'':
+		case '"':
+		{
+			int cnt = deserialize_string_delim(mStream, mKey, c);
+			if(LLSDParser::PARSE_FAILURE == cnt)
+			{
+				return fail();
+			}
+			if(mCheckLimits) mMaxBytesLeft -= cnt;
+			break;
+		}
+		default:
+			return fail();
+		}
+		if(!read(&c, 1))
+		{
+			return fail();
+		}
+	}
+	return readElement(c);
+}
+
+LLSDBinaryPullParser::EEvent LLSDBinaryPullParser::readElement(char c)
+{
+	// Same encoding as LLSDBinaryParser::doParse()
+	switch(c)
+	{
+	case '{':
+	case '[':
+	{
+		S32 size = 0;
+		if(!readSize(size))
+		{
+			return fail();
+		}
+		Frame frame;
+		frame.mIsMap = (c == '{');
+		frame.mSize = size;
+		frame.mCount = 0;
+		mStack.push_back(frame);
+		mSize = size;
+		mEvent = frame.mIsMap ? EV_MAP_BEGIN : EV_ARRAY_BEGIN;
+		return mEvent;
+	}
+
+	case '!':
+		break;
+
+	case '0':
+		mValue = false;
+		break;
+
+	case '1':
+		mValue = true;
+		break;
+
+	case 'i':
+	{
+		U32 value_nbo = 0;
+		if(!read((char*)&value_nbo, sizeof(U32)))
+		{
+			return fail();
+		}
+		mValue = (S32)ntohl(value_nbo);
+		break;
+	}
+
+	case 'r':
+	{
+		F64 real_nbo = 0.0;
+		if(!read((char*)&real_nbo, sizeof(F64)))
+		{
+			return fail();
+		}
+		mValue = ll_ntohd(real_nbo);
+		break;
+	}
+
+	case 'u':
+	{
+		LLUUID id;
+		if(!read((char*)(&id.mData), UUID_BYTES))
+		{
+			return fail();
+		}
+		mValue = id;
+		break;
+	}
+
+	case '\'':
+	case '"':
+	{
+		std::string value;
+		int cnt = deserialize_string_delim(mStream, value, c);
+		if(LLSDParser::PARSE_FAILURE == cnt || mStream.fail())
+		{
+			return fail();
+		}
+		if(mCheckLimits) mMaxBytesLeft -= cnt;
+		mValue = value;
+		break;
+	}
+
+	case 's':
+	case 'l':
+	{
+		std::string value;
+		if(!readString(value))
+		{
+			return fail();
+		}
+		if(c == 's')
+		{
+			mValue = value;
+		}
+		else
+		{
+			mValue = LLURI(value);
+		}
+		break;
+	}
+
+	case 'd':
+	{
+		F64 real = 0.0;
+		if(!read((char*)&real, sizeof(F64)))
+		{
+			return fail();
+		}
+		mValue = LLDate(real);
+		break;
+	}
+
+	case 'b':
+	{
+		S32 size = 0;
+		if(!readSize(size))
+		{
+			return fail();
+		}
+		std::vector<U8> value(size);
+		if(size && !read((char*)&value[0], size))
+		{
+			return fail();
+		}
+		mValue = value;
+		break;
+	}
+
+	default:
+		LL_INFOS() << "Unrecognized character while pull parsing: int(" << (int)c
+			<< ")" << LL_ENDL;
+		return fail();
+	}
+	mEvent = EV_VALUE;
+	return mEvent;
+}
+
+bool LLSDBinaryPullParser::readValue(LLSD& value)
+{
+	switch(mEvent)
+	{
+	case EV_VALUE:
+		value = mValue;
+		return true;
+
+	case EV_MAP_BEGIN:
+		value = LLSD::emptyMap();
+		while(true)
+		{
+			EEvent event = next();
+			if(event == EV_MAP_END)
+			{
+				return true;
+			}
+			if(event <= EV_END_OF_DOCUMENT)
+			{
+				break;
+			}
+			// Nested containers consume their own end event.
+			std::string key(mKey);
+			LLSD child;
+			if(!readValue(child))
+			{
+				break;
+			}
+			value.insert(key, child);
+		}
+		break;
+
+	case EV_ARRAY_BEGIN:
+		value = LLSD::emptyArray();
+		while(true)
+		{
+			EEvent event = next();
+			if(event == EV_ARRAY_END)
+			{
+				return true;
+			}
+			if(event <= EV_END_OF_DOCUMENT)
+			{
+				break;
+			}
+			LLSD child;
+			if(!readValue(child))
+			{
+				break;
+			}
+			value.append(child);
+		}
+		break;
+
+	default:
+		break;
+	}
+	value.clear();
+	return false;
+}
+
+bool LLSDBinaryPullParser::skip()
+{
+	if(mEvent != EV_MAP_BEGIN && mEvent != EV_ARRAY_BEGIN)
+	{
+		return mEvent != EV_ERROR;
+	}
+	const S32 depth = getDepth();
+	while(getDepth() >= depth)
+	{
+		if(next() <= EV_END_OF_DOCUMENT)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+
 /**
  * LLSDFormatter
  */
@@ -2133,9 +2524,19 @@ std::string zip_llsd(LLSD& data)
 
 // <alchemy>
 //decompress a block of LLSD from provided istream
-// not very efficient -- creats a copy of decompressed LLSD block in memory
-// and deserializes from that copy using LLSDSerialize
 bool unzip_llsd(LLSD& data, std::istream& is, S32 size)
+{
+	U8 *in = new U8[size];
+	is.read((char*) in, size); 
+
+	bool result = unzip_llsd(data, in, size);
+	delete [] in;
+	return result;
+}
+
+//decompress a block of LLSD held in memory; the decompressed copy is
+//parsed in place by LLSDBufferParser
+bool unzip_llsd(LLSD& data, const U8* in, S32 size)
 {
 	U8* result = NULL;
 	U32 cur_size = 0;
@@ -2143,16 +2544,13 @@ bool unzip_llsd(LLSD& data, std::istream& is, S32 size)
 		
 	const U32 CHUNK = 65536;
 
-	U8 *in = new U8[size];
-	is.read((char*) in, size); 
-
 	U8 out[CHUNK];
 		
 	strm.zalloc = Z_NULL;
 	strm.zfree = Z_NULL;
 	strm.opaque = Z_NULL;
 	strm.avail_in = size;
-	strm.next_in = in;
+	strm.next_in = const_cast<U8*>(in);
 
 	S32 ret = inflateInit(&strm);
 	
@@ -2171,7 +2569,6 @@ bool unzip_llsd(LLSD& data, std::istream& is, S32 size)
 		case Z_STREAM_ERROR:
 			inflateEnd(&strm);
 			free(result);
-			delete [] in;
 			return false;
 			break;
 		}
@@ -2187,7 +2584,6 @@ bool unzip_llsd(LLSD& data, std::istream& is, S32 size)
 			{
 				free(result);
 			}
-			delete in;
 			return false;
 		}
 		result = new_result;
@@ -2197,7 +2593,6 @@ bool unzip_llsd(LLSD& data, std::istream& is, S32 size)
 	} while (ret == Z_OK);
 
 	inflateEnd(&strm);
-	delete [] in;
 
 	if (ret != Z_STREAM_END)
 	{
@@ -2205,21 +2600,23 @@ bool unzip_llsd(LLSD& data, std::istream& is, S32 size)
 		return false;
 	}
 
-	//result now points to the decompressed LLSD block
+	//result now points to the decompressed LLSD block, parse it in place
 	{
-		std::string res_str((char*) result, cur_size);
+		const char* res = (const char*)result;
+		size_t res_size = cur_size;
 
-		std::string deprecated_header("<? LLSD/Binary ?>");
+		static const char deprecated_header[] = "<? LLSD/Binary ?>";
+		const size_t header_size = sizeof(deprecated_header) - 1;
 
-		if (res_str.substr(0, deprecated_header.size()) == deprecated_header)
+		if (res_size >= header_size && !memcmp(res, deprecated_header, header_size))
 		{
-			res_str = res_str.substr(deprecated_header.size()+1, cur_size);
+			// Skip the header and the newline after it.
+			const size_t skip = llmin(header_size + 1, res_size);
+			res += skip;
+			res_size -= skip;
 		}
-		cur_size = res_str.size();
 
-		std::istringstream istr(res_str);
-		
-		if (!LLSDSerialize::fromBinary(data, istr, cur_size))
+		if (!LLSDSerialize::fromBinary(data, res, res_size, (S32)res_size))
 		{
 			LL_WARNS() << "Failed to unzip LLSD block" << LL_ENDL;
 			free(result);
@@ -30,6 +30,7 @@
 #define LL_LLSDSERIALIZE_H
 
 #include <iosfwd>
+#include <vector>
 #include "llpointer.h"
 #include "llrefcount.h"
 #include "llsd.h"
@@ -396,6 +397,179 @@ private:
 	bool parseString(std::istream& istr, std::string& value) const;
 };
 
+/** 
+ * @class LLSDBinaryPullParser
+ * @brief Streaming parser for binary formatted LLSD.
+ *
+ * Instead of building the whole tree, the caller pulls one event at a
+ * time: the start and end of every map and array, and every scalar
+ * together with its map key. Subtrees of interest can be materialized
+ * with readValue() and the rest stepped over with skip(), so a large
+ * cache can be consumed without holding all of it in memory.
+ *
+ * <code>
+ *  LLSDBinaryPullParser parser(istr, LLSDSerialize::SIZE_UNLIMITED);
+ *  while (parser.next() > LLSDBinaryPullParser::EV_END_OF_DOCUMENT)
+ *  {
+ *      if (parser.getDepth() == 1 && parser.getKey() == "wanted")
+ *      {
+ *          parser.readValue(wanted);
+ *      }
+ *  }
+ * </code>
+ */
+class LL_COMMON_API LLSDBinaryPullParser
+{
+public:
+	enum EEvent
+	{
+		EV_ERROR = -1,
+		EV_END_OF_DOCUMENT = 0,
+		EV_MAP_BEGIN,
+		EV_MAP_END,
+		EV_ARRAY_BEGIN,
+		EV_ARRAY_END,
+		EV_VALUE
+	};
+
+	/** 
+	 * @brief Constructor
+	 *
+	 * @param istr The input stream, positioned after any header.
+	 * @param max_bytes The maximum number of bytes to read, or
+	 * LLSDSerialize::SIZE_UNLIMITED.
+	 */
+	LLSDBinaryPullParser(std::istream& istr, S32 max_bytes);
+
+	/** 
+	 * @brief Reads the next event from the stream.
+	 *
+	 * Once EV_ERROR or EV_END_OF_DOCUMENT was returned, further calls
+	 * keep returning it.
+	 */
+	EEvent next();
+
+	EEvent getEvent() const				{ return mEvent; }
+	// Key of the current value or container when its parent is a map.
+	const std::string& getKey() const	{ return mKey; }
+	// The scalar of an EV_VALUE event.
+	const LLSD& getValue() const		{ return mValue; }
+	// Declared child count of an EV_MAP_BEGIN or EV_ARRAY_BEGIN event.
+	S32 getSize() const					{ return mSize; }
+	// Number of maps and arrays currently open.
+	S32 getDepth() const				{ return (S32)mStack.size(); }
+
+	/** 
+	 * @brief Materializes the current event.
+	 *
+	 * On EV_VALUE this copies getValue(). On EV_MAP_BEGIN or
+	 * EV_ARRAY_BEGIN this parses the container up to and including its
+	 * end event.
+	 * @param value[out] The parsed value.
+	 * @return Returns false on parse failure.
+	 */
+	bool readValue(LLSD& value);
+
+	/** 
+	 * @brief Steps over the container just begun. Does nothing on a
+	 * scalar.
+	 * @return Returns false on parse failure.
+	 */
+	bool skip();
+
+private:
+	struct Frame
+	{
+		bool	mIsMap;
+		S32		mSize;
+		S32		mCount;
+	};
+
+	EEvent fail();
+	bool read(char* buffer, S32 bytes);
+	bool readSize(S32& size);
+	bool readString(std::string& value);
+	EEvent readElement(char c);
+
+	std::istream&		mStream;
+	S32					mMaxBytesLeft;
+	bool				mCheckLimits;
+	bool				mStarted;
+	EEvent				mEvent;
+	std::string			mKey;
+	LLSD				mValue;
+	S32					mSize;
+	std::vector<Frame>	mStack;
+};
+
+
+/** 
+ * @class LLSDBufferParser
+ * @brief Binary and notation parser for LLSD held in contiguous memory.
+ *
+ * Gives the same results as LLSDBinaryParser and LLSDNotationParser, but
+ * walks a pointer over the buffer instead of pulling the data out of a
+ * std::istream one character at a time. Strings are scanned sixteen bytes
+ * at a time for their delimiter and escapes, string and binary values are
+ * copied out in one go, and integer, real and UUID tokens are converted in
+ * place with the stream extraction operators only as a fallback for the
+ * unusual spellings.
+ *
+ * Parsing never reads past the end of the buffer nor past max_bytes.
+ */
+class LL_COMMON_API LLSDBufferParser
+{
+public:
+	enum EFormat
+	{
+		BINARY,
+		NOTATION
+	};
+
+	LLSDBufferParser(EFormat format);
+
+	/** 
+	 * @brief Parses one structured data object out of the buffer.
+	 *
+	 * @param buffer The data, positioned after any header.
+	 * @param size The number of bytes in buffer.
+	 * @param data[out] The newly parsed structured data.
+	 * @param max_bytes The maximum number of bytes to read, or
+	 * LLSDSerialize::SIZE_UNLIMITED.
+	 * @return Returns the number of LLSD objects parsed into data, like
+	 * LLSDParser::parse(). Returns PARSE_FAILURE (-1) on parse failure.
+	 */
+	S32 parse(const char* buffer, size_t size, LLSD& data, S32 max_bytes);
+
+	// Bytes consumed by the last parse().
+	size_t getBytesRead() const		{ return mPos - mBegin; }
+
+private:
+	S32 parseBinary(LLSD& data);
+	S32 parseBinaryMap(LLSD& map);
+	S32 parseBinaryArray(LLSD& array);
+	bool readBinaryString(std::string& value);
+
+	S32 parseNotation(LLSD& data);
+	S32 parseNotationMap(LLSD& map);
+	S32 parseNotationArray(LLSD& array);
+	bool parseNotationString(std::string& value);
+	bool parseNotationRawString(std::string& value);
+	bool parseNotationBinary(LLSD& data);
+	bool parseNotationBoolean(const char* rest, bool value, LLSD& data);
+	bool parseNotationInteger(LLSD& data);
+	bool parseNotationReal(LLSD& data);
+	bool parseNotationUUID(LLSD& data);
+
+	bool parseDelimitedString(char delim, std::string& value);
+	bool read(void* dest, size_t bytes);
+
+	EFormat		mFormat;
+	const char*	mBegin;
+	const char*	mPos;
+	const char*	mEnd;
+};
+
 
 /** 
  * @class LLSDFormatter
@@ -723,6 +897,8 @@ public:
 	 * @return Returns true if the stream appears to contain valid data
 	 */
 	static bool deserialize(LLSD& sd, std::istream& str, S32 max_bytes);
+	// Same as above, for data held in memory.
+	static bool deserialize(LLSD& sd, const char* buffer, size_t size, S32 max_bytes);
 
 	/*
 	 * Notation Methods
@@ -756,6 +932,11 @@ public:
 		(void)p->parse(str, sd, max_bytes);
 		return sd;
 	}
+	static S32 fromNotation(LLSD& sd, const char* buffer, size_t size, S32 max_bytes)
+	{
+		LLSDBufferParser p(LLSDBufferParser::NOTATION);
+		return p.parse(buffer, size, sd, max_bytes);
+	}
 	
 	/*
 	 * XML Methods
@@ -812,10 +993,16 @@ public:
 		(void)p->parse(str, sd, max_bytes);
 		return sd;
 	}
+	static S32 fromBinary(LLSD& sd, const char* buffer, size_t size, S32 max_bytes)
+	{
+		LLSDBufferParser p(LLSDBufferParser::BINARY);
+		return p.parse(buffer, size, sd, max_bytes);
+	}
 };
 
 //dirty little zip functions -- yell at davep
 LL_COMMON_API std::string zip_llsd(LLSD& data);
 LL_COMMON_API bool unzip_llsd(LLSD& data, std::istream& is, S32 size);
+LL_COMMON_API bool unzip_llsd(LLSD& data, const U8* in, S32 size);
 LL_COMMON_API U8* unzip_llsdNavMesh( bool& valid, unsigned int& outsize,std::istream& is, S32 size);
 #endif // LL_LLSDSERIALIZE_H
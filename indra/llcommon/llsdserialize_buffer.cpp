@@ -0,0 +1,1044 @@
+/**
+ * @file llsdserialize_buffer.cpp
+ * @brief LLSD binary and notation parser over contiguous memory.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+#include "llsdserialize.h"
+#include "llbase64.h"
+
+#include <sstream>
+
+#if !LL_WINDOWS
+#include <netinet/in.h> // ntohl
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LL_SD_SCAN_SSE2 1
+#include <emmintrin.h>
+#if LL_WINDOWS
+#include <intrin.h>
+#endif
+#else
+#define LL_SD_SCAN_SSE2 0
+#endif
+
+#include "lldate.h"
+#include "llsd.h"
+#include "llstring.h"
+#include "lluri.h"
+
+// Defined in llsdserialize.cpp
+F64 ll_ntohd(F64 netdouble);
+
+namespace
+{
+// The character classes of the "C" locale, which is what the stream
+// parsers see through std::istringstream.
+inline bool is_space(char c)
+{
+	return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline bool is_digit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+inline bool is_alpha(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+inline char to_lower(char c)
+{
+	return (c >= 'A' && c <= 'Z') ? c + ('a' - 'A') : c;
+}
+
+#if LL_SD_SCAN_SSE2
+inline U32 first_set_bit(U32 mask)
+{
+#if LL_WINDOWS
+	unsigned long index;
+	_BitScanForward(&index, mask);
+	return (U32)index;
+#else
+	return (U32)__builtin_ctz(mask);
+#endif
+}
+#endif
+
+// Returns the first delim or backslash in [p, end), or end.
+const char* find_delimiter(const char* p, const char* end, char delim)
+{
+#if LL_SD_SCAN_SSE2
+	const __m128i delims = _mm_set1_epi8(delim);
+	const __m128i escapes = _mm_set1_epi8('\\');
+	while (end - p >= 16)
+	{
+		const __m128i chunk = _mm_loadu_si128((const __m128i*)p);
+		const U32 mask = (U32)_mm_movemask_epi8(
+			_mm_or_si128(_mm_cmpeq_epi8(chunk, delims),
+						 _mm_cmpeq_epi8(chunk, escapes)));
+		if (mask)
+		{
+			return p + first_set_bit(mask);
+		}
+		p += 16;
+	}
+#endif
+	while (p < end && *p != delim && *p != '\\')
+	{
+		++p;
+	}
+	return p;
+}
+
+inline bool is_hex(char c)
+{
+	return is_digit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+const F64 POWERS_OF_TEN[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+}
+
+/**
+ * LLSDBufferParser
+ */
+LLSDBufferParser::LLSDBufferParser(EFormat format) :
+	mFormat(format),
+	mBegin(NULL),
+	mPos(NULL),
+	mEnd(NULL)
+{
+}
+
+S32 LLSDBufferParser::parse(const char* buffer, size_t size, LLSD& data, S32 max_bytes)
+{
+	if (max_bytes >= 0 && (size_t)max_bytes < size)
+	{
+		size = (size_t)max_bytes;
+	}
+	mBegin = mPos = buffer;
+	mEnd = buffer + size;
+
+	S32 parse_count = (mFormat == BINARY) ? parseBinary(data) : parseNotation(data);
+	if (LLSDParser::PARSE_FAILURE == parse_count)
+	{
+		LL_INFOS() << "LLSD parse failure at byte " << getBytesRead() << " of "
+			<< size << LL_ENDL;
+	}
+	return parse_count;
+}
+
+bool LLSDBufferParser::read(void* dest, size_t bytes)
+{
+	if ((size_t)(mEnd - mPos) < bytes)
+	{
+		mPos = mEnd;
+		return false;
+	}
+	memcpy(dest, mPos, bytes);	/* Flawfinder: ignore */
+	mPos += bytes;
+	return true;
+}
+
+bool LLSDBufferParser::parseDelimitedString(char delim, std::string& value)
+{
+	value.clear();
+	while (true)
+	{
+		const char* stop = find_delimiter(mPos, mEnd, delim);
+		value.append(mPos, stop);
+		mPos = stop;
+		if (mPos >= mEnd)
+		{
+			return false;
+		}
+
+		// The escape test comes first, like in deserialize_string_delim(),
+		// so a backslash delimiter never ends the string.
+		if (*mPos++ != '\\')
+		{
+			return true;
+		}
+		if (mPos >= mEnd)
+		{
+			return false;
+		}
+
+		char c = *mPos++;
+		if (c == 'x')
+		{
+			if (mEnd - mPos < 2)
+			{
+				mPos = mEnd;
+				return false;
+			}
+			U8 byte = hex_as_nybble(mPos[0]) << 4;
+			byte |= hex_as_nybble(mPos[1]);
+			mPos += 2;
+			value += (char)byte;
+			continue;
+		}
+		switch (c)
+		{
+		case 'a':	value += '\a';	break;
+		case 'b':	value += '\b';	break;
+		case 'f':	value += '\f';	break;
+		case 'n':	value += '\n';	break;
+		case 'r':	value += '\r';	break;
+		case 't':	value += '\t';	break;
+		case 'v':	value += '\v';	break;
+		default:	value += c;		break;
+		}
+	}
+}
+
+/**
+ * Binary format, see LLSDBinaryParser::doParse()
+ */
+S32 LLSDBufferParser::parseBinary(LLSD& data)
+{
+	if (mPos >= mEnd)
+	{
+		return 0;
+	}
+	const char c = *mPos++;
+	S32 parse_count = 1;
+	switch (c)
+	{
+	case '{':
+	case '[':
+	{
+		S32 child_count = (c == '{') ? parseBinaryMap(data) : parseBinaryArray(data);
+		if (LLSDParser::PARSE_FAILURE == child_count)
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		else
+		{
+			parse_count += child_count;
+		}
+		break;
+	}
+
+	case '!':
+		data.clear();
+		break;
+
+	case '0':
+		data = false;
+		break;
+
+	case '1':
+		data = true;
+		break;
+
+	case 'i':
+	{
+		U32 value_nbo = 0;
+		if (read(&value_nbo, sizeof(U32)))
+		{
+			data = (S32)ntohl(value_nbo);
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'r':
+	{
+		F64 real_nbo = 0.0;
+		if (read(&real_nbo, sizeof(F64)))
+		{
+			data = ll_ntohd(real_nbo);
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'u':
+	{
+		LLUUID id;
+		if (read(id.mData, UUID_BYTES))
+		{
+			data = id;
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case '\'':
+	case '"':
+	case 's':
+	case 'l':
+	{
+		std::string value;
+		bool ok = (c == '\'' || c == '"') ? parseDelimitedString(c, value)
+										  : readBinaryString(value);
+		if (!ok)
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		else if (c == 'l')
+		{
+			data = LLURI(value);
+		}
+		else
+		{
+			data = value;
+		}
+		break;
+	}
+
+	case 'd':
+	{
+		// Dates are not byte swapped.
+		F64 real = 0.0;
+		if (read(&real, sizeof(F64)))
+		{
+			data = LLDate(real);
+		}
+		else
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		break;
+	}
+
+	case 'b':
+	{
+		U32 size_nbo = 0;
+		S32 size = -1;
+		if (read(&size_nbo, sizeof(U32)))
+		{
+			size = (S32)ntohl(size_nbo); // Can return negative size if > 2^31.
+		}
+		if (size < 0 || (size_t)size > (size_t)(mEnd - mPos))
+		{
+			parse_count = LLSDParser::PARSE_FAILURE;
+		}
+		else
+		{
+			data = LLSD::Binary((const U8*)mPos, (const U8*)mPos + size);
+			mPos += size;
+		}
+		break;
+	}
+
+	default:
+		parse_count = LLSDParser::PARSE_FAILURE;
+		LL_INFOS() << "Unrecognized character while parsing: int(" << (int)c
+			<< ")" << LL_ENDL;
+		break;
+	}
+	if (LLSDParser::PARSE_FAILURE == parse_count)
+	{
+		data.clear();
+	}
+	return parse_count;
+}
+
+S32 LLSDBufferParser::parseBinaryMap(LLSD& map)
+{
+	map = LLSD::emptyMap();
+	U32 value_nbo = 0;
+	if (!read(&value_nbo, sizeof(U32)))
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	S32 size = (S32)ntohl(value_nbo);  // Can return negative size if > 2^31.
+	if (size < 0 || mPos >= mEnd)
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	S32 parse_count = 0;
+	S32 count = 0;
+	char c = *mPos++;
+	std::string name;
+	while (c != '}' && count < size)
+	{
+		name.clear();
+		switch (c)
+		{
+		case 'k':
+			if (!readBinaryString(name))
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+			break;
+		case '\'':
+		case '"':
+			if (!parseDelimitedString(c, name))
+			{
+				return LLSDParser::PARSE_FAILURE;
+			}
+			break;
+		}
+		LLSD child;
+		S32 child_count = parseBinary(child);
+		if (child_count <= 0)
+		{
+			// There must be a value for every key.
+			return LLSDParser::PARSE_FAILURE;
+		}
+		parse_count += child_count;
+		map.insert(name, child);
+		++count;
+		if (mPos >= mEnd)
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+		c = *mPos++;
+	}
+	if ((c != '}') || (count < size))
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	return parse_count;
+}
+
+S32 LLSDBufferParser::parseBinaryArray(LLSD& array)
+{
+	array = LLSD::emptyArray();
+	U32 value_nbo = 0;
+	if (!read(&value_nbo, sizeof(U32)))
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	S32 size = (S32)ntohl(value_nbo); // Can return negative size if > 2^31.
+	if (size < 0)
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	S32 parse_count = 0;
+	S32 count = 0;
+	while (mPos < mEnd && *mPos != ']' && count < size)
+	{
+		LLSD child;
+		S32 child_count = parseBinary(child);
+		if (LLSDParser::PARSE_FAILURE == child_count)
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+		parse_count += child_count;
+		array.append(child);
+		++count;
+	}
+	if (mPos >= mEnd || *mPos++ != ']' || count < size)
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	return parse_count;
+}
+
+bool LLSDBufferParser::readBinaryString(std::string& value)
+{
+	U32 value_nbo = 0;
+	if (!read(&value_nbo, sizeof(U32)))
+	{
+		return false;
+	}
+	S32 size = (S32)ntohl(value_nbo); // Can return negative size if > 2^31.
+	if (size < 0 || (size_t)size > (size_t)(mEnd - mPos))
+	{
+		return false;
+	}
+	value.assign(mPos, size);
+	mPos += size;
+	return true;
+}
+
+/**
+ * Notation format, see LLSDNotationParser::doParse()
+ */
+S32 LLSDBufferParser::parseNotation(LLSD& data)
+{
+	while (mPos < mEnd && is_space(*mPos))
+	{
+		++mPos;
+	}
+	if (mPos >= mEnd)
+	{
+		return 0;
+	}
+	const char c = *mPos;
+	S32 parse_count = 1;
+	bool ok = true;
+	switch (c)
+	{
+	case '{':
+	case '[':
+	{
+		S32 child_count = (c == '{') ? parseNotationMap(data) : parseNotationArray(data);
+		if (LLSDParser::PARSE_FAILURE == child_count)
+		{
+			ok = false;
+		}
+		else
+		{
+			parse_count += child_count;
+		}
+		break;
+	}
+
+	case '!':
+		++mPos;
+		data.clear();
+		break;
+
+	case '0':
+		++mPos;
+		data = false;
+		break;
+
+	case '1':
+		++mPos;
+		data = true;
+		break;
+
+	case 'F':
+	case 'f':
+		++mPos;
+		ok = parseNotationBoolean("alse", false, data);
+		break;
+
+	case 'T':
+	case 't':
+		++mPos;
+		ok = parseNotationBoolean("rue", true, data);
+		break;
+
+	case 'i':
+		++mPos;
+		ok = parseNotationInteger(data);
+		break;
+
+	case 'r':
+		++mPos;
+		ok = parseNotationReal(data);
+		break;
+
+	case 'u':
+		++mPos;
+		ok = parseNotationUUID(data);
+		break;
+
+	case '"':
+	case '\'':
+	case 's':
+	{
+		std::string value;
+		ok = parseNotationString(value);
+		if (ok)
+		{
+			data = value;
+		}
+		break;
+	}
+
+	case 'l':
+	case 'd':
+	{
+		// The character after the type is the delimiter, whatever it is.
+		++mPos;
+		std::string value;
+		ok = mPos < mEnd;
+		if (ok)
+		{
+			const char delim = *mPos++;
+			ok = parseDelimitedString(delim, value);
+		}
+		if (!ok)
+		{
+			break;
+		}
+		if (c == 'l')
+		{
+			data = LLURI(value);
+		}
+		else
+		{
+			data = LLDate(value);
+		}
+		break;
+	}
+
+	case 'b':
+		ok = parseNotationBinary(data);
+		break;
+
+	default:
+		ok = false;
+		LL_INFOS() << "Unrecognized character while parsing: int(" << (int)c
+			<< ")" << LL_ENDL;
+		break;
+	}
+	if (!ok)
+	{
+		data.clear();
+		parse_count = LLSDParser::PARSE_FAILURE;
+	}
+	return parse_count;
+}
+
+S32 LLSDBufferParser::parseNotationMap(LLSD& map)
+{
+	// map: { string:object, string:object }
+	// Like the stream parser, anything but a key is skipped while looking
+	// for one, and whitespace and colons between a key and its value.
+	map = LLSD::emptyMap();
+	++mPos;
+	S32 parse_count = 0;
+	bool found_name = false;
+	std::string name;
+	while (mPos < mEnd && *mPos != '}')
+	{
+		const char c = *mPos;
+		if (!found_name)
+		{
+			if ((c == '"') || (c == '\'') || (c == 's'))
+			{
+				found_name = true;
+				if (!parseNotationString(name))
+				{
+					return LLSDParser::PARSE_FAILURE;
+				}
+			}
+			else
+			{
+				++mPos;
+			}
+		}
+		else if (is_space(c) || (c == ':'))
+		{
+			++mPos;
+		}
+		else
+		{
+			LLSD child;
+			S32 count = parseNotation(child);
+			if (count <= 0)
+			{
+				// There must be a value for every key.
+				return LLSDParser::PARSE_FAILURE;
+			}
+			parse_count += count;
+			map.insert(name, child);
+			found_name = false;
+		}
+	}
+	if (mPos >= mEnd)
+	{
+		map.clear();
+		return LLSDParser::PARSE_FAILURE;
+	}
+	++mPos;
+	return parse_count;
+}
+
+S32 LLSDBufferParser::parseNotationArray(LLSD& array)
+{
+	// array: [ object, object, object ]
+	array = LLSD::emptyArray();
+	++mPos;
+	S32 parse_count = 0;
+	while (mPos < mEnd && *mPos != ']')
+	{
+		if (is_space(*mPos) || (*mPos == ','))
+		{
+			++mPos;
+			continue;
+		}
+		LLSD child;
+		S32 count = parseNotation(child);
+		if (LLSDParser::PARSE_FAILURE == count)
+		{
+			return LLSDParser::PARSE_FAILURE;
+		}
+		parse_count += count;
+		array.append(child);
+	}
+	if (mPos >= mEnd)
+	{
+		return LLSDParser::PARSE_FAILURE;
+	}
+	++mPos;
+	return parse_count;
+}
+
+bool LLSDBufferParser::parseNotationString(std::string& value)
+{
+	// string: "g'day" | 'have a "nice" day' | s(size)"raw data"
+	const char c = *mPos++;
+	if (c == 's')
+	{
+		return parseNotationRawString(value);
+	}
+	return parseDelimitedString(c, value);
+}
+
+bool LLSDBufferParser::parseNotationRawString(std::string& value)
+{
+	// Like deserialize_string_raw(): at most 18 characters up to the
+	// closing parenthesis, which is skipped unchecked, then a quote.
+	const char* start = mPos;
+	const char* limit = mPos + llmin((size_t)18, (size_t)(mEnd - mPos));
+	while (mPos < limit && *mPos != ')')
+	{
+		++mPos;
+	}
+	if (mPos == start || mEnd - mPos < 2)
+	{
+		return false;
+	}
+	std::string size_str(start, mPos);
+	++mPos;
+	const char quote = *mPos++;
+	if (!((quote == '"') || (quote == '\'')) || (size_str[0] != '('))
+	{
+		return false;
+	}
+
+	S32 len = strtol(size_str.c_str() + 1, NULL, 0);
+	if (len < 0 || (size_t)len >= (size_t)(mEnd - mPos))
+	{
+		// Also needs room for the closing quote.
+		mPos = mEnd;
+		return false;
+	}
+	value.assign(mPos, len);
+	mPos += len;
+	const char end_quote = *mPos++;
+	return (end_quote == '"') || (end_quote == '\'');
+}
+
+bool LLSDBufferParser::parseNotationBinary(LLSD& data)
+{
+	// binary: b##"ff3120ab1" | b(len)"raw data"
+	// The encoding is whatever precedes the first double quote, which the
+	// stream parser looks for in the next 255 characters.
+	const char* start = mPos;
+	const size_t avail = llmin((size_t)255, (size_t)(mEnd - mPos));
+	const char* quote = (const char*)memchr(start, '"', avail);
+	if (!quote)
+	{
+		return false;
+	}
+	std::string encoding(start, quote);
+	mPos = quote + 1;
+
+	if (!encoding.compare(0, 2, "b("))
+	{
+		S32 len = strtol(encoding.c_str() + 2, NULL, 0);
+		// The character after the data, normally the closing quote, is
+		// skipped unchecked.
+		if (len < 0 || (size_t)len >= (size_t)(mEnd - mPos))
+		{
+			mPos = mEnd;
+			return false;
+		}
+		data = LLSD::Binary((const U8*)mPos, (const U8*)mPos + len);
+		mPos += len + 1;
+		return true;
+	}
+
+	const bool base64 = !encoding.compare(0, 3, "b64");
+	if (!base64 && encoding.compare(0, 3, "b16"))
+	{
+		return false;
+	}
+
+	const char* end_quote = (const char*)memchr(mPos, '"', mEnd - mPos);
+	if (!end_quote)
+	{
+		mPos = mEnd;
+		return false;
+	}
+	const char* encoded = mPos;
+	const size_t encoded_len = end_quote - mPos;
+	mPos = end_quote + 1;
+
+	if (base64)
+	{
+		if (!encoded_len)
+		{
+			// The stream parser fails on empty base 64 data too.
+			return false;
+		}
+		std::string coded(encoded, encoded_len);
+		size_t len = LLBase64::requiredDecryptionSpace(coded);
+		LLSD::Binary value;
+		if (len)
+		{
+			value.resize(len);
+			len = LLBase64::decode(coded, &value[0], len);
+			value.resize(len);
+		}
+		data = value;
+		return true;
+	}
+
+	LLSD::Binary value;
+	value.reserve((encoded_len + 1) / 2);
+	for (size_t i = 0; i < encoded_len; i += 2)
+	{
+		U8 byte = hex_as_nybble(encoded[i]) << 4;
+		if (i + 1 < encoded_len)
+		{
+			byte |= hex_as_nybble(encoded[i + 1]);
+		}
+		value.push_back(byte);
+	}
+	data = value;
+	return true;
+}
+
+bool LLSDBufferParser::parseNotationBoolean(const char* rest, bool value, LLSD& data)
+{
+	// boolean: true | false | T | F | t | f | TRUE | FALSE
+	if (mPos < mEnd && is_alpha(*mPos))
+	{
+		for ( ; *rest; ++rest, ++mPos)
+		{
+			if (mPos >= mEnd || to_lower(*mPos) != *rest)
+			{
+				return false;
+			}
+		}
+	}
+	data = value;
+	return true;
+}
+
+bool LLSDBufferParser::parseNotationInteger(LLSD& data)
+{
+	// What std::istream >> S32 accepts: whitespace, a sign and decimal
+	// digits, failing on overflow.
+	const char* p = mPos;
+	while (p < mEnd && is_space(*p))
+	{
+		++p;
+	}
+	bool negative = false;
+	if (p < mEnd && (*p == '-' || *p == '+'))
+	{
+		negative = (*p == '-');
+		++p;
+	}
+	const char* digits = p;
+	U64 value = 0;
+	const U64 limit = negative ? 0x80000000ULL : 0x7FFFFFFFULL;
+	bool overflow = false;
+	while (p < mEnd && is_digit(*p))
+	{
+		if (!overflow)
+		{
+			value = value * 10 + (*p - '0');
+			overflow = value > limit;
+		}
+		++p;
+	}
+	mPos = p;
+	if (p == digits || overflow)
+	{
+		return false;
+	}
+	data = negative ? (S32)(0 - value) : (S32)value;
+	return true;
+}
+
+bool LLSDBufferParser::parseNotationReal(LLSD& data)
+{
+	const char* p = mPos;
+	while (p < mEnd && is_space(*p))
+	{
+		++p;
+	}
+
+	// Fast path for the usual [-]digits[.digits][e[-]digits] spelling:
+	// when the digits fit in the 53 bits of a double and the power of ten
+	// is exact, a single multiplication or division rounds correctly.
+	const char* start = p;
+	bool negative = false;
+	if (p < mEnd && (*p == '-' || *p == '+'))
+	{
+		negative = (*p == '-');
+		++p;
+	}
+	U64 mantissa = 0;
+	S32 exponent = 0;
+	S32 significant = 0;
+	bool found_digit = false;
+	bool exact = true;
+	for (bool fraction = false; p < mEnd; ++p)
+	{
+		if (is_digit(*p))
+		{
+			found_digit = true;
+			if (mantissa || *p != '0')
+			{
+				if (++significant > 18)
+				{
+					exact = false;
+					break;
+				}
+				mantissa = mantissa * 10 + (*p - '0');
+			}
+			if (fraction)
+			{
+				--exponent;
+			}
+		}
+		else if (*p == '.' && !fraction)
+		{
+			fraction = true;
+		}
+		else
+		{
+			break;
+		}
+	}
+	if (exact && found_digit && p < mEnd && (*p == 'e' || *p == 'E'))
+	{
+		const char* q = p + 1;
+		bool negative_exponent = false;
+		if (q < mEnd && (*q == '-' || *q == '+'))
+		{
+			negative_exponent = (*q == '-');
+			++q;
+		}
+		S32 exp10 = 0;
+		const char* exp_digits = q;
+		while (q < mEnd && is_digit(*q) && exp10 < 1000)
+		{
+			exp10 = exp10 * 10 + (*q++ - '0');
+		}
+		exact = (q != exp_digits) && !(q < mEnd && is_digit(*q));
+		exponent += negative_exponent ? -exp10 : exp10;
+		p = q;
+	}
+	if (exact && found_digit && mantissa <= (1ULL << 53)
+		&& exponent >= -22 && exponent <= 22)
+	{
+		F64 value = (F64)mantissa;
+		if (exponent < 0)
+		{
+			value /= POWERS_OF_TEN[-exponent];
+		}
+		else
+		{
+			value *= POWERS_OF_TEN[exponent];
+		}
+		data = negative ? -value : value;
+		mPos = p;
+		return true;
+	}
+
+	// Anything else is left to the stream, over the characters it could
+	// possibly consume.
+	const char* end = start;
+	while (end < mEnd && (is_digit(*end) || *end == '.' || *end == '-'
+						  || *end == '+' || *end == 'e' || *end == 'E'))
+	{
+		++end;
+	}
+	std::istringstream istr(std::string(start, end));
+	F64 real = 0.0;
+	istr >> real;
+	if (istr.fail())
+	{
+		mPos = end;
+		return false;
+	}
+	mPos = istr.eof() ? end : start + (size_t)istr.tellg();
+	data = real;
+	return true;
+}
+
+bool LLSDBufferParser::parseNotationUUID(LLSD& data)
+{
+	// Fast path for the canonical 8-4-4-4-12 spelling.
+	const size_t length = UUID_STR_LENGTH - 1;
+	if ((size_t)(mEnd - mPos) >= length)
+	{
+		bool canonical = true;
+		for (size_t i = 0; canonical && i < length; ++i)
+		{
+			canonical = (i == 8 || i == 13 || i == 18 || i == 23)
+				? mPos[i] == '-' : is_hex(mPos[i]);
+		}
+		if (canonical)
+		{
+			LLUUID id;
+			const char* hex = mPos;
+			for (S32 i = 0; i < UUID_BYTES; ++i)
+			{
+				if (*hex == '-')
+				{
+					++hex;
+				}
+				id.mData[i] = (hex_as_nybble(hex[0]) << 4) | hex_as_nybble(hex[1]);
+				hex += 2;
+			}
+			mPos += length;
+			data = id;
+			return true;
+		}
+	}
+
+	// Like operator>>(std::istream&, LLUUID&): the next 36 characters that
+	// are not whitespace, handed to LLUUID::set().
+	char uuid_str[UUID_STR_LENGTH];		/* Flawfinder: ignore */
+	for (size_t i = 0; i < length; ++i)
+	{
+		while (mPos < mEnd && is_space(*mPos))
+		{
+			++mPos;
+		}
+		if (mPos >= mEnd)
+		{
+			return false;
+		}
+		uuid_str[i] = *mPos++;
+	}
+	uuid_str[length] = '\0';
+	LLUUID id;
+	id.set(std::string(uuid_str));
+	data = id;
+	return true;
+}
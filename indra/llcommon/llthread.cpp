@@ -35,6 +35,8 @@
 
 #include "llthread.h"
 
+#include "llfasttimer.h"
+#include "llmemtag.h"
 #include "lltimer.h"
 
 #if LL_LINUX || LL_SOLARIS
@@ -89,9 +91,17 @@ void *APR_THREAD_FUNC LLThread::staticRun(apr_thread_t *apr_threadp, void *datap
 	// Create a thread local data.
 	LLThreadLocalData::create(threadp);
 
+	// Give the thread its own lane in the fast timer view.
+	LLFastTimer::registerThread(threadp->mName);
+
 	// Run the user supplied function
 	threadp->run();
 
+	LLFastTimer::unregisterThread();
+
+	// Don't lose what this thread accounted for without folding it.
+	LLMemTag::foldLocal();
+
 	// Setting mStatus to STOPPED is done non-thread-safe, so it's
 	// possible that the thread is deleted by another thread at
 	// the moment it happens... therefore make a copy here.
@@ -0,0 +1,508 @@
+/**
+ * @file lltracerecorder.cpp
+ * @brief Per-thread ring buffers of timer events, exported as Chrome trace JSON.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "lltracerecorder.h"
+
+#include <ctime>
+#include <deque>
+#include <limits>
+#include <vector>
+
+#include "aithreadid.h"
+#include "llthread.h"
+#include "lltimer.h"
+
+std::atomic<bool> LLTraceRecorder::sActive(false);
+
+// Events kept per thread; a power of two. 32 bytes each.
+static const U64 RING_EVENTS = 1 << 15;
+
+// Hitches tend to come in bursts: one automatic export per burst is enough.
+static const F32 SPIKE_EXPORT_INTERVAL = 30.f;
+
+static const std::string FRAME_NAME("Frame");
+
+namespace
+{
+	enum EEventType
+	{
+		EVENT_BEGIN,
+		EVENT_END,
+		EVENT_COUNTER
+	};
+
+	struct TraceEvent
+	{
+		U64					mTime;		// get_clock_count()
+		const std::string*	mName;
+		S64					mValue;		// counters only
+		U32					mType;
+	};
+
+	// Written by its thread only. Its events are allocated on the first one
+	// recorded, with sBufferMutex locked, and live until cleanupClass() if the
+	// thread is gone by then, else until exit.
+	struct ThreadBuffer
+	{
+		std::string				mName;
+		U32						mThreadID;
+		bool					mInUse;
+		std::vector<TraceEvent>	mEvents;
+		std::atomic<U64>		mWritten;	// events ever written
+	};
+
+	LLGlobalMutex sBufferMutex;
+	std::vector<ThreadBuffer*> sBuffers;
+	LL_THREAD_LOCAL ThreadBuffer* tBuffer = NULL;
+
+	// Threads come and go: reuse the buffer of an earlier thread of the same
+	// name. sBufferMutex must be locked.
+	ThreadBuffer* take_buffer(const std::string& name)
+	{
+		for (std::vector<ThreadBuffer*>::iterator it = sBuffers.begin(); it != sBuffers.end(); ++it)
+		{
+			if (!(*it)->mInUse && (*it)->mName == name)
+			{
+				(*it)->mInUse = true;
+				return *it;
+			}
+		}
+		ThreadBuffer* buffer = new ThreadBuffer;
+		buffer->mName = name;
+		buffer->mThreadID = (U32)sBuffers.size();
+		buffer->mInUse = true;
+		buffer->mWritten = 0;
+		sBuffers.push_back(buffer);
+		return buffer;
+	}
+
+	ThreadBuffer* current_buffer()
+	{
+		ThreadBuffer* buffer = tBuffer;
+		if (LL_UNLIKELY(!buffer))
+		{
+			LLMutexLock lock(sBufferMutex);
+			buffer = tBuffer = take_buffer(AIThreadID::in_main_thread() ? std::string("Main thread")
+														: llformat("Thread %u", (U32)sBuffers.size()));
+		}
+		return buffer;
+	}
+
+	void record(U32 type, const std::string* name, S64 value, U64 time)
+	{
+		ThreadBuffer* buffer = current_buffer();
+		if (LL_UNLIKELY(buffer->mEvents.empty()))
+		{
+			LLMutexLock lock(sBufferMutex);
+			buffer->mEvents.resize(RING_EVENTS);
+		}
+		const U64 written = buffer->mWritten.load(std::memory_order_relaxed);
+		TraceEvent& event = buffer->mEvents[written & (RING_EVENTS - 1)];
+		event.mTime = time;
+		event.mName = name;
+		event.mValue = value;
+		event.mType = type;
+		buffer->mWritten.store(written + 1, std::memory_order_release);
+	}
+
+	std::vector<LLTraceCounter*>& get_counters()
+	{
+		// Counters are declared statically, possibly before anything else here
+		// is constructed.
+		static std::vector<LLTraceCounter*> counters;
+		return counters;
+	}
+
+	//-------------------------------------------------------------------------
+	// Export
+	//-------------------------------------------------------------------------
+
+	struct ThreadSnapshot
+	{
+		std::string				mName;
+		U32						mThreadID;
+		std::vector<TraceEvent>	mEvents;
+	};
+
+	struct ExportJob
+	{
+		std::string					mFilename;
+		std::string					mReason;
+		F64							mFrequency;
+		std::vector<ThreadSnapshot>	mThreads;
+	};
+
+	std::string json_escape(const std::string& str)
+	{
+		std::string escaped;
+		escaped.reserve(str.size());
+		for (std::string::const_iterator it = str.begin(); it != str.end(); ++it)
+		{
+			const unsigned char c = *it;
+			if (c == '"' || c == '\\')
+			{
+				escaped += '\\';
+				escaped += c;
+			}
+			else if (c < 0x20)
+			{
+				escaped += llformat("\\u%04x", c);
+			}
+			else
+			{
+				escaped += c;
+			}
+		}
+		return escaped;
+	}
+
+	bool write_job(const ExportJob& job)
+	{
+		LLFILE* fp = LLFile::fopen(job.mFilename, "wb");
+		if (!fp)
+		{
+			return false;
+		}
+
+		U64 start = std::numeric_limits<U64>::max();
+		for (std::vector<ThreadSnapshot>::const_iterator it = job.mThreads.begin(); it != job.mThreads.end(); ++it)
+		{
+			if (!it->mEvents.empty())
+			{
+				start = llmin(start, it->mEvents.front().mTime);
+			}
+		}
+		const F64 to_us = 1000000.0 / job.mFrequency;
+
+		fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"reason\":\"%s\"},\"traceEvents\":[\n",
+				json_escape(job.mReason).c_str());
+		const char* separator = "";
+		for (std::vector<ThreadSnapshot>::const_iterator it = job.mThreads.begin(); it != job.mThreads.end(); ++it)
+		{
+			const U32 tid = it->mThreadID;
+			fprintf(fp, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}}",
+					separator, tid, json_escape(it->mName).c_str());
+			fprintf(fp, ",\n{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"sort_index\":%u}}",
+					tid, tid);
+			separator = ",\n";
+
+			// The oldest events may end timers whose start was overwritten,
+			// and the newest may start timers still running: drop the former
+			// and close the latter.
+			std::vector<const std::string*> open;
+			U64 last_time = start;
+			for (std::vector<TraceEvent>::const_iterator eit = it->mEvents.begin(); eit != it->mEvents.end(); ++eit)
+			{
+				const F64 ts = (F64)(eit->mTime - start) * to_us;
+				last_time = eit->mTime;
+				switch (eit->mType)
+				{
+				case EVENT_BEGIN:
+					open.push_back(eit->mName);
+					fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"timer\",\"ph\":\"B\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+							json_escape(*eit->mName).c_str(), ts, tid);
+					break;
+				case EVENT_END:
+					if (open.empty()) break;
+					open.pop_back();
+					fprintf(fp, ",\n{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}", ts, tid);
+					break;
+				case EVENT_COUNTER:
+					fprintf(fp, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"value\":%lld}}",
+							json_escape(*eit->mName).c_str(), ts, tid, (long long)eit->mValue);
+					break;
+				}
+			}
+			const F64 end_ts = (F64)(last_time - start) * to_us;
+			for (size_t i = 0; i < open.size(); ++i)
+			{
+				fprintf(fp, ",\n{\"ph\":\"E\",\"ts\":%.3f,\"pid\":1,\"tid\":%u}", end_ts, tid);
+			}
+		}
+		fprintf(fp, "\n]}\n");
+		return LLFile::close(fp) == 0;
+	}
+
+	class ExportThread : public LLThread
+	{
+	public:
+		ExportThread()
+		:	LLThread("Trace export")
+		{
+		}
+
+		~ExportThread()
+		{
+			for (std::deque<ExportJob*>::iterator it = mJobs.begin(); it != mJobs.end(); ++it)
+			{
+				delete *it;
+			}
+		}
+
+		void queueJob(ExportJob* job)
+		{
+			mCondition.lock();
+			mJobs.push_back(job);
+			mCondition.signal();
+			mCondition.unlock();
+		}
+
+		/*virtual*/ void shutdown()
+		{
+			setQuitting();
+			mCondition.lock();
+			mCondition.signal();
+			mCondition.unlock();
+			LLThread::shutdown();
+		}
+
+	protected:
+		/*virtual*/ void run()
+		{
+			while (true)
+			{
+				mCondition.lock();
+				while (mJobs.empty() && !isQuitting())
+				{
+					mCondition.wait();
+				}
+				if (mJobs.empty())
+				{
+					mCondition.unlock();
+					break;
+				}
+				ExportJob* job = mJobs.front();
+				mJobs.pop_front();
+				mCondition.unlock();
+
+				if (write_job(*job))
+				{
+					LL_INFOS() << "Trace written to " << job->mFilename << LL_ENDL;
+				}
+				else
+				{
+					LL_WARNS() << "Could not write trace " << job->mFilename << LL_ENDL;
+				}
+				delete job;
+			}
+		}
+
+	private:
+		LLCondition				mCondition;		// guards mJobs
+		std::deque<ExportJob*>	mJobs;
+	};
+
+	ExportThread* sExportThread = NULL;
+	std::string sOutputDir;
+	F32 sSpikeThreshold = 0.f;
+	U64 sFrameStart = 0;
+	LLTimer sSpikeExportTimer;
+	bool sSpikeExported = false;
+}
+
+//static
+void LLTraceRecorder::initClass(const std::string& output_dir)
+{
+	if (sExportThread) return;
+
+	sOutputDir = output_dir;
+	if (!sOutputDir.empty() && sOutputDir.back() != '/' && sOutputDir.back() != '\\')
+	{
+		sOutputDir += '/';
+	}
+	sExportThread = new ExportThread;
+	sExportThread->start();
+}
+
+//static
+void LLTraceRecorder::cleanupClass()
+{
+	setActive(false);
+	if (sExportThread)
+	{
+		// Finishes the exports still queued.
+		sExportThread->shutdown();
+		delete sExportThread;
+		sExportThread = NULL;
+	}
+	// A thread still running may have checked isActive() before we cleared
+	// it and be writing to its events right now, without the lock: only
+	// release the events of threads that are gone. The others stay allocated,
+	// and unused now that recording is off, until the process exits.
+	LLMutexLock lock(sBufferMutex);
+	for (std::vector<ThreadBuffer*>::iterator it = sBuffers.begin(); it != sBuffers.end(); ++it)
+	{
+		if (!(*it)->mInUse)
+		{
+			std::vector<TraceEvent>().swap((*it)->mEvents);
+			(*it)->mWritten = 0;
+		}
+	}
+}
+
+//static
+void LLTraceRecorder::setActive(bool active)
+{
+	if (active != isActive())
+	{
+		LL_INFOS() << "Trace recording " << (active ? "started" : "stopped") << LL_ENDL;
+		sActive.store(active, std::memory_order_relaxed);
+		sFrameStart = 0;
+	}
+}
+
+//static
+void LLTraceRecorder::setSpikeThreshold(F32 ms)
+{
+	sSpikeThreshold = llmax(ms, 0.f);
+}
+
+//static
+void LLTraceRecorder::registerThread(const std::string& name)
+{
+	if (tBuffer) return;
+
+	LLMutexLock lock(sBufferMutex);
+	tBuffer = take_buffer(name);
+}
+
+//static
+void LLTraceRecorder::unregisterThread()
+{
+	ThreadBuffer* buffer = tBuffer;
+	if (buffer)
+	{
+		tBuffer = NULL;
+		LLMutexLock lock(sBufferMutex);
+		buffer->mInUse = false;
+	}
+}
+
+//static
+void LLTraceRecorder::begin(const std::string& name)
+{
+	record(EVENT_BEGIN, &name, 0, get_clock_count());
+}
+
+//static
+void LLTraceRecorder::end(const std::string& name)
+{
+	record(EVENT_END, &name, 0, get_clock_count());
+}
+
+//static
+void LLTraceRecorder::nextFrame()
+{
+	if (!isActive()) return;
+
+	const U64 now = get_clock_count();
+	if (sFrameStart)
+	{
+		record(EVENT_END, &FRAME_NAME, 0, now);
+	}
+	std::vector<LLTraceCounter*>& counters = get_counters();
+	for (std::vector<LLTraceCounter*>::iterator it = counters.begin(); it != counters.end(); ++it)
+	{
+		record(EVENT_COUNTER, &(*it)->getName(), (*it)->takeValue(), now);
+	}
+
+	if (sFrameStart && sSpikeThreshold > 0.f)
+	{
+		const F32 frame_ms = (F32)((F64)(now - sFrameStart) * 1000.0 / calc_clock_frequency());
+		if (frame_ms > sSpikeThreshold
+			&& (!sSpikeExported || sSpikeExportTimer.getElapsedTimeF32() > SPIKE_EXPORT_INTERVAL))
+		{
+			LL_INFOS() << "Frame took " << frame_ms << " ms, exporting trace" << LL_ENDL;
+			exportTrace("spike");
+			sSpikeExported = true;
+			sSpikeExportTimer.reset();
+		}
+	}
+
+	sFrameStart = get_clock_count();
+	record(EVENT_BEGIN, &FRAME_NAME, 0, sFrameStart);
+}
+
+//static
+std::string LLTraceRecorder::exportTrace(const std::string& reason)
+{
+	if (!sExportThread) return std::string();
+
+	ExportJob* job = new ExportJob;
+	job->mReason = reason.empty() ? std::string("request") : reason;
+	job->mFrequency = calc_clock_frequency();
+	{
+		LLMutexLock lock(sBufferMutex);
+		for (std::vector<ThreadBuffer*>::const_iterator it = sBuffers.begin(); it != sBuffers.end(); ++it)
+		{
+			const ThreadBuffer* buffer = *it;
+			if (buffer->mEvents.empty()) continue;
+
+			job->mThreads.push_back(ThreadSnapshot());
+			ThreadSnapshot& snapshot = job->mThreads.back();
+			snapshot.mName = buffer->mName;
+			snapshot.mThreadID = buffer->mThreadID;
+
+			const U64 written = buffer->mWritten.load(std::memory_order_acquire);
+			U64 first = written > RING_EVENTS ? written - RING_EVENTS : 0;
+			snapshot.mEvents.reserve((size_t)(written - first));
+			for (U64 i = first; i < written; ++i)
+			{
+				snapshot.mEvents.push_back(buffer->mEvents[i & (RING_EVENTS - 1)]);
+			}
+			// The thread kept writing while we copied: drop what it may have
+			// overwritten, including the slot it could be writing right now.
+			const U64 rewritten = buffer->mWritten.load(std::memory_order_acquire) + 1;
+			if (rewritten > first + RING_EVENTS)
+			{
+				const U64 drop = llmin(rewritten - RING_EVENTS - first, (U64)snapshot.mEvents.size());
+				snapshot.mEvents.erase(snapshot.mEvents.begin(), snapshot.mEvents.begin() + (size_t)drop);
+			}
+		}
+	}
+	if (job->mThreads.empty())
+	{
+		delete job;
+		return std::string();
+	}
+
+	char stamp[32];
+	const time_t now = time(NULL);
+	strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&now));
+	job->mFilename = sOutputDir + "trace_" + stamp + "_" + job->mReason + ".json";
+	const std::string filename = job->mFilename;
+	sExportThread->queueJob(job);
+	return filename;
+}
+
+LLTraceCounter::LLTraceCounter(const std::string& name)
+:	mName(name),
+	mValue(0)
+{
+	get_counters().push_back(this);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file lltracerecorder.h
+ * @brief Per-thread ring buffers of timer events, exported as Chrome trace JSON.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLTRACERECORDER_H
+#define LL_LLTRACERECORDER_H
+
+#include <atomic>
+#include <string>
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLTraceRecorder
+//
+//   While active, every fast timer that starts or stops, on any thread,
+//   appends a begin or end event to a ring buffer owned by its thread. The
+//   buffers only hold the last few seconds, so recording can stay on for a
+//   whole session. nextFrame() marks the frame boundaries on the main thread,
+//   samples the LLTraceCounter's and, when a frame took longer than the spike
+//   threshold, exports the buffers by itself.
+//
+//   exportTrace() copies the buffers on the calling thread and writes them
+//   from a background thread in the Chrome trace event format, which both
+//   chrome://tracing and the Perfetto UI open.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LL_COMMON_API LLTraceRecorder
+{
+public:
+	// Traces are written to output_dir.
+	static void initClass(const std::string& output_dir);
+	static void cleanupClass();
+
+	static void setActive(bool active);
+	static bool isActive()		{ return sActive.load(std::memory_order_relaxed); }
+
+	// 0 turns the automatic export off.
+	static void setSpikeThreshold(F32 ms);
+
+	// Names the ring buffer of the calling thread.
+	static void registerThread(const std::string& name);
+	static void unregisterThread();
+
+	// name must outlive the recorder; the timer names do.
+	static void begin(const std::string& name);
+	static void end(const std::string& name);
+
+	// Main thread, once per frame.
+	static void nextFrame();
+
+	// Returns the name of the file that will be written, or an empty
+	// string when there is nothing to export.
+	static std::string exportTrace(const std::string& reason = std::string());
+
+private:
+	static std::atomic<bool> sActive;
+};
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLTraceCounter
+//
+//   A named quantity added to from any thread, for instance the bytes of
+//   texture data received. LLTraceRecorder::nextFrame() records the sum of
+//   the frame as a counter event and starts over. Declare them statically.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LL_COMMON_API LLTraceCounter
+{
+public:
+	LLTraceCounter(const std::string& name);
+
+	void add(S64 delta)
+	{
+		if (LL_UNLIKELY(LLTraceRecorder::isActive()))
+		{
+			mValue.fetch_add(delta, std::memory_order_relaxed);
+		}
+	}
+
+	const std::string& getName() const		{ return mName; }
+	S64 takeValue()							{ return mValue.exchange(0, std::memory_order_relaxed); }
+
+private:
+	std::string			mName;
+	std::atomic<S64>	mValue;
+};
+
+#endif // LL_LLTRACERECORDER_H
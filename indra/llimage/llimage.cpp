@@ -39,6 +39,7 @@
 #include "llimagedxt.h"
 #include "llimageworker.h"
 #include "llmemory.h"
+#include "llmemtag.h"
 
 //---------------------------------------------------------------------------
 // LLImage
@@ -359,6 +360,7 @@ U8* LLImageRaw::allocateData(S32 size)
 {
 	U8* res = LLImageBase::allocateData(size);
 	*AIAccess<S64>(sGlobalRawMemory) += getDataSize();
+	LLMemTag::add(LLMemTag::MT_TEXTURE_RAW, getDataSize());
 	return res;
 }
 
@@ -368,6 +370,7 @@ U8* LLImageRaw::reallocateData(S32 size)
 	S32 old_data_size = getDataSize();
 	U8* res = LLImageBase::reallocateData(size);
 	*AIAccess<S64>(sGlobalRawMemory) += getDataSize() - old_data_size;
+	LLMemTag::add(LLMemTag::MT_TEXTURE_RAW, getDataSize() - old_data_size);
 	return res;
 }
 
@@ -377,6 +380,7 @@ void LLImageRaw::deleteData()
 	{
 		*AIAccess<S64>(sGlobalRawMemory) -= getDataSize();
 	}
+	LLMemTag::sub(LLMemTag::MT_TEXTURE_RAW, getDataSize());
 	LLImageBase::deleteData();
 }
 
@@ -393,6 +397,7 @@ void LLImageRaw::setDataAndSize(U8 *data, S32 width, S32 height, S8 components)
 	LLImageBase::setDataAndSize(data, width * height * components) ;
 	
 	*AIAccess<S64>(sGlobalRawMemory) += getDataSize();
+	LLMemTag::add(LLMemTag::MT_TEXTURE_RAW, getDataSize());
 }
 
 BOOL LLImageRaw::resize(U16 width, U16 height, S8 components)
@@ -1576,15 +1581,18 @@ U8* LLImageFormatted::allocateData(S32 size)
 {
 	U8* res = LLImageBase::allocateData(size); // calls deleteData()
 	sGlobalFormattedMemory += getDataSize();
+	LLMemTag::add(LLMemTag::MT_TEXTURE_FORMATTED, getDataSize());
 	return res;
 }
 
 // virtual
 U8* LLImageFormatted::reallocateData(S32 size)
 {
-	sGlobalFormattedMemory -= getDataSize();
+	S32 old_data_size = getDataSize();
+	sGlobalFormattedMemory -= old_data_size;
 	U8* res = LLImageBase::reallocateData(size);
 	sGlobalFormattedMemory += getDataSize();
+	LLMemTag::add(LLMemTag::MT_TEXTURE_FORMATTED, getDataSize() - old_data_size);
 	return res;
 }
 
@@ -1592,6 +1600,7 @@ U8* LLImageFormatted::reallocateData(S32 size)
 void LLImageFormatted::deleteData()
 {
 	sGlobalFormattedMemory -= getDataSize();
+	LLMemTag::sub(LLMemTag::MT_TEXTURE_FORMATTED, getDataSize());
 	LLImageBase::deleteData();
 }
 
@@ -1634,6 +1643,7 @@ void LLImageFormatted::setData(U8 *data, S32 size)
 		setDataAndSize(data, size); // Access private LLImageBase members
 
 		sGlobalFormattedMemory += getDataSize();
+		LLMemTag::add(LLMemTag::MT_TEXTURE_FORMATTED, getDataSize());
 	}
 }
 
@@ -0,0 +1,377 @@
+/**
+ * @file llimagecompositor.cpp
+ * @brief Blends images into an LLImageRaw the way the GL layer compositing does.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llimagecompositor.h"
+
+#include <map>
+
+#include "lltimer.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LL_COMPOSITE_SSE2 1
+#include <emmintrin.h>
+#else
+#define LL_COMPOSITE_SSE2 0
+#endif
+
+namespace
+{
+	// The layer shaders discard fragments below an alpha of 0.004, that is
+	// 0 and 1 out of 255.
+	const U8 MIN_TESTED_ALPHA = 2;
+
+	// a * b / 255, rounded like the blender does
+	inline U8 mul8(U32 a, U32 b)
+	{
+		U32 t = a * b + 128;
+		return (U8)((t + (t >> 8)) >> 8);
+	}
+
+	void blend_pixels(LLImageCompositor::EBlend blend, U8* dst, const U8* src, const LLColor4U& color,
+					  S32 pixels, bool alpha_test, bool alpha_only)
+	{
+		const S32 first = alpha_only ? 3 : 0;
+		for (S32 i = 0; i < pixels; ++i, dst += 4)
+		{
+			U8 s[4];
+			for (S32 c = 0; c < 4; ++c)
+			{
+				s[c] = src ? mul8(src[c], color.mV[c]) : color.mV[c];
+			}
+			if (src)
+			{
+				src += 4;
+			}
+			if (alpha_test && s[3] < MIN_TESTED_ALPHA)
+			{
+				continue;
+			}
+
+			const U8 dst_alpha = dst[3];
+			for (S32 c = first; c < 4; ++c)
+			{
+				switch (blend)
+				{
+				case LLImageCompositor::BLEND_ALPHA:
+					dst[c] = mul8(s[c], s[3]) + mul8(dst[c], 255 - s[3]);
+					break;
+				case LLImageCompositor::BLEND_DEST_ALPHA:
+					dst[c] = mul8(s[c], dst_alpha) + mul8(dst[c], 255 - dst_alpha);
+					break;
+				case LLImageCompositor::BLEND_REPLACE:
+					dst[c] = s[c];
+					break;
+				case LLImageCompositor::BLEND_ADD:
+					dst[c] = (U8)llmin((U32)s[c] + dst[c], (U32)255);
+					break;
+				case LLImageCompositor::BLEND_MULT_ALPHA:
+					dst[c] = mul8(s[c], dst_alpha);
+					break;
+				}
+			}
+		}
+	}
+
+#if LL_COMPOSITE_SSE2
+	// Two pixels per register, one channel per 16 bit lane.
+	inline __m128i mul16(__m128i a, __m128i b)
+	{
+		const __m128i half = _mm_set1_epi16(128);
+		__m128i t = _mm_add_epi16(_mm_mullo_epi16(a, b), half);
+		return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+	}
+
+	inline __m128i splat_alpha(__m128i v)
+	{
+		return _mm_shufflehi_epi16(_mm_shufflelo_epi16(v, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+	}
+
+	template <LLImageCompositor::EBlend BLEND>
+	inline __m128i blend16(__m128i s, __m128i d, __m128i write, __m128i threshold)
+	{
+		const __m128i one = _mm_set1_epi16(255);
+		const __m128i s_alpha = splat_alpha(s);
+		__m128i n;
+		switch (BLEND)
+		{
+		case LLImageCompositor::BLEND_ALPHA:
+			n = _mm_add_epi16(mul16(s, s_alpha), mul16(d, _mm_sub_epi16(one, s_alpha)));
+			break;
+		case LLImageCompositor::BLEND_DEST_ALPHA:
+		{
+			const __m128i d_alpha = splat_alpha(d);
+			n = _mm_add_epi16(mul16(s, d_alpha), mul16(d, _mm_sub_epi16(one, d_alpha)));
+			break;
+		}
+		case LLImageCompositor::BLEND_REPLACE:
+			n = s;
+			break;
+		case LLImageCompositor::BLEND_ADD:
+			n = _mm_min_epi16(_mm_add_epi16(s, d), one);
+			break;
+		case LLImageCompositor::BLEND_MULT_ALPHA:
+		default:
+			n = mul16(s, splat_alpha(d));
+			break;
+		}
+		const __m128i mask = _mm_and_si128(write, _mm_cmpgt_epi16(s_alpha, threshold));
+		return _mm_or_si128(_mm_and_si128(mask, n), _mm_andnot_si128(mask, d));
+	}
+
+	// Four pixels per iteration, returns how many were done.
+	template <LLImageCompositor::EBlend BLEND>
+	S32 blend_pixels_sse2(U8* dst, const U8* src, const LLColor4U& color,
+						  S32 pixels, bool alpha_test, bool alpha_only)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i color16 = _mm_setr_epi16(color.mV[0], color.mV[1], color.mV[2], color.mV[3],
+											   color.mV[0], color.mV[1], color.mV[2], color.mV[3]);
+		const __m128i write = alpha_only ? _mm_setr_epi16(0, 0, 0, -1, 0, 0, 0, -1) : _mm_set1_epi16(-1);
+		const __m128i threshold = _mm_set1_epi16(alpha_test ? MIN_TESTED_ALPHA - 1 : -1);
+
+		S32 done = 0;
+		for (; done + 4 <= pixels; done += 4)
+		{
+			__m128i* dst_ptr = (__m128i*)(dst + done * 4);
+			const __m128i d = _mm_loadu_si128(dst_ptr);
+			__m128i s_lo = color16;
+			__m128i s_hi = color16;
+			if (src)
+			{
+				const __m128i s = _mm_loadu_si128((const __m128i*)(src + done * 4));
+				s_lo = mul16(_mm_unpacklo_epi8(s, zero), color16);
+				s_hi = mul16(_mm_unpackhi_epi8(s, zero), color16);
+			}
+			const __m128i lo = blend16<BLEND>(s_lo, _mm_unpacklo_epi8(d, zero), write, threshold);
+			const __m128i hi = blend16<BLEND>(s_hi, _mm_unpackhi_epi8(d, zero), write, threshold);
+			_mm_storeu_si128(dst_ptr, _mm_packus_epi16(lo, hi));
+		}
+		return done;
+	}
+#endif
+}
+
+//-----------------------------------------------------------------------------
+// LLImageCompositor
+//-----------------------------------------------------------------------------
+LLImageCompositor::LLImageCompositor(S32 width, S32 height)
+:	mWidth(width),
+	mHeight(height)
+{
+}
+
+void LLImageCompositor::addImage(LLImageRaw* image, const LLColor4U& color, EBlend blend,
+								 bool alpha_test, bool alpha_only, bool is_mask)
+{
+	Op op;
+	op.mImage = image;
+	op.mColor = color;
+	op.mBlend = blend;
+	op.mAlphaTest = alpha_test;
+	op.mAlphaOnly = alpha_only;
+	op.mIsMask = is_mask;
+	op.mCapture = -1;
+	mOps.push_back(op);
+}
+
+S32 LLImageCompositor::addCapture()
+{
+	Op op;
+	op.mBlend = BLEND_REPLACE;
+	op.mAlphaTest = false;
+	op.mAlphaOnly = true;
+	op.mIsMask = false;
+	op.mCapture = (S32)mCaptures.size();
+	mOps.push_back(op);
+	mCaptures.push_back(std::vector<U8>());
+	return op.mCapture;
+}
+
+LLPointer<LLImageRaw> LLImageCompositor::prepareImage(LLImageRaw* image, bool is_mask) const
+{
+	const S32 components = image->getComponents();
+	if (components != 1 && components != 3 && components != 4)
+	{
+		LL_WARNS() << "Skipping image with " << components << " components" << LL_ENDL;
+		return NULL;
+	}
+
+	// Scale first, the source is usually no bigger than the target and
+	// has fewer components.
+	LLPointer<LLImageRaw> scaled = image;
+	if (image->getWidth() != mWidth || image->getHeight() != mHeight)
+	{
+		scaled = new LLImageRaw(mWidth, mHeight, components);
+		scaled->copyScaled(image);
+	}
+	if (components == 4)
+	{
+		return scaled;
+	}
+
+	LLPointer<LLImageRaw> rgba = new LLImageRaw(mWidth, mHeight, 4);
+	if (components == 3)
+	{
+		rgba->copyUnscaled3onto4(scaled);
+	}
+	else if (is_mask)
+	{
+		rgba->copyUnscaledAlphaMask(scaled, LLColor4U::black);
+	}
+	else
+	{
+		const U8* src = scaled->getData();
+		U8* dst = rgba->getData();
+		for (S32 i = 0, count = mWidth * mHeight; i < count; ++i, dst += 4)
+		{
+			dst[0] = dst[1] = dst[2] = src[i];
+			dst[3] = 255;
+		}
+	}
+	return rgba;
+}
+
+static LLTrace::BlockTimerStatHandle FTM_IMAGE_COMPOSITE("Image Composite");
+void LLImageCompositor::composite()
+{
+	LL_RECORD_BLOCK_TIME(FTM_IMAGE_COMPOSITE);
+	const S32 pixels = mWidth * mHeight;
+	mResult = new LLImageRaw(mWidth, mHeight, 4);
+	mResult->clear(0, 0, 0, 0);
+	U8* data = mResult->getData();
+
+	// The same texture is often drawn by several ops.
+	typedef std::map<std::pair<LLImageRaw*, bool>, LLPointer<LLImageRaw> > prepared_map_t;
+	prepared_map_t prepared;
+
+	for (op_list_t::const_iterator iter = mOps.begin(); iter != mOps.end(); ++iter)
+	{
+		const Op& op = *iter;
+		if (op.mCapture >= 0)
+		{
+			std::vector<U8>& capture = mCaptures[op.mCapture];
+			capture.resize(pixels);
+			for (S32 i = 0; i < pixels; ++i)
+			{
+				capture[i] = data[i * 4 + 3];
+			}
+			continue;
+		}
+
+		const U8* src = NULL;
+		if (op.mImage.notNull())
+		{
+			LLPointer<LLImageRaw>& image = prepared[std::make_pair(op.mImage.get(), op.mIsMask)];
+			if (image.isNull())
+			{
+				image = prepareImage(op.mImage, op.mIsMask);
+				if (image.isNull())
+				{
+					continue;
+				}
+			}
+			src = image->getData();
+		}
+		blendRow(op.mBlend, data, src, op.mColor, pixels, op.mAlphaTest, op.mAlphaOnly);
+	}
+}
+
+//static
+void LLImageCompositor::blendRow(EBlend blend, U8* dst, const U8* src, const LLColor4U& color,
+								 S32 pixels, bool alpha_test, bool alpha_only)
+{
+	S32 done = 0;
+#if LL_COMPOSITE_SSE2
+	switch (blend)
+	{
+	case BLEND_ALPHA:
+		done = blend_pixels_sse2<BLEND_ALPHA>(dst, src, color, pixels, alpha_test, alpha_only);
+		break;
+	case BLEND_DEST_ALPHA:
+		done = blend_pixels_sse2<BLEND_DEST_ALPHA>(dst, src, color, pixels, alpha_test, alpha_only);
+		break;
+	case BLEND_REPLACE:
+		done = blend_pixels_sse2<BLEND_REPLACE>(dst, src, color, pixels, alpha_test, alpha_only);
+		break;
+	case BLEND_ADD:
+		done = blend_pixels_sse2<BLEND_ADD>(dst, src, color, pixels, alpha_test, alpha_only);
+		break;
+	case BLEND_MULT_ALPHA:
+		done = blend_pixels_sse2<BLEND_MULT_ALPHA>(dst, src, color, pixels, alpha_test, alpha_only);
+		break;
+	}
+#endif
+	blend_pixels(blend, dst + done * 4, src ? src + done * 4 : NULL, color,
+				 pixels - done, alpha_test, alpha_only);
+}
+
+//static
+void LLImageCompositor::scaleMask(U8* data, const U8* mask, S32 count)
+{
+	S32 i = 0;
+#if LL_COMPOSITE_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	for (; i + 16 <= count; i += 16)
+	{
+		const __m128i d = _mm_loadu_si128((const __m128i*)(data + i));
+		const __m128i m = _mm_loadu_si128((const __m128i*)(mask + i));
+		const __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero),
+														  _mm_add_epi16(_mm_unpacklo_epi8(m, zero), one)), 8);
+		const __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero),
+														  _mm_add_epi16(_mm_unpackhi_epi8(m, zero), one)), 8);
+		_mm_storeu_si128((__m128i*)(data + i), _mm_packus_epi16(lo, hi));
+	}
+#endif
+	for (; i < count; ++i)
+	{
+		data[i] = (U8)(((U16)data[i] * ((U16)mask[i] + 1)) >> 8);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// LLImageCompositeThread
+//-----------------------------------------------------------------------------
+LLImageCompositeThread::LLImageCompositeThread(LLImageCompositor* compositor)
+:	LLThread("Image compositor"),
+	mCompositor(compositor),
+	mCompositeTime(0.f)
+{
+}
+
+LLImageCompositeThread::~LLImageCompositeThread()
+{
+	delete mCompositor;
+}
+
+void LLImageCompositeThread::run()
+{
+	LLTimer timer;
+	mCompositor->composite();
+	mCompositeTime = timer.getElapsedTimeF32();
+}
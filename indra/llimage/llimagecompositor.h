@@ -0,0 +1,143 @@
+/**
+ * @file llimagecompositor.h
+ * @brief Blends images into an LLImageRaw the way the GL layer compositing does.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLIMAGECOMPOSITOR_H
+#define LL_LLIMAGECOMPOSITOR_H
+
+#include <vector>
+
+#include "llimage.h"
+#include "llpointer.h"
+#include "llthread.h"
+#include "v4coloru.h"
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLImageCompositor
+//
+//   Replays a list of full size rectangle draws into an RGBA LLImageRaw,
+//   with the blend functions, color modulation, alpha test and color mask
+//   that LLTexLayerSet uses when it composites a bake through GL. Images
+//   are stretched to the target size; one component masks become alpha
+//   over black like the GL_ALPHA8 textures they replace.
+//
+//   The ops only keep references to their images, which must not change
+//   until composite() returns. composite() does not touch GL or any state
+//   outside the compositor, so it can run on a LLImageCompositeThread.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLImageCompositor
+{
+public:
+	enum EBlend
+	{
+		BLEND_ALPHA,		// src * src_a + dst * (1 - src_a)
+		BLEND_DEST_ALPHA,	// src * dst_a + dst * (1 - dst_a)
+		BLEND_REPLACE,		// src
+		BLEND_ADD,			// min(src + dst, 1)
+		BLEND_MULT_ALPHA	// src * dst_a
+	};
+
+	LLImageCompositor(S32 width, S32 height);
+
+	S32 getWidth() const		{ return mWidth; }
+	S32 getHeight() const		{ return mHeight; }
+
+	// Draws image, or a flat rectangle if it is NULL, modulated by color.
+	// alpha_test drops the fragments that the layer shaders discard,
+	// alpha_only leaves the color channels alone.
+	void addImage(LLImageRaw* image, const LLColor4U& color, EBlend blend,
+				  bool alpha_test = true, bool alpha_only = false, bool is_mask = false);
+	void addRect(const LLColor4U& color, EBlend blend,
+				 bool alpha_test = true, bool alpha_only = false)
+	{
+		addImage(NULL, color, blend, alpha_test, alpha_only);
+	}
+
+	// Copies the alpha channel as it is at this point of the ops, returns
+	// the index to pass to getCapture().
+	S32 addCapture();
+
+	// Runs the ops. Safe to call once, from any thread.
+	void composite();
+
+	LLImageRaw* getResult()					{ return mResult; }
+	const U8* getCapture(S32 index) const	{ return &mCaptures[index][0]; }
+	U32 getOpCount() const					{ return mOps.size(); }
+
+	// Kernels, exposed for the layer code and the tests. All pixels are
+	// RGBA; src is NULL for a flat color.
+	static void blendRow(EBlend blend, U8* dst, const U8* src, const LLColor4U& color,
+						 S32 pixels, bool alpha_test, bool alpha_only);
+	// data[i] = data[i] * (mask[i] + 1) / 256, the alpha mask gathering.
+	static void scaleMask(U8* data, const U8* mask, S32 count);
+
+private:
+	// RGBA copy of image at the target size
+	LLPointer<LLImageRaw> prepareImage(LLImageRaw* image, bool is_mask) const;
+
+	struct Op
+	{
+		LLPointer<LLImageRaw>	mImage;
+		LLColor4U				mColor;
+		EBlend					mBlend;
+		bool					mAlphaTest;
+		bool					mAlphaOnly;
+		bool					mIsMask;
+		S32						mCapture;		// >= 0 for a capture
+	};
+	typedef std::vector<Op> op_list_t;
+	op_list_t				mOps;
+
+	S32						mWidth;
+	S32						mHeight;
+	LLPointer<LLImageRaw>	mResult;
+	std::vector<std::vector<U8> > mCaptures;
+};
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLImageCompositeThread
+//
+//   Runs a compositor on its own thread. The main thread polls isStopped()
+//   and then reads the result from getCompositor().
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLImageCompositeThread : public LLThread
+{
+public:
+	// Takes ownership of compositor.
+	LLImageCompositeThread(LLImageCompositor* compositor);
+	~LLImageCompositeThread();
+
+	LLImageCompositor* getCompositor()	{ return mCompositor; }
+	F32 getCompositeTime() const		{ return mCompositeTime; }
+
+protected:
+	/*virtual*/ void run();
+
+private:
+	LLImageCompositor*	mCompositor;
+	F32					mCompositeTime;
+};
+
+#endif // LL_LLIMAGECOMPOSITOR_H
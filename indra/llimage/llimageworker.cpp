@@ -27,8 +27,11 @@
 #include "linden_common.h"
 
 #include "llimageworker.h"
+#include "llfasttimer.h"
 #include "llimagedxt.h"
 
+static LLTrace::BlockTimerStatHandle FTM_IMAGE_DECODE("Image Decode");
+
 //----------------------------------------------------------------------------
 
 // MAIN THREAD
@@ -118,6 +121,7 @@ LLImageDecodeThread::ImageRequest::~ImageRequest()
 // Returns true when done, whether or not decode was successful.
 bool LLImageDecodeThread::ImageRequest::processRequest()
 {
+	LL_RECORD_BLOCK_TIME(FTM_IMAGE_DECODE);
 	const F32 decode_time_slice = .1f;
 	bool done = true;
 	if (!mDecodedRaw && mFormattedImage.notNull())
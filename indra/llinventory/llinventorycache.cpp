@@ -0,0 +1,339 @@
+/**
+ * @file llinventorycache.cpp
+ * @brief Packed binary on-disk inventory cache.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llinventorycache.h"
+
+#include <algorithm>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "hbxxh.h"
+#include "llfile.h"
+#include "llinventory.h"
+
+// 'LINV' read as a little endian U32. A file written on a machine of the
+// other byte order fails the magic test instead of loading garbage.
+static const U32 INVENTORY_CACHE_MAGIC = 0x564e494c;
+
+LL_STATIC_ASSERT(sizeof(LLInventoryCache::Header) == 32, "Inventory cache header layout changed");
+LL_STATIC_ASSERT(sizeof(LLInventoryCache::CategoryRecord) == 64, "Inventory cache category layout changed");
+LL_STATIC_ASSERT(sizeof(LLInventoryCache::ItemRecord) == 164, "Inventory cache item layout changed");
+
+static inline void pack_uuid(U8* dest, const LLUUID& id)
+{
+	memcpy(dest, id.mData, UUID_BYTES);		/* Flawfinder: ignore */
+}
+
+static inline LLUUID unpack_uuid(const U8* src)
+{
+	LLUUID id;
+	memcpy(id.mData, src, UUID_BYTES);		/* Flawfinder: ignore */
+	return id;
+}
+
+//---------------------------------------------------------------------------
+// LLInventoryCache::Writer
+//---------------------------------------------------------------------------
+
+LLInventoryCache::Writer::Writer(S32 cache_version)
+:	mCacheVersion(cache_version)
+{
+}
+
+LLInventoryCache::StringRef LLInventoryCache::Writer::addString(const std::string& str)
+{
+	StringRef ref;
+	ref.mOffset = (U32)mHeap.size();
+	ref.mLength = (U32)str.size();
+	mHeap.append(str);
+	return ref;
+}
+
+void LLInventoryCache::Writer::addCategory(const LLInventoryCategory* cat, const LLUUID& owner_id, S32 version)
+{
+	CategoryRecord rec;
+	memset(&rec, 0, sizeof(rec));
+	pack_uuid(rec.mID, cat->getUUID());
+	pack_uuid(rec.mParentID, cat->getParentUUID());
+	pack_uuid(rec.mOwnerID, owner_id);
+	rec.mVersion = version;
+	rec.mType = (S8)cat->getType();
+	rec.mPreferredType = (S8)cat->getPreferredType();
+	rec.mName = addString(cat->getName());
+	mCategories.push_back(rec);
+}
+
+void LLInventoryCache::Writer::addItem(const LLInventoryItem* item)
+{
+	const LLPermissions& perm = item->getPermissions();
+	const LLSaleInfo& sale_info = item->getSaleInfo();
+
+	ItemRecord rec;
+	memset(&rec, 0, sizeof(rec));
+	pack_uuid(rec.mID, item->getUUID());
+	pack_uuid(rec.mParentID, item->getParentUUID());
+	// Not getAssetUUID(), which follows links.
+	pack_uuid(rec.mAssetID, item->LLInventoryItem::getAssetUUID());
+	pack_uuid(rec.mCreatorID, perm.getCreator());
+	pack_uuid(rec.mOwnerID, perm.getOwner());
+	pack_uuid(rec.mLastOwnerID, perm.getLastOwner());
+	pack_uuid(rec.mGroupID, perm.getGroup());
+	rec.mMaskBase = perm.getMaskBase();
+	rec.mMaskOwner = perm.getMaskOwner();
+	rec.mMaskGroup = perm.getMaskGroup();
+	rec.mMaskEveryone = perm.getMaskEveryone();
+	rec.mMaskNextOwner = perm.getMaskNextOwner();
+	rec.mFlags = item->LLInventoryItem::getFlags();
+	rec.mCreationDate = (S32)item->LLInventoryItem::getCreationDate();
+	rec.mSalePrice = sale_info.getSalePrice();
+	rec.mType = (S8)item->getActualType();
+	rec.mInventoryType = (S8)item->LLInventoryItem::getInventoryType();
+	rec.mSaleType = (U8)sale_info.getSaleType();
+	rec.mGroupOwned = perm.isGroupOwned() ? 1 : 0;
+	rec.mName = addString(item->LLInventoryItem::getName());
+	rec.mDescription = addString(item->getActualDescription());
+	mItems.push_back(rec);
+}
+
+// Keeps items of the same folder next to each other, in their original
+// relative order.
+struct item_record_parent_less
+{
+	bool operator()(const LLInventoryCache::ItemRecord& lhs, const LLInventoryCache::ItemRecord& rhs) const
+	{
+		return memcmp(lhs.mParentID, rhs.mParentID, UUID_BYTES) < 0;
+	}
+};
+
+bool LLInventoryCache::Writer::write(const std::string& filename)
+{
+	std::stable_sort(mItems.begin(), mItems.end(), item_record_parent_less());
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	header.mMagic = INVENTORY_CACHE_MAGIC;
+	header.mFormatVersion = FORMAT_VERSION;
+	header.mCacheVersion = mCacheVersion;
+	header.mCategoryCount = (U32)mCategories.size();
+	header.mItemCount = (U32)mItems.size();
+	header.mHeapSize = (U32)mHeap.size();
+
+	const size_t cat_bytes = mCategories.size() * sizeof(CategoryRecord);
+	const size_t item_bytes = mItems.size() * sizeof(ItemRecord);
+
+	HBXXH64 hash;
+	if (cat_bytes) hash.update(&mCategories[0], cat_bytes);
+	if (item_bytes) hash.update(&mItems[0], item_bytes);
+	hash.update(mHeap);
+	header.mChecksum = hash.digest();
+
+	std::string temp_filename(filename + ".tmp");
+	LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+	if (!fp)
+	{
+		LL_WARNS("Inventory") << "Unable to open " << temp_filename << " for writing" << LL_ENDL;
+		return false;
+	}
+
+	bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+	if (success && cat_bytes)
+	{
+		success = fwrite(&mCategories[0], cat_bytes, 1, fp) == 1;
+	}
+	if (success && item_bytes)
+	{
+		success = fwrite(&mItems[0], item_bytes, 1, fp) == 1;
+	}
+	if (success && !mHeap.empty())
+	{
+		success = fwrite(mHeap.data(), mHeap.size(), 1, fp) == 1;
+	}
+	success = (LLFile::close(fp) == 0) && success;
+
+	if (success)
+	{
+		LLFile::remove_nowarn(filename);
+		success = LLFile::rename(temp_filename, filename) == 0;
+	}
+	if (!success)
+	{
+		LL_WARNS("Inventory") << "Failed writing inventory cache " << filename << LL_ENDL;
+		LLFile::remove(temp_filename);
+	}
+	return success;
+}
+
+//---------------------------------------------------------------------------
+// LLInventoryCache::Reader
+//---------------------------------------------------------------------------
+
+LLInventoryCache::Reader::Reader()
+:	mMapping(NULL),
+	mRegion(NULL),
+	mHeader(NULL),
+	mCategories(NULL),
+	mItems(NULL),
+	mHeap(NULL)
+{
+}
+
+LLInventoryCache::Reader::~Reader()
+{
+	close();
+}
+
+void LLInventoryCache::Reader::close()
+{
+	delete mRegion;
+	mRegion = NULL;
+	delete mMapping;
+	mMapping = NULL;
+	mHeader = NULL;
+	mCategories = NULL;
+	mItems = NULL;
+	mHeap = NULL;
+}
+
+bool LLInventoryCache::Reader::open(const std::string& filename, S32 cache_version, bool& is_obsolete)
+{
+	close();
+	is_obsolete = false;
+
+	if (!LLFile::isfile(filename))
+	{
+		return false;
+	}
+
+	try
+	{
+		mMapping = new boost::interprocess::file_mapping(filename.c_str(), boost::interprocess::read_only);
+		mRegion = new boost::interprocess::mapped_region(*mMapping, boost::interprocess::read_only);
+	}
+	catch (const boost::interprocess::interprocess_exception& e)
+	{
+		LL_WARNS("Inventory") << "Unable to map " << filename << ": " << e.what() << LL_ENDL;
+		close();
+		return false;
+	}
+
+	const size_t size = mRegion->get_size();
+	const char* base = (const char*)mRegion->get_address();
+	if (size < sizeof(Header))
+	{
+		LL_WARNS("Inventory") << "Truncated inventory cache " << filename << LL_ENDL;
+		close();
+		return false;
+	}
+
+	const Header* header = (const Header*)base;
+	if (header->mMagic != INVENTORY_CACHE_MAGIC || header->mFormatVersion != FORMAT_VERSION)
+	{
+		LL_INFOS("Inventory") << "Inventory cache " << filename << " has an unknown format" << LL_ENDL;
+		is_obsolete = true;
+		close();
+		return false;
+	}
+	if (header->mCacheVersion != cache_version)
+	{
+		is_obsolete = true;
+		close();
+		return false;
+	}
+
+	const U64 cat_bytes = (U64)header->mCategoryCount * sizeof(CategoryRecord);
+	const U64 item_bytes = (U64)header->mItemCount * sizeof(ItemRecord);
+	const U64 payload = cat_bytes + item_bytes + header->mHeapSize;
+	if (size != sizeof(Header) + payload)
+	{
+		LL_WARNS("Inventory") << "Inventory cache " << filename << " has the wrong size" << LL_ENDL;
+		is_obsolete = true;
+		close();
+		return false;
+	}
+
+	const char* data = base + sizeof(Header);
+	if (HBXXH64::digest(data, (size_t)payload) != header->mChecksum)
+	{
+		LL_WARNS("Inventory") << "Inventory cache " << filename << " is corrupt" << LL_ENDL;
+		is_obsolete = true;
+		close();
+		return false;
+	}
+
+	mHeader = header;
+	mCategories = (const CategoryRecord*)data;
+	mItems = (const ItemRecord*)(data + cat_bytes);
+	mHeap = data + cat_bytes + item_bytes;
+	return true;
+}
+
+std::string LLInventoryCache::Reader::getString(const StringRef& ref) const
+{
+	if ((U64)ref.mOffset + ref.mLength > mHeader->mHeapSize)
+	{
+		return LLStringUtil::null;
+	}
+	return std::string(mHeap + ref.mOffset, ref.mLength);
+}
+
+void LLInventoryCache::Reader::getCategory(U32 index, LLInventoryCategory* cat, LLUUID& owner_id, S32& version) const
+{
+	const CategoryRecord& rec = mCategories[index];
+	cat->setUUID(unpack_uuid(rec.mID));
+	cat->setParent(unpack_uuid(rec.mParentID));
+	cat->setType((LLAssetType::EType)rec.mType);
+	cat->setPreferredType((LLFolderType::EType)rec.mPreferredType);
+	cat->rename(getString(rec.mName));
+	owner_id = unpack_uuid(rec.mOwnerID);
+	version = rec.mVersion;
+}
+
+void LLInventoryCache::Reader::getItem(U32 index, LLInventoryItem* item) const
+{
+	const ItemRecord& rec = mItems[index];
+
+	LLPermissions perm;
+	perm.init(unpack_uuid(rec.mCreatorID), unpack_uuid(rec.mOwnerID),
+			  unpack_uuid(rec.mLastOwnerID), unpack_uuid(rec.mGroupID));
+	perm.initMasks(rec.mMaskBase, rec.mMaskOwner, rec.mMaskEveryone,
+				   rec.mMaskGroup, rec.mMaskNextOwner);
+	perm.yesReallySetOwner(perm.getOwner(), rec.mGroupOwned != 0);
+
+	item->setUUID(unpack_uuid(rec.mID));
+	item->setParent(unpack_uuid(rec.mParentID));
+	item->setAssetUUID(unpack_uuid(rec.mAssetID));
+	item->setType((LLAssetType::EType)rec.mType);
+	item->setInventoryType((LLInventoryType::EType)rec.mInventoryType);
+	// After the inventory type, which setPermissions() depends on.
+	item->setPermissions(perm);
+	item->setSaleInfo(LLSaleInfo((LLSaleInfo::EForSale)rec.mSaleType, rec.mSalePrice));
+	item->setFlags(rec.mFlags);
+	item->setCreationDate((time_t)rec.mCreationDate);
+	item->rename(getString(rec.mName));
+	item->setDescription(getString(rec.mDescription));
+}
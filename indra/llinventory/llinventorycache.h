@@ -0,0 +1,170 @@
+/**
+ * @file llinventorycache.h
+ * @brief Packed binary on-disk inventory cache.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINVENTORYCACHE_H
+#define LL_LLINVENTORYCACHE_H
+
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+#include "lluuid.h"
+
+class LLInventoryCategory;
+class LLInventoryItem;
+
+namespace boost { namespace interprocess {
+	class file_mapping;
+	class mapped_region;
+} }
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLInventoryCache
+//
+//   Binary replacement for the text inventory cache. The file is a header,
+//   an array of fixed width category records, an array of fixed width item
+//   records and a heap holding every name and description. Nothing needs
+//   parsing: the reader maps the file and hands out records in place.
+//
+//   Items are written grouped by parent folder so each folder's contents
+//   are contiguous in the file.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLInventoryCache
+{
+public:
+	// Bump whenever any of the records below change layout.
+	enum { FORMAT_VERSION = 1 };
+
+	struct Header
+	{
+		U32 mMagic;
+		U32 mFormatVersion;
+		S32 mCacheVersion;		// caller supplied, see LLInventoryModel
+		U32 mCategoryCount;
+		U32 mItemCount;
+		U32 mHeapSize;
+		U64 mChecksum;			// of everything following the header
+	};
+
+	struct StringRef
+	{
+		U32 mOffset;
+		U32 mLength;
+	};
+
+	struct CategoryRecord
+	{
+		U8	mID[UUID_BYTES];
+		U8	mParentID[UUID_BYTES];
+		U8	mOwnerID[UUID_BYTES];
+		S32	mVersion;
+		S8	mType;
+		S8	mPreferredType;
+		U8	mPad[2];
+		StringRef mName;
+	};
+
+	struct ItemRecord
+	{
+		U8	mID[UUID_BYTES];
+		U8	mParentID[UUID_BYTES];
+		U8	mAssetID[UUID_BYTES];
+		U8	mCreatorID[UUID_BYTES];
+		U8	mOwnerID[UUID_BYTES];
+		U8	mLastOwnerID[UUID_BYTES];
+		U8	mGroupID[UUID_BYTES];
+		U32	mMaskBase;
+		U32	mMaskOwner;
+		U32	mMaskGroup;
+		U32	mMaskEveryone;
+		U32	mMaskNextOwner;
+		U32	mFlags;
+		S32	mCreationDate;
+		S32	mSalePrice;
+		S8	mType;
+		S8	mInventoryType;
+		U8	mSaleType;
+		U8	mGroupOwned;
+		StringRef mName;
+		StringRef mDescription;
+	};
+
+	class Writer : boost::noncopyable
+	{
+	public:
+		Writer(S32 cache_version);
+
+		void addCategory(const LLInventoryCategory* cat, const LLUUID& owner_id, S32 version);
+		void addItem(const LLInventoryItem* item);
+
+		// Writes to a temporary file and renames it over filename, so a
+		// crash never leaves a truncated cache behind.
+		bool write(const std::string& filename);
+
+	private:
+		StringRef addString(const std::string& str);
+
+		S32 mCacheVersion;
+		std::vector<CategoryRecord> mCategories;
+		std::vector<ItemRecord> mItems;
+		std::string mHeap;
+	};
+
+	class Reader : boost::noncopyable
+	{
+	public:
+		Reader();
+		~Reader();
+
+		// Maps filename and validates it. Sets is_obsolete when the file is
+		// fine but was written for another cache_version.
+		bool open(const std::string& filename, S32 cache_version, bool& is_obsolete);
+		void close();
+
+		U32 getCategoryCount() const	{ return mHeader ? mHeader->mCategoryCount : 0; }
+		U32 getItemCount() const		{ return mHeader ? mHeader->mItemCount : 0; }
+
+		const CategoryRecord& getCategoryRecord(U32 index) const { return mCategories[index]; }
+		const ItemRecord& getItemRecord(U32 index) const { return mItems[index]; }
+
+		// Fill the shared LLInventory fields; viewer-side fields that only
+		// categories carry are returned through the out parameters.
+		void getCategory(U32 index, LLInventoryCategory* cat, LLUUID& owner_id, S32& version) const;
+		void getItem(U32 index, LLInventoryItem* item) const;
+
+	private:
+		std::string getString(const StringRef& ref) const;
+
+		boost::interprocess::file_mapping* mMapping;
+		boost::interprocess::mapped_region* mRegion;
+		const Header* mHeader;
+		const CategoryRecord* mCategories;
+		const ItemRecord* mItems;
+		const char* mHeap;
+	};
+};
+
+#endif // LL_LLINVENTORYCACHE_H
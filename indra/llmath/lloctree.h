@@ -30,6 +30,7 @@
 #include "lltreenode.h"
 #include "v3math.h"
 #include "llvector4a.h"
+#include "llmemtag.h"
 #include <vector>
 #ifdef TIME_UTC
 //Singu note: TIME_UTC is defined as '1' in time.h, and boost thread (1.49) tries to use it as an enum member.
@@ -287,6 +288,7 @@ public:
 #ifdef LL_OCTREE_STATS
 		OctreeStats::getInstance()->addNode();
 #endif
+		LLMemTag::addLocal(LLMemTag::MT_OCTREE, sizeof(*this));
 		if(gOctreeReserveCapacity)
 			mData.reserve(gOctreeReserveCapacity);
 #ifdef LL_OCTREE_STATS
@@ -314,6 +316,7 @@ public:
 #ifdef LL_OCTREE_STATS
 		OctreeStats::getInstance()->removeNode();
 #endif
+		LLMemTag::subLocal(LLMemTag::MT_OCTREE, sizeof(*this));
 		BaseType::destroyListeners(); 
 		
 		//for (U32 i = 0; i < mElementCount; ++i)
@@ -26,6 +26,7 @@
 
 #include "linden_common.h"
 #include "llmemory.h"
+#include "llmemtag.h"
 #include "llmath.h"
 
 #include <set>
@@ -4683,7 +4684,11 @@ LLVolumeFace::LLVolumeFace() :
 	mWeights(NULL),
 	mWeightsScrubbed(FALSE),
 	mOctree(NULL),
-	mOptimized(FALSE)
+	mOptimized(FALSE),
+	mVertexBytes(0),
+	mTangentBytes(0),
+	mWeightBytes(0),
+	mIndexBytes(0)
 {
 	mExtents = (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a)*3);
 	mExtents[0].splat(-0.5f);
@@ -4709,7 +4714,11 @@ LLVolumeFace::LLVolumeFace(const LLVolumeFace& src)
 	mWeights(NULL),
 	mWeightsScrubbed(FALSE),
 	mOctree(NULL),
-	mOptimized(FALSE)
+	mOptimized(FALSE),
+	mVertexBytes(0),
+	mTangentBytes(0),
+	mWeightBytes(0),
+	mIndexBytes(0)
 { 
 	mExtents = (LLVector4a*) ll_aligned_malloc_16(sizeof(LLVector4a)*3);
 	mCenter = mExtents+2;
@@ -5509,6 +5518,9 @@ void LLVolumeFace::swapData(LLVolumeFace& rhs)
 	llswap(rhs.mIndices,mIndices);
 	llswap(rhs.mNumVertices, mNumVertices);
 	llswap(rhs.mNumIndices, mNumIndices);
+	llswap(rhs.mVertexBytes, mVertexBytes);
+	llswap(rhs.mTangentBytes, mTangentBytes);
+	llswap(rhs.mIndexBytes, mIndexBytes);
 }
 
 void	LerpPlanarVertex(LLVolumeFace::VertexData& v0,
@@ -6259,6 +6271,12 @@ void LLVolumeFace::pushVertex(const LLVector4a& pos, const LLVector4a& norm, con
 	mNumVertices++;	
 }
 
+static void account_volume_bytes(S32& accounted, S32 bytes)
+{
+	LLMemTag::add(LLMemTag::MT_VOLUME, bytes - accounted);
+	accounted = bytes;
+}
+
 void LLVolumeFace::allocateTangents(S32 num_verts)
 {
 	ll_aligned_free_16(mTangents);
@@ -6267,6 +6285,7 @@ void LLVolumeFace::allocateTangents(S32 num_verts)
 	{
 		mTangents = (LLVector4a*)ll_aligned_malloc_16(sizeof(LLVector4a)*num_verts);
 	}
+	account_volume_bytes(mTangentBytes, sizeof(LLVector4a)*num_verts);
 }
 
 void LLVolumeFace::allocateWeights(S32 num_verts)
@@ -6277,6 +6296,7 @@ void LLVolumeFace::allocateWeights(S32 num_verts)
 	{
 		mWeights = (LLVector4a*)ll_aligned_malloc_16(sizeof(LLVector4a)*num_verts);
 	}
+	account_volume_bytes(mWeightBytes, sizeof(LLVector4a)*num_verts);
 }
 
 void LLVolumeFace::allocateVertices(S32 num_verts, bool copy)
@@ -6319,6 +6339,7 @@ void LLVolumeFace::allocateVertices(S32 num_verts, bool copy)
 		}
 	}
 	mNumAllocatedVertices = num_verts;
+	account_volume_bytes(mVertexBytes, num_verts * sizeof(LLVector4a) * 2 + ((num_verts * sizeof(LLVector2) + 0xF) & ~0xF));
 }
 
 void LLVolumeFace::allocateIndices(S32 num_indices, bool copy)
@@ -6338,6 +6359,7 @@ void LLVolumeFace::allocateIndices(S32 num_indices, bool copy)
 		mIndices = (U16*)ll_aligned_realloc_16(mIndices, new_size, old_size);
 
 		mNumIndices = num_indices;
+		account_volume_bytes(mIndexBytes, new_size);
 		return;
 	}
 	ll_aligned_free_16(mIndices);
@@ -6348,6 +6370,7 @@ void LLVolumeFace::allocateIndices(S32 num_indices, bool copy)
 	}
 
 	mNumIndices = num_indices;
+	account_volume_bytes(mIndexBytes, num_indices ? new_size : 0);
 }
 void LLVolumeFace::resizeIndices(S32 num_indices)
 {
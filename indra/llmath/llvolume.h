@@ -973,6 +973,12 @@ private:
 	BOOL createUnCutCubeCap(LLVolume* volume, BOOL partial_build = FALSE);
 	BOOL createCap(LLVolume* volume, BOOL partial_build = FALSE);
 	BOOL createSide(LLVolume* volume, BOOL partial_build = FALSE);
+
+	// Bytes of each buffer reported to LLMemTag::MT_VOLUME.
+	S32 mVertexBytes;
+	S32 mTangentBytes;
+	S32 mWeightBytes;
+	S32 mIndexBytes;
 };
 
 class LLVolume : public LLRefCount
@@ -35,6 +35,7 @@
 #include "aicurlperservice.h"
 #include "aiaverage.h"
 #include "aicurltimer.h"
+#include "llfasttimer.h"
 #include "lltimer.h"		// ms_sleep, get_clock_count
 #include "llhttpstatuscodes.h"
 #include "llbuffer.h"
@@ -1382,6 +1383,9 @@ static bool is_bad(curl_socket_t fd, bool for_writing)
 }
 
 // The main loop of the curl thread.
+static LLTrace::BlockTimerStatHandle FTM_CURL_SOCKET_ACTION("Curl Socket Action");
+static LLTrace::BlockTimerStatHandle FTM_CURL_MESSAGES("Curl Messages");
+
 void AICurlThread::run(void)
 {
   DoutEntering(dc::curl, "AICurlThread::run()");
@@ -1605,6 +1609,7 @@ void AICurlThread::run(void)
 		  --ready;
 		}
 		// Handle all active filedescriptors.
+		LL_RECORD_BLOCK_TIME(FTM_CURL_SOCKET_ACTION);
 		MergeIterator iter(multi_handle_w->mReadPollSet, multi_handle_w->mWritePollSet);
 		curl_socket_t fd;
 		int ev_bitmask;
@@ -1619,7 +1624,10 @@ void AICurlThread::run(void)
 		// that libcurl removed file descriptors which we subsequently
 		// didn't handle.
 	  }
-	  multi_handle_w->check_msg_queue();
+	  {
+		LL_RECORD_BLOCK_TIME(FTM_CURL_MESSAGES);
+		multi_handle_w->check_msg_queue();
+	  }
 	}
 	// Clear the queued requests.
 	AIPerService::purge();
@@ -113,6 +113,9 @@ public:
 	F64 mNextUpdate;
 
 private:
+	// Reads and writes the fields below directly
+	friend class LLNameCacheFile;
+
 	// "bobsmith123" or "james.linden", US-ASCII only
 	std::string mUsername;
 
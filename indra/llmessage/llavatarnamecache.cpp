@@ -30,10 +30,13 @@
 
 #include "llcachename.h"		// we wrap this system
 #include "llcontrol.h"		// For LLCachedControl
+#include "llfile.h"
 #include "llframetimer.h"
 #include "llhttpclient.h"
+#include "llnamecachefile.h"
 #include "llsd.h"
 #include "llsdserialize.h"
+#include "lltimer.h"
 
 #include <boost/tokenizer.hpp>
 
@@ -67,6 +70,9 @@ namespace LLAvatarNameCache
 	typedef uuid_set_t ask_queue_t;
 	ask_queue_t sAskQueue;
 
+	// When the oldest ID in sAskQueue was queued.
+	F64 sAskQueueTime = 0.0;
+
 	// Agent IDs that have been requested, but with no reply.
 	// Maps agent ID to frame time request was made.
 	typedef std::map<LLUUID, F64> pending_queue_t;
@@ -83,9 +89,11 @@ namespace LLAvatarNameCache
 	typedef std::map<LLUUID, LLAvatarName> cache_t;
 	cache_t sCache;
 
-	// Send bulk lookup requests a few times a second at most.
-	// Only need per-frame timing resolution.
-	LLFrameTimer sRequestTimer;
+	// Reads the binary cache at startup, NULL once merged.
+	LLNameCacheLoader* sCacheLoader = NULL;
+	load_failed_callback_t sCacheLoadFailed;
+
+	Stats sStats;
 
     // Maximum time an unrefreshed cache entry is allowed.
     const F64 MAX_UNREFRESHED_TIME = 20.0 * 60.0;
@@ -104,7 +112,10 @@ namespace LLAvatarNameCache
 	void processName(const LLUUID& agent_id,
 					 const LLAvatarName& av_name);
 
-	void requestNamesViaCapability();
+	// Queue agent_id for the next batch request.
+	void queueRequest(const LLUUID& agent_id);
+
+	void requestNamesViaCapability(U32 max_ids);
 
 	// Legacy name system callbacks
 	void legacyNameCallback(const LLUUID& agent_id,
@@ -128,6 +139,9 @@ namespace LLAvatarNameCache
 	void eraseUnrefreshed();
 
 	bool expirationFromCacheControl(AIHTTPReceivedHeaders const& headers, F64* expires);
+
+	// Merge the names read by sCacheLoader, if it is done or wait is set.
+	void mergeLoadedCache(bool wait);
 }
 
 /* Sample response:
@@ -297,7 +311,15 @@ void LLAvatarNameCache::processName(const LLUUID& agent_id, const LLAvatarName&
 	sCache[agent_id] = av_name;
 
 	// Suppress request from the queue
-	sPendingQueue.erase(agent_id);
+	pending_queue_t::iterator pending_it = sPendingQueue.find(agent_id);
+	if (pending_it != sPendingQueue.end())
+	{
+		const F64 latency = LLFrameTimer::getTotalSeconds() - pending_it->second;
+		++sStats.mReceived;
+		sStats.mTotalLatency += latency;
+		sStats.mMaxLatency = llmax(sStats.mMaxLatency, latency);
+		sPendingQueue.erase(pending_it);
+	}
 
 	// Signal everyone waiting on this name
 	signal_map_t::iterator sig_it =	sSignalMap.find(agent_id);
@@ -313,7 +335,16 @@ void LLAvatarNameCache::processName(const LLUUID& agent_id, const LLAvatarName&
 	}
 }
 
-void LLAvatarNameCache::requestNamesViaCapability()
+void LLAvatarNameCache::queueRequest(const LLUUID& agent_id)
+{
+	if (sAskQueue.empty())
+	{
+		sAskQueueTime = LLFrameTimer::getTotalSeconds();
+	}
+	sAskQueue.insert(agent_id);
+}
+
+void LLAvatarNameCache::requestNamesViaCapability(U32 max_ids)
 {
 	F64 now = LLFrameTimer::getTotalSeconds();
 
@@ -357,7 +388,7 @@ void LLAvatarNameCache::requestNamesViaCapability()
 		// mark request as pending
 		sPendingQueue[agent_id] = now;
 
-		if (url.size() > NAME_URL_SEND_THRESHOLD)
+		if (url.size() > NAME_URL_SEND_THRESHOLD || ids >= max_ids)
 		{
 			break;
 		}
@@ -365,6 +396,8 @@ void LLAvatarNameCache::requestNamesViaCapability()
 
 	if (!url.empty())
 	{
+		++sStats.mBatches;
+		sStats.mRequested += ids;
 		LL_INFOS("AvNameCache") << "LLAvatarNameCache::requestNamesViaCapability getting " << ids << " ids" << LL_ENDL;
 		LLHTTPClient::get(url, new LLAvatarNameResponder(agent_ids));
 	}
@@ -417,6 +450,7 @@ void LLAvatarNameCache::requestNamesViaLegacy()
 		// Mark as pending first, just in case the callback is immediately
 		// invoked below.  This should never happen in practice.
 		sPendingQueue[agent_id] = now;
+		++sStats.mRequested;
 
 		LL_DEBUGS("AvNameCache") << "LLAvatarNameCache::requestNamesViaLegacy agent " << agent_id << LL_ENDL;
 
@@ -433,6 +467,7 @@ void LLAvatarNameCache::initClass(bool running, bool usePeopleAPI)
 
 void LLAvatarNameCache::cleanupClass()
 {
+	mergeLoadedCache(true);
 	sCache.clear();
 }
 
@@ -444,29 +479,42 @@ bool LLAvatarNameCache::importFile(std::istream& istr)
         LL_WARNS("AvNameCache") << "avatar name cache data xml parse failed" << LL_ENDL;
 		return false;
 	}
+	importLLSD(data);
+	return true;
+}
 
+void LLAvatarNameCache::importLLSD(const LLSD& data)
+{
 	// by convention LLSD storage is a map
 	// we only store one entry in the map
 	LLSD agents = data["agents"];
 
 	LLUUID agent_id;
 	LLAvatarName av_name;
+	S32 loaded = 0;
 	LLSD::map_const_iterator it = agents.beginMap();
 	for ( ; it != agents.endMap(); ++it)
 	{
 		agent_id.set(it->first);
+		// Anything that came in off the network meanwhile is newer
+		if (sCache.count(agent_id)) continue;
+
 		av_name.fromLLSD( it->second );
 		sCache[agent_id] = av_name;
+		++loaded;
 	}
-    LL_INFOS("AvNameCache") << "LLAvatarNameCache loaded " << sCache.size() << LL_ENDL;
+    LL_INFOS("AvNameCache") << "LLAvatarNameCache loaded " << loaded << LL_ENDL;
 	// Some entries may have expired since the cache was stored,
     // but they will be flushed in the first call to eraseUnrefreshed
     // from LLAvatarNameResponder::idle
-
-    return true;
 }
 
 void LLAvatarNameCache::exportFile(std::ostream& ostr)
+{
+	LLSDSerialize::toPrettyXML(exportLLSD(), ostr);
+}
+
+LLSD LLAvatarNameCache::exportLLSD()
 {
 	LLSD agents;
 	F64 max_unrefreshed = LLFrameTimer::getTotalSeconds() - MAX_UNREFRESHED_TIME;
@@ -486,7 +534,130 @@ void LLAvatarNameCache::exportFile(std::ostream& ostr)
     LL_INFOS("AvNameCache") << "LLAvatarNameCache returning " << agents.size() << LL_ENDL;
 	LLSD data;
 	data["agents"] = agents;
-	LLSDSerialize::toPrettyXML(data, ostr);
+	return data;
+}
+
+bool LLAvatarNameCache::loadCache(const std::string& filename,
+								  const load_failed_callback_t& on_failure)
+{
+	if (sCacheLoader || !LLFile::isfile(filename))
+	{
+		return false;
+	}
+	sCacheLoadFailed = on_failure;
+	sCacheLoader = new LLNameCacheLoader(filename);
+	sCacheLoader->start();
+	return true;
+}
+
+bool LLAvatarNameCache::isLoadingCache()
+{
+	return sCacheLoader != NULL;
+}
+
+void LLAvatarNameCache::mergeLoadedCache(bool wait)
+{
+	if (!sCacheLoader) return;
+
+	while (!sCacheLoader->isStopped())
+	{
+		if (!wait) return;
+		ms_sleep(1);
+	}
+
+	if (sCacheLoader->succeeded())
+	{
+		LLNameCacheFile& file = sCacheLoader->getFile();
+		F64 now = LLFrameTimer::getTotalSeconds();
+		S32 loaded = 0;
+		for (LLNameCacheFile::avatar_vec_t::const_iterator it = file.mAvatarNames.begin();
+			 it != file.mAvatarNames.end(); ++it)
+		{
+			const LLUUID& agent_id = it->mID;
+			// Anything that came in off the network meanwhile is newer
+			if (sCache.count(agent_id)) continue;
+
+			++loaded;
+			if (it->mName.mExpires > now)
+			{
+				// No need to ask for it anymore; answer whoever waits on it
+				sAskQueue.erase(agent_id);
+				processName(agent_id, it->mName);
+			}
+			else
+			{
+				sCache[agent_id] = it->mName;
+			}
+		}
+		LL_INFOS("AvNameCache") << "LLAvatarNameCache loaded " << loaded << " names in "
+								<< sCacheLoader->getLoadTime() << " seconds" << LL_ENDL;
+
+		if (gCacheName)
+		{
+			gCacheName->importCache(file);
+		}
+	}
+
+	bool failed = !sCacheLoader->succeeded();
+	delete sCacheLoader;
+	sCacheLoader = NULL;
+	// Requests held back while loading are overdue.
+	sAskQueueTime = 0.0;
+
+	load_failed_callback_t on_failure;
+	on_failure.swap(sCacheLoadFailed);
+	// Not worth it when waiting, that is when saving or shutting down.
+	if (failed && !wait && on_failure)
+	{
+		LL_WARNS("AvNameCache") << "Could not read the name cache file" << LL_ENDL;
+		on_failure();
+	}
+}
+
+bool LLAvatarNameCache::saveCache(const std::string& filename)
+{
+	// Don't lose what is still being loaded.
+	mergeLoadedCache(true);
+
+	LLNameCacheFile file;
+	F64 max_unrefreshed = LLFrameTimer::getTotalSeconds() - MAX_UNREFRESHED_TIME;
+	file.mAvatarNames.reserve(sCache.size());
+	for (cache_t::const_iterator it = sCache.begin(); it != sCache.end(); ++it)
+	{
+		// Do not write temporary or expired entries to the stored cache
+		if (it->second.isValidName(max_unrefreshed))
+		{
+			LLNameCacheFile::AvatarEntry entry;
+			entry.mID = it->first;
+			entry.mName = it->second;
+			file.mAvatarNames.push_back(entry);
+		}
+	}
+	if (gCacheName)
+	{
+		gCacheName->exportCache(file);
+	}
+
+	LL_INFOS("AvNameCache") << "LLAvatarNameCache saving " << file.mAvatarNames.size() << " names and "
+							<< file.mLegacyNames.size() << " legacy names" << LL_ENDL;
+	dumpStats();
+	return file.write(filename);
+}
+
+const LLAvatarNameCache::Stats& LLAvatarNameCache::getStats()
+{
+	return sStats;
+}
+
+void LLAvatarNameCache::dumpStats()
+{
+	LL_INFOS("AvNameCache") << "LLAvatarNameCache hits: " << sStats.mHits
+							<< " misses: " << sStats.mMisses
+							<< " requests: " << sStats.mBatches
+							<< " names requested: " << sStats.mRequested
+							<< " received: " << sStats.mReceived
+							<< " mean latency: " << (sStats.mReceived ? sStats.mTotalLatency / sStats.mReceived : 0.0)
+							<< "s max latency: " << sStats.mMaxLatency << "s" << LL_ENDL;
 }
 
 void LLAvatarNameCache::setNameLookupURL(const std::string& name_lookup_url)
@@ -509,32 +680,43 @@ void LLAvatarNameCache::idle()
 	// By convention, start running at first idle() call
 	sRunning = true;
 
-	// *TODO: Possibly re-enabled this based on People API load measurements
-	// 100 ms is the threshold for "user speed" operations, so we can
-	// stall for about that long to batch up requests.
-	const F32 SECS_BETWEEN_REQUESTS = 0.1f;
-	if (!sRequestTimer.hasExpired())
+	// Don't ask the network for names the cache file is about to provide.
+	if (sCacheLoader)
 	{
-		return;
+		mergeLoadedCache(false);
+		if (sCacheLoader)
+		{
+			return;
+		}
 	}
 
-	if (!sAskQueue.empty())
+	// A full batch goes out at once; a partial one waits a little for more
+	// names, 100 ms being the threshold for "user speed" operations. The
+	// URL length caps a batch at about 85 ids.
+	static const LLCachedControl<U32> max_batch("NameLookupMaxBatch", 64);
+	static const LLCachedControl<F32> max_delay("NameLookupMaxDelay", 0.1f);
+	static const S32 MAX_REQUESTS_PER_FRAME = 4;
+	const U32 batch_size = llclamp((U32)max_batch, 1U, 85U);
+	const F64 now = LLFrameTimer::getTotalSeconds();
+	for (S32 requests = 0; !sAskQueue.empty() && requests < MAX_REQUESTS_PER_FRAME; ++requests)
 	{
+		if (sAskQueue.size() < batch_size && now - sAskQueueTime < (F64)max_delay)
+		{
+			break;
+		}
+
         if (usePeopleAPI())
         {
-            requestNamesViaCapability();
+            requestNamesViaCapability(batch_size);
         }
         else
         {
             LL_WARNS_ONCE("AvNameCache") << "LLAvatarNameCache still using legacy api" << LL_ENDL;
             requestNamesViaLegacy();
+            ++sStats.mBatches;
         }
-	}
-
-	if (sAskQueue.empty())
-	{
-		// cleared the list, reset the request timer.
-		sRequestTimer.resetWithExpiry(SECS_BETWEEN_REQUESTS);
+		// Whatever is left over starts a new batch
+		sAskQueueTime = now;
 	}
 
     // erase anything that has not been refreshed for more than MAX_UNREFRESHED_TIME
@@ -597,6 +779,7 @@ bool LLAvatarNameCache::get(const LLUUID& agent_id, LLAvatarName *av_name)
 		std::map<LLUUID,LLAvatarName>::iterator it = sCache.find(agent_id);
 		if (it != sCache.end())
 		{
+			++sStats.mHits;
 			*av_name = it->second;
 
 			// re-request name if entry is expired
@@ -606,7 +789,7 @@ bool LLAvatarNameCache::get(const LLUUID& agent_id, LLAvatarName *av_name)
 				{
 					LL_DEBUGS("AvNameCache") << "LLAvatarNameCache refresh agent " << agent_id
 											 << LL_ENDL;
-					sAskQueue.insert(agent_id);
+					queueRequest(agent_id);
 				}
 			}
 			
@@ -617,6 +800,7 @@ bool LLAvatarNameCache::get(const LLUUID& agent_id, LLAvatarName *av_name)
 			std::string full_name;
 			if (gCacheName->getFullName(agent_id, full_name))
 			{
+				++sStats.mHits;
 				av_name->fromString(full_name);
 				sCache[agent_id] = *av_name;
 				return true;
@@ -624,10 +808,11 @@ bool LLAvatarNameCache::get(const LLUUID& agent_id, LLAvatarName *av_name)
 		}
 	}
 
+	++sStats.mMisses;
 	if (!isRequestPending(agent_id))
 	{
 		LL_DEBUGS("AvNameCache") << "LLAvatarNameCache queue request for agent " << agent_id << LL_ENDL;
-		sAskQueue.insert(agent_id);
+		queueRequest(agent_id);
 	}
 
 	return false;
@@ -673,6 +858,7 @@ LLAvatarNameCache::callback_connection_t LLAvatarNameCache::get(const LLUUID& ag
 			if (av_name.mExpires > LLFrameTimer::getTotalSeconds())
 			{
 				// ...name already exists in cache, fire callback now
+				++sStats.mHits;
 				fireSignal(agent_id, slot, av_name);
 				return connection;
 			}
@@ -680,9 +866,10 @@ LLAvatarNameCache::callback_connection_t LLAvatarNameCache::get(const LLUUID& ag
 	}
 
 	// schedule a request
+	++sStats.mMisses;
 	if (!isRequestPending(agent_id))
 	{
-		sAskQueue.insert(agent_id);
+		queueRequest(agent_id);
 	}
 
 	// always store additional callback, even if request is pending
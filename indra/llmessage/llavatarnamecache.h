@@ -30,6 +30,7 @@
 
 #include "llavatarname.h"	// for convenience
 
+#include <boost/function.hpp>
 #include <boost/signals2.hpp>
 
 class AIHTTPReceivedHeaders;
@@ -48,6 +49,35 @@ namespace LLAvatarNameCache
 	// Import/export the name cache to file.
 	bool importFile(std::istream& istr);
 	void exportFile(std::ostream& ostr);
+	// The same as LLSD, for callers that parse or format it themselves.
+	// Importing keeps the names already in the cache.
+	void importLLSD(const LLSD& data);
+	LLSD exportLLSD();
+
+	// Compact binary cache holding both these names and the LLCacheName
+	// ones (see LLNameCacheFile). loadCache() reads the file on a worker
+	// thread; the names are merged in from idle(), which holds back
+	// network requests until then. Returns false if there is no file.
+	// When the file turns out to be unreadable, idle() calls on_failure
+	// instead, so that the caller can fall back to another cache.
+	typedef boost::function<void()> load_failed_callback_t;
+	bool loadCache(const std::string& filename,
+				   const load_failed_callback_t& on_failure = load_failed_callback_t());
+	bool isLoadingCache();
+	bool saveCache(const std::string& filename);
+
+	struct Stats
+	{
+		U32 mHits;				// get() calls answered from the cache
+		U32 mMisses;			// get() calls that had to queue a request
+		U32 mBatches;			// lookup requests sent
+		U32 mRequested;			// names asked for in those requests
+		U32 mReceived;			// names that came back
+		F64 mTotalLatency;		// seconds from request to reply, summed
+		F64 mMaxLatency;
+	};
+	const Stats& getStats();
+	void dumpStats();
 
 	// On the viewer, usually a simulator capabilitity.
 	// If empty, name cache will fall back to using legacy name lookup system.
@@ -59,7 +89,8 @@ namespace LLAvatarNameCache
 	bool usePeopleAPI();
 	
 	// Periodically makes a batch request for display names not already in
-	// cache.  Called once per frame.
+	// cache: once NameLookupMaxBatch names are queued, or the oldest queued
+	// name waited NameLookupMaxDelay seconds.  Called once per frame.
 	void idle();
 
 	// If name is in cache, returns true and fills in provided LLAvatarName
@@ -645,6 +645,43 @@ void LLBufferArray::writeChannelTo(std::ostream& ostr, S32 channel) const
 	}
 }
 
+const U8* LLBufferArray::getContiguous(S32 channel, S32& len, std::vector<U8>& scratch) const
+{
+	LLMutexLock lock(mMutexp) ;
+	const U8* first = NULL;
+	S32 segments = 0;
+	len = 0;
+	const_segment_iterator_t const end = mSegments.end();
+	for (const_segment_iterator_t it = mSegments.begin(); it != end; ++it)
+	{
+		if (it->isOnChannel(channel) && it->size())
+		{
+			if (!first)
+			{
+				first = it->data();
+			}
+			len += it->size();
+			++segments;
+		}
+	}
+	if (segments <= 1)
+	{
+		return first;
+	}
+
+	scratch.resize(len);
+	U8* dest = &scratch[0];
+	for (const_segment_iterator_t it = mSegments.begin(); it != end; ++it)
+	{
+		if (it->isOnChannel(channel))
+		{
+			memcpy(dest, it->data(), it->size());	/* Flawfinder: ignore */
+			dest += it->size();
+		}
+	}
+	return &scratch[0];
+}
+
 U8* LLBufferArray::seek(
 	S32 channel,
 	U8* start,
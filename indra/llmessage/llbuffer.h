@@ -598,6 +598,19 @@ public:
 	 */
 	void writeChannelTo(std::ostream& ostr, S32 channel) const;
 
+	/**
+	 * @brief Get the data on a channel as one block.
+	 *
+	 * When the data lives in a single segment, which is the usual case
+	 * for a body received in one go, this points into that segment.
+	 * Otherwise the segments are copied into scratch.
+	 * @param channel The channel to read.
+	 * @param len[out] The number of bytes on the channel.
+	 * @param scratch Storage for the copy, when one is needed.
+	 * @return Returns the start of the data, NULL when there is none.
+	 */
+	const U8* getContiguous(S32 channel, S32& len, std::vector<U8>& scratch) const;
+
 protected:
 	/** 
 	 * @brief Optimally put data in buffers, and reutrn segments.
@@ -33,6 +33,7 @@
 #include "lldbstrings.h"
 #include "llframetimer.h"
 #include "llhost.h"
+#include "llnamecachefile.h"
 #include "llrand.h"
 #include "llsdserialize.h"
 #include "lluuid.h"
@@ -317,7 +318,12 @@ bool LLCacheName::importFile(std::istream& istr)
 	{
 		return false;
 	}
+	importLLSD(data);
+	return true;
+}
 
+void LLCacheName::importLLSD(const LLSD& data)
+{
 	// We'll expire entries more than a week old
 	U32 now = (U32)time(NULL);
 	const U32 SECS_PER_DAY = 60 * 60 * 24;
@@ -334,6 +340,8 @@ bool LLCacheName::importFile(std::istream& istr)
 		LLSD agent = (*iter).second;
 		U32 ctime = (U32)agent[CTIME].asInteger();
 		if(ctime < delete_before_time) continue;
+		// Anything that came in off the network meanwhile is newer
+		if(impl.mCache.count(id)) continue;
 
 		LLCacheNameEntry* entry = new LLCacheNameEntry();
 		entry->mIsGroup = false;
@@ -358,6 +366,7 @@ bool LLCacheName::importFile(std::istream& istr)
 		LLSD group = (*iter).second;
 		U32 ctime = (U32)group[CTIME].asInteger();
 		if(ctime < delete_before_time) continue;
+		if(impl.mCache.count(id)) continue;
 
 		LLCacheNameEntry* entry = new LLCacheNameEntry();
 		entry->mIsGroup = true;
@@ -368,10 +377,14 @@ bool LLCacheName::importFile(std::istream& istr)
 		++count;
 	}
 	LL_INFOS() << "LLCacheName loaded " << count << " group names" << LL_ENDL;
-	return true;
 }
 
 void LLCacheName::exportFile(std::ostream& ostr)
+{
+	LLSDSerialize::toPrettyXML(exportLLSD(), ostr);
+}
+
+LLSD LLCacheName::exportLLSD()
 {
 	LLSD data;
 	Cache::iterator iter = impl.mCache.begin();
@@ -403,10 +416,79 @@ void LLCacheName::exportFile(std::ostream& ostr)
 			data[GROUPS][id_str][CTIME] = (S32)entry->mCreateTime;
 		}
 	}
+	return data;
+}
+
+void LLCacheName::importCache(const LLNameCacheFile& file)
+{
+	// Same expiry as importFile()
+	U32 now = (U32)time(NULL);
+	const U32 SECS_PER_DAY = 60 * 60 * 24;
+	U32 delete_before_time = now - (7 * SECS_PER_DAY);
+
+	S32 agents = 0;
+	S32 groups = 0;
+	for (LLNameCacheFile::legacy_vec_t::const_iterator it = file.mLegacyNames.begin();
+		 it != file.mLegacyNames.end(); ++it)
+	{
+		if (it->mCreateTime < delete_before_time || impl.mCache.count(it->mID)) continue;
 
-	LLSDSerialize::toPrettyXML(data, ostr);
+		LLCacheNameEntry* entry = new LLCacheNameEntry();
+		entry->mIsGroup = it->mIsGroup;
+		entry->mCreateTime = it->mCreateTime;
+		if (it->mIsGroup)
+		{
+			entry->mGroupName = it->mGroupName;
+			impl.mReverseCache[entry->mGroupName] = it->mID;
+			++groups;
+		}
+		else
+		{
+			entry->mFirstName = it->mFirstName;
+			entry->mLastName = it->mLastName;
+			impl.mReverseCache[buildFullName(entry->mFirstName, entry->mLastName)] = it->mID;
+			++agents;
+		}
+		impl.mCache[it->mID] = entry;
+	}
+	LL_INFOS() << "LLCacheName loaded " << agents << " agent names and " << groups << " group names" << LL_ENDL;
 }
 
+void LLCacheName::exportCache(LLNameCacheFile& file)
+{
+	file.mLegacyNames.reserve(file.mLegacyNames.size() + impl.mCache.size());
+	for (Cache::const_iterator iter = impl.mCache.begin(), end = impl.mCache.end(); iter != end; ++iter)
+	{
+		// Same filtering as exportFile()
+		const LLCacheNameEntry* entry = iter->second;
+		if (!entry
+		   || (std::string::npos != entry->mFirstName.find('?'))
+		   || (std::string::npos != entry->mGroupName.find('?')))
+		{
+			continue;
+		}
+
+		LLNameCacheFile::LegacyEntry legacy;
+		legacy.mID = iter->first;
+		legacy.mCreateTime = entry->mCreateTime;
+		if (!entry->mFirstName.empty() && !entry->mLastName.empty())
+		{
+			legacy.mIsGroup = false;
+			legacy.mFirstName = entry->mFirstName;
+			legacy.mLastName = entry->mLastName;
+		}
+		else if (entry->mIsGroup && !entry->mGroupName.empty())
+		{
+			legacy.mIsGroup = true;
+			legacy.mGroupName = entry->mGroupName;
+		}
+		else
+		{
+			continue;
+		}
+		file.mLegacyNames.push_back(legacy);
+	}
+}
 
 BOOL LLCacheName::Impl::getName(const LLUUID& id, std::string& first, std::string& last)
 {
@@ -32,6 +32,7 @@
 
 class LLMessageSystem;
 class LLHost;
+class LLNameCacheFile;
 class LLUUID;
 
 
@@ -69,6 +70,14 @@ public:
 	// storing cache on disk; for viewer, in name.cache
 	bool importFile(std::istream& istr);
 	void exportFile(std::ostream& ostr);
+	// The same as LLSD; importing keeps the names already in the cache.
+	void importLLSD(const LLSD& data);
+	LLSD exportLLSD();
+
+	// Binary cache shared with LLAvatarNameCache, which does the file I/O.
+	// Imported names never replace names already in the cache.
+	void importCache(const LLNameCacheFile& file);
+	void exportCache(LLNameCacheFile& file);
 
 	// If available, copies name ("bobsmith123" or "James Linden") into string
 	// If not available, copies the string "waiting".
@@ -335,7 +335,10 @@ LLIOPipe::EStatus LLFilterSD2XMLRPCResponse::process_impl(
 	LLBufferStream stream(channels, buffer.get());
 	stream << XML_HEADER << XMLRPC_METHOD_RESPONSE_HEADER << std::flush;	// Flush, or buffer->count() returns too much!
 	LLSD sd;
-	LLSDSerialize::fromNotation(sd, stream, buffer->count(channels.in()));
+	std::vector<U8> scratch;
+	S32 len = 0;
+	const U8* data = buffer->getContiguous(channels.in(), len, scratch);
+	LLSDSerialize::fromNotation(sd, (const char*)data, len, len);
 
 	PUMP_DEBUG;
 	LLIOPipe::EStatus rv = STATUS_ERROR;
@@ -407,11 +410,13 @@ LLIOPipe::EStatus LLFilterSD2XMLRPCRequest::process_impl(
 		return STATUS_BREAK;
 	}
 
-	// See if we can parse it
+	// See if we can parse it, in place when the request is in one segment
 	LLBufferStream stream(channels, buffer.get());
 	LLSD sd;
-	LLSDSerialize::fromNotation(sd, stream, buffer->count(channels.in()));
-	if(stream.fail())
+	std::vector<U8> scratch;
+	S32 len = 0;
+	const U8* data = buffer->getContiguous(channels.in(), len, scratch);
+	if(LLSDSerialize::fromNotation(sd, (const char*)data, len, len) == LLSDParser::PARSE_FAILURE)
 	{
 		LL_INFOS() << "STREAM FAILURE reading structure data." << LL_ENDL;
 	}
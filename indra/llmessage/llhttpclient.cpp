@@ -26,16 +26,19 @@
 
 #include "linden_common.h"
 
+#include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
 #include <xmlrpc-epi/xmlrpc.h>
 
 #include "llhttpclient.h"
 #include "llbufferstream.h"
+#include "llsdasync.h"
 #include "llsdserialize.h"
 #include "llvfile.h"
 #include "llurlrequest.h"
 #include "llxmltree.h"
 #include "aihttptimeoutpolicy.h"
+#include "aithreadid.h"
 
 class AIHTTPTimeoutPolicy;
 extern AIHTTPTimeoutPolicy blockingLLSDPost_timeout;
@@ -458,6 +461,17 @@ void LLHTTPClient::ResponderWithResult::finished(CURLcode code, U32 http_status,
   mStatus = http_status;
   mReason = reason;
 
+  if (parseBodyAsync() && isGoodStatus(http_status) && !is_internal_http_error(http_status) && is_main_thread())
+  {
+	AICurlInterface::Stats::llsd_body_count++;
+	std::stringstream ss;
+	buffer->writeChannelTo(ss, channels.in());
+	// Keep this responder alive until the body has been parsed.
+	LLSDAsyncSerializer::parse(ss.str(), LLSDSerialize::LLSD_XML,
+		boost::bind(&ResponderWithResult::asyncBodyParsed, boost::intrusive_ptr<ResponderWithResult>(this), _1, _2));
+	return;
+  }
+
   // Fill mContent.
   decode_llsd_body(channels, buffer);
 
@@ -476,6 +490,22 @@ void LLHTTPClient::ResponderWithResult::finished(CURLcode code, U32 http_status,
   mFinished = true;
 }
 
+// static
+void LLHTTPClient::ResponderWithResult::asyncBodyParsed(boost::intrusive_ptr<ResponderWithResult> const& responder, bool success, LLSD const& content)
+{
+  if (success)
+  {
+	responder->mContent = content;
+  }
+  else
+  {
+	LL_WARNS() << "Failed to deserialize LLSD. " << responder->mURL << " [" << responder->mStatus << "]: " << responder->mReason << LL_ENDL;
+	AICurlInterface::Stats::llsd_body_parse_error++;
+  }
+  responder->httpSuccess();
+  responder->mFinished = true;
+}
+
 // virtual
 void LLHTTPClient::ResponderWithResult::httpFailure(void)
 {
@@ -414,6 +414,14 @@ public:
 		// The default prints the error to llinfos.
 		virtual void httpFailure(void);
 
+		// Derived classes that receive large bodies can return true to have a successful body parsed by
+		// LLSDAsyncSerializer instead; httpSuccess() is then called from the main loop in a later frame.
+		// Only honoured when the request finishes on the main thread.
+		virtual bool parseBodyAsync(void) const { return false; }
+
+	private:
+		static void asyncBodyParsed(boost::intrusive_ptr<ResponderWithResult> const& responder, bool success, LLSD const& content);
+
 	public:
 		// Called from LLSDMessage::ResponderAdapter::listener.
 		// LLSDMessage::ResponderAdapter is a hack, showing among others by fact that it needs these functions.
@@ -0,0 +1,292 @@
+/**
+ * @file llnamecachefile.cpp
+ * @brief Compact binary on-disk cache shared by LLAvatarNameCache and
+ * LLCacheName.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llnamecachefile.h"
+
+#include "hbxxh.h"
+#include "llfile.h"
+#include "lltimer.h"
+
+// 'LNAM', little endian
+static const U32 NAME_CACHE_MAGIC = 0x4d414e4c;
+
+namespace
+{
+	struct Header
+	{
+		U32 mMagic;
+		U32 mFormatVersion;
+		U32 mAvatarCount;
+		U32 mLegacyCount;
+		U32 mDataSize;
+		U32 mPad;
+		U64 mChecksum;			// of everything following the header
+	};
+
+	enum
+	{
+		AVATAR_DISPLAY_NAME_DEFAULT = 1 << 0
+	};
+
+	class Packer
+	{
+	public:
+		Packer(std::string& buffer) : mBuffer(buffer) {}
+
+		template<typename T> void put(const T& value)
+		{
+			mBuffer.append((const char*)&value, sizeof(T));
+		}
+		void putUUID(const LLUUID& id)
+		{
+			mBuffer.append((const char*)id.mData, UUID_BYTES);
+		}
+		void putString(const std::string& str)
+		{
+			const U16 length = (U16)llmin(str.size(), (size_t)U16_MAX);
+			put(length);
+			mBuffer.append(str.data(), length);
+		}
+
+	private:
+		std::string& mBuffer;
+	};
+
+	class Unpacker
+	{
+	public:
+		Unpacker(const char* data, size_t size) : mData(data), mSize(size), mPos(0), mFailed(false) {}
+
+		bool failed() const { return mFailed; }
+
+		template<typename T> T get()
+		{
+			T value = T();
+			if (check(sizeof(T)))
+			{
+				memcpy(&value, mData + mPos, sizeof(T));
+				mPos += sizeof(T);
+			}
+			return value;
+		}
+		void getUUID(LLUUID& id)
+		{
+			if (check(UUID_BYTES))
+			{
+				memcpy(id.mData, mData + mPos, UUID_BYTES);
+				mPos += UUID_BYTES;
+			}
+		}
+		void getString(std::string& str)
+		{
+			const U16 length = get<U16>();
+			if (check(length))
+			{
+				str.assign(mData + mPos, length);
+				mPos += length;
+			}
+		}
+
+	private:
+		bool check(size_t bytes)
+		{
+			if (mFailed || mPos + bytes > mSize)
+			{
+				mFailed = true;
+				return false;
+			}
+			return true;
+		}
+
+		const char* mData;
+		size_t mSize;
+		size_t mPos;
+		bool mFailed;
+	};
+}
+
+void LLNameCacheFile::clear()
+{
+	mAvatarNames.clear();
+	mLegacyNames.clear();
+}
+
+bool LLNameCacheFile::write(const std::string& filename) const
+{
+	std::string data;
+	Packer packer(data);
+	for (avatar_vec_t::const_iterator it = mAvatarNames.begin(); it != mAvatarNames.end(); ++it)
+	{
+		const LLAvatarName& av_name = it->mName;
+		packer.putUUID(it->mID);
+		packer.put(av_name.mExpires);
+		packer.put(av_name.mNextUpdate);
+		packer.put((U8)(av_name.mIsDisplayNameDefault ? AVATAR_DISPLAY_NAME_DEFAULT : 0));
+		packer.putString(av_name.mUsername);
+		packer.putString(av_name.mDisplayName);
+		packer.putString(av_name.mLegacyFirstName);
+		packer.putString(av_name.mLegacyLastName);
+	}
+	for (legacy_vec_t::const_iterator it = mLegacyNames.begin(); it != mLegacyNames.end(); ++it)
+	{
+		packer.putUUID(it->mID);
+		packer.put(it->mCreateTime);
+		packer.put((U8)it->mIsGroup);
+		if (it->mIsGroup)
+		{
+			packer.putString(it->mGroupName);
+		}
+		else
+		{
+			packer.putString(it->mFirstName);
+			packer.putString(it->mLastName);
+		}
+	}
+
+	Header header;
+	memset(&header, 0, sizeof(header));
+	header.mMagic = NAME_CACHE_MAGIC;
+	header.mFormatVersion = FORMAT_VERSION;
+	header.mAvatarCount = (U32)mAvatarNames.size();
+	header.mLegacyCount = (U32)mLegacyNames.size();
+	header.mDataSize = (U32)data.size();
+	header.mChecksum = HBXXH64::digest(data);
+
+	std::string temp_filename(filename + ".tmp");
+	LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+	if (!fp)
+	{
+		LL_WARNS("AvNameCache") << "Unable to open " << temp_filename << " for writing" << LL_ENDL;
+		return false;
+	}
+
+	bool success = fwrite(&header, sizeof(header), 1, fp) == 1;
+	if (success && !data.empty())
+	{
+		success = fwrite(data.data(), data.size(), 1, fp) == 1;
+	}
+	success = (LLFile::close(fp) == 0) && success;
+
+	if (success)
+	{
+		LLFile::remove_nowarn(filename);
+		success = LLFile::rename(temp_filename, filename) == 0;
+	}
+	if (!success)
+	{
+		LL_WARNS("AvNameCache") << "Failed writing name cache " << filename << LL_ENDL;
+		LLFile::remove(temp_filename);
+	}
+	return success;
+}
+
+bool LLNameCacheFile::read(const std::string& filename)
+{
+	clear();
+
+	LLFILE* fp = LLFile::fopen(filename, "rb");
+	if (!fp)
+	{
+		return false;
+	}
+
+	Header header;
+	std::string data;
+	bool success = fread(&header, sizeof(header), 1, fp) == 1
+		&& header.mMagic == NAME_CACHE_MAGIC
+		&& header.mFormatVersion == FORMAT_VERSION;
+	if (success && header.mDataSize)
+	{
+		data.resize(header.mDataSize);
+		success = fread(&data[0], header.mDataSize, 1, fp) == 1
+			&& fgetc(fp) == EOF;
+	}
+	LLFile::close(fp);
+
+	if (!success || HBXXH64::digest(data) != header.mChecksum)
+	{
+		LL_WARNS("AvNameCache") << "Name cache " << filename << " is obsolete or corrupt" << LL_ENDL;
+		return false;
+	}
+
+	Unpacker unpacker(data.data(), data.size());
+	mAvatarNames.resize(header.mAvatarCount);
+	for (avatar_vec_t::iterator it = mAvatarNames.begin(); it != mAvatarNames.end() && !unpacker.failed(); ++it)
+	{
+		LLAvatarName& av_name = it->mName;
+		unpacker.getUUID(it->mID);
+		av_name.mExpires = unpacker.get<F64>();
+		av_name.mNextUpdate = unpacker.get<F64>();
+		av_name.mIsDisplayNameDefault = (unpacker.get<U8>() & AVATAR_DISPLAY_NAME_DEFAULT) != 0;
+		av_name.mIsTemporaryName = false;
+		unpacker.getString(av_name.mUsername);
+		unpacker.getString(av_name.mDisplayName);
+		unpacker.getString(av_name.mLegacyFirstName);
+		unpacker.getString(av_name.mLegacyLastName);
+	}
+	mLegacyNames.resize(header.mLegacyCount);
+	for (legacy_vec_t::iterator it = mLegacyNames.begin(); it != mLegacyNames.end() && !unpacker.failed(); ++it)
+	{
+		unpacker.getUUID(it->mID);
+		it->mCreateTime = unpacker.get<U32>();
+		it->mIsGroup = unpacker.get<U8>() != 0;
+		if (it->mIsGroup)
+		{
+			unpacker.getString(it->mGroupName);
+		}
+		else
+		{
+			unpacker.getString(it->mFirstName);
+			unpacker.getString(it->mLastName);
+		}
+	}
+
+	if (unpacker.failed())
+	{
+		LL_WARNS("AvNameCache") << "Name cache " << filename << " is truncated" << LL_ENDL;
+		clear();
+		return false;
+	}
+	return true;
+}
+
+LLNameCacheLoader::LLNameCacheLoader(const std::string& filename)
+:	LLThread("name cache loader"),
+	mFilename(filename),
+	mLoadTime(0.f),
+	mSucceeded(false)
+{
+}
+
+void LLNameCacheLoader::run()
+{
+	LLTimer timer;
+	mSucceeded = mFile.read(mFilename);
+	mLoadTime = timer.getElapsedTimeF32();
+}
@@ -0,0 +1,110 @@
+/**
+ * @file llnamecachefile.h
+ * @brief Compact binary on-disk cache shared by LLAvatarNameCache and
+ * LLCacheName.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLNAMECACHEFILE_H
+#define LL_LLNAMECACHEFILE_H
+
+#include <string>
+#include <vector>
+
+#include "llavatarname.h"
+#include "llthread.h"
+#include "lluuid.h"
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLNameCacheFile
+//
+//   One file for both name systems: the display names of LLAvatarNameCache
+//   and the legacy agent and group names of LLCacheName. Replaces
+//   avatar_name_cache.xml and name.cache, which both had to be parsed as
+//   LLSD XML at login.
+//
+//   The file is a header followed by packed records; strings are stored
+//   with a 16 bits length prefix.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLNameCacheFile
+{
+public:
+	// Bump whenever the record layout changes.
+	enum { FORMAT_VERSION = 1 };
+
+	struct AvatarEntry
+	{
+		LLUUID			mID;
+		LLAvatarName	mName;
+	};
+
+	struct LegacyEntry
+	{
+		LLUUID			mID;
+		U32				mCreateTime;	// unix time_t
+		bool			mIsGroup;
+		std::string		mFirstName;
+		std::string		mLastName;
+		std::string		mGroupName;
+	};
+
+	typedef std::vector<AvatarEntry> avatar_vec_t;
+	typedef std::vector<LegacyEntry> legacy_vec_t;
+
+	void clear();
+
+	// False if the file is missing, of another format version or corrupt.
+	bool read(const std::string& filename);
+	// Writes to a temporary file first, so a crash leaves the old file.
+	bool write(const std::string& filename) const;
+
+	avatar_vec_t	mAvatarNames;
+	legacy_vec_t	mLegacyNames;
+};
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLNameCacheLoader
+//
+//   Reads a name cache file on its own thread. The main thread polls
+//   isStopped() and then takes the names from getFile().
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLNameCacheLoader : public LLThread
+{
+public:
+	LLNameCacheLoader(const std::string& filename);
+
+	bool succeeded() const			{ return mSucceeded; }
+	F32 getLoadTime() const			{ return mLoadTime; }
+	LLNameCacheFile& getFile()		{ return mFile; }
+
+protected:
+	/*virtual*/ void run();
+
+private:
+	std::string		mFilename;
+	LLNameCacheFile	mFile;
+	F32				mLoadTime;
+	bool			mSucceeded;
+};
+
+#endif // LL_LLNAMECACHEFILE_H
@@ -0,0 +1,139 @@
+/**
+ * @file llnamecachefile_test.cpp
+ * @brief LLNameCacheFile test cases.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "../llnamecachefile.h"
+#include "llfile.h"
+#include "llsd.h"
+
+#include "../test/lltut.h"
+
+namespace tut
+{
+	struct namecachefile_data
+	{
+		namecachefile_data()
+		:	mFilename("name_cache_test.bin")
+		{
+		}
+
+		~namecachefile_data()
+		{
+			LLFile::remove_nowarn(mFilename);
+		}
+
+		std::string mFilename;
+	};
+	typedef test_group<namecachefile_data> namecachefile_test;
+	typedef namecachefile_test::object namecachefile_object;
+	tut::namecachefile_test namecachefile_testcase("LLNameCacheFile");
+
+	template<> template<>
+	void namecachefile_object::test<1>()
+	{
+		// Round trip both kinds of names.
+		LLNameCacheFile out;
+		LLNameCacheFile::AvatarEntry avatar;
+		avatar.mID.generate();
+		LLSD sd;
+		sd["username"] = "james.linden";
+		sd["display_name"] = "Jos\xc3\xa9 Sanchez";
+		sd["legacy_first_name"] = "James";
+		sd["legacy_last_name"] = "Linden";
+		sd["is_display_name_default"] = false;
+		avatar.mName.fromLLSD(sd);
+		avatar.mName.mExpires = 1700000000.5;
+		avatar.mName.mNextUpdate = 1700003600.25;
+		out.mAvatarNames.push_back(avatar);
+
+		LLNameCacheFile::LegacyEntry agent;
+		agent.mID.generate();
+		agent.mCreateTime = 1234567;
+		agent.mIsGroup = false;
+		agent.mFirstName = "bobsmith123";
+		agent.mLastName = "Resident";
+		out.mLegacyNames.push_back(agent);
+
+		LLNameCacheFile::LegacyEntry group;
+		group.mID.generate();
+		group.mCreateTime = 7654321;
+		group.mIsGroup = true;
+		group.mGroupName = "Linden Lab";
+		out.mLegacyNames.push_back(group);
+
+		ensure("write failed", out.write(mFilename));
+
+		LLNameCacheFile in;
+		ensure("read failed", in.read(mFilename));
+		ensure_equals("avatar count", in.mAvatarNames.size(), (size_t)1);
+		ensure_equals("legacy count", in.mLegacyNames.size(), (size_t)2);
+
+		const LLAvatarName& av_name = in.mAvatarNames[0].mName;
+		ensure_equals("avatar id", in.mAvatarNames[0].mID, avatar.mID);
+		ensure_equals("username", av_name.getAccountName(), std::string("james.linden"));
+		ensure_equals("legacy name", av_name.getLegacyName(), std::string("James Linden"));
+		ensure_equals("display name", av_name.asLLSD()["display_name"].asString(), sd["display_name"].asString());
+		ensure("display name default", !av_name.isDisplayNameDefault());
+		ensure_equals("expires", av_name.mExpires, avatar.mName.mExpires);
+		ensure_equals("next update", av_name.mNextUpdate, avatar.mName.mNextUpdate);
+
+		ensure_equals("agent id", in.mLegacyNames[0].mID, agent.mID);
+		ensure_equals("agent ctime", in.mLegacyNames[0].mCreateTime, agent.mCreateTime);
+		ensure("agent is group", !in.mLegacyNames[0].mIsGroup);
+		ensure_equals("first name", in.mLegacyNames[0].mFirstName, agent.mFirstName);
+		ensure_equals("last name", in.mLegacyNames[0].mLastName, agent.mLastName);
+		ensure_equals("group id", in.mLegacyNames[1].mID, group.mID);
+		ensure("group not group", in.mLegacyNames[1].mIsGroup);
+		ensure_equals("group name", in.mLegacyNames[1].mGroupName, group.mGroupName);
+	}
+
+	template<> template<>
+	void namecachefile_object::test<2>()
+	{
+		// Corrupted and truncated files are rejected.
+		LLNameCacheFile out;
+		LLNameCacheFile::LegacyEntry agent;
+		agent.mID.generate();
+		agent.mCreateTime = 1;
+		agent.mIsGroup = false;
+		agent.mFirstName = "Random";
+		agent.mLastName = "Linden";
+		out.mLegacyNames.push_back(agent);
+		ensure("write failed", out.write(mFilename));
+
+		LLFILE* fp = LLFile::fopen(mFilename, "r+b");
+		ensure("reopen failed", fp != NULL);
+		fseek(fp, -2, SEEK_END);
+		fputc('x', fp);
+		fclose(fp);
+
+		LLNameCacheFile in;
+		ensure("read corrupt file", !in.read(mFilename));
+		ensure("names from corrupt file", in.mLegacyNames.empty());
+		ensure("read missing file", !in.read(mFilename + ".missing"));
+	}
+}
@@ -36,6 +36,7 @@
 #include "llshadermgr.h"
 #include "llglslshader.h"
 #include "llmemory.h"
+#include "llmemtag.h"
 
 //Next Highest Power Of Two
 //helper function, returns first number > v that is a power of 2, or v if v is already a power of 2
@@ -250,10 +251,12 @@ volatile U8* LLVBOPool::allocate(U32& name, U32 size, U32 seed)
 		if (mType == GL_ARRAY_BUFFER_ARB)
 		{
 			LLVertexBuffer::sAllocatedBytes += size;
+			LLMemTag::add(LLMemTag::MT_VERTEX_BUFFER, size);
 		}
 		else
 		{
 			LLVertexBuffer::sAllocatedIndexBytes += size;
+			LLMemTag::add(LLMemTag::MT_INDEX_BUFFER, size);
 		}
 
 		if (LLVertexBuffer::sDisableVBOMapping || mUsage != GL_DYNAMIC_DRAW_ARB)
@@ -320,10 +323,12 @@ void LLVBOPool::release(U32 name, volatile U8* buffer, U32 size)
 	if (mType == GL_ARRAY_BUFFER_ARB)
 	{
 		LLVertexBuffer::sAllocatedBytes -= size;
+		LLMemTag::sub(LLMemTag::MT_VERTEX_BUFFER, size);
 	}
 	else
 	{
 		LLVertexBuffer::sAllocatedIndexBytes -= size;
+		LLMemTag::sub(LLMemTag::MT_INDEX_BUFFER, size);
 	}
 }
 
@@ -401,11 +406,13 @@ void LLVBOPool::cleanup()
 			{
 				sBytesPooled -= size;
 				LLVertexBuffer::sAllocatedBytes -= size;
+				LLMemTag::sub(LLMemTag::MT_VERTEX_BUFFER, size);
 			}
 			else
 			{
 				sIndexBytesPooled -= size;
 				LLVertexBuffer::sAllocatedIndexBytes -= size;
+				LLMemTag::sub(LLMemTag::MT_INDEX_BUFFER, size);
 			}
 		}
 
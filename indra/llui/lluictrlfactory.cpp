@@ -70,6 +70,7 @@
 #include "llui.h"
 #include "lluiimage.h"
 #include "llviewborder.h"
+#include "llxuicache.h"
 
 LLTrace::BlockTimerStatHandle FTM_WIDGET_CONSTRUCTION("Widget Construction");
 LLTrace::BlockTimerStatHandle FTM_INIT_FROM_PARAMS("Widget InitFromParams");
@@ -174,50 +175,32 @@ const std::vector<std::string>& LLUICtrlFactory::getXUIPaths()
 //-----------------------------------------------------------------------------
 bool LLUICtrlFactory::getLayeredXMLNode(const std::string &xui_filename, LLXMLNodePtr& root)
 {
-	std::string full_filename = gDirUtilp->findSkinnedFilenameBaseLang(LLDir::XUI, xui_filename);
-	if (full_filename.empty())
+	LLXUICache::layer_vec_t layers = LLXUICache::findLayers(xui_filename);
+	if (layers.empty())
 	{
 		// try filename as passed in since sometimes we load an xml file from a user-supplied path
 		if (gDirUtilp->fileExists(xui_filename))
 		{
-			full_filename = xui_filename;
-		}
-		else
-		{
-			LL_WARNS() << "Couldn't find UI description file: " << sXUIPaths.front() + gDirUtilp->getDirDelimiter() + xui_filename << LL_ENDL;
-			return false;
+			if (!LLXMLNode::parseFile(xui_filename, root, NULL))
+			{
+				LL_WARNS() << "Problem reading UI description file: " << xui_filename << LL_ENDL;
+				return false;
+			}
+			return true;
 		}
+		LL_WARNS() << "Couldn't find UI description file: " << sXUIPaths.front() + gDirUtilp->getDirDelimiter() + xui_filename << LL_ENDL;
+		return false;
 	}
 
-	if (!LLXMLNode::parseFile(full_filename, root, NULL))
+	if (LLXUICache::get(layers, root))
 	{
-		LL_WARNS() << "Problem reading UI description file: " << full_filename << LL_ENDL;
-		return false;
+		return true;
 	}
-	
-	std::vector<std::string> paths =
-	gDirUtilp->findSkinnedFilenames(LLDir::XUI, xui_filename);
-
-	for ( auto& layer_filename : paths )
+	if (!LLXUICache::parseLayers(layers, root))
 	{
-		LLXMLNodePtr updateRoot;
-		if (!LLXMLNode::parseFile(layer_filename, updateRoot, NULL))
-		{
-			LL_WARNS() << "Problem reading localized UI description file: " << layer_filename << LL_ENDL;
-			return false;
-		}
-
-		std::string updateName;
-		std::string nodeName;
-		updateRoot->getAttributeString("name", updateName);
-		root->getAttributeString("name", nodeName);
-
-		if (updateName == nodeName)
-		{
-			LLXMLNode::updateNode(root, updateRoot);
-		}
+		return false;
 	}
-
+	LLXUICache::put(layers, root);
 	return true;
 }
 
@@ -239,13 +222,20 @@ void LLUICtrlFactory::buildFloater(LLFloater* floaterp, const std::string& filen
 									const LLCallbackMap::map_t* factory_map, BOOL open) /* Flawfinder: ignore */
 {
 	LLXMLNodePtr root;
+	LLTimer timer;
+	const U32 hits = LLXUICache::getHitCount();
 
 	if (!LLUICtrlFactory::getLayeredXMLNode(filename, root))
 	{
 		return;
 	}
+	const F32 xml_ms = timer.getElapsedTimeF32() * 1000.f;
 	
 	buildFloaterInternal(floaterp, root, filename, factory_map, open);
+
+	LL_DEBUGS("XUI") << "Built floater " << filename << " in " << timer.getElapsedTimeF32() * 1000.f
+					 << " ms, of which " << xml_ms << " ms getting the "
+					 << (LLXUICache::getHitCount() != hits ? "cached" : "parsed") << " XML" << LL_ENDL;
 }
 
 void LLUICtrlFactory::buildFloaterFromBuffer(LLFloater *floaterp, const std::string &buffer,
@@ -337,14 +327,22 @@ BOOL LLUICtrlFactory::buildPanel(LLPanel* panelp, const std::string& filename,
 									const LLCallbackMap::map_t* factory_map)
 {
 	LLXMLNodePtr root;
+	LLTimer timer;
+	const U32 hits = LLXUICache::getHitCount();
 
 	if (!LLUICtrlFactory::getLayeredXMLNode(filename, root))
 	{
 		return FALSE;
 	}
+	const F32 xml_ms = timer.getElapsedTimeF32() * 1000.f;
 	
-	return buildPanelInternal(panelp, root, filename, factory_map);
-	}
+	BOOL didPost = buildPanelInternal(panelp, root, filename, factory_map);
+
+	LL_DEBUGS("XUI") << "Built panel " << filename << " in " << timer.getElapsedTimeF32() * 1000.f
+					 << " ms, of which " << xml_ms << " ms getting the "
+					 << (LLXUICache::getHitCount() != hits ? "cached" : "parsed") << " XML" << LL_ENDL;
+	return didPost;
+}
 
 BOOL LLUICtrlFactory::buildPanelFromBuffer(LLPanel *panelp, const std::string &buffer,
                                            const LLCallbackMap::map_t* factory_map)
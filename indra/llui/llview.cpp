@@ -43,6 +43,7 @@
 #include "llevent.h"
 #include "llfontgl.h"
 #include "llfocusmgr.h"
+#include "llmemtag.h"
 #include "llrect.h"
 #include "llstl.h"
 #include "llui.h"
@@ -125,6 +126,9 @@ LLView::LLView(const LLView::Params& p)
 
 void LLView::init(const LLView::Params& p)
 {
+	// Only the object itself, the children account for themselves.
+	LLMemTag::add(LLMemTag::MT_UI, sizeof(LLView));
+
 	mVisible = p.visible;
 	mInDraw = false;
 	mName = p.name;
@@ -177,6 +181,7 @@ LLView::~LLView()
 {
 	//LL_INFOS() << "Deleting view " << mName << ":" << (void*) this << LL_ENDL;
 // 	llassert(LLView::sIsDrawing == FALSE);
+	LLMemTag::sub(LLMemTag::MT_UI, sizeof(LLView));
 
 	if( hasMouseCapture() )
 	{
@@ -0,0 +1,435 @@
+/**
+ * @file llxuicache.cpp
+ * @brief Process wide cache of parsed and merged XUI trees.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "linden_common.h"
+
+#include "llxuicache.h"
+
+#include <deque>
+#include <map>
+
+#include "lldir.h"
+#include "llthread.h"
+#include "lltimer.h"
+
+U32 LLXUICache::sHits = 0;
+U32 LLXUICache::sMisses = 0;
+
+namespace
+{
+	struct LayerStamp
+	{
+		S64	mSize;
+		S64	mModified;
+
+		bool operator==(const LayerStamp& rhs) const
+		{
+			return mSize == rhs.mSize && mModified == rhs.mModified;
+		}
+	};
+
+	bool get_stamp(const std::string& filename, LayerStamp& stamp)
+	{
+		llstat status;
+		if (LLFile::stat(filename, &status))
+		{
+			return false;
+		}
+		stamp.mSize = (S64)status.st_size;
+		stamp.mModified = (S64)status.st_mtime;
+		return true;
+	}
+
+	struct CacheEntry
+	{
+		std::vector<LayerStamp>	mStamps;
+		LLXMLNodePtr			mRoot;
+	};
+
+	// Keyed by the layer file names joined with newlines
+	typedef std::map<std::string, CacheEntry> cache_map_t;
+	cache_map_t sCache;
+
+	std::string make_key(const LLXUICache::layer_vec_t& layers)
+	{
+		std::string key;
+		for (LLXUICache::layer_vec_t::const_iterator it = layers.begin(); it != layers.end(); ++it)
+		{
+			key += *it;
+			key += '\n';
+		}
+		return key;
+	}
+
+	bool is_valid(const LLXUICache::layer_vec_t& layers, const CacheEntry& entry)
+	{
+		if (entry.mStamps.size() != layers.size())
+		{
+			return false;
+		}
+		for (size_t i = 0; i < layers.size(); ++i)
+		{
+			LayerStamp stamp;
+			if (!get_stamp(layers[i], stamp) || !(stamp == entry.mStamps[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	//-------------------------------------------------------------------------
+	// Warm up
+	//-------------------------------------------------------------------------
+
+	struct WarmUpFile
+	{
+		LLXUICache::layer_vec_t		mLayers;
+		std::vector<std::string>	mBuffers;
+		bool						mSuccess;
+	};
+	typedef std::deque<WarmUpFile*> file_queue_t;
+
+	// Reads the layers the main thread found. LLDir is not thread safe
+	// either, so the lookups stay on the main thread too.
+	class WarmUpThread : public LLThread
+	{
+	public:
+		WarmUpThread()
+		:	LLThread("XUI cache warm up")
+		{
+		}
+
+		~WarmUpThread()
+		{
+			for (file_queue_t::iterator it = mQueue.begin(); it != mQueue.end(); ++it)
+			{
+				delete *it;
+			}
+			for (file_queue_t::iterator it = mDone.begin(); it != mDone.end(); ++it)
+			{
+				delete *it;
+			}
+		}
+
+		void queueFile(WarmUpFile* file)
+		{
+			mCondition.lock();
+			mQueue.push_back(file);
+			mCondition.signal();
+			mCondition.unlock();
+		}
+
+		// The caller owns the returned files.
+		void takeFiles(file_queue_t& files)
+		{
+			LLMutexLock lock(mCondition);
+			files.insert(files.end(), mDone.begin(), mDone.end());
+			mDone.clear();
+		}
+
+		bool isIdle()
+		{
+			LLMutexLock lock(mCondition);
+			return mQueue.empty() && mDone.empty() && !mBusy;
+		}
+
+		/*virtual*/ void shutdown()
+		{
+			setQuitting();
+			mCondition.lock();
+			mCondition.signal();
+			mCondition.unlock();
+			LLThread::shutdown();
+		}
+
+	protected:
+		/*virtual*/ void run();
+
+	private:
+		LLCondition		mCondition;		// guards the queues and mBusy
+		file_queue_t	mQueue;
+		file_queue_t	mDone;
+		bool			mBusy = false;
+	};
+
+	bool read_file(const std::string& filename, std::string& buffer)
+	{
+		LLFILE* fp = LLFile::fopen(filename, "rb");
+		if (!fp)
+		{
+			return false;
+		}
+		fseek(fp, 0, SEEK_END);
+		const long length = ftell(fp);
+		fseek(fp, 0, SEEK_SET);
+		bool success = length >= 0;
+		if (success)
+		{
+			buffer.resize(length);
+			success = !length || fread(&buffer[0], 1, length, fp) == (size_t)length;
+		}
+		LLFile::close(fp);
+		return success;
+	}
+
+	void WarmUpThread::run()
+	{
+		while (true)
+		{
+			mCondition.lock();
+			while (mQueue.empty() && !isQuitting())
+			{
+				mCondition.wait();
+			}
+			if (isQuitting())
+			{
+				mCondition.unlock();
+				break;
+			}
+			WarmUpFile* file = mQueue.front();
+			mQueue.pop_front();
+			mBusy = true;
+			mCondition.unlock();
+
+			file->mBuffers.resize(file->mLayers.size());
+			file->mSuccess = true;
+			for (size_t i = 0; file->mSuccess && i < file->mLayers.size(); ++i)
+			{
+				file->mSuccess = read_file(file->mLayers[i], file->mBuffers[i]);
+			}
+
+			LLMutexLock lock(mCondition);
+			mDone.push_back(file);
+			mBusy = false;
+		}
+	}
+
+	WarmUpThread* sWarmUpThread = NULL;
+	std::deque<std::string> sWarmUpNames;		// layers not looked up yet
+	file_queue_t sWarmUpFiles;					// read, waiting to be parsed
+}
+
+//static
+LLXUICache::layer_vec_t LLXUICache::findLayers(const std::string& xui_filename)
+{
+	layer_vec_t layers;
+	const std::string full_filename = gDirUtilp->findSkinnedFilenameBaseLang(LLDir::XUI, xui_filename);
+	if (full_filename.empty())
+	{
+		return layers;
+	}
+	layers.push_back(full_filename);
+
+	// The base file comes back first: merging it with itself changes nothing.
+	std::vector<std::string> paths = gDirUtilp->findSkinnedFilenames(LLDir::XUI, xui_filename);
+	for (std::vector<std::string>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+	{
+		if (*it != full_filename)
+		{
+			layers.push_back(*it);
+		}
+	}
+	return layers;
+}
+
+//static
+bool LLXUICache::get(const layer_vec_t& layers, LLXMLNodePtr& root)
+{
+	cache_map_t::iterator it = sCache.find(make_key(layers));
+	if (it == sCache.end())
+	{
+		++sMisses;
+		return false;
+	}
+	if (!is_valid(layers, it->second))
+	{
+		sCache.erase(it);
+		++sMisses;
+		return false;
+	}
+	++sHits;
+	root = it->second.mRoot->deepCopy();
+	return true;
+}
+
+//static
+void LLXUICache::put(const layer_vec_t& layers, const LLXMLNodePtr& root)
+{
+	CacheEntry entry;
+	entry.mStamps.resize(layers.size());
+	for (size_t i = 0; i < layers.size(); ++i)
+	{
+		if (!get_stamp(layers[i], entry.mStamps[i]))
+		{
+			return;
+		}
+	}
+	entry.mRoot = root->deepCopy();
+	sCache[make_key(layers)] = entry;
+}
+
+//static
+bool LLXUICache::parseLayers(const layer_vec_t& layers, LLXMLNodePtr& root,
+							 const std::vector<std::string>* buffers)
+{
+	for (size_t i = 0; i < layers.size(); ++i)
+	{
+		LLXMLNodePtr layer_root;
+		bool success;
+		if (buffers)
+		{
+			const std::string& buffer = (*buffers)[i];
+			success = LLXMLNode::parseBuffer((U8*)buffer.data(), (U32)buffer.size(), layer_root, NULL);
+		}
+		else
+		{
+			success = LLXMLNode::parseFile(layers[i], layer_root, NULL);
+		}
+		if (!success)
+		{
+			if (i)
+			{
+				LL_WARNS() << "Problem reading localized UI description file: " << layers[i] << LL_ENDL;
+			}
+			else
+			{
+				LL_WARNS() << "Problem reading UI description file: " << layers[i] << LL_ENDL;
+			}
+			return false;
+		}
+
+		if (!i)
+		{
+			root = layer_root;
+			continue;
+		}
+
+		std::string updateName;
+		std::string nodeName;
+		layer_root->getAttributeString("name", updateName);
+		root->getAttributeString("name", nodeName);
+
+		if (updateName == nodeName)
+		{
+			LLXMLNode::updateNode(root, layer_root);
+		}
+	}
+	return !layers.empty();
+}
+
+//static
+void LLXUICache::startWarmUp()
+{
+	if (sWarmUpThread) return;
+
+	// Floaters and panels are what gets built over and over; menus, strings
+	// and notifications are loaded once anyway.
+	const std::string base_filename = gDirUtilp->findSkinnedFilenameBaseLang(LLDir::XUI, "floater_about.xml");
+	if (!base_filename.empty())
+	{
+		std::vector<std::string> files = gDirUtilp->getFilesInDir(gDirUtilp->getDirName(base_filename));
+		for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
+		{
+			if ((!it->compare(0, 8, "floater_") || !it->compare(0, 6, "panel_"))
+				&& gDirUtilp->getExtension(*it) == "xml")
+			{
+				sWarmUpNames.push_back(*it);
+			}
+		}
+	}
+	if (sWarmUpNames.empty()) return;
+
+	LL_INFOS() << "Warming up the XUI cache with " << sWarmUpNames.size() << " files" << LL_ENDL;
+	sWarmUpThread = new WarmUpThread;
+	sWarmUpThread->start();
+}
+
+//static
+void LLXUICache::idle(F32 budget_ms)
+{
+	if (!sWarmUpThread) return;
+
+	LLTimer timer;
+	sWarmUpThread->takeFiles(sWarmUpFiles);
+	while (!sWarmUpFiles.empty() && timer.getElapsedTimeF32() * 1000.f < budget_ms)
+	{
+		WarmUpFile* file = sWarmUpFiles.front();
+		sWarmUpFiles.pop_front();
+		// Skip what was built since the file was queued.
+		if (file->mSuccess && !sCache.count(make_key(file->mLayers)))
+		{
+			LLXMLNodePtr root;
+			if (parseLayers(file->mLayers, root, &file->mBuffers))
+			{
+				put(file->mLayers, root);
+			}
+		}
+		delete file;
+	}
+
+	// Keep a few files ahead of the parsing.
+	while (!sWarmUpNames.empty() && sWarmUpFiles.size() < 8
+		   && timer.getElapsedTimeF32() * 1000.f < budget_ms)
+	{
+		WarmUpFile* file = new WarmUpFile;
+		file->mLayers = findLayers(sWarmUpNames.front());
+		file->mSuccess = false;
+		sWarmUpNames.pop_front();
+		if (file->mLayers.empty())
+		{
+			delete file;
+			continue;
+		}
+		sWarmUpThread->queueFile(file);
+	}
+
+	if (sWarmUpNames.empty() && sWarmUpFiles.empty() && sWarmUpThread->isIdle())
+	{
+		LL_INFOS() << "XUI cache warm up done, " << sCache.size() << " trees cached" << LL_ENDL;
+		sWarmUpThread->shutdown();
+		delete sWarmUpThread;
+		sWarmUpThread = NULL;
+	}
+}
+
+//static
+void LLXUICache::cleanupClass()
+{
+	if (sWarmUpThread)
+	{
+		sWarmUpThread->shutdown();
+		delete sWarmUpThread;
+		sWarmUpThread = NULL;
+	}
+	sWarmUpNames.clear();
+	for (file_queue_t::iterator it = sWarmUpFiles.begin(); it != sWarmUpFiles.end(); ++it)
+	{
+		delete *it;
+	}
+	sWarmUpFiles.clear();
+	sCache.clear();
+}
@@ -0,0 +1,81 @@
+/**
+ * @file llxuicache.h
+ * @brief Process wide cache of parsed and merged XUI trees.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLXUICACHE_H
+#define LL_LLXUICACHE_H
+
+#include <string>
+#include <vector>
+
+#include "llxmlnode.h"
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLXUICache
+//
+//   Keeps the tree LLUICtrlFactory::getLayeredXMLNode() built for a XUI file,
+//   keyed by the layer files it was merged from: the base language file and
+//   the skin and language overrides. Switching skin or language therefore
+//   selects other entries, and a layer modified on disk (size or time stamp)
+//   invalidates its entry. The cached trees are never handed out: callers
+//   get a deep copy, which is much cheaper than parsing.
+//
+//   After login, startWarmUp() lists the floater and panel files. Within a
+//   time budget per frame, idle() looks up their layers, hands them to a
+//   background thread for reading and parses what was read. LLXMLNode uses
+//   the global string table, which is not thread safe, so the parsing
+//   itself stays on the main thread.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLXUICache
+{
+public:
+	typedef std::vector<std::string> layer_vec_t;
+
+	// The files getLayeredXMLNode() merges for xui_filename, base file
+	// first. Empty when there is no such file in the current skin.
+	static layer_vec_t findLayers(const std::string& xui_filename);
+
+	// Returns a copy of the cached tree for these layers, if still valid.
+	static bool get(const layer_vec_t& layers, LLXMLNodePtr& root);
+	static void put(const layer_vec_t& layers, const LLXMLNodePtr& root);
+
+	// Parses and merges the layers, the first one being the base file.
+	// buffers, when not NULL, holds the contents of each layer.
+	static bool parseLayers(const layer_vec_t& layers, LLXMLNodePtr& root,
+							const std::vector<std::string>* buffers = NULL);
+
+	static void startWarmUp();
+	static void idle(F32 budget_ms);
+	static void cleanupClass();
+
+	static U32 getHitCount()	{ return sHits; }
+	static U32 getMissCount()	{ return sMisses; }
+
+private:
+	static U32 sHits;
+	static U32 sMisses;
+};
+
+#endif // LL_LLXUICACHE_H
@@ -43,6 +43,7 @@
 #include "llrect.h"
 #include "llxmltree.h"
 #include "llsdserialize.h"
+#include "hbxxh.h"
 #include "llsqlmgr.h"
 #if LL_RELEASE_WITH_DEBUG_INFO || LL_DEBUG
 #define CONTROL_ERRS LL_ERRS("ControlErrors")
@@ -960,31 +961,330 @@ U32 LLControlGroup::saveToFile(const std::string& filename, BOOL nondefault_only
 	return num_saved;
 }
 
+// Default settings snapshots
+//
+// The default settings files only change with the viewer install, yet
+// parsing them as XML sits on the critical path of every launch. After a
+// file was parsed, its controls are written as a flat table next to the
+// user settings; later launches load that table instead, as long as the
+// hash of the XML still matches the one recorded in it.
+
+// 'LCSS', little endian
+static const U32 SNAPSHOT_MAGIC = 0x5353434c;
+// Bump whenever the snapshot layout changes.
+static const U32 SNAPSHOT_VERSION = 1;
+
+std::string LLControlGroup::sSnapshotDirectory;
+U32 LLControlGroup::sSnapshotLoads = 0;
+U32 LLControlGroup::sSnapshotMisses = 0;
+
+namespace
+{
+	enum
+	{
+		SNAPSHOT_PERSIST = 1 << 0,
+		SNAPSHOT_HIDE_FROM_EDITOR = 1 << 1,
+		SNAPSHOT_IS_COA = 1 << 2,
+		SNAPSHOT_INCLUDE = 1 << 3		// value is the array of included files
+	};
+
+	struct SnapshotHeader
+	{
+		U32 mMagic;
+		U32 mVersion;
+		U32 mEntryCount;
+		U32 mDataSize;
+		U64 mSourceHash;		// of the XML file
+		U64 mChecksum;			// of everything following the header
+	};
+
+	struct SnapshotEntry
+	{
+		std::string	mName;
+		std::string	mComment;
+		LLSD		mValue;
+		S8			mType;
+		U8			mFlags;
+	};
+	typedef std::vector<SnapshotEntry> snapshot_entry_vec_t;
+
+	bool read_whole_file(const std::string& filename, std::string& data)
+	{
+		LLFILE* fp = LLFile::fopen(filename, "rb");
+		if (!fp)
+		{
+			return false;
+		}
+		bool success = !fseek(fp, 0, SEEK_END);
+		const long size = success ? ftell(fp) : -1;
+		success = size >= 0 && !fseek(fp, 0, SEEK_SET);
+		if (success)
+		{
+			data.resize(size);
+			success = !size || fread(&data[0], 1, size, fp) == (size_t)size;
+		}
+		LLFile::close(fp);
+		return success;
+	}
+
+	std::string get_snapshot_filename(const std::string& directory, const std::string& filename)
+	{
+		// Snapshots of identically named files in different directories must
+		// not collide.
+		std::string basename = filename.substr(filename.find_last_of("/\\") + 1);
+		basename = basename.substr(0, basename.rfind('.'));
+		std::string path = directory;
+		if (!path.empty() && path.back() != '/' && path.back() != '\\')
+		{
+			path += '/';
+		}
+		return path + llformat("defaults_%016llx_", (unsigned long long)HBXXH64::digest(filename))
+			+ basename + ".bin";
+	}
+
+	bool read_snapshot(const std::string& filename, U64 source_hash, snapshot_entry_vec_t& entries)
+	{
+		std::string data;
+		if (!read_whole_file(filename, data) || data.size() < sizeof(SnapshotHeader))
+		{
+			return false;
+		}
+		SnapshotHeader header;
+		memcpy(&header, data.data(), sizeof(SnapshotHeader));
+		const char* ptr = data.data() + sizeof(SnapshotHeader);
+		const char* end = data.data() + data.size();
+		if (header.mMagic != SNAPSHOT_MAGIC || header.mVersion != SNAPSHOT_VERSION
+			|| header.mSourceHash != source_hash
+			|| header.mDataSize != (U32)(end - ptr)
+			|| HBXXH64::digest(ptr, header.mDataSize) != header.mChecksum)
+		{
+			return false;
+		}
+
+		entries.resize(header.mEntryCount);
+		for (snapshot_entry_vec_t::iterator it = entries.begin(); it != entries.end(); ++it)
+		{
+			U16 name_length;
+			U32 comment_length;
+			if (end - ptr < (std::ptrdiff_t)(sizeof(U16) + 2)) return false;
+			memcpy(&name_length, ptr, sizeof(U16));
+			ptr += sizeof(U16);
+			it->mType = (S8)*ptr++;
+			it->mFlags = (U8)*ptr++;
+			if (end - ptr < (std::ptrdiff_t)(name_length + sizeof(U32))) return false;
+			it->mName.assign(ptr, name_length);
+			ptr += name_length;
+			memcpy(&comment_length, ptr, sizeof(U32));
+			ptr += sizeof(U32);
+			if ((U32)(end - ptr) < comment_length) return false;
+			it->mComment.assign(ptr, comment_length);
+			ptr += comment_length;
+		}
+
+		// All the values in one binary LLSD array, parsed in one go.
+		LLSD values;
+		if (LLSDSerialize::fromBinary(values, ptr, end - ptr, (S32)(end - ptr)) <= 0
+			|| !values.isArray() || values.size() != (S32)entries.size())
+		{
+			return false;
+		}
+		for (S32 i = 0, count = (S32)entries.size(); i < count; ++i)
+		{
+			entries[i].mValue = values[i];
+		}
+		return true;
+	}
+
+	bool write_snapshot(const std::string& filename, U64 source_hash, const snapshot_entry_vec_t& entries)
+	{
+		std::string data;
+		LLSD values = LLSD::emptyArray();
+		for (snapshot_entry_vec_t::const_iterator it = entries.begin(); it != entries.end(); ++it)
+		{
+			const U16 name_length = (U16)llmin(it->mName.size(), (size_t)U16_MAX);
+			const U32 comment_length = (U32)it->mComment.size();
+			data.append((const char*)&name_length, sizeof(U16));
+			data.push_back((char)it->mType);
+			data.push_back((char)it->mFlags);
+			data.append(it->mName.data(), name_length);
+			data.append((const char*)&comment_length, sizeof(U32));
+			data.append(it->mComment);
+			values.append(it->mValue);
+		}
+		std::ostringstream ostr;
+		LLSDSerialize::toBinary(values, ostr);
+		data += ostr.str();
+
+		SnapshotHeader header;
+		header.mMagic = SNAPSHOT_MAGIC;
+		header.mVersion = SNAPSHOT_VERSION;
+		header.mEntryCount = (U32)entries.size();
+		header.mDataSize = (U32)data.size();
+		header.mSourceHash = source_hash;
+		header.mChecksum = HBXXH64::digest(data);
+
+		const std::string temp_filename = filename + ".tmp";
+		LLFILE* fp = LLFile::fopen(temp_filename, "wb");
+		if (!fp)
+		{
+			return false;
+		}
+		bool success = fwrite(&header, sizeof(header), 1, fp) == 1
+			&& fwrite(data.data(), data.size(), 1, fp) == 1;
+		success = (LLFile::close(fp) == 0) && success;
+		if (success)
+		{
+			LLFile::remove_nowarn(filename);
+			success = LLFile::rename(temp_filename, filename) == 0;
+		}
+		if (!success)
+		{
+			LLFile::remove_nowarn(temp_filename);
+		}
+		return success;
+	}
+}
+
+//static
+void LLControlGroup::setSnapshotDirectory(const std::string& directory)
+{
+	sSnapshotDirectory = directory;
+}
+
+U32 LLControlGroup::loadIncludes(const std::string& filename, const LLSD& includes, bool set_default_values)
+{
+	U32 validitems = 0;
+	if(includes.isArray())
+	{
+#if LL_WINDOWS
+		size_t pos = filename.find_last_of("\\");
+#else
+		size_t pos = filename.find_last_of("/");
+#endif			
+		if(pos!=std::string::npos)
+		{
+			const std::string dir = filename.substr(0,++pos);
+			for(LLSD::array_const_iterator array_itr = includes.beginArray(); array_itr != includes.endArray(); ++array_itr)
+				validitems+=loadFromFile(dir+(*array_itr).asString(),set_default_values);
+		}
+	}
+	return validitems;
+}
+
+void LLControlGroup::applyLoadedControl(const std::string& filename, const std::string& name, eControlType type,
+										const LLSD& value, const std::string& comment, bool persist,
+										bool hidefromsettingseditor, bool IsCOA,
+										bool set_default_values, bool save_values)
+{
+	// If the control exists just set the value from the input file.
+	LLControlVariable* existing_control = getControl(name);
+	if(existing_control)
+	{
+		if(set_default_values)
+		{
+			// Override all previously set properties of this control.
+			// ... except for type. The types must match.
+			if(existing_control->isType(type))
+			{
+				existing_control->setDefaultValue(value);
+				existing_control->setPersist(persist);
+				existing_control->setHiddenFromSettingsEditor(hidefromsettingseditor);
+				existing_control->setComment(comment);
+			}
+			else
+			{
+				LL_ERRS() << "Mismatched type of control variable '"
+					   << name << "' found while loading '"
+					   << filename << "'." << LL_ENDL;
+			}
+		}
+		else if(existing_control->isPersisted())
+		{
+			existing_control->setValue(value, save_values);
+		}
+		// *NOTE: If not persisted and not setting defaults, 
+		// the value should not get loaded.
+	}
+	else
+	{
+		declareControl(name, type, value, comment, persist, hidefromsettingseditor, IsCOA);
+	}
+}
+
 U32 LLControlGroup::loadFromFile(const std::string& filename, bool set_default_values, bool save_values)
 {
 	if(!mIncludedFiles.insert(filename).second)
 		return 0; //Already included this file.
 
-	LLSD settings;
-	llifstream infile;
-	infile.open(filename);
-	if(!infile.is_open())
+	std::string snapshot_filename;
+	std::string xml;
+	U64 xml_hash = 0;
+	if (set_default_values && !sSnapshotDirectory.empty())
 	{
-		LL_WARNS() << "Cannot find file " << filename << " to load." << LL_ENDL;
-		return 0;
+		if (!read_whole_file(filename, xml))
+		{
+			LL_WARNS() << "Cannot find file " << filename << " to load." << LL_ENDL;
+			return 0;
+		}
+		xml_hash = HBXXH64::digest(xml);
+		snapshot_filename = get_snapshot_filename(sSnapshotDirectory, filename);
+
+		snapshot_entry_vec_t entries;
+		if (read_snapshot(snapshot_filename, xml_hash, entries))
+		{
+			++sSnapshotLoads;
+			U32 validitems = 0;
+			for (snapshot_entry_vec_t::const_iterator it = entries.begin(); it != entries.end(); ++it)
+			{
+				if (it->mFlags & SNAPSHOT_INCLUDE)
+				{
+					validitems += loadIncludes(filename, it->mValue, set_default_values);
+					continue;
+				}
+				applyLoadedControl(filename, it->mName, (eControlType)it->mType, it->mValue, it->mComment,
+								   it->mFlags & SNAPSHOT_PERSIST, it->mFlags & SNAPSHOT_HIDE_FROM_EDITOR,
+								   it->mFlags & SNAPSHOT_IS_COA, set_default_values, save_values);
+				++validitems;
+			}
+			return validitems;
+		}
+		++sSnapshotMisses;
 	}
 
-	S32 ret = LLSDSerialize::fromXML(settings, infile);
+	LLSD settings;
+	S32 ret;
+	if (snapshot_filename.empty())
+	{
+		llifstream infile;
+		infile.open(filename);
+		if(!infile.is_open())
+		{
+			LL_WARNS() << "Cannot find file " << filename << " to load." << LL_ENDL;
+			return 0;
+		}
+
+		ret = LLSDSerialize::fromXML(settings, infile);
+		infile.close();
+	}
+	else
+	{
+		std::istringstream instr(xml);
+		ret = LLSDSerialize::fromXML(settings, instr);
+	}
 
 	if (ret <= 0)
 	{
-		infile.close();
 		LL_WARNS() << "Unable to open LLSD control file " << filename << ". Trying Legacy Method." << LL_ENDL;		
 		return loadFromFileLegacy(filename, TRUE, TYPE_STRING);
 	}
 
 	U32	validitems = 0;
 	bool hidefromsettingseditor = false;
+	snapshot_entry_vec_t entries;
+	if (!snapshot_filename.empty())
+	{
+		entries.reserve(settings.size());
+	}
 	
 	for(LLSD::map_const_iterator itr = settings.beginMap(); itr != settings.endMap(); ++itr)
 	{
@@ -994,20 +1294,16 @@ U32 LLControlGroup::loadFromFile(const std::string& filename, bool set_default_v
 		
 		if(name == "Include")
 		{
-			if(control_map.isArray())
+			if (!snapshot_filename.empty())
 			{
-#if LL_WINDOWS
-				size_t pos = filename.find_last_of("\\");
-#else
-				size_t pos = filename.find_last_of("/");
-#endif			
-				if(pos!=std::string::npos)
-				{
-					const std::string dir = filename.substr(0,++pos);
-					for(LLSD::array_const_iterator array_itr = control_map.beginArray(); array_itr != control_map.endArray(); ++array_itr)
-						validitems+=loadFromFile(dir+(*array_itr).asString(),set_default_values);
-				}
+				SnapshotEntry entry;
+				entry.mName = name;
+				entry.mValue = control_map;
+				entry.mType = -1;
+				entry.mFlags = SNAPSHOT_INCLUDE;
+				entries.push_back(entry);
 			}
+			validitems += loadIncludes(filename, control_map, set_default_values);
 			continue;
 		}
 		if(control_map.has("Persist")) 
@@ -1027,53 +1323,32 @@ U32 LLControlGroup::loadFromFile(const std::string& filename, bool set_default_v
 			hidefromsettingseditor = false;
 		}
 		
-		// If the control exists just set the value from the input file.
-		LLControlVariable* existing_control = getControl(name);
-		if(existing_control)
-		{
-			if(set_default_values)
-			{
-				// Override all previously set properties of this control.
-				// ... except for type. The types must match.
-				eControlType new_type = typeStringToEnum(control_map["Type"].asString());
-				if(existing_control->isType(new_type))
-				{
-					existing_control->setDefaultValue(control_map["Value"]);
-					existing_control->setPersist(persist);
-					existing_control->setHiddenFromSettingsEditor(hidefromsettingseditor);
-					existing_control->setComment(control_map["Comment"].asString());
-				}
-				else
-				{
-					LL_ERRS() << "Mismatched type of control variable '"
-						   << name << "' found while loading '"
-						   << filename << "'." << LL_ENDL;
-				}
-			}
-			else if(existing_control->isPersisted())
-			{
-				existing_control->setValue(control_map["Value"], save_values);
-			}
-			// *NOTE: If not persisted and not setting defaults, 
-			// the value should not get loaded.
-		}
-		else
-		{
-			bool IsCOA = control_map.has("IsCOA") && !!control_map["IsCOA"].asInteger();
-			declareControl(name, 
-						   typeStringToEnum(control_map["Type"].asString()), 
-						   control_map["Value"], 
-						   control_map["Comment"].asString(), 
-						   persist,
-						   hidefromsettingseditor,
-						   IsCOA
-						   );
+		const eControlType type = typeStringToEnum(control_map["Type"].asString());
+		const bool IsCOA = control_map.has("IsCOA") && !!control_map["IsCOA"].asInteger();
+		applyLoadedControl(filename, name, type, control_map["Value"], control_map["Comment"].asString(),
+						   persist, hidefromsettingseditor, IsCOA, set_default_values, save_values);
 
+		if (!snapshot_filename.empty())
+		{
+			SnapshotEntry entry;
+			entry.mName = name;
+			entry.mComment = control_map["Comment"].asString();
+			entry.mValue = control_map["Value"];
+			entry.mType = (S8)type;
+			entry.mFlags = (persist ? SNAPSHOT_PERSIST : 0)
+				| (hidefromsettingseditor ? SNAPSHOT_HIDE_FROM_EDITOR : 0)
+				| (IsCOA ? SNAPSHOT_IS_COA : 0);
+			entries.push_back(entry);
 		}
 		
 		++validitems;
 	}
 
+	if (!snapshot_filename.empty() && !write_snapshot(snapshot_filename, xml_hash, entries))
+	{
+		LL_WARNS() << "Unable to write settings snapshot " << snapshot_filename << LL_ENDL;
+	}
+
 	return validitems;
 }
 
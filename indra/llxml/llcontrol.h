@@ -232,6 +232,16 @@ protected:
 	eControlType typeStringToEnum(const std::string& typestr);
 	std::string typeEnumToString(eControlType typeenum);
 	std::set<std::string> mIncludedFiles; //To prevent perpetual recursion.
+
+	U32 loadIncludes(const std::string& filename, const LLSD& includes, bool set_default_values);
+	void applyLoadedControl(const std::string& filename, const std::string& name, eControlType type,
+							const LLSD& value, const std::string& comment, bool persist,
+							bool hidefromsettingseditor, bool IsCOA,
+							bool set_default_values, bool save_values);
+
+	static std::string sSnapshotDirectory;
+	static U32 sSnapshotLoads;
+	static U32 sSnapshotMisses;
 public:
 	LLControlGroup(const std::string& name);
 	~LLControlGroup();
@@ -342,6 +352,11 @@ public:
  	U32 saveToFile(const std::string& filename, BOOL nondefault_only);
 	void saveColorSettings(std::string setting_name,LLColor4 setting_value);
  	U32	loadFromFile(const std::string& filename, bool default_values = false, bool save_values = true);
+	// When set, files loaded as default values are cached in binary form in
+	// that directory and reloaded from there while the XML is unchanged.
+	static void setSnapshotDirectory(const std::string& directory);
+	static U32 getSnapshotLoadCount()	{ return sSnapshotLoads; }
+	static U32 getSnapshotMissCount()	{ return sSnapshotMisses; }
 	void	resetToDefaults();
 
 	
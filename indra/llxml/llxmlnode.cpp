@@ -41,6 +41,7 @@
 #include "llquaternion.h"
 #include "llstring.h"
 #include "lluuid.h"
+#include "llmemtag.h"
 //#include "lldir.h" // Do not need.
 
 // static
@@ -67,6 +68,7 @@ LLXMLNode::LLXMLNode() :
 	mValue(""), 
 	mDefault(NULL)
 {
+	LLMemTag::addLocal(LLMemTag::MT_UI, sizeof(LLXMLNode));
 }
 
 LLXMLNode::LLXMLNode(const char* name, BOOL is_attribute) : 
@@ -88,6 +90,7 @@ LLXMLNode::LLXMLNode(const char* name, BOOL is_attribute) :
 	mValue(""), 
 	mDefault(NULL)
 {
+	LLMemTag::addLocal(LLMemTag::MT_UI, sizeof(LLXMLNode));
     mName = gStringTable.addStringEntry(name);
 }
 
@@ -111,6 +114,7 @@ LLXMLNode::LLXMLNode(LLStringTableEntry* name, BOOL is_attribute) :
 	mValue(""), 
 	mDefault(NULL)
 {
+	LLMemTag::addLocal(LLMemTag::MT_UI, sizeof(LLXMLNode));
 }
 
 // copy constructor (except for the children)
@@ -134,6 +138,7 @@ LLXMLNode::LLXMLNode(const LLXMLNode& rhs) :
 	mValue(rhs.mValue), 
 	mDefault(rhs.mDefault)
 {
+	LLMemTag::addLocal(LLMemTag::MT_UI, sizeof(LLXMLNode));
 }
 
 // returns a new copy of this node and all its children
@@ -142,10 +147,11 @@ LLXMLNodePtr LLXMLNode::deepCopy()
 	LLXMLNodePtr newnode = LLXMLNodePtr(new LLXMLNode(*this));
 	if (mChildren.notNull())
 	{
-		for (LLXMLChildList::iterator iter = mChildren->map.begin();
-			 iter != mChildren->map.end(); ++iter)	
+		// Walk the sibling list rather than the map, which is sorted by name:
+		// the copy must keep the document order.
+		for (LLXMLNodePtr child = mChildren->head; child.notNull(); child = child->mNext)
 		{
-			LLXMLNodePtr temp_ptr_for_gcc(iter->second->deepCopy());
+			LLXMLNodePtr temp_ptr_for_gcc(child->deepCopy());
 			newnode->addChild(temp_ptr_for_gcc);
 		}
 	}
@@ -191,6 +197,7 @@ LLXMLNode::~LLXMLNode()
 	}
 	llassert(mParent == NULL);
 	mDefault = NULL;
+	LLMemTag::subLocal(LLMemTag::MT_UI, sizeof(LLXMLNode));
 }
 
 BOOL LLXMLNode::isNull()
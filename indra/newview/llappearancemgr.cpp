@@ -2630,7 +2630,9 @@ void LLAppearanceMgr::updateAppearanceFromCOF(bool enforce_item_restrictions,
 		// Here we remove the attachment pos overrides for *all*
 		// attachments, even those that are not being removed. This is
 		// needed to get joint positions all slammed down to their
-		// pre-attachment states.
+		// pre-attachment states. The overrides of the attachments that
+		// are retained below are resolved once, at the end.
+		gAgentAvatarp->beginAttachmentOverrides();
 		gAgentAvatarp->clearAttachmentOverrides();
 
 		// Take off the attachments that will no longer be in the outfit.
@@ -2647,6 +2649,7 @@ void LLAppearanceMgr::updateAppearanceFromCOF(bool enforce_item_restrictions,
 			LLViewerObject *objectp = *it;
 			gAgentAvatarp->addAttachmentOverridesForObject(objectp);
 		}
+		gAgentAvatarp->endAttachmentOverrides();
 		
 		// Add new attachments to match those requested.
 		LL_DEBUGS("Avatar") << self_av_string() << "Adding " << items_to_add.size() << " attachments" << LL_ENDL;
@@ -151,7 +151,13 @@
 #include "llcontainerview.h"
 #include "llhoverview.h"
 
+#include "llanimationpool.h"
+#include "llhitchrecorder.h"
+#include "lllogchat.h"
+#include "llsdasync.h"
 #include "llsdserialize.h"
+#include "llxuicache.h"
+#include "lltracerecorder.h"
 
 #include "llworld.h"
 #include "llhudeffecttrail.h"
@@ -1357,6 +1363,7 @@ bool LLAppViewer::mainLoop()
 		while (!LLApp::isExiting())
 		{
 			LLFastTimer::nextFrame(); // Should be outside of any timer instances
+			LLHitchRecorder::nextFrame();
 
 			//clear call stack records
 			LL_CLEAR_CALLSTACKS();
@@ -1692,6 +1699,19 @@ bool LLAppViewer::cleanup()
 
 	LL_INFOS() << "Viewer disconnected" << LL_ENDL;
 
+	// Write out what is still being formatted, like the name caches saved
+	// by disconnectViewer(), rather than dropping it. The parse callbacks
+	// delivered meanwhile need inventory, UI and curl, so this has to
+	// happen before any of them is shut down.
+	LLTimer serializer_timer;
+	while (LLSDAsyncSerializer::getPendingCount() > 0 && serializer_timer.getElapsedTimeF32() < 5.f)
+	{
+		if (!LLSDAsyncSerializer::deliver())
+		{
+			ms_sleep(1);
+		}
+	}
+
 	display_cleanup(); 
 
 	release_start_screen(); // just in case
@@ -2007,6 +2027,13 @@ bool LLAppViewer::cleanup()
 	LLImage::cleanupClass();
 	LLVFSThread::cleanupClass();
 	LLLFSThread::cleanupClass();
+	// Anything still queued by now is dropped.
+	LLSDAsyncSerializer::cleanupClass();
+	LLAnimationPool::cleanupClass();
+	LLLogChat::cleanupClass();
+	LLXUICache::cleanupClass();
+	LLTraceRecorder::cleanupClass();
+	LLHitchRecorder::cleanupClass();
 
 	LL_INFOS() << "VFS Thread finished" << LL_ENDL;
 
@@ -2120,6 +2147,21 @@ bool LLAppViewer::initThreads()
 	LLVFSThread::initClass(enable_threads && false);
 	LLLFSThread::initClass(enable_threads && false);
 
+	// Chat and IM logs
+	LLLogChat::initClass();
+
+	// Large LLSD documents
+	LLSDAsyncSerializer::initClass(enable_threads ? llclamp(gSavedSettings.getS32("LLSDSerializerThreads"), 0, 4) : 0);
+
+	// Avatar motions and skeletons
+	LLAnimationPool::initClass(enable_threads ? llclamp(gSavedSettings.getS32("AvatarAnimationThreads"), 0, 8) : 0);
+
+	// Chrome traces of the fast timers
+	LLTraceRecorder::initClass(gDirUtilp->getExpandedFilename(LL_PATH_LOGS, ""));
+	LLTraceRecorder::setSpikeThreshold(gSavedSettings.getF32("TraceRecorderSpikeMs"));
+	LLTraceRecorder::setActive(gSavedSettings.getBOOL("TraceRecorderEnabled"));
+	LLHitchRecorder::initClass(gSavedSettings.getU32("HitchCaptureFrames"), gSavedSettings.getF32("HitchCaptureThresholdMs"));
+
 	// Image decoding
 	const S32 image_decoder_threads = llmax(1,llabs(gSavedSettings.getS32("GenxDecodeImageThreads")));
 	for (int i=0; i<image_decoder_threads;i++) {
@@ -2389,6 +2431,8 @@ bool LLAppViewer::initConfiguration()
 	
 	// - load defaults
 	bool set_defaults = true;
+	LLControlGroup::setSnapshotDirectory(gDirUtilp->getExpandedFilename(LL_PATH_USER_SETTINGS, ""));
+	LLTimer defaults_timer;
 	if(!loadSettingsFromDirectory(settings_w, "Default", set_defaults))
 	{
 		OSMessageBox(
@@ -2396,6 +2440,9 @@ bool LLAppViewer::initConfiguration()
 			LLStringUtil::null,OSMB_OK);
 		return false;
 	}
+	LL_INFOS("InitInfo") << "Loaded default settings in " << defaults_timer.getElapsedTimeF32() * 1000.f
+						 << " ms (" << LLControlGroup::getSnapshotLoadCount() << " files from snapshots, "
+						 << LLControlGroup::getSnapshotMissCount() << " parsed)" << LL_ENDL;
 
 	LLUICtrlFactory::getInstance()->setupPaths(); // setup paths for LLTrans based on settings files only
 	LLTrans::parseStrings("strings.xml", default_trans_args);
@@ -3023,6 +3070,9 @@ void LLAppViewer::handleViewerCrash()
 	}
 	pApp->mReportedCrash = TRUE;
 
+	// Get the chat logs on disk while the other threads still run.
+	LLLogChat::flushOnCrash();
+
 	// Insert crash host url (url to post crash log to) if configured.
 	std::string crashHostUrl = gSavedSettings.get<std::string>("CrashHostUrl");
 	if (!crashHostUrl.empty())
@@ -4001,50 +4051,112 @@ void LLAppViewer::saveFinalSnapshot()
 	}
 }
 
-void LLAppViewer::loadNameCache()
+// The XML name caches are only read once, after an upgrade; later sessions
+// use the binary cache. They can be large, so they are parsed off the main
+// thread and merged in when done.
+static bool read_name_cache_file(const std::string& filename, std::string& buffer)
+{
+	llifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open()) return false;
+	buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	return !buffer.empty();
+}
+
+static void avatar_name_cache_parsed(bool success, const LLSD& data)
+{
+	if (success)
+	{
+		LLAvatarNameCache::importLLSD(data);
+	}
+	else
+	{
+		LL_WARNS("AvNameCache") << "avatar name cache data xml parse failed" << LL_ENDL;
+	}
+}
+
+static void legacy_name_cache_parsed(bool success, const LLSD& data)
+{
+	if (success && gCacheName)
+	{
+		gCacheName->importLLSD(data);
+	}
+}
+
+static void name_cache_formatted(const std::string& filename, bool success, const std::string& data)
+{
+	if (!success) return;
+	llofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+	if (file.is_open())
+	{
+		file << data;
+	}
+}
+
+// The XML caches used before name_cache.bin, and still written when it
+// can't be.
+static void load_xml_name_caches()
 {
 	// display names cache
 	std::string filename =
 		gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
 	LL_INFOS("AvNameCache") << filename << LL_ENDL;
-	llifstream name_cache_stream(filename.c_str());
-	if(name_cache_stream.is_open())
+	std::string buffer;
+	if (read_name_cache_file(filename, buffer))
 	{
-		LLAvatarNameCache::importFile(name_cache_stream);
+		LLSDAsyncSerializer::parse(buffer, LLSDSerialize::LLSD_XML, &avatar_name_cache_parsed);
 	}
 
 	if (!gCacheName) return;
 
 	std::string name_cache;
 	name_cache = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "name.cache");
-	llifstream cache_file(name_cache.c_str());
-	if(cache_file.is_open())
+	if (read_name_cache_file(name_cache, buffer))
 	{
-		if(gCacheName->importFile(cache_file)) return;
+		LLSDAsyncSerializer::parse(buffer, LLSDSerialize::LLSD_XML, &legacy_name_cache_parsed);
 	}
 }
 
+void LLAppViewer::loadNameCache()
+{
+	// Binary cache of both name systems, read in the background. Should it
+	// be corrupt, the XML caches are read instead.
+	std::string binary_filename =
+		gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "name_cache.bin");
+	if (LLAvatarNameCache::loadCache(binary_filename, &load_xml_name_caches)) return;
+
+	load_xml_name_caches();
+}
+
 void LLAppViewer::saveNameCache()
 {
+	// Binary cache of both name systems; once it is written the old XML
+	// caches are obsolete.
+	std::string binary_filename =
+		gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "name_cache.bin");
+	if (LLAvatarNameCache::saveCache(binary_filename))
+	{
+		LLFile::remove_nowarn(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml"));
+		LLFile::remove_nowarn(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "name.cache"));
+		return;
+	}
+
+	// Otherwise fall back to the XML caches. They are written once the
+	// workers have formatted them; cleanup() waits for that.
 	// display names cache
 	std::string filename =
 		gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "avatar_name_cache.xml");
-	llofstream name_cache_stream(filename.c_str());
-	if(name_cache_stream.is_open())
-	{
-		LLAvatarNameCache::exportFile(name_cache_stream);
-	}
+	LLSDAsyncSerializer::format(LLAvatarNameCache::exportLLSD(), LLSDSerialize::LLSD_XML,
+								boost::bind(&name_cache_formatted, filename, _1, _2),
+								LLSDFormatter::OPTIONS_PRETTY);
 
     // real names cache
 	if (gCacheName)
     {
 		std::string name_cache;
 		name_cache = gDirUtilp->getExpandedFilename(LL_PATH_CACHE, "name.cache");
-        llofstream cache_file(name_cache.c_str());
-		if(cache_file.is_open())
-		{
-			gCacheName->exportFile(cache_file);
-		}
+		LLSDAsyncSerializer::format(gCacheName->exportLLSD(), LLSDSerialize::LLSD_XML,
+									boost::bind(&name_cache_formatted, name_cache, _1, _2),
+									LLSDFormatter::OPTIONS_PRETTY);
 	}
 }
 
@@ -4312,6 +4424,8 @@ void LLAppViewer::idle()
 		gEventNotifier.update();
 
 		gIdleCallbacks.callFunctions();
+		LLSDAsyncSerializer::deliver();
+		LLXUICache::idle(2.f);
 		gInventory.idleNotifyObservers();
 		if (auto antispam = NACLAntiSpamRegistry::getIfExists()) antispam->idle();
 	}
@@ -4966,6 +5080,7 @@ void LLAppViewer::disconnectViewer()
 	}
 
 	saveNameCache();
+	LLLogChat::cleanupClass();
 	if (LLExperienceCache::instanceExists())
 	{
 		// TODO: LLExperienceCache::cleanup() logic should be moved to
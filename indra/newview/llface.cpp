@@ -353,6 +353,10 @@ void LLFace::notifyAboutCreatingTexture(LLViewerTexture *texture)
 			gPipeline.markTextured(drawablep);
 			gPipeline.markRebuild(drawablep, LLDrawable::REBUILD_VOLUME);
 		}
+		if (vobj && vobj->getAvatarAncestor())
+		{	// texture size is part of the attachment's render cost
+			vobj->updateVisualComplexity();
+		}
 	}
 }
 
@@ -107,6 +107,7 @@ LLFastTimerView::LLFastTimerView(const std::string& name, const LLRect& rect)
 	mOverLegend = false;
 	mScrollOffset = 0;
 	// </FS:LO>
+	mShowThreads = false;
 	LLUICtrlFactory::getInstance()->buildFloater(this, "floater_fast_timers.xml");
 }
 
@@ -215,6 +216,10 @@ BOOL LLFastTimerView::handleMouseDown(S32 x, S32 y, MASK mask)
 			mDisplayCalls = !mDisplayCalls;
 		}
 	}
+	else if ((mask & (MASK_CONTROL | MASK_SHIFT)) == (MASK_CONTROL | MASK_SHIFT))
+	{
+		mShowThreads = !mShowThreads;
+	}
 	else if (mask & MASK_SHIFT)
 	{
 		if (++mDisplayMode > 3)
@@ -463,7 +468,7 @@ void LLFastTimerView::draw()
 		LLFontGL::getFontMonospace()->renderUTF8(tdesc, 0, x, y, LLColor4::white, LLFontGL::LEFT, LLFontGL::TOP);
 
 		x = xleft, y -= (texth + 2);
-		tdesc = llformat("Justification = %s [CTRL-Click to toggle]",centerdesc[mDisplayCenter]);
+		tdesc = llformat("Justification = %s [CTRL-Click to toggle] [CTRL-SHIFT-Click threads]",centerdesc[mDisplayCenter]);
 		LLFontGL::getFontMonospace()->renderUTF8(tdesc, 0, x, y, LLColor4::white, LLFontGL::LEFT, LLFontGL::TOP);
 		y -= (texth + 2);
 
@@ -901,7 +906,12 @@ void LLFastTimerView::draw()
 				y -= barh;
 		}
 		
+		if (mShowThreads)
+		{
+			drawThreadLanes(mGraphRect, iclock_freq);
+		}
 		//draw line graph history
+		else
 		{
 			gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
 			LLLocalClipRect clip(mGraphRect);
@@ -1144,6 +1154,69 @@ void saveChart(const std::string& label, const char* suffix, LLImageRaw* scratch
 	result->save(out_file);
 }
 
+// One row per worker thread: its name, the time it spent in timers and a bar
+// of its outermost timers, for the hovered frame or on average.
+void LLFastTimerView::drawThreadLanes(const LLRect& rect, F64 iclock_freq)
+{
+	gGL.getTexUnit(0)->unbind(LLTexUnit::TT_TEXTURE);
+	LLLocalClipRect clip(rect);
+
+	const LLFontGL* font = LLFontGL::getFontMonospace();
+	const S32 texth = (S32)font->getLineHeight();
+	const S32 lanes = LLFastTimer::getThreadLaneCount();
+	if (!lanes)
+	{
+		font->renderUTF8(std::string("No worker thread timers"), 0, rect.mLeft + 5, rect.mTop - 2,
+						 LLColor4::white, LLFontGL::LEFT, LLFontGL::TOP);
+		return;
+	}
+
+	const S32 history_index = mHoverBarIndex > 0
+		? LLFastTimer::NamedTimer::HISTORY_NUM - mScrollIndex - mHoverBarIndex : -1;
+	std::vector<LLFastTimer::ThreadTimerInfo> timers;
+	std::vector<U32> totals(lanes, 0);
+	U32 max_total = 1;
+	for (S32 lane = 0; lane < lanes; ++lane)
+	{
+		LLFastTimer::getThreadLaneTimers(lane, history_index, timers);
+		for (std::vector<LLFastTimer::ThreadTimerInfo>::const_iterator it = timers.begin(); it != timers.end(); ++it)
+		{
+			if (!it->mDepth)
+			{
+				totals[lane] += it->mCount;
+			}
+		}
+		max_total = llmax(max_total, totals[lane]);
+	}
+
+	const S32 name_width = font->getWidth(std::string("MMMMMMMMMMMMMMMMMMMMMMMM"));
+	const S32 lane_height = llclamp((rect.getHeight() - 4) / lanes, 2, texth + 4);
+	const S32 bar_left = rect.mLeft + 5 + name_width;
+	const S32 bar_width = llmax(rect.mRight - 5 - bar_left, 1);
+	S32 top = rect.mTop - 2;
+	for (S32 lane = 0; lane < lanes && top - lane_height >= rect.mBottom; ++lane, top -= lane_height)
+	{
+		std::string tdesc = llformat("%-16.16s %6.2f ms", LLFastTimer::getThreadLaneName(lane).c_str(),
+									 (F32)((F64)totals[lane] * iclock_freq));
+		font->renderUTF8(tdesc, 0, rect.mLeft + 5, top, LLColor4::white, LLFontGL::LEFT, LLFontGL::TOP);
+
+		LLFastTimer::getThreadLaneTimers(lane, history_index, timers);
+		F32 left = (F32)bar_left;
+		for (std::vector<LLFastTimer::ThreadTimerInfo>::const_iterator it = timers.begin(); it != timers.end(); ++it)
+		{
+			if (it->mDepth || !it->mCount)
+			{
+				continue;
+			}
+			const F32 right = left + (F32)bar_width * (F32)it->mCount / (F32)max_total;
+			std::map<LLFastTimer::NamedTimer*, LLColor4>::const_iterator color = sTimerColors.find(it->mTimer);
+			gl_rect_2d((S32)left, top - 1, llmax((S32)right, (S32)left + 1), top - lane_height + 2,
+					   color != sTimerColors.end() ? color->second : LLColor4::grey);
+			left = right;
+		}
+	}
+}
+
 //static
 void LLFastTimerView::exportCharts(const std::string& base, const std::string& target)
 {
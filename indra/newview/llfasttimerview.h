@@ -53,6 +53,7 @@ private:
 	static void exportCharts(const std::string& base, const std::string& target);
 	void onPause();
 	static void onPauseHandler(void *data);
+	void drawThreadLanes(const LLRect& rect, F64 iclock_freq);
 
 public:
 
@@ -104,6 +105,8 @@ private:
 	bool mOverLegend;
 	S32 mScrollOffset;
 	// </FS:LO>
+
+	bool mShowThreads;		// worker thread lanes instead of the line graph
 };
 
 #endif
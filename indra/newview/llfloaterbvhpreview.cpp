@@ -146,6 +146,7 @@ std::string STATUS[] =
 LLFloaterBvhPreview::LLFloaterBvhPreview(const std::string& filename, void* item) :
 	LLFloaterNameDesc(filename, item),
 	mItem(item), //<edit/>
+	mLoadThread(NULL),
 	mLastMouseX(0),
 	mLastMouseY(0),
 	mPlayButton(nullptr),
@@ -213,7 +214,6 @@ BOOL LLFloaterBvhPreview::postBuild()
 {
 	LLRect r;
 	LLKeyframeMotion* motionp = NULL;
-	LLBVHLoader* loaderp = NULL;
 
 	if (!LLFloaterNameDesc::postBuild())
 	{
@@ -300,89 +300,25 @@ BOOL LLFloaterBvhPreview::postBuild()
 		}
 		else
 		{
-			char*	file_buffer;
-
-			file_buffer = new char[file_size + 1];
+			std::string file_buffer(file_size, '\0');
 
-			if (file_size == infile.read(file_buffer, file_size))
+			if (file_size == infile.read(&file_buffer[0], file_size))
 			{
-				file_buffer[file_size] = '\0';
+				// Large mocap files take a while, onBvhLoaded() sets the
+				// preview up once the thread is done.
 				LL_INFOS() << "Loading BVH file " << mFilename << LL_ENDL;
-				ELoadStatus load_status = E_ST_OK;
-				S32 line_number = 0; 
-				loaderp = new LLBVHLoader(file_buffer, load_status, line_number);
-				std::string status = getString(STATUS[load_status]);
-				
-				if(load_status == E_ST_NO_XLT_FILE)
-				{
-					LL_WARNS() << "NOTE: No translation table found." << LL_ENDL;
-				}
-				else
-				{
-					LL_WARNS() << "ERROR: [line: " << line_number << "] " << status << LL_ENDL;
-				}
+				mLoadThread = new LLBVHLoadThread(file_buffer);
+				mLoadThread->start();
 			}
 
 			infile.close() ;
-			delete[] file_buffer;
-
-			// <edit> moved everything bvh from below
-			if(loaderp && loaderp->isInitialized() && loaderp->getDuration() <= MAX_ANIM_DURATION)
-	{
-		// generate unique id for this motion
-		mTransactionID.generate();
-		mMotionID = mTransactionID.makeAssetID(gAgent.getSecureSessionID());
-
-		mAnimPreview = new LLPreviewAnimation(256, 256);
-
-		// motion will be returned, but it will be in a load-pending state, as this is a new motion
-		// this motion will not request an asset transfer until next update, so we have a chance to 
-		// load the keyframe data locally
-		if (mInWorld)
-			motionp = (LLKeyframeMotion*)gAgentAvatarp->createMotion(mMotionID);
-		else
-			motionp = (LLKeyframeMotion*)mAnimPreview->getDummyAvatar()->createMotion(mMotionID);
-
-		// create data buffer for keyframe initialization
-		S32 buffer_size = loaderp->getOutputSize();
-		U8* buffer = new U8[buffer_size];
-
-		LLDataPackerBinaryBuffer dp(buffer, buffer_size);
-
-		// pass animation data through memory buffer
-		loaderp->serialize(dp);
-		dp.reset();
-				success = motionp && motionp->deserialize(dp, mMotionID);
-			}
-			else
-			{
-				success = false;
-				if ( loaderp )
-				{
-					if (loaderp->getDuration() > MAX_ANIM_DURATION)
-					{
-						LLUIString out_str = getString("anim_too_long");
-						out_str.setArg("[LENGTH]", llformat("%.1f", loaderp->getDuration()));
-						out_str.setArg("[MAX_LENGTH]", llformat("%.1f", MAX_ANIM_DURATION));
-						getChild<LLUICtrl>("bad_animation_text")->setValue(out_str.getString());
-					}
-					else
-					{
-						LLUIString out_str = getString("failed_file_read");
-						out_str.setArg("[STATUS]", getString(STATUS[loaderp->getStatus()])); 
-						getChild<LLUICtrl>("bad_animation_text")->setValue(out_str.getString());
-					}
-				}
+		}
 
-                if (motionp && mInWorld)
-				{
-					gAgentAvatarp->removeMotion(mMotionID);
-				}
-				//setEnabled(FALSE);
-				mMotionID.setNull();
-				mAnimPreview = NULL;
-			}
-			// </edit>
+		if (mLoadThread)
+		{
+			updateLoadProgress();
+			refresh();
+			return TRUE;
 		}
 	}
 	// <edit>
@@ -420,61 +356,157 @@ BOOL LLFloaterBvhPreview::postBuild()
 	}
 	// </edit>
 
-		if (success)
+	initMotion(motionp, success);
+
+	return TRUE;
+}
+
+//-----------------------------------------------------------------------------
+// updateLoadProgress()
+//-----------------------------------------------------------------------------
+void LLFloaterBvhPreview::updateLoadProgress()
+{
+	LLUIString out_str = getString("loading_bvh");
+	out_str.setArg("[PERCENT]", llformat("%d", ll_round(mLoadThread->getProgress() * 100.f)));
+	getChild<LLUICtrl>("bad_animation_text")->setValue(out_str.getString());
+}
+
+//-----------------------------------------------------------------------------
+// onBvhLoaded()
+//-----------------------------------------------------------------------------
+void LLFloaterBvhPreview::onBvhLoaded()
+{
+	LLKeyframeMotion* motionp = NULL;
+	BOOL success = FALSE;
+
+	ELoadStatus load_status = mLoadThread->getStatus();
+	if (load_status == E_ST_NO_XLT_FILE)
+	{
+		LL_WARNS() << "NOTE: No translation table found." << LL_ENDL;
+	}
+	else if (load_status != E_ST_OK)
+	{
+		LL_WARNS() << "ERROR: [line: " << mLoadThread->getErrorLine() << "] " << getString(STATUS[load_status]) << LL_ENDL;
+	}
+	else
+	{
+		LL_INFOS() << "Loaded BVH file " << mFilename << " in " << mLoadThread->getLoadTime() << " seconds" << LL_ENDL;
+	}
+
+	std::vector<U8>& data = mLoadThread->getData();
+	if (data.empty())
+	{
+		if (mLoadThread->getDuration() > MAX_ANIM_DURATION)
 		{
-			setAnimCallbacks() ;
+			LLUIString out_str = getString("anim_too_long");
+			out_str.setArg("[LENGTH]", llformat("%.1f", mLoadThread->getDuration()));
+			out_str.setArg("[MAX_LENGTH]", llformat("%.1f", MAX_ANIM_DURATION));
+			getChild<LLUICtrl>("bad_animation_text")->setValue(out_str.getString());
+		}
+		else
+		{
+			LLUIString out_str = getString("failed_file_read");
+			out_str.setArg("[STATUS]", getString(STATUS[load_status])); 
+			getChild<LLUICtrl>("bad_animation_text")->setValue(out_str.getString());
+		}
 
-			if (!mInWorld)
-			{
-				const LLBBoxLocal &pelvis_bbox = motionp->getPelvisBBox();
+		delete mLoadThread;
+		mLoadThread = NULL;
+		refresh();
+		return;
+	}
 
-				LLVector3 temp = pelvis_bbox.getCenter();
-				// only consider XY?
-				//temp.mV[VZ] = 0.f;
-				F32 pelvis_offset = temp.magVec();
+	// generate unique id for this motion
+	mTransactionID.generate();
+	mMotionID = mTransactionID.makeAssetID(gAgent.getSecureSessionID());
 
-				temp = pelvis_bbox.getExtent();
-				//temp.mV[VZ] = 0.f;
-				F32 pelvis_max_displacement = pelvis_offset + (temp.magVec() * 0.5f) + 1.f;
+	mAnimPreview = new LLPreviewAnimation(256, 256);
 
-				F32 camera_zoom = LLViewerCamera::getInstance()->getDefaultFOV() / (2.f * atan(pelvis_max_displacement / PREVIEW_CAMERA_DISTANCE));
+	// motion will be returned, but it will be in a load-pending state, as this is a new motion
+	// this motion will not request an asset transfer until next update, so we have a chance to 
+	// load the keyframe data locally
+	if (mInWorld)
+		motionp = (LLKeyframeMotion*)gAgentAvatarp->createMotion(mMotionID);
+	else
+		motionp = (LLKeyframeMotion*)mAnimPreview->getDummyAvatar()->createMotion(mMotionID);
 
-				mAnimPreview->setZoom(camera_zoom);
-			}
+	// pass animation data through memory buffer
+	LLDataPackerBinaryBuffer dp(&data[0], (S32)data.size());
+	success = motionp && motionp->deserialize(dp, mMotionID);
 
-			motionp->setName(getChild<LLUICtrl>("name_form")->getValue().asString());
-			if (!mInWorld)
-				mAnimPreview->getDummyAvatar()->startMotion(mMotionID);
-
-			getChild<LLSlider>("playback_slider")->setMinValue(0.0);
-			getChild<LLSlider>("playback_slider")->setMaxValue(1.0);
-
-			getChild<LLUICtrl>("loop_check")->setValue(LLSD(motionp->getLoop()));
-			getChild<LLUICtrl>("loop_in_point")->setValue(LLSD(motionp->getLoopIn() / motionp->getDuration() * 100.f));
-			getChild<LLUICtrl>("loop_out_point")->setValue(LLSD(motionp->getLoopOut() / motionp->getDuration() * 100.f));
-			getChild<LLUICtrl>("priority")->setValue(LLSD((F32)motionp->getPriority()));
-			getChild<LLUICtrl>("hand_pose_combo")->setValue(LLHandMotion::getHandPoseName(motionp->getHandPose()));
-			getChild<LLUICtrl>("ease_in_time")->setValue(LLSD(motionp->getEaseInDuration()));
-			getChild<LLUICtrl>("ease_out_time")->setValue(LLSD(motionp->getEaseOutDuration()));
-			setEnabled(TRUE);
-			std::string seconds_string;
-			seconds_string = llformat(" - %.2f seconds", motionp->getDuration());
-
-			setTitle(mFilename + std::string(seconds_string));
+	delete mLoadThread;
+	mLoadThread = NULL;
+
+	if (mInWorld)
+	{
+		if (success)
+		{
+			getChild<LLUICtrl>("bad_animation_text")->setValue(getString("in_world"));
 		}
-		else
+		else if (motionp)
 		{
-			mAnimPreview = NULL;
-			mMotionID.setNull();
-			getChild<LLUICtrl>("bad_animation_text")->setValue(getString("failed_to_initialize"));
+			gAgentAvatarp->removeMotion(mMotionID);
 		}
+	}
 
+	initMotion(motionp, success);
+}
 
-	refresh();
+//-----------------------------------------------------------------------------
+// initMotion()
+//-----------------------------------------------------------------------------
+void LLFloaterBvhPreview::initMotion(LLKeyframeMotion* motionp, BOOL success)
+{
+	if (success)
+	{
+		setAnimCallbacks() ;
 
-	delete loaderp;
+		if (!mInWorld)
+		{
+			const LLBBoxLocal &pelvis_bbox = motionp->getPelvisBBox();
 
-	return TRUE;
+			LLVector3 temp = pelvis_bbox.getCenter();
+			// only consider XY?
+			//temp.mV[VZ] = 0.f;
+			F32 pelvis_offset = temp.magVec();
+
+			temp = pelvis_bbox.getExtent();
+			//temp.mV[VZ] = 0.f;
+			F32 pelvis_max_displacement = pelvis_offset + (temp.magVec() * 0.5f) + 1.f;
+
+			F32 camera_zoom = LLViewerCamera::getInstance()->getDefaultFOV() / (2.f * atan(pelvis_max_displacement / PREVIEW_CAMERA_DISTANCE));
+
+			mAnimPreview->setZoom(camera_zoom);
+		}
+
+		motionp->setName(getChild<LLUICtrl>("name_form")->getValue().asString());
+		if (!mInWorld)
+			mAnimPreview->getDummyAvatar()->startMotion(mMotionID);
+
+		getChild<LLSlider>("playback_slider")->setMinValue(0.0);
+		getChild<LLSlider>("playback_slider")->setMaxValue(1.0);
+
+		getChild<LLUICtrl>("loop_check")->setValue(LLSD(motionp->getLoop()));
+		getChild<LLUICtrl>("loop_in_point")->setValue(LLSD(motionp->getLoopIn() / motionp->getDuration() * 100.f));
+		getChild<LLUICtrl>("loop_out_point")->setValue(LLSD(motionp->getLoopOut() / motionp->getDuration() * 100.f));
+		getChild<LLUICtrl>("priority")->setValue(LLSD((F32)motionp->getPriority()));
+		getChild<LLUICtrl>("hand_pose_combo")->setValue(LLHandMotion::getHandPoseName(motionp->getHandPose()));
+		getChild<LLUICtrl>("ease_in_time")->setValue(LLSD(motionp->getEaseInDuration()));
+		getChild<LLUICtrl>("ease_out_time")->setValue(LLSD(motionp->getEaseOutDuration()));
+		setEnabled(TRUE);
+		std::string seconds_string;
+		seconds_string = llformat(" - %.2f seconds", motionp->getDuration());
+
+		setTitle(mFilename + std::string(seconds_string));
+	}
+	else
+	{
+		mAnimPreview = NULL;
+		mMotionID.setNull();
+		getChild<LLUICtrl>("bad_animation_text")->setValue(getString("failed_to_initialize"));
+	}
+
+	refresh();
 }
 
 //-----------------------------------------------------------------------------
@@ -482,6 +514,16 @@ BOOL LLFloaterBvhPreview::postBuild()
 //-----------------------------------------------------------------------------
 LLFloaterBvhPreview::~LLFloaterBvhPreview()
 {
+	if (mLoadThread)
+	{
+		mLoadThread->cancel();
+		while (!mLoadThread->isStopped())
+		{
+			ms_sleep(1);
+		}
+		delete mLoadThread;
+	}
+
 	if (mInWorld)
 	{
 		LLVOAvatar* avatarp = gAgentAvatarp;
@@ -512,6 +554,18 @@ LLFloaterBvhPreview::~LLFloaterBvhPreview()
 //-----------------------------------------------------------------------------
 void LLFloaterBvhPreview::draw()
 {
+	if (mLoadThread)
+	{
+		if (mLoadThread->isStopped())
+		{
+			onBvhLoaded();
+		}
+		else
+		{
+			updateLoadProgress();
+		}
+	}
+
 	LLFloater::draw();
 	LLRect r = getRect();
 
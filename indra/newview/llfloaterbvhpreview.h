@@ -37,6 +37,8 @@
 #include "llcharacter.h"
 #include "llquaternion.h"
 
+class LLBVHLoadThread;
+class LLKeyframeMotion;
 class LLVOAvatar;
 class LLViewerJointMesh;
 
@@ -129,7 +131,14 @@ protected:
 	void			draw();
 	void			resetMotion();
 
+	// Shows how far mLoadThread got.
+	void			updateLoadProgress();
+	// Sets the preview up from what mLoadThread loaded.
+	void			onBvhLoaded();
+	void			initMotion(LLKeyframeMotion* motionp, BOOL success);
+
 	LLPointer< LLPreviewAnimation> mAnimPreview;
+	LLBVHLoadThread*	mLoadThread;
 	S32					mLastMouseX;
 	S32					mLastMouseY;
 	LLButton*			mPlayButton;
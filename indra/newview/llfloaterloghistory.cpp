@@ -0,0 +1,247 @@
+/**
+ * @file llfloaterloghistory.cpp
+ * @brief Pages through and searches a chat or IM log.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llfloaterloghistory.h"
+
+#include "llbutton.h"
+#include "llscrolllistctrl.h"
+#include "lltexteditor.h"
+#include "lluictrlfactory.h"
+
+static const S32 LINES_PER_PAGE = 200;
+static const U32 MAX_SEARCH_RESULTS = 500;
+// How often to look whether the index of the log is ready.
+static const F32 INDEX_POLL_INTERVAL = 0.25f;
+
+LLFloaterLogHistory::LLFloaterLogHistory(const LLSD& key)
+:	LLFloater(),
+	mFirstLine(0),
+	mLineCount(0),
+	mWaitingFirstLine(-1),
+	mWaitingFocusLine(-1),
+	mSearchID(0),
+	mHistoryEditor(NULL),
+	mResultsList(NULL)
+{
+	LLUICtrlFactory::instance().buildFloater(this, "floater_log_history.xml");
+}
+
+LLFloaterLogHistory::~LLFloaterLogHistory()
+{
+	LLLogChat::cancelSearch(mSearchID);
+}
+
+BOOL LLFloaterLogHistory::postBuild()
+{
+	mHistoryEditor = getChild<LLTextEditor>("history_editor");
+	mResultsList = getChild<LLScrollListCtrl>("results_list");
+	mResultsList->setDoubleClickCallback(boost::bind(&LLFloaterLogHistory::onResultDoubleClick, this));
+
+	getChild<LLUICtrl>("search_editor")->setCommitCallback(boost::bind(&LLFloaterLogHistory::onSearch, this));
+	childSetAction("search_btn", boost::bind(&LLFloaterLogHistory::onSearch, this));
+	childSetAction("oldest_btn", boost::bind(&LLFloaterLogHistory::onClickOldest, this));
+	childSetAction("older_btn", boost::bind(&LLFloaterLogHistory::onClickPage, this, -LINES_PER_PAGE));
+	childSetAction("newer_btn", boost::bind(&LLFloaterLogHistory::onClickPage, this, LINES_PER_PAGE));
+	childSetAction("newest_btn", boost::bind(&LLFloaterLogHistory::onClickNewest, this));
+
+	return TRUE;
+}
+
+void LLFloaterLogHistory::draw()
+{
+	if (mWaitingFirstLine >= 0 && mIndexPollTimer.getElapsedTimeF32() > INDEX_POLL_INTERVAL)
+	{
+		mIndexPollTimer.reset();
+		if (LLLogChat::getHistoryLineCount(mName, mID) >= 0)
+		{
+			showPage(mWaitingFirstLine, mWaitingFocusLine);
+		}
+	}
+	LLFloater::draw();
+}
+
+//static
+void LLFloaterLogHistory::show(const std::string& name, const LLUUID& id)
+{
+	if (LLFloaterLogHistory* floater = showInstance())
+	{
+		floater->setLog(name, id);
+	}
+}
+
+void LLFloaterLogHistory::setLog(const std::string& name, const LLUUID& id)
+{
+	LLLogChat::cancelSearch(mSearchID);
+	mSearchID = 0;
+	mName = name;
+	mID = id;
+	setTitle(name);
+	mResultsList->deleteAllItems();
+	mResultsList->setVisible(false);
+	getChild<LLUICtrl>("search_status")->setValue(LLStringUtil::null);
+	onClickNewest();
+}
+
+void LLFloaterLogHistory::showPage(S32 first_line, S32 focus_line)
+{
+	// The log may have grown since the last page.
+	mLineCount = LLLogChat::getHistoryLineCount(mName, mID);
+	if (mLineCount < 0)
+	{
+		showNewestUnindexed(first_line, focus_line);
+		return;
+	}
+	mWaitingFirstLine = mWaitingFocusLine = -1;
+	mFirstLine = llclamp(first_line, 0, llmax(mLineCount - LINES_PER_PAGE, 0));
+
+	std::string text;
+	S32 lines = 0;
+	LLLogChat::loadHistoryPage(mName, mID, mFirstLine, LINES_PER_PAGE,
+		[&text, &lines](LLLogChat::ELogLineType type, const std::string& line)
+		{
+			if (type != LLLogChat::LOG_LINE) return;
+			if (lines++) text += '\n';
+			text += line;
+		});
+	mHistoryEditor->setText(text, false);
+	if (focus_line >= mFirstLine && focus_line < mFirstLine + lines)
+	{
+		mHistoryEditor->setCursor(focus_line - mFirstLine, 0);
+	}
+	else
+	{
+		mHistoryEditor->setCursorAndScrollToEnd();
+	}
+	mResultsList->setVisible(false);
+
+	if (mLineCount > 0)
+	{
+		LLStringUtil::format_map_t args;
+		args["[FIRST]"] = llformat("%d", mFirstLine + 1);
+		args["[LAST]"] = llformat("%d", llmin(mFirstLine + LINES_PER_PAGE, mLineCount));
+		args["[COUNT]"] = llformat("%d", mLineCount);
+		getChild<LLUICtrl>("page_text")->setValue(getString("page", args));
+	}
+	else
+	{
+		getChild<LLUICtrl>("page_text")->setValue(getString("empty"));
+	}
+	getChildView("oldest_btn")->setEnabled(mFirstLine > 0);
+	getChildView("older_btn")->setEnabled(mFirstLine > 0);
+	getChildView("newer_btn")->setEnabled(mFirstLine + LINES_PER_PAGE < mLineCount);
+	getChildView("newest_btn")->setEnabled(mFirstLine + LINES_PER_PAGE < mLineCount);
+}
+
+void LLFloaterLogHistory::showNewestUnindexed(S32 first_line, S32 focus_line)
+{
+	mWaitingFirstLine = llmax(first_line, 0);
+	mWaitingFocusLine = focus_line;
+	mIndexPollTimer.reset();
+
+	std::string text;
+	LLLogChat::loadHistory(mName, mID,
+		[&text](LLLogChat::ELogLineType type, const std::string& line)
+		{
+			if (type != LLLogChat::LOG_LINE) return;
+			if (!text.empty()) text += '\n';
+			text += line;
+		});
+	mHistoryEditor->setText(text, false);
+	mHistoryEditor->setCursorAndScrollToEnd();
+	mResultsList->setVisible(false);
+
+	getChild<LLUICtrl>("page_text")->setValue(getString("indexing"));
+	getChildView("oldest_btn")->setEnabled(false);
+	getChildView("older_btn")->setEnabled(false);
+	getChildView("newer_btn")->setEnabled(false);
+	getChildView("newest_btn")->setEnabled(false);
+}
+
+void LLFloaterLogHistory::onClickPage(S32 lines)
+{
+	showPage(mFirstLine + lines);
+}
+
+void LLFloaterLogHistory::onClickOldest()
+{
+	showPage(0);
+}
+
+void LLFloaterLogHistory::onClickNewest()
+{
+	// Clamped to the last full page
+	showPage(S32_MAX);
+}
+
+void LLFloaterLogHistory::onSearch()
+{
+	LLLogChat::cancelSearch(mSearchID);
+	const std::string text = getChild<LLUICtrl>("search_editor")->getValue().asString();
+	mSearchID = LLLogChat::searchHistory(mName, mID, text, MAX_SEARCH_RESULTS,
+										 boost::bind(&LLFloaterLogHistory::onSearchDone, this, _1));
+	getChild<LLUICtrl>("search_status")->setValue(mSearchID ? getString("searching") : LLStringUtil::null);
+}
+
+void LLFloaterLogHistory::onSearchDone(const LLLogChat::search_result_vec_t& results)
+{
+	mSearchID = 0;
+	mResultsList->deleteAllItems();
+	for (LLLogChat::search_result_vec_t::const_iterator it = results.begin(); it != results.end(); ++it)
+	{
+		LLSD row;
+		row["value"] = (S32)it->first;
+		row["columns"][0]["column"] = "line";
+		row["columns"][0]["value"] = (S32)it->first + 1;
+		row["columns"][1]["column"] = "text";
+		row["columns"][1]["value"] = it->second;
+		mResultsList->addElement(row);
+	}
+	mResultsList->setVisible(true);
+
+	if (results.empty())
+	{
+		getChild<LLUICtrl>("search_status")->setValue(getString("no_matches"));
+	}
+	else
+	{
+		LLStringUtil::format_map_t args;
+		args["[COUNT]"] = llformat("%d", (S32)results.size());
+		getChild<LLUICtrl>("search_status")->setValue(getString("matches", args));
+	}
+}
+
+void LLFloaterLogHistory::onResultDoubleClick()
+{
+	if (LLScrollListItem* item = mResultsList->getFirstSelected())
+	{
+		// Page around the line
+		const S32 line = item->getValue().asInteger();
+		showPage(line - LINES_PER_PAGE / 2, line);
+	}
+}
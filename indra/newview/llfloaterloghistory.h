@@ -0,0 +1,78 @@
+/**
+ * @file llfloaterloghistory.h
+ * @brief Pages through and searches a chat or IM log.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#ifndef LL_LLFLOATERLOGHISTORY_H
+#define LL_LLFLOATERLOGHISTORY_H
+
+#include "llfloater.h"
+#include "llframetimer.h"
+#include "lllogchat.h"
+
+class LLScrollListCtrl;
+class LLTextEditor;
+
+// Shows a log a page at a time through its line index, so that logs of any
+// size open at once, and searches it without blocking the viewer.
+class LLFloaterLogHistory : public LLFloater
+, public LLFloaterSingleton<LLFloaterLogHistory>
+{
+public:
+	LLFloaterLogHistory(const LLSD& key);
+	BOOL postBuild() override;
+	void draw() override;
+
+	// Opens the newest page of the log of name/id.
+	static void show(const std::string& name, const LLUUID& id);
+
+private:
+	~LLFloaterLogHistory();
+	void setLog(const std::string& name, const LLUUID& id);
+	// Puts the cursor on focus_line if it is on the page, else at the end.
+	// Until the log is indexed, shows its newest lines and leaves the page
+	// for draw() to show once it is.
+	void showPage(S32 first_line, S32 focus_line = -1);
+	void showNewestUnindexed(S32 first_line, S32 focus_line);
+	void onClickPage(S32 lines);
+	void onClickOldest();
+	void onClickNewest();
+	void onSearch();
+	void onSearchDone(const LLLogChat::search_result_vec_t& results);
+	void onResultDoubleClick();
+
+	std::string mName;
+	LLUUID mID;
+	S32 mFirstLine;
+	S32 mLineCount;
+	S32 mWaitingFirstLine;
+	S32 mWaitingFocusLine;
+	LLFrameTimer mIndexPollTimer;
+	U32 mSearchID;
+	LLTextEditor* mHistoryEditor;
+	LLScrollListCtrl* mResultsList;
+};
+
+#endif // LL_LLFLOATERLOGHISTORY_H
@@ -0,0 +1,114 @@
+/**
+ * @file llfloatermemorytags.cpp
+ * @brief Shows the memory accounted to each subsystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llfloatermemorytags.h"
+
+#include "llmemtag.h"
+#include "llscrolllistctrl.h"
+#include "lluictrlfactory.h"
+#include "sgmemstat.h"
+
+static const F32 REFRESH_INTERVAL = 0.5f;
+
+static std::string format_mb(F64 bytes)
+{
+	return llformat("%.1f", bytes / 1048576.0);
+}
+
+LLFloaterMemoryTags::LLFloaterMemoryTags()
+:	LLFloater()
+{
+	LLUICtrlFactory::getInstance()->buildFloater(this, "floater_memory_tags.xml");
+}
+
+BOOL LLFloaterMemoryTags::postBuild()
+{
+	getChild<LLUICtrl>("reset_peaks_btn")->setCommitCallback(boost::bind(&LLFloaterMemoryTags::onClickResetPeaks, this));
+	getChild<LLUICtrl>("dump_btn")->setCommitCallback(boost::bind(&LLFloaterMemoryTags::onClickDump, this));
+	refresh();
+	return TRUE;
+}
+
+void LLFloaterMemoryTags::draw()
+{
+	if (mRefreshTimer.getElapsedTimeF32() > REFRESH_INTERVAL)
+	{
+		refresh();
+	}
+	LLFloater::draw();
+}
+
+void LLFloaterMemoryTags::refresh()
+{
+	mRefreshTimer.reset();
+
+	LLScrollListCtrl* list = getChild<LLScrollListCtrl>("tag_list");
+	S32 scroll_pos = list->getScrollPos();
+	list->deleteAllItems();
+
+	LLSD row;
+	LLSD& columns = row["columns"];
+	columns[0]["column"] = "tag";	columns[0]["type"] = "text";
+	columns[1]["column"] = "current";	columns[1]["type"] = "text";
+	columns[2]["column"] = "peak";	columns[2]["type"] = "text";
+
+	for (S32 i = 0; i < LLMemTag::MT_COUNT; ++i)
+	{
+		LLMemTag::ETag tag = (LLMemTag::ETag)i;
+		columns[0]["value"] = LLMemTag::getName(tag);
+		columns[1]["value"] = format_mb(LLMemTag::getBytes(tag));
+		columns[2]["value"] = format_mb(LLMemTag::getPeakBytes(tag));
+		list->addElement(row, ADD_BOTTOM);
+	}
+
+	columns[0]["value"] = getString("total");
+	columns[1]["value"] = format_mb(LLMemTag::getTotalBytes());
+	columns[2]["value"] = "";
+	list->addElement(row, ADD_BOTTOM);
+
+	// What the allocator reports, to see how much is not accounted for.
+	if (SGMemStat::haveStat())
+	{
+		columns[0]["value"] = getString("malloc");
+		columns[1]["value"] = format_mb(SGMemStat::getMalloc());
+		list->addElement(row, ADD_BOTTOM);
+	}
+
+	list->setScrollPos(scroll_pos);
+}
+
+void LLFloaterMemoryTags::onClickResetPeaks()
+{
+	LLMemTag::resetPeaks();
+	refresh();
+}
+
+void LLFloaterMemoryTags::onClickDump()
+{
+	LLMemTag::dumpToLog();
+}
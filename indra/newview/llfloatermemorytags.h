@@ -0,0 +1,50 @@
+/**
+ * @file llfloatermemorytags.h
+ * @brief Shows the memory accounted to each subsystem.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLFLOATERMEMORYTAGS_H
+#define LL_LLFLOATERMEMORYTAGS_H
+
+#include "llfloater.h"
+#include "llframetimer.h"
+
+// Lists the LLMemTag counters with their high-water marks.
+class LLFloaterMemoryTags : public LLFloater, public LLSingleton<LLFloaterMemoryTags>
+{
+public:
+	LLFloaterMemoryTags();
+
+	/*virtual*/ BOOL postBuild();
+	/*virtual*/ void draw();
+
+private:
+	void refresh();
+	void onClickResetPeaks();
+	void onClickDump();
+
+	LLFrameTimer mRefreshTimer;
+};
+
+#endif // LL_LLFLOATERMEMORYTAGS_H
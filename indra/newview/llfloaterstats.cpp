@@ -201,6 +201,62 @@ void LLFloaterStats::buildStats()
 		render_statviewp->addStat("Object Cache Hit Rate", &(LLViewerStats::getInstance()->mNumNewObjectsStat), params, std::string(), false, true);
 	}
 
+	{
+		LLStatBar::Parameters params;
+		params.mUnitLabel = "/fr";
+		params.mMinBar = 0.f;
+		params.mMaxBar = 20.f;
+		params.mTickSpacing = 5.f;
+		params.mLabelSpacing = 10.f;
+		params.mPerSec = FALSE;
+		render_statviewp->addStat("Impostors Refreshed", &(LLViewerStats::getInstance()->mImpostorsRefreshedStat), params);
+	}
+
+	{
+		LLStatBar::Parameters params;
+		params.mUnitLabel = "/fr";
+		params.mMinBar = 0.f;
+		params.mMaxBar = 100.f;
+		params.mTickSpacing = 25.f;
+		params.mLabelSpacing = 50.f;
+		params.mPerSec = FALSE;
+		render_statviewp->addStat("Impostors Skipped", &(LLViewerStats::getInstance()->mImpostorsSkippedStat), params);
+	}
+
+	{
+		LLStatBar::Parameters params;
+		params.mUnitLabel = "ms";
+		params.mMinBar = 0.f;
+		params.mMaxBar = 10.f;
+		params.mTickSpacing = 1.f;
+		params.mLabelSpacing = 5.f;
+		params.mPrecision = 2;
+		params.mPerSec = FALSE;
+		render_statviewp->addStat("Impostor Time", &(LLViewerStats::getInstance()->mImpostorMsecStat), params);
+	}
+
+	{
+		LLStatBar::Parameters params;
+		params.mUnitLabel = "/fr";
+		params.mMinBar = 0.f;
+		params.mMaxBar = 1000.f;
+		params.mTickSpacing = 250.f;
+		params.mLabelSpacing = 500.f;
+		params.mPerSec = FALSE;
+		render_statviewp->addStat("Visual Params Checked", &(LLViewerStats::getInstance()->mVisualParamsCheckedStat), params);
+	}
+
+	{
+		LLStatBar::Parameters params;
+		params.mUnitLabel = "/fr";
+		params.mMinBar = 0.f;
+		params.mMaxBar = 500.f;
+		params.mTickSpacing = 100.f;
+		params.mLabelSpacing = 250.f;
+		params.mPerSec = FALSE;
+		render_statviewp->addStat("Visual Params Applied", &(LLViewerStats::getInstance()->mVisualParamsAppliedStat), params);
+	}
+
 	// Texture statistics
 	params.name("texture stat view");
 	params.show_label(true);
@@ -201,6 +201,9 @@ LLFolderView::LLFolderView( const std::string& name,
 	mAutoSelectOverride(FALSE),
 	mNeedsAutoRename(FALSE),
 	mDebugFilters(FALSE),
+	mLastFilterItemCount(0),
+	mLastFilterRejectCount(0),
+	mLastFilterTime(0.f),
 	mSortOrder(LLInventoryFilter::SO_FOLDERS_BY_NAME),	// This gets overridden by a pref immediately
 	mFilter(LLInventoryFilter::Params().name(name)),
 	mShowSelectionContext(FALSE),
@@ -547,13 +550,26 @@ static LLTrace::BlockTimerStatHandle FTM_FILTER("Filter Inventory");
 void LLFolderView::filter( LLInventoryFilter& filter )
 {
 	LL_RECORD_BLOCK_TIME(FTM_FILTER);
-	filter.setFilterCount(llclamp(gSavedSettings.getS32("FilterItemsPerFrame"), 1, 5000));
+	static LLCachedControl<S32> filter_items_per_frame(gSavedSettings, "FilterItemsPerFrame");
+	static LLCachedControl<F32> filter_time_per_frame(gSavedSettings, "FilterTimePerFrame");
+	const S32 filter_count = llclamp((S32)filter_items_per_frame, 1, 5000);
+	filter.setFilterCount(filter_count);
+	filter.setFilterTimeLimit(llmax((F32)filter_time_per_frame, 0.f) * 0.001f);
 
 	if (getCompletedFilterGeneration() < filter.getCurrentGeneration())
 	{
+		LLTimer timer;
+		filter.updateSearchIndex(getSearchType());
 		mPassedFilter = FALSE;
 		mMinWidth = 0;
 		LLFolderViewFolder::filter(filter);
+
+		mLastFilterItemCount = filter_count - llmax(filter.getFilterCount(), 0) + filter.getIndexRejectCount();
+		mLastFilterRejectCount = filter.getIndexRejectCount();
+		mLastFilterTime = timer.getElapsedTimeF32() * 1000.f;
+		LL_DEBUGS("InventoryFilter") << getName() << ": filtered " << mLastFilterItemCount << " items ("
+									 << mLastFilterRejectCount << " rejected by the search index) in "
+									 << mLastFilterTime << " ms" << LL_ENDL;
 	}
 	else
 	{
@@ -908,8 +924,9 @@ void LLFolderView::draw()
 {
 	if (mDebugFilters)
 	{
-		std::string current_filter_string = llformat("Current Filter: %d, Least Filter: %d, Auto-accept Filter: %d",
-										mFilter.getCurrentGeneration(), mFilter.getFirstSuccessGeneration(), mFilter.getFirstRequiredGeneration());
+		std::string current_filter_string = llformat("Current Filter: %d, Least Filter: %d, Auto-accept Filter: %d, Last Pass: %d items (%d indexed out) in %.2f ms",
+										mFilter.getCurrentGeneration(), mFilter.getFirstSuccessGeneration(), mFilter.getFirstRequiredGeneration(),
+										mLastFilterItemCount, mLastFilterRejectCount, mLastFilterTime);
 		LLFontGL::getFontMonospace()->renderUTF8(current_filter_string, 0, 2, 
 			getRect().getHeight() - LLFontGL::getFontMonospace()->getLineHeight(), LLColor4(0.5f, 0.5f, 0.8f, 1.f), 
 			LLFontGL::LEFT, LLFontGL::BOTTOM, LLFontGL::NORMAL, LLFontGL::NO_SHADOW,  S32_MAX, S32_MAX, NULL, FALSE );
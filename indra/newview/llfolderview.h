@@ -316,6 +316,10 @@ protected:
 	LLRect							mScrollConstraintRect;
 
 	bool							mDebugFilters;
+	// Last frame's filter pass, shown with the debug filters
+	S32								mLastFilterItemCount;
+	S32								mLastFilterRejectCount;
+	F32								mLastFilterTime;
 	U32								mSortOrder;
 	U32								mSearchType;
 	LLDepthStack<LLFolderViewFolder>	mAutoOpenItems;
@@ -259,6 +259,7 @@ public:
 	const std::string& getName( void ) const;
 
 	const std::string& getSearchableLabel( void );
+	const std::string& getLabelSuffix() const { return mLabelSuffix; }
 
 	// This method returns the label displayed on the view. This
 	// method was primarily added to allow sorting on the folder
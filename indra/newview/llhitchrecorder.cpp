@@ -0,0 +1,382 @@
+/**
+ * @file llhitchrecorder.cpp
+ * @brief Keeps the last frames' timings and stats, dumped on a hitch.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llhitchrecorder.h"
+
+#include <ctime>
+#include <map>
+
+#include "llappviewer.h"
+#include "llfasttimer.h"
+#include "llimageworker.h"
+#include "llmeshrepository.h"
+#include "llsdasync.h"
+#include "llstartup.h"
+#include "lltexturefetch.h"
+#include "llversioninfo.h"
+#include "llviewerstats.h"
+#include "message.h"
+
+// Timers below this share of a millisecond are left out of the records.
+static const F64 MIN_TIMER_MS = 0.05;
+
+// A hitch often comes with a few more: don't write a file for each.
+static const F32 MIN_DUMP_INTERVAL = 10.f;
+static const U32 MAX_DUMPS_PER_SESSION = 50;
+
+U32 LLHitchRecorder::sDumpCount = 0;
+
+namespace
+{
+	const char* const STAT_NAMES[] =
+	{
+		"fps",
+		"kbit_in",
+		"packets_in",
+		"packets_lost",
+		"objects_drawn",
+		"triangles_drawn",
+		"objects",
+		"new_objects",
+		"sim_time_dilation",
+		"sim_ping_ms",
+		"gl_tex_mem",
+		"malloc"
+	};
+	const S32 NUM_STATS = LL_ARRAY_SIZE(STAT_NAMES);
+
+	const char* const QUEUE_NAMES[] =
+	{
+		"texture_fetch",
+		"texture_http",
+		"image_decode",
+		"mesh_pending",
+		"mesh_header_http",
+		"mesh_lod_http"
+	};
+	const S32 NUM_QUEUES = LL_ARRAY_SIZE(QUEUE_NAMES);
+
+	const char* const MESSAGE_NAMES[] =
+	{
+		"packets_in",
+		"packets_out",
+		"bytes_in",
+		"bytes_out"
+	};
+	const S32 NUM_MESSAGES = LL_ARRAY_SIZE(MESSAGE_NAMES);
+
+	struct TimerSample
+	{
+		LLFastTimer::NamedTimer*	mTimer;
+		U32							mCount;		// includes the children
+		U32							mCalls;
+	};
+
+	struct FrameRecord
+	{
+		U32							mFrame;
+		F64							mTime;		// seconds since startup
+		F32							mFrameMs;
+		std::vector<TimerSample>	mTimers;	// parents before children
+		F32							mStats[NUM_STATS];
+		S32							mQueues[NUM_QUEUES];
+		U64							mMessages[NUM_MESSAGES];	// during the frame
+	};
+
+	std::vector<FrameRecord> sFrames;
+	U32 sRecorded = 0;			// frames ever recorded
+	F32 sThreshold = 0.f;
+	LLTimer sFrameTimer;
+	bool sFrameTimerStarted = false;
+	LLTimer sDumpTimer;
+	U64 sLastMessages[NUM_MESSAGES];
+
+	void add_timers(LLFastTimer::NamedTimer* timer, U32 min_count, std::vector<TimerSample>& timers)
+	{
+		// A timer includes its children: nothing below one too short to
+		// keep would be kept either.
+		std::vector<LLFastTimer::NamedTimer*>& children = timer->getChildren();
+		for (std::vector<LLFastTimer::NamedTimer*>::iterator it = children.begin(); it != children.end(); ++it)
+		{
+			const U32 count = (*it)->getHistoricalCount(0);
+			if (count < min_count) continue;
+
+			TimerSample sample;
+			sample.mTimer = *it;
+			sample.mCount = count;
+			sample.mCalls = (*it)->getHistoricalCalls(0);
+			timers.push_back(sample);
+			add_timers(*it, min_count, timers);
+		}
+	}
+
+	void record_frame(FrameRecord& record, F32 frame_ms)
+	{
+		record.mFrame = LLFrameTimer::getFrameCount();
+		record.mTime = LLFrameTimer::getElapsedSeconds();
+		record.mFrameMs = frame_ms;
+
+		record.mTimers.clear();
+		const U32 min_count = (U32)((F64)LLFastTimer::countsPerSecond() * MIN_TIMER_MS / 1000.0);
+		add_timers(&LLFastTimer::NamedTimer::getRootNamedTimer(), llmax(min_count, (U32)1), record.mTimers);
+
+		LLViewerStats& stats = LLViewerStats::instance();
+		const LLStat* stat_values[NUM_STATS] =
+		{
+			&stats.mFPSStat,
+			&stats.mKBitStat,
+			&stats.mPacketsInStat,
+			&stats.mPacketsLostStat,
+			&stats.mObjectsDrawnStat,
+			&stats.mTrianglesDrawnStat,
+			&stats.mNumObjectsStat,
+			&stats.mNumNewObjectsStat,
+			&stats.mSimTimeDilation,
+			&stats.mSimPingStat,
+			&stats.mGLTexMemStat,
+			&stats.mMallocStat
+		};
+		for (S32 i = 0; i < NUM_STATS; ++i)
+		{
+			record.mStats[i] = stat_values[i]->getCurrent();
+		}
+
+		LLTextureFetch* fetch = LLAppViewer::getTextureFetch();
+		record.mQueues[0] = fetch ? fetch->getNumRequests() : 0;
+		record.mQueues[1] = fetch ? fetch->getNumHTTPRequests() : 0;
+		S32 decodes = 0;
+		for (S32 i = 0; i < LLAppViewer::countGenxImageDecodeThread(); ++i)
+		{
+			decodes += LLAppViewer::getGenxImageDecodeThread(i)->getPending();
+		}
+		record.mQueues[2] = decodes;
+		record.mQueues[3] = (S32)gMeshRepo.mPendingRequests.size();
+		record.mQueues[4] = LLMeshRepoThread::sActiveHeaderRequests;
+		record.mQueues[5] = LLMeshRepoThread::sActiveLODRequests;
+
+		const U64 messages[NUM_MESSAGES] =
+		{
+			gMessageSystem->mPacketsIn,
+			gMessageSystem->mPacketsOut,
+			gMessageSystem->mBytesIn,
+			gMessageSystem->mBytesOut
+		};
+		for (S32 i = 0; i < NUM_MESSAGES; ++i)
+		{
+			record.mMessages[i] = messages[i] - sLastMessages[i];
+			sLastMessages[i] = messages[i];
+		}
+	}
+
+	void write_dump(const std::string& filename, bool success, const std::string& data)
+	{
+		if (!success)
+		{
+			LL_WARNS() << "Could not format hitch report " << filename << LL_ENDL;
+			return;
+		}
+		llofstream file(filename.c_str(), std::ios_base::out | std::ios_base::binary);
+		if (!file.is_open())
+		{
+			LL_WARNS() << "Could not write hitch report " << filename << LL_ENDL;
+			return;
+		}
+		// The header LLSDSerialize::deserialize() expects
+		file << "<? LLSD/Binary ?>\n";
+		file.write(data.data(), data.size());
+		LL_INFOS() << "Hitch report written to " << filename << LL_ENDL;
+	}
+
+	LLSD make_names(const char* const* names, S32 count)
+	{
+		LLSD array = LLSD::emptyArray();
+		for (S32 i = 0; i < count; ++i)
+		{
+			array.append(names[i]);
+		}
+		return array;
+	}
+}
+
+//static
+void LLHitchRecorder::initClass(U32 frames, F32 threshold_ms)
+{
+	setHistorySize(frames);
+	setThreshold(threshold_ms);
+}
+
+//static
+void LLHitchRecorder::cleanupClass()
+{
+	std::vector<FrameRecord>().swap(sFrames);
+	sRecorded = 0;
+}
+
+//static
+void LLHitchRecorder::setHistorySize(U32 frames)
+{
+	frames = llclamp(frames, (U32)2, (U32)LLFastTimer::NamedTimer::HISTORY_NUM);
+	if (frames != sFrames.size())
+	{
+		// Changing it drops the history: not worth reordering the ring.
+		sFrames.clear();
+		sFrames.resize(frames);
+		sRecorded = 0;
+	}
+}
+
+//static
+void LLHitchRecorder::setThreshold(F32 ms)
+{
+	sThreshold = llmax(ms, 0.f);
+}
+
+//static
+void LLHitchRecorder::nextFrame()
+{
+	// Logging in is one long series of hitches.
+	if (sThreshold <= 0.f || sFrames.empty() || LLStartUp::getStartupState() < STATE_STARTED
+		|| !gMessageSystem || LLFastTimer::sPauseHistory)
+	{
+		sFrameTimerStarted = false;
+		return;
+	}
+
+	const F32 frame_ms = sFrameTimer.getElapsedTimeAndResetF32() * 1000.f;
+	if (!sFrameTimerStarted)
+	{
+		// The first frame only sets the baselines.
+		sFrameTimerStarted = true;
+		sLastMessages[0] = gMessageSystem->mPacketsIn;
+		sLastMessages[1] = gMessageSystem->mPacketsOut;
+		sLastMessages[2] = gMessageSystem->mBytesIn;
+		sLastMessages[3] = gMessageSystem->mBytesOut;
+		return;
+	}
+
+	record_frame(sFrames[sRecorded++ % sFrames.size()], frame_ms);
+
+	if (frame_ms > sThreshold && sDumpCount < MAX_DUMPS_PER_SESSION
+		&& (!sDumpCount || sDumpTimer.getElapsedTimeF32() > MIN_DUMP_INTERVAL))
+	{
+		dump(frame_ms);
+		sDumpTimer.reset();
+		// Whatever the dump costs shows in the next frame.
+		sFrameTimer.reset();
+	}
+}
+
+//static
+void LLHitchRecorder::getHistory(LLSD& history)
+{
+	const F64 ms_per_count = 1000.0 / (F64)LLFastTimer::countsPerSecond();
+	const U32 count = llmin(sRecorded, (U32)sFrames.size());
+
+	// Timer names and parents are stored once.
+	typedef std::map<LLFastTimer::NamedTimer*, S32> timer_index_map_t;
+	timer_index_map_t timer_index;
+	LLSD timer_names = LLSD::emptyArray();
+	LLSD timer_parents = LLSD::emptyArray();
+	LLSD frames = LLSD::emptyArray();
+	for (U32 i = sRecorded - count; i != sRecorded; ++i)
+	{
+		const FrameRecord& record = sFrames[i % sFrames.size()];
+		LLSD frame;
+		frame["frame"] = (S32)record.mFrame;
+		frame["time"] = record.mTime;
+		frame["ms"] = record.mFrameMs;
+
+		// Flat [ index, microseconds, calls, ... ]
+		LLSD timers = LLSD::emptyArray();
+		for (std::vector<TimerSample>::const_iterator it = record.mTimers.begin(); it != record.mTimers.end(); ++it)
+		{
+			timer_index_map_t::iterator tit = timer_index.find(it->mTimer);
+			if (tit == timer_index.end())
+			{
+				tit = timer_index.insert(std::make_pair(it->mTimer, (S32)timer_names.size())).first;
+				timer_names.append(it->mTimer->getName());
+				timer_parents.append(it->mTimer->getParent() ? it->mTimer->getParent()->getName() : std::string());
+			}
+			timers.append(tit->second);
+			timers.append((S32)((F64)it->mCount * ms_per_count * 1000.0));
+			timers.append((S32)it->mCalls);
+		}
+		frame["timers"] = timers;
+
+		LLSD stats = LLSD::emptyArray();
+		for (S32 s = 0; s < NUM_STATS; ++s)
+		{
+			stats.append(record.mStats[s]);
+		}
+		frame["stats"] = stats;
+
+		LLSD queues = LLSD::emptyArray();
+		for (S32 q = 0; q < NUM_QUEUES; ++q)
+		{
+			queues.append(record.mQueues[q]);
+		}
+		frame["queues"] = queues;
+
+		LLSD messages = LLSD::emptyArray();
+		for (S32 m = 0; m < NUM_MESSAGES; ++m)
+		{
+			messages.append((S32)llmin(record.mMessages[m], (U64)S32_MAX));
+		}
+		frame["messages"] = messages;
+
+		frames.append(frame);
+	}
+
+	history = LLSD::emptyMap();
+	history["version"] = 1;
+	history["viewer"] = LLVersionInfo::getChannelAndVersion();
+	history["threshold_ms"] = sThreshold;
+	history["timer_names"] = timer_names;
+	history["timer_parents"] = timer_parents;
+	history["stat_names"] = make_names(STAT_NAMES, NUM_STATS);
+	history["queue_names"] = make_names(QUEUE_NAMES, NUM_QUEUES);
+	history["message_names"] = make_names(MESSAGE_NAMES, NUM_MESSAGES);
+	history["frames"] = frames;
+}
+
+//static
+void LLHitchRecorder::dump(F32 frame_ms)
+{
+	++sDumpCount;
+
+	char stamp[32];
+	const time_t now = time(NULL);
+	strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", localtime(&now));
+	const std::string filename = gDirUtilp->getExpandedFilename(LL_PATH_LOGS, std::string("hitch_") + stamp + ".llsd");
+	LL_INFOS() << "Frame took " << frame_ms << " ms, writing hitch report " << filename << LL_ENDL;
+
+	LLSD history;
+	getHistory(history);
+	LLSDAsyncSerializer::format(history, LLSDSerialize::LLSD_BINARY,
+								boost::bind(&write_dump, filename, _1, _2));
+}
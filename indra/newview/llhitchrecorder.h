@@ -0,0 +1,72 @@
+/**
+ * @file llhitchrecorder.h
+ * @brief Keeps the last frames' timings and stats, dumped on a hitch.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLHITCHRECORDER_H
+#define LL_LLHITCHRECORDER_H
+
+#include <string>
+
+class LLSD;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLHitchRecorder
+//
+//   Once logged in, nextFrame() stores a record of the frame that just ended
+//   in a ring of the last HitchCaptureFrames frames: the fast timers that
+//   took measurable time, a few LLViewerStats values, the queue depths of
+//   the texture fetch, image decode and mesh threads and the packets and
+//   bytes the message system moved.
+//
+//   When a frame takes longer than HitchCaptureThresholdMs, the ring is
+//   dumped as a binary LLSD "hitch_<date>.llsd" in the logs directory. Timer
+//   and stat names are stored once, the frames only refer to them by index.
+//   The formatting happens on an LLSDAsyncSerializer worker.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLHitchRecorder
+{
+public:
+	static void initClass(U32 frames, F32 threshold_ms);
+	static void cleanupClass();
+
+	static void setHistorySize(U32 frames);
+	// 0 turns the capture off.
+	static void setThreshold(F32 ms);
+
+	// Main thread, right after LLFastTimer::nextFrame().
+	static void nextFrame();
+
+	// The history as written to the hitch files.
+	static void getHistory(LLSD& history);
+
+	static U32 getDumpCount()	{ return sDumpCount; }
+
+private:
+	static void dump(F32 frame_ms);
+
+	static U32 sDumpCount;
+};
+
+#endif // LL_LLHITCHRECORDER_H
@@ -45,8 +45,8 @@
 #include "llfloateravatarpicker.h"
 #include "llfloaterchat.h"
 #include "llfloaterinventory.h"
+#include "llfloaterloghistory.h"
 #include "llfloaterreporter.h"
-#include "llfloaterwebcontent.h" // For web browser display of logs
 #include "llgroupactions.h"
 #include "llhttpclient.h"
 #include "llimview.h"
@@ -1332,12 +1332,8 @@ void show_log_browser(const std::string& name, const LLUUID& id)
 		if (!LLWindow::ShellEx(file)) // 0 = success, otherwise fallback on internal browser.
 			return;
 	}
-	LLFloaterWebContent::Params p;
-	p.url("file:///" + file);
-	p.id(id.asString());
-	p.show_chrome(false);
-	p.trusted_content(true);
-	LLFloaterWebContent::showInstance("log", p); // If we passed id instead of "log", there would be no control over how many log browsers opened at once.
+	// Paged through the log's index, rather than loading all of it in a browser.
+	LLFloaterLogHistory::show(name, id);
 }
 
 void LLFloaterIMPanel::onClickHistory()
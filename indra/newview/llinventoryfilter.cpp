@@ -85,6 +85,11 @@ LLInventoryFilter::LLInventoryFilter(const Params& p)
 
 	mSubStringMatchOffset = std::string::npos;
 	mFilterCount = 0;
+	mFilterTimeLimit = 0.f;
+	mFilterCheckCount = 0;
+	mIndexRejectCount = 0;
+	mLastCheckIndexRejected = false;
+	mSearchIndexStamp = 0;
 	// Singu Note: Why aren't we calling fromParams here?
 
 	// copy mFilterOps into mDefaultFilterOps
@@ -98,6 +103,7 @@ bool LLInventoryFilter::check(LLFolderViewItem* item)
 	const LLUUID item_id = listener ? listener->getUUID() : LLUUID::null;
 	
 	const bool passed_clipboard = listener && item_id.notNull() ? checkAgainstClipboard(item_id) : true;
+	mLastCheckIndexRejected = false;
 
 	// If it's a folder and we're showing all folders, return automatically.
 	const BOOL is_folder = listener->getInventoryType() == LLInventoryType::IT_CATEGORY;
@@ -127,6 +133,17 @@ bool LLInventoryFilter::check(LLFolderViewItem* item)
 		
 	}
 
+	// The index only knows the inventory fields, not the label suffix the
+	// folder view appends ("(worn)", "(no copy)"...).
+	if (mSearchIndexStamp && item->getLabelSuffix().empty()
+		&& !gInventory.getSearchIndex().mayMatch(item_id, mSearchIndexStamp))
+	{
+		mSubStringMatchOffset = std::string::npos;
+		mLastCheckIndexRejected = true;
+		++mIndexRejectCount;
+		return false;
+	}
+
 	mSubStringMatchOffset = mFilterSubString.size() ? item->getSearchableLabel().find(mFilterSubString) : std::string::npos;
 	
 	const bool passed_filtertype = checkAgainstFilterType(item);
@@ -941,6 +958,7 @@ void LLInventoryFilter::resetDefault()
 void LLInventoryFilter::setModified(EFilterModified behavior)
 {
 	mFilterText.clear();
+	mSearchIndexStamp = 0;
 	mCurrentGeneration++;
 	
 	if (mFilterModified == FILTER_NONE)
@@ -1284,6 +1302,8 @@ U32 LLInventoryFilter::getSortOrder() const
 void LLInventoryFilter::setFilterCount(S32 count) 
 { 
 	mFilterCount = count; 
+	mFilterCheckCount = 0;
+	mIndexRejectCount = 0;
 }
 S32 LLInventoryFilter::getFilterCount() const
 {
@@ -1292,7 +1312,37 @@ S32 LLInventoryFilter::getFilterCount() const
 
 void LLInventoryFilter::decrementFilterCount() 
 { 
-	mFilterCount--; 
+	// Items the search index ruled out cost next to nothing, only the time
+	// limit applies to them.
+	if (!mLastCheckIndexRejected)
+	{
+		mFilterCount--; 
+	}
+	// Reading the clock for every item would cost more than some checks
+	if (mFilterTimeLimit > 0.f && !(++mFilterCheckCount & 15)
+		&& mFilterTimer.getElapsedTimeF32() > mFilterTimeLimit)
+	{
+		mFilterCount = -1;
+	}
+}
+
+void LLInventoryFilter::setFilterTimeLimit(F32 seconds)
+{
+	mFilterTimeLimit = seconds;
+	mFilterTimer.reset();
+}
+
+void LLInventoryFilter::updateSearchIndex(U32 search_type)
+{
+	// The link finder formula is not a substring
+	if (mFilterSubString.empty() || boost::algorithm::starts_with(mFilterSubString, "=FINDLINKS("))
+	{
+		mSearchIndexStamp = 0;
+	}
+	else
+	{
+		mSearchIndexStamp = gInventory.querySearchIndex(mFilterSubString, search_type);
+	}
 }
 
 S32 LLInventoryFilter::getCurrentGeneration() const 
@@ -29,6 +29,7 @@
 
 #include "llinventorytype.h"
 #include "llpermissionsflags.h"
+#include "lltimer.h"
 
 class LLFolderViewItem;
 class LLFolderViewFolder;
@@ -265,6 +266,17 @@ public:
 	void 				setFilterCount(S32 count);
 	S32 				getFilterCount() const;
 	void 				decrementFilterCount();
+	// Ends the frame's pass early (as if the count ran out) after seconds.
+	void				setFilterTimeLimit(F32 seconds);
+	// Items rejected by the search index since the last setFilterCount().
+	S32					getIndexRejectCount() const { return mIndexRejectCount; }
+
+	// +-------------------------------------------------------------------+
+	// + Search Index
+	// +-------------------------------------------------------------------+
+	// Runs the substring through the inventory search index; call before
+	// each filter pass. search_type is LLFolderView::getSearchType().
+	void				updateSearchIndex(U32 search_type);
 
 	// +-------------------------------------------------------------------+
 	// + Default
@@ -321,6 +333,12 @@ private:
 	S32						mFirstSuccessGeneration;
 
 	S32						mFilterCount;
+	LLTimer					mFilterTimer;
+	F32						mFilterTimeLimit;
+	S32						mFilterCheckCount;
+	S32						mIndexRejectCount;
+	bool					mLastCheckIndexRejected;
+	U32						mSearchIndexStamp;
 	EFilterModified 		mFilterModified;
 
 	std::string 			mFilterText;
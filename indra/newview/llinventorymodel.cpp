@@ -35,6 +35,7 @@
 #include "llagentwearables.h"
 #include "llappearancemgr.h"
 #include "llavatarnamecache.h"
+#include "llinventorycache.h"
 #include "llinventoryclipboard.h"
 #include "llinventorypanel.h"
 #include "llinventorybridge.h"
@@ -78,6 +79,7 @@ BOOL LLInventoryModel::sFirstTimeInViewer2 = TRUE;
 
 //BOOL decompress_file(const char* src_filename, const char* dst_filename);
 static const char CACHE_FORMAT_STRING[] = "%s.inv"; 
+static const char CACHE_BINARY_FORMAT_STRING[] = "%s.inv.bin";
 static const char * const LOG_INV("Inventory");
 
 struct InventoryIDPtrLess
@@ -1665,6 +1667,21 @@ void LLInventoryModel::notifyObservers()
 	}
 
 	mIsNotifyObservers = TRUE;
+	if (mSearchIndex.isBuilt())
+	{
+		for (changed_items_t::const_iterator it = mChangedItemIDs.begin(); it != mChangedItemIDs.end(); ++it)
+		{
+			if (LLViewerInventoryItem* item = getItem(*it))
+			{
+				mSearchIndex.addItem(item);
+			}
+			else
+			{
+				mSearchIndex.removeItem(*it);
+			}
+		}
+	}
+
 	for (observer_list_t::iterator iter = mObservers.begin();
 		 iter != mObservers.end(); )
 	{
@@ -1682,6 +1699,22 @@ void LLInventoryModel::notifyObservers()
 	mIsNotifyObservers = FALSE;
 }
 
+U32 LLInventoryModel::querySearchIndex(const std::string& substring, U32 search_type)
+{
+	if (!mSearchIndex.isBuilt())
+	{
+		LLTimer timer;
+		for (item_map_t::const_iterator it = mItemMap.begin(); it != mItemMap.end(); ++it)
+		{
+			mSearchIndex.addItem(it->second);
+		}
+		mSearchIndex.setBuilt();
+		LL_INFOS(LOG_INV) << "Built search index of " << mSearchIndex.getItemCount()
+						  << " items in " << timer.getElapsedTimeF32() << " seconds" << LL_ENDL;
+	}
+	return mSearchIndex.query(substring, search_type);
+}
+
 // store flag for change
 // and id of object change applies to
 void LLInventoryModel::addChangedMask(U32 mask, const LLUUID& referent) 
@@ -1780,9 +1813,19 @@ void LLInventoryModel::cache(
 	agent_id.toString(agent_id_str);
 	std::string path(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, agent_id_str));
 	inventory_filename = llformat(CACHE_FORMAT_STRING, path.c_str());
-	saveToFile(inventory_filename, categories, items);
 	std::string gzip_filename(inventory_filename);
 	gzip_filename.append(".gz");
+	if (saveToBinaryFile(llformat(CACHE_BINARY_FORMAT_STRING, path.c_str()), categories, items))
+	{
+		// The text cache is only read to migrate older installs; don't let
+		// a stale one linger next to the binary cache.
+		if (LLFile::isfile(gzip_filename))
+		{
+			LLFile::remove(gzip_filename);
+		}
+		return;
+	}
+	saveToFile(inventory_filename, categories, items);
 	if(gzip_file(inventory_filename, gzip_filename))
 	{
 		LL_DEBUGS(LOG_INV) << "Successfully compressed " << inventory_filename << LL_ENDL;
@@ -1920,6 +1963,7 @@ void LLInventoryModel::empty()
 	mBacklinkMMap.clear(); // forget all backlink information.
 	mCategoryMap.clear(); // remove all references (should delete entries)
 	mItemMap.clear(); // remove all references (should delete entries)
+	mSearchIndex.clear();
 	mLastItem = NULL;
 	//mInventory.clear();
 }
@@ -2097,30 +2141,47 @@ bool LLInventoryModel::loadSkeleton(
 		std::string path(gDirUtilp->getExpandedFilename(LL_PATH_CACHE, owner_id_str));
 		std::string inventory_filename;
 		inventory_filename = llformat(CACHE_FORMAT_STRING, path.c_str());
+		std::string binary_filename = llformat(CACHE_BINARY_FORMAT_STRING, path.c_str());
 		const S32 NO_VERSION = LLViewerInventoryCategory::VERSION_UNKNOWN;
 		std::string gzip_filename(inventory_filename);
 		gzip_filename.append(".gz");
-		LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
 		bool remove_inventory_file = false;
-		if(fp)
+		bool is_cache_obsolete = false;
+		LLTimer load_timer;
+		bool loaded = loadFromBinaryFile(binary_filename, categories, items, categories_to_update, is_cache_obsolete);
+		if (!loaded)
 		{
-			fclose(fp);
-			fp = nullptr;
-			if(gunzip_file(gzip_filename, inventory_filename))
+			if (is_cache_obsolete)
 			{
-				// we only want to remove the inventory file if it was
-				// gzipped before we loaded, and we successfully
-				// gunziped it.
-				remove_inventory_file = true;
+				LL_WARNS(LOG_INV) << "Binary inv cache out of date, removing" << LL_ENDL;
+				LLFile::remove(binary_filename);
+				is_cache_obsolete = false;
 			}
-			else
+
+			// Fall back on the gzipped text cache written by older viewers.
+			LLFILE* fp = LLFile::fopen(gzip_filename, "rb");
+			if(fp)
 			{
-				LL_INFOS(LOG_INV) << "Unable to gunzip " << gzip_filename << LL_ENDL;
+				fclose(fp);
+				fp = nullptr;
+				if(gunzip_file(gzip_filename, inventory_filename))
+				{
+					// we only want to remove the inventory file if it was
+					// gzipped before we loaded, and we successfully
+					// gunziped it.
+					remove_inventory_file = true;
+				}
+				else
+				{
+					LL_INFOS(LOG_INV) << "Unable to gunzip " << gzip_filename << LL_ENDL;
+				}
 			}
+			loaded = loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete);
 		}
-		bool is_cache_obsolete = false;
-		if (loadFromFile(inventory_filename, categories, items, categories_to_update, is_cache_obsolete))
+		if (loaded)
 		{
+			LL_INFOS(LOG_INV) << "Read " << categories.size() << " categories and " << items.size()
+							  << " items from cache in " << load_timer.getElapsedTimeF32() << " seconds" << LL_ENDL;
 			// We were able to find a cache of files. So, use what we
 			// found to generate a set of categories we should add. We
 			// will go through each category loaded and if the version
@@ -2726,6 +2787,76 @@ bool LLInventoryModel::loadFromFile(const std::string& filename,
 	return true;
 }
 
+// static
+bool LLInventoryModel::loadFromBinaryFile(const std::string& filename,
+										  LLInventoryModel::cat_array_t& categories,
+										  LLInventoryModel::item_array_t& items,
+										  LLInventoryModel::changed_items_t& cats_to_update,
+										  bool& is_cache_obsolete)
+{
+	LLInventoryCache::Reader reader;
+	if (!reader.open(filename, sCurrentInvCacheVersion, is_cache_obsolete))
+	{
+		return false;
+	}
+	LL_INFOS(LOG_INV) << "LLInventoryModel::loadFromBinaryFile(" << filename << ")" << LL_ENDL;
+
+	U32 count = reader.getCategoryCount();
+	categories.reserve(categories.size() + count);
+	for (U32 i = 0; i < count; ++i)
+	{
+		LLPointer<LLViewerInventoryCategory> inv_cat = new LLViewerInventoryCategory(LLUUID::null);
+		S32 version;
+		reader.getCategory(i, inv_cat, inv_cat->mOwnerID, version);
+		inv_cat->setVersion(version);
+		categories.push_back(inv_cat);
+	}
+
+	count = reader.getItemCount();
+	items.reserve(items.size() + count);
+	for (U32 i = 0; i < count; ++i)
+	{
+		LLPointer<LLViewerInventoryItem> inv_item = new LLViewerInventoryItem;
+		reader.getItem(i, inv_item);
+		if (inv_item->getUUID().isNull())
+		{
+			LL_WARNS(LOG_INV) << "Ignoring inventory with null item id: "
+							  << inv_item->getName() << LL_ENDL;
+		}
+		else if (inv_item->getType() == LLAssetType::AT_UNKNOWN)
+		{
+			cats_to_update.insert(inv_item->getParentUUID());
+		}
+		else
+		{
+			items.push_back(inv_item);
+		}
+	}
+	return true;
+}
+
+// static
+bool LLInventoryModel::saveToBinaryFile(const std::string& filename,
+										const cat_array_t& categories,
+										const item_array_t& items)
+{
+	LL_INFOS(LOG_INV) << "LLInventoryModel::saveToBinaryFile(" << filename << ")" << LL_ENDL;
+	LLInventoryCache::Writer writer(sCurrentInvCacheVersion);
+	for (cat_array_t::const_iterator it = categories.begin(); it != categories.end(); ++it)
+	{
+		const LLViewerInventoryCategory* cat = *it;
+		if (cat->getVersion() != LLViewerInventoryCategory::VERSION_UNKNOWN)
+		{
+			writer.addCategory(cat, cat->getOwnerID(), cat->getVersion());
+		}
+	}
+	for (item_array_t::const_iterator it = items.begin(); it != items.end(); ++it)
+	{
+		writer.addItem(*it);
+	}
+	return writer.write(filename);
+}
+
 // static
 bool LLInventoryModel::saveToFile(const std::string& filename,
 								  const cat_array_t& categories,
@@ -36,6 +36,7 @@
 #include "llfoldertype.h"
 #include "llframetimer.h"
 #include "llhttpclient.h"
+#include "llinventorysearchindex.h"
 #include "lluuid.h"
 #include "llpermissionsflags.h"
 #include "llviewerinventory.h"
@@ -531,6 +532,18 @@ public:
 private:
 	typedef std::set<LLInventoryObserver*> observer_list_t;
 	observer_list_t mObservers;
+
+	//--------------------------------------------------------------------
+	// Search Index
+	//--------------------------------------------------------------------
+public:
+	// Runs a filter substring through the item search index, building it on
+	// first use. See LLInventorySearchIndex::query().
+	U32 querySearchIndex(const std::string& substring, U32 search_type);
+	const LLInventorySearchIndex& getSearchIndex() const { return mSearchIndex; }
+private:
+	// Brought up to date from mChangedItemIDs on every notifyObservers().
+	LLInventorySearchIndex mSearchIndex;
 	
 /**                    Notifications
  **                                                                            **
@@ -563,6 +576,16 @@ protected:
 	static bool saveToFile(const std::string& filename,
 						   const cat_array_t& categories,
 						   const item_array_t& items); 
+	// Packed binary cache, see LLInventoryCache. The text format above is
+	// kept to migrate caches written by older viewers.
+	static bool loadFromBinaryFile(const std::string& filename,
+								   cat_array_t& categories,
+								   item_array_t& items,
+								   changed_items_t& cats_to_update,
+								   bool& is_cache_obsolete);
+	static bool saveToBinaryFile(const std::string& filename,
+								 const cat_array_t& categories,
+								 const item_array_t& items);
 
 	//--------------------------------------------------------------------
 	// Message handling functionality
@@ -119,6 +119,8 @@ public:
 	/*virtual*/ AICapabilityType capability_type(void) const { return cap_inventory; }
 	/*virtual*/ AIHTTPTimeoutPolicy const& getHTTPTimeoutPolicy(void) const { return BGFolderHttpHandler_timeout; }
 	/*virtual*/ char const* getName(void) const { return "BGFolderHttpHandler"; }
+	// Descendents of big folders run to megabytes of XML.
+	/*virtual*/ bool parseBodyAsync(void) const { return true; }
 
 protected:
 	BGFolderHttpHandler(const BGFolderHttpHandler &);			// Not defined
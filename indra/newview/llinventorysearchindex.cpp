@@ -0,0 +1,319 @@
+/**
+ * @file llinventorysearchindex.cpp
+ * @brief Inverted index over inventory item names, descriptions and creators.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "llinventorysearchindex.h"
+
+#include "llcachename.h"
+#include "llviewerinventory.h"
+
+// Don't bother compacting small indices.
+static const U32 MIN_STALE_POSTINGS_TO_REBUILD = 4096;
+
+static inline U32 make_trigram(const char* str)
+{
+	return ((U32)(U8)str[0] << 16) | ((U32)(U8)str[1] << 8) | (U32)(U8)str[2];
+}
+
+LLInventorySearchIndex::LLInventorySearchIndex()
+:	mBuilt(false),
+	mPostingCount(0),
+	mStalePostingCount(0),
+	mLastSearchType(0),
+	mStamp(0),
+	mLastValid(false),
+	mQueryCount(0),
+	mRefinedQueryCount(0)
+{
+}
+
+void LLInventorySearchIndex::clear()
+{
+	mBuilt = false;
+	mEntries.clear();
+	mFreeSlots.clear();
+	mSlots.clear();
+	mPostings.clear();
+	mPostingCount = 0;
+	mStalePostingCount = 0;
+	mMatches.clear();
+	mMatchStamps.clear();
+	invalidate();
+}
+
+void LLInventorySearchIndex::invalidate()
+{
+	mLastValid = false;
+	mLastSubString.clear();
+	// Outstanding stamps go stale, so mayMatch() lets everything through
+	// until the filter queries again.
+	if (++mStamp == 0)
+	{
+		std::fill(mMatchStamps.begin(), mMatchStamps.end(), 0);
+		mStamp = 1;
+	}
+}
+
+void LLInventorySearchIndex::addItem(const LLViewerInventoryItem* item)
+{
+	if (!item) return;
+
+	const LLUUID& item_id = item->getUUID();
+	U32 slot;
+	boost::unordered_map<LLUUID, U32>::iterator it = mSlots.find(item_id);
+	if (it != mSlots.end())
+	{
+		slot = it->second;
+		mStalePostingCount += mEntries[slot].mPostingCount;
+	}
+	else if (!mFreeSlots.empty())
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+		mSlots[item_id] = slot;
+	}
+	else
+	{
+		slot = (U32)mEntries.size();
+		mEntries.push_back(Entry());
+		mMatchStamps.push_back(0);
+		mSlots[item_id] = slot;
+	}
+
+	Entry& entry = mEntries[slot];
+	entry.mID = item_id;
+	entry.mName = item->getName();
+	LLStringUtil::toUpper(entry.mName);
+	entry.mDescription = item->getDescription();
+	LLStringUtil::toUpper(entry.mDescription);
+	entry.mCreator.clear();
+	entry.mPostingCount = 0;
+	entry.mFlags = 0;
+	entry.mLive = true;
+	if (item->getIsLinkType())
+	{
+		entry.mFlags |= ENTRY_ALWAYS_MATCH;
+	}
+	const LLUUID& creator_id = item->getCreatorUUID();
+	if (creator_id.notNull())
+	{
+		if (gCacheName && gCacheName->getFullName(creator_id, entry.mCreator))
+		{
+			LLStringUtil::toUpper(entry.mCreator);
+		}
+		else
+		{
+			entry.mCreator.clear();
+			entry.mFlags |= ENTRY_CREATOR_PENDING;
+		}
+	}
+
+	addPostings(entry.mName, slot);
+	addPostings(entry.mDescription, slot);
+	addPostings(entry.mCreator, slot);
+
+	invalidate();
+}
+
+void LLInventorySearchIndex::removeItem(const LLUUID& item_id)
+{
+	boost::unordered_map<LLUUID, U32>::iterator it = mSlots.find(item_id);
+	if (it == mSlots.end()) return;
+
+	const U32 slot = it->second;
+	Entry& entry = mEntries[slot];
+	mStalePostingCount += entry.mPostingCount;
+	entry.mLive = false;
+	entry.mPostingCount = 0;
+	entry.mName.clear();
+	entry.mDescription.clear();
+	entry.mCreator.clear();
+	mFreeSlots.push_back(slot);
+	mSlots.erase(it);
+
+	invalidate();
+}
+
+void LLInventorySearchIndex::addPostings(const std::string& field, U32 slot)
+{
+	if (field.size() < 3) return;
+
+	Entry& entry = mEntries[slot];
+	const char* str = field.c_str();
+	for (size_t i = 0, count = field.size() - 2; i < count; ++i)
+	{
+		posting_t& posting = mPostings[make_trigram(str + i)];
+		// Repeated trigrams of the same item are adjacent, skip them.
+		if (posting.empty() || posting.back() != slot)
+		{
+			posting.push_back(slot);
+			++entry.mPostingCount;
+			++mPostingCount;
+		}
+	}
+}
+
+void LLInventorySearchIndex::rebuildPostings()
+{
+	mPostings.clear();
+	mPostingCount = 0;
+	mStalePostingCount = 0;
+	for (U32 slot = 0, count = (U32)mEntries.size(); slot < count; ++slot)
+	{
+		Entry& entry = mEntries[slot];
+		entry.mPostingCount = 0;
+		if (entry.mLive)
+		{
+			addPostings(entry.mName, slot);
+			addPostings(entry.mDescription, slot);
+			addPostings(entry.mCreator, slot);
+		}
+	}
+}
+
+bool LLInventorySearchIndex::matches(const Entry& entry, const std::string& substring, U32 search_type) const
+{
+	return ((search_type & SEARCH_NAME) && entry.mName.find(substring) != std::string::npos)
+		|| ((search_type & SEARCH_DESCRIPTION) && entry.mDescription.find(substring) != std::string::npos)
+		|| ((search_type & SEARCH_CREATOR) && entry.mCreator.find(substring) != std::string::npos);
+}
+
+U32 LLInventorySearchIndex::query(const std::string& substring, U32 search_type)
+{
+	if (!search_type)
+	{
+		search_type = SEARCH_NAME;
+	}
+
+	// The folder view joins the fields and the label suffix with spaces, a
+	// substring with a space may straddle two of them.
+	if (substring.empty() || substring.find(' ') != std::string::npos)
+	{
+		return 0;
+	}
+
+	if (mLastValid && search_type == mLastSearchType && substring == mLastSubString)
+	{
+		return mStamp;
+	}
+
+	++mQueryCount;
+
+	std::vector<U32> candidates;
+	if (mLastValid && search_type == mLastSearchType
+		&& substring.size() > mLastSubString.size()
+		&& !substring.compare(0, mLastSubString.size(), mLastSubString))
+	{
+		// Typing ahead: only the previous matches can still match.
+		candidates.swap(mMatches);
+		++mRefinedQueryCount;
+	}
+	else if (substring.size() >= 3)
+	{
+		if (mStalePostingCount > MIN_STALE_POSTINGS_TO_REBUILD
+			&& mStalePostingCount > mPostingCount / 2)
+		{
+			rebuildPostings();
+		}
+
+		// Every trigram of the substring occurs in a matching item, so the
+		// shortest posting is a complete candidate list.
+		const posting_t* shortest = NULL;
+		const char* str = substring.c_str();
+		for (size_t i = 0, count = substring.size() - 2; i < count; ++i)
+		{
+			posting_map_t::const_iterator it = mPostings.find(make_trigram(str + i));
+			if (it == mPostings.end())
+			{
+				shortest = NULL;
+				break;
+			}
+			if (!shortest || it->second.size() < shortest->size())
+			{
+				shortest = &it->second;
+			}
+		}
+		if (shortest)
+		{
+			candidates = *shortest;
+		}
+	}
+	else
+	{
+		candidates.reserve(mSlots.size());
+		for (U32 slot = 0, count = (U32)mEntries.size(); slot < count; ++slot)
+		{
+			candidates.push_back(slot);
+		}
+	}
+
+	if (++mStamp == 0)
+	{
+		std::fill(mMatchStamps.begin(), mMatchStamps.end(), 0);
+		mStamp = 1;
+	}
+
+	mMatches.clear();
+	for (std::vector<U32>::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+	{
+		const U32 slot = *it;
+		const Entry& entry = mEntries[slot];
+		if (entry.mLive && mMatchStamps[slot] != mStamp && matches(entry, substring, search_type))
+		{
+			mMatchStamps[slot] = mStamp;
+			mMatches.push_back(slot);
+		}
+	}
+
+	mLastSubString = substring;
+	mLastSearchType = search_type;
+	mLastValid = true;
+	return mStamp;
+}
+
+bool LLInventorySearchIndex::mayMatch(const LLUUID& item_id, U32 stamp) const
+{
+	if (!stamp || stamp != mStamp)
+	{
+		return true;
+	}
+
+	boost::unordered_map<LLUUID, U32>::const_iterator it = mSlots.find(item_id);
+	if (it == mSlots.end())
+	{
+		return true;
+	}
+
+	const U32 slot = it->second;
+	const Entry& entry = mEntries[slot];
+	if ((entry.mFlags & ENTRY_ALWAYS_MATCH)
+		|| ((entry.mFlags & ENTRY_CREATOR_PENDING) && (mLastSearchType & SEARCH_CREATOR)))
+	{
+		return true;
+	}
+	return mMatchStamps[slot] == mStamp;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file llinventorysearchindex.h
+ * @brief Inverted index over inventory item names, descriptions and creators.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLINVENTORYSEARCHINDEX_H
+#define LL_LLINVENTORYSEARCHINDEX_H
+
+#include <string>
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+#include "lluuid.h"
+
+class LLViewerInventoryItem;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLInventorySearchIndex
+//
+//   Trigram index over the upper cased name, description and creator name of
+//   every inventory item, owned and kept current by LLInventoryModel. The
+//   inventory filter runs its substring through query() once per frame and
+//   then asks mayMatch() per item instead of searching each label.
+//
+//   The index only ever rules items out: anything it does not know about
+//   (folders, links, items added since the last notify, creators whose name
+//   was not cached yet) is reported as a possible match.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLInventorySearchIndex
+{
+public:
+	// Same bits as LLFolderView::getSearchType().
+	enum ESearchField
+	{
+		SEARCH_NAME = 1,
+		SEARCH_DESCRIPTION = 2,
+		SEARCH_CREATOR = 4
+	};
+
+	LLInventorySearchIndex();
+
+	void clear();
+	bool isBuilt() const					{ return mBuilt; }
+	void setBuilt()							{ mBuilt = true; }
+
+	// Adds or re-indexes item.
+	void addItem(const LLViewerInventoryItem* item);
+	void removeItem(const LLUUID& item_id);
+
+	// Runs an upper cased substring against the fields in search_type. When
+	// the substring extends the previous query and nothing changed since,
+	// only the previous matches are re-checked. Returns a stamp to hand to
+	// mayMatch(), or 0 if the query can not be answered from the index.
+	U32 query(const std::string& substring, U32 search_type);
+
+	// False only if the item is indexed and definitely does not contain the
+	// substring of the query that returned stamp.
+	bool mayMatch(const LLUUID& item_id, U32 stamp) const;
+
+	S32 getItemCount() const				{ return (S32)mSlots.size(); }
+	U32 getQueryCount() const				{ return mQueryCount; }
+	U32 getRefinedQueryCount() const		{ return mRefinedQueryCount; }
+	U32 getLastMatchCount() const			{ return (U32)mMatches.size(); }
+
+private:
+	enum
+	{
+		ENTRY_ALWAYS_MATCH = 1 << 0,	// links: their label follows the target
+		ENTRY_CREATOR_PENDING = 1 << 1	// creator name was not cached yet
+	};
+
+	struct Entry
+	{
+		LLUUID		mID;
+		std::string	mName;
+		std::string	mDescription;
+		std::string	mCreator;
+		U32			mPostingCount;
+		U8			mFlags;
+		bool		mLive;
+	};
+
+	typedef std::vector<U32> posting_t;
+	typedef boost::unordered_map<U32, posting_t> posting_map_t;
+
+	void addPostings(const std::string& field, U32 slot);
+	void rebuildPostings();
+	bool matches(const Entry& entry, const std::string& substring, U32 search_type) const;
+	void invalidate();
+
+	bool						mBuilt;
+	std::vector<Entry>			mEntries;
+	std::vector<U32>			mFreeSlots;
+	boost::unordered_map<LLUUID, U32> mSlots;
+
+	// Slots are appended when indexed and never removed from a posting, so
+	// a posting can hold dead or re-used slots; query() verifies every
+	// candidate and rebuilds the postings once they are mostly stale.
+	posting_map_t				mPostings;
+	U32							mPostingCount;
+	U32							mStalePostingCount;
+
+	// Result of the last query
+	std::string					mLastSubString;
+	U32							mLastSearchType;
+	U32							mStamp;
+	bool						mLastValid;
+	std::vector<U32>			mMatches;
+	std::vector<U32>			mMatchStamps;
+
+	U32							mQueryCount;
+	U32							mRefinedQueryCount;
+};
+
+#endif // LL_LLINVENTORYSEARCHINDEX_H
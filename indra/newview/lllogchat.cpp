@@ -35,7 +35,10 @@
 #include <ctime>
 #include "boost/filesystem.hpp"
 #include "lllogchat.h"
+#include "lllogchatindex.h"
+#include "lllogchatwriter.h"
 #include "llappviewer.h"
+#include "llcallbacklist.h"
 #include "llfloaterchat.h"
 #include "llsdserialize.h"
 #include "llsqlmgr.h"
@@ -217,6 +220,109 @@ std::string LLLogChat::timestamp(bool withdate)
 }
 
 
+static LLLogChatWriter* sWriter = NULL;
+// Last line time of each log written this session, so that the history
+// timestamps still queued in the writer are not read back from the DB.
+static std::map<std::string, U32> sLastLineTimestamps;
+
+namespace
+{
+	struct SearchJob
+	{
+		std::unique_ptr<LLLogChatIndex::Search>	mSearch;
+		LLLogChatWriter::string_vec_t		mPending;	// lines after the searched ones
+		std::string							mUpperText;
+		U32									mMaxResults;
+		LLLogChat::search_callback_t		mCallback;
+	};
+	typedef std::map<U32, SearchJob> search_map_t;
+	search_map_t sSearches;
+	U32 sLastSearchID = 0;
+
+	// Enough to keep a search of a long log short without a hitch.
+	const size_t SEARCH_BYTES_PER_FRAME = 1024 * 1024;
+
+	void finish_search(SearchJob& job)
+	{
+		LLLogChat::search_result_vec_t results(job.mSearch->getMatches().begin(), job.mSearch->getMatches().end());
+		std::string upper_line;
+		for (U32 i = 0; i < job.mPending.size(); ++i)
+		{
+			upper_line = job.mPending[i];
+			LLStringUtil::toUpper(upper_line);
+			if (upper_line.find(job.mUpperText) != std::string::npos)
+			{
+				results.push_back(std::make_pair(job.mSearch->getLineCount() + i, job.mPending[i]));
+			}
+		}
+		if (results.size() > job.mMaxResults)
+		{
+			results.erase(results.begin(), results.end() - job.mMaxResults);
+		}
+		job.mCallback(results);
+	}
+}
+
+static F32 get_flush_interval()
+{
+	static const LLCachedControl<F32> flush_interval("LogChatFlushInterval", 2.f);
+	return llmax((F32)flush_interval, 0.f);
+}
+
+//static
+void LLLogChat::initClass()
+{
+	if (sWriter) return;
+	sWriter = new LLLogChatWriter(get_flush_interval());
+	sWriter->start();
+	gIdleCallbacks.addFunction(&LLLogChat::idle);
+}
+
+//static
+void LLLogChat::cleanupClass()
+{
+	sSearches.clear();
+	if (!sWriter) return;
+	gIdleCallbacks.deleteFunction(&LLLogChat::idle);
+	// Lines logged from now on are written directly.
+	LLLogChatWriter* writer = sWriter;
+	sWriter = NULL;
+	writer->shutdown();
+	writer->commitTimestamps();
+	delete writer;
+}
+
+//static
+void LLLogChat::flushOnCrash()
+{
+	if (sWriter)
+	{
+		sWriter->flushOnCrash();
+	}
+}
+
+// Calls read() with the lines the writer holds for filename, which follow
+// the ones in the file. Read again when the writer flushed meanwhile, so
+// that no line is missed or seen twice; read() must start over each time.
+static void read_log(const std::string& filename, const std::function<void (const LLLogChatWriter::string_vec_t&)>& read)
+{
+	LLLogChatWriter::string_vec_t pending;
+	if (!sWriter)
+	{
+		read(pending);
+		return;
+	}
+	// A flush takes milliseconds; past that, settle for what was read.
+	static const S32 MAX_TRIES = 10;
+	for (S32 tries = 1; ; ++tries)
+	{
+		const U32 seq = sWriter->getPendingLines(filename, pending);
+		read(pending);
+		if (sWriter->isFlushSeq(seq) || tries == MAX_TRIES) return;
+		ms_sleep(1);
+	}
+}
+
 //static
 void LLLogChat::saveHistory(const std::string& name, const LLUUID& id, const std::string& line, const U32 timestamp)
 {
@@ -226,22 +332,28 @@ void LLLogChat::saveHistory(const std::string& name, const LLUUID& id, const std
 		return;
 	}
 
-	LLFILE* fp = LLFile::fopen(LLLogChat::makeLogFileName(name, id), "a"); 		/*Flawfinder: ignore*/
-	if (!fp)
+	const std::string filename = LLLogChat::makeLogFileName(name, id);
+	if (sWriter)
 	{
-		LL_INFOS() << "Couldn't open chat history log!" << LL_ENDL;
+		sWriter->setFlushInterval(get_flush_interval());
+		sWriter->append(filename, line);
 	}
-	else
+	else if (!LLLogChatWriter::writeLine(filename, line))
 	{
-		fprintf(fp, "%s\n", line.c_str());
-		
-		fclose (fp);
-		updateTimestampForLastHistoryLine(name, timestamp>0?timestamp:LLTimer::getTotalSeconds());
+		LL_INFOS() << "Couldn't open chat history log!" << LL_ENDL;
+		return;
 	}
+	updateTimestampForLastHistoryLine(name, timestamp>0?timestamp:LLTimer::getTotalSeconds());
 }
 
 static long const LOG_RECALL_BUFSIZ = 2048;
 U32 LLLogChat::getTimestampForLastHistoryLine(const std::string mLogLabel, const LLUUID& id) {
+	std::map<std::string, U32>::const_iterator it = sLastLineTimestamps.find(mLogLabel);
+	if (it != sLastLineTimestamps.end())
+	{
+		return it->second;
+	}
+
 	U32 timestamp = 0;
 	sqlite3 * db= LLSqlMgr::instance().getDB();
 	char* sql = "SELECT TIMESTAMP FROM LOG_HISTORY_TIMESTAMP WHERE ID = ?";
@@ -268,84 +380,256 @@ U32 LLLogChat::getTimestampForLastHistoryLine(const std::string mLogLabel, const
 }
 
 void LLLogChat::updateTimestampForLastHistoryLine(std::string mLogLabel, U32 timestamp) {
-	sqlite3 * db= LLSqlMgr::instance().getDB();
-	char* sql = "INSERT INTO LOG_HISTORY_TIMESTAMP (ID,TIMESTAMP) VALUES (?,?)  ON CONFLICT(ID) DO UPDATE SET TIMESTAMP = excluded.TIMESTAMP";
-	sqlite3_stmt *stmt;
-	sqlite3_prepare_v2(db, sql, -1, &stmt, NULL);
-	sqlite3_bind_text(stmt, 1,  mLogLabel.c_str(), strlen(mLogLabel.c_str()), 0);
-	sqlite3_bind_int(stmt, 2, timestamp);
-	sqlite3_step(stmt);
-   	sqlite3_finalize(stmt);
+	sLastLineTimestamps[mLogLabel] = timestamp;
+	if (sWriter)
+	{
+		// Batched with the other conversations' in one transaction.
+		sWriter->setTimestamp(mLogLabel, timestamp);
+	}
+	else
+	{
+		LLLogChatWriter::writeTimestamp(mLogLabel, timestamp);
+	}
 }
 
-void LLLogChat::loadHistory(const std::string& name, const LLUUID& id, std::function<void (ELogLineType, const std::string&)> callback)
+// Number of complete lines in the log file according to its index, or -1
+// when the index is missing or behind. The writer thread is then asked to
+// bring it up to date: reading a whole log here would stall the viewer.
+static S32 get_indexed_line_count(const std::string& filename)
 {
-	if (name.empty() && id.isNull())
+	const S32 count = LLLogChatIndex::getLineCount(filename);
+	if (count >= 0)
 	{
-		LL_WARNS() << "filename is empty!" << LL_ENDL;
+		return count;
 	}
-	else while(1)	// So we can use break.
+	if (!LLFile::isfile(filename))
+	{
+		return 0;
+	}
+	if (sWriter)
+	{
+		sWriter->updateIndex(filename);
+	}
+	return -1;
+}
+
+// Appends the last count lines of the log file to lines, oldest first.
+static void read_last_lines(const std::string& filename, U32 count, std::vector<std::string>& lines)
+{
+	const S32 total = get_indexed_line_count(filename);
+	if (total > 0)
 	{
-		// The number of lines to return.
-		static const LLCachedControl<U32> lines("LogShowHistoryLines", 32);
-		if (lines == 0) break;
+		// Straight to the last lines through the index.
+		const U32 first = (U32)total > count ? (U32)total - count : 0;
+		if (LLLogChatIndex::readLines(filename, first, count, [&lines](U32, const std::string& line) { lines.push_back(line); }))
+		{
+			return;
+		}
+	}
 
-		// Open the log file.
-		LLFILE* fptr = LLFile::fopen(makeLogFileName(name, id), "rb");
-		if (!fptr) break;
+	// The index is not there yet, or can not be made (read-only log
+	// directory): search backwards for the start of the lines to show.
+	LLFILE* fptr = LLFile::fopen(filename, "rb");
+	if (!fptr) return;
 
-		// Set pos to point to the last character of the file, if any.
-		if (fseek(fptr, 0, SEEK_END)) break;
-		long pos = ftell(fptr) - 1;
-		if (pos < 0) break;
+	// Set pos to point to the last character of the file, if any.
+	long pos = fseek(fptr, 0, SEEK_END) ? -1 : ftell(fptr) - 1;
+	if (pos < 0)
+	{
+		fclose(fptr);
+		return;
+	}
 
-		char buffer[LOG_RECALL_BUFSIZ];
-		bool error = false;
-		U32 nlines = 0;
-		while (pos > 0 && nlines < lines)
+	char buffer[LOG_RECALL_BUFSIZ];
+	U32 nlines = 0;
+	while (pos > 0 && nlines < count)
+	{
+		// Read the LOG_RECALL_BUFSIZ characters before pos.
+		size_t size = llmin(LOG_RECALL_BUFSIZ, pos);
+		pos -= size;
+		fseek(fptr, pos, SEEK_SET);
+		size_t len = fread(buffer, 1, size, fptr);
+		if (len != size)
 		{
-			// Read the LOG_RECALL_BUFSIZ characters before pos.
-			size_t size = llmin(LOG_RECALL_BUFSIZ, pos);
-			pos -= size;
-			fseek(fptr, pos, SEEK_SET);
-			size_t len = fread(buffer, 1, size, fptr);
-			error = len != size;
-			if (error) break;
-			// Count the number of newlines in it and set pos to the beginning of the first line to return when we found enough.
-			for (char const* p = buffer + size - 1; p >= buffer; --p)
+			fclose(fptr);
+			return;
+		}
+		// Count the number of newlines in it and set pos to the beginning of the first line to return when we found enough.
+		for (char const* p = buffer + size - 1; p >= buffer; --p)
+		{
+			if (*p == '\n')
 			{
-				if (*p == '\n')
+				if (++nlines == count)
 				{
-					if (++nlines == lines)
-					{
-						pos += p - buffer + 1;
-						break;
-					}
+					pos += p - buffer + 1;
+					break;
 				}
 			}
 		}
-		if (error)
+	}
+
+	// Set the file pointer at the first line to return.
+	fseek(fptr, pos, SEEK_SET);
+
+	// Read lines from the file one by one until we reach the end of the file.
+	while (fgets(buffer, LOG_RECALL_BUFSIZ, fptr))
+	{
+		// strip newline chars from the end of the string
+		for (S32 i = strlen(buffer) - 1; i >= 0 && (buffer[i] == '\r' || buffer[i] == '\n'); --i)
+			buffer[i] = '\0';
+		lines.push_back(buffer);
+	}
+
+	fclose(fptr);
+}
+
+void LLLogChat::loadHistory(const std::string& name, const LLUUID& id, std::function<void (ELogLineType, const std::string&)> callback)
+{
+	if (name.empty() && id.isNull())
+	{
+		LL_WARNS() << "filename is empty!" << LL_ENDL;
+		callback(LOG_EMPTY, LLStringUtil::null);
+		return;
+	}
+
+	// The number of lines to return.
+	static const LLCachedControl<U32> lines("LogShowHistoryLines", 32);
+	const U32 count = lines;
+	const std::string filename = makeLogFileName(name, id);
+	std::vector<std::string> history;
+	if (count)
+	{
+		read_log(filename, [&](const LLLogChatWriter::string_vec_t& pending)
 		{
-			fclose(fptr);
-			break;
-		}
+			history.clear();
+			// Lines still queued in the writer are the newest ones.
+			if (pending.size() < count)
+			{
+				read_last_lines(filename, count - (U32)pending.size(), history);
+			}
+			const size_t skip = pending.size() > count ? pending.size() - count : 0;
+			history.insert(history.end(), pending.begin() + skip, pending.end());
+		});
+	}
 
-		// Set the file pointer at the first line to return.
-		fseek(fptr, pos, SEEK_SET);
+	if (history.empty())
+	{
+		callback(LOG_EMPTY, LLStringUtil::null);
+		return;
+	}
+	for (std::vector<std::string>::const_iterator it = history.begin(); it != history.end(); ++it)
+	{
+		callback(LOG_LINE, *it);
+	}
+	callback(LOG_END, LLStringUtil::null);
+}
+
+//static
+S32 LLLogChat::getHistoryLineCount(const std::string& name, const LLUUID& id)
+{
+	if (name.empty() && id.isNull()) return 0;
+	const std::string filename = makeLogFileName(name, id);
+	S32 count = 0;
+	read_log(filename, [&](const LLLogChatWriter::string_vec_t& pending)
+	{
+		const S32 on_disk = get_indexed_line_count(filename);
+		count = on_disk < 0 ? -1 : on_disk + (S32)pending.size();
+	});
+	return count;
+}
 
-		// Read lines from the file one by one until we reach the end of the file.
-		while (fgets(buffer, LOG_RECALL_BUFSIZ, fptr))
+//static
+void LLLogChat::loadHistoryPage(const std::string& name, const LLUUID& id, U32 first_line, U32 count,
+								std::function<void (ELogLineType, const std::string&)> callback)
+{
+	if ((name.empty() && id.isNull()) || !count)
+	{
+		callback(LOG_EMPTY, LLStringUtil::null);
+		return;
+	}
+
+	const std::string filename = makeLogFileName(name, id);
+	std::vector<std::string> page;
+	read_log(filename, [&](const LLLogChatWriter::string_vec_t& pending)
+	{
+		page.clear();
+		const U32 on_disk = (U32)llmax(get_indexed_line_count(filename), 0);
+		if (first_line < on_disk)
 		{
-			// strip newline chars from the end of the string
-			for (S32 i = strlen(buffer) - 1; i >= 0 && (buffer[i] == '\r' || buffer[i] == '\n'); --i)
-				buffer[i] = '\0';
-			callback(LOG_LINE, buffer);
+			LLLogChatIndex::readLines(filename, first_line, llmin(count, on_disk - first_line),
+									  [&page](U32, const std::string& line) { page.push_back(line); });
 		}
+		// The rest of the page is still with the writer.
+		for (U32 line = llmax(first_line, on_disk); line < first_line + count && line - on_disk < pending.size(); ++line)
+		{
+			page.push_back(pending[line - on_disk]);
+		}
+	});
 
-		fclose(fptr);
-		callback(LOG_END, LLStringUtil::null);
-		
+	if (page.empty())
+	{
+		callback(LOG_EMPTY, LLStringUtil::null);
 		return;
 	}
-	callback(LOG_EMPTY, LLStringUtil::null);
+	for (std::vector<std::string>::const_iterator it = page.begin(); it != page.end(); ++it)
+	{
+		callback(LOG_LINE, *it);
+	}
+	callback(LOG_END, LLStringUtil::null);
+}
+
+//static
+U32 LLLogChat::searchHistory(const std::string& name, const LLUUID& id, const std::string& text, U32 max_results,
+							 search_callback_t callback)
+{
+	if ((name.empty() && id.isNull()) || text.empty() || !max_results) return 0;
+
+	const std::string filename = makeLogFileName(name, id);
+	SearchJob& job = sSearches[++sLastSearchID];
+	// The lines on disk now are searched in the background, the rest here
+	// once that is done.
+	U64 log_size = 0;
+	read_log(filename, [&](const LLLogChatWriter::string_vec_t& pending)
+	{
+		job.mPending = pending;
+		llstat stat_data;
+		log_size = LLFile::stat(filename, &stat_data) ? 0 : (U64)stat_data.st_size;
+	});
+	job.mSearch.reset(new LLLogChatIndex::Search(filename, text, max_results, log_size));
+	job.mUpperText = text;
+	LLStringUtil::toUpper(job.mUpperText);
+	job.mMaxResults = max_results;
+	job.mCallback = callback;
+	return sLastSearchID;
+}
+
+//static
+void LLLogChat::cancelSearch(U32 search_id)
+{
+	sSearches.erase(search_id);
+}
+
+//static
+void LLLogChat::idle(void*)
+{
+	if (sWriter)
+	{
+		sWriter->commitTimestamps();
+	}
+
+	if (sSearches.empty()) return;
+
+	const size_t slice = SEARCH_BYTES_PER_FRAME / sSearches.size() + 1;
+	for (search_map_t::iterator it = sSearches.begin(); it != sSearches.end(); ++it)
+	{
+		if (it->second.mSearch->step(slice))
+		{
+			// The callback may start or cancel searches; any other search
+			// that is done gets its turn next frame.
+			SearchJob job = std::move(it->second);
+			sSearches.erase(it);
+			finish_search(job);
+			return;
+		}
+	}
 }
@@ -34,7 +34,9 @@
 #ifndef LL_LLLOGCHAT_H
 #define LL_LLLOGCHAT_H
 
+#include <functional>
 #include <string>
+#include <vector>
 
 class LLLogChat
 {
@@ -45,6 +47,13 @@ public:
 		LOG_LINE,
 		LOG_END
 	};
+	static void initClass();
+	// Writes out everything queued and stops the log writer thread.
+	static void cleanupClass();
+	// Stores the timestamps of the lines the writer flushed and moves the
+	// searches along.
+	static void idle(void*);
+	static void flushOnCrash();
 	static void initializeIDMap();
 	static std::string timestamp(bool withdate = false);
 	static std::string timestamp(tm* timestamp, bool withdate);
@@ -52,6 +61,20 @@ public:
 	static void saveHistory(const std::string& name, const LLUUID& id, const std::string& line, const U32 timestamp=0);
 	static void loadHistory(const std::string& name, const LLUUID& id,
 		                    std::function<void (ELogLineType, const std::string&)> callback);
+	// Paged access to the whole history through the log's line index. The
+	// count is -1 while the index is being built.
+	static S32 getHistoryLineCount(const std::string& name, const LLUUID& id);
+	static void loadHistoryPage(const std::string& name, const LLUUID& id, U32 first_line, U32 count,
+								std::function<void (ELogLineType, const std::string&)> callback);
+	// Case insensitive. The log is searched a slice per frame, then the
+	// callback gets the line number and text of the newest max_results
+	// matching lines, oldest first. Returns the id to cancel the search
+	// with; the callback is never called for a cancelled search.
+	typedef std::vector<std::pair<U32, std::string> > search_result_vec_t;
+	typedef std::function<void (const search_result_vec_t&)> search_callback_t;
+	static U32 searchHistory(const std::string& name, const LLUUID& id, const std::string& text, U32 max_results,
+							 search_callback_t callback);
+	static void cancelSearch(U32 search_id);
 	static  U32 getTimestampForLastHistoryLine(const std::string mLogLabel, const LLUUID& id);	
 	static void LLLogChat::updateTimestampForLastHistoryLine(std::string mLogLabel, U32 timestamp);				
 private:
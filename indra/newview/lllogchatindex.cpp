@@ -0,0 +1,413 @@
+/**
+ * @file lllogchatindex.cpp
+ * @brief Line offset index kept next to each chat and IM log.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lllogchatindex.h"
+
+#include "hbxxh.h"
+#include "llthread.h"
+
+// 'LIDX', little endian
+static const U32 LOG_INDEX_MAGIC = 0x5844494c;
+
+// Enough of the start of a log to tell two logs apart.
+static const size_t HEAD_HASH_BYTES = 256;
+
+static const size_t SCAN_BUFFER_SIZE = 65536;
+
+// Readers accept a sidecar this far behind its log, if no line was
+// completed since.
+static const size_t MAX_UNINDEXED_TAIL = 4096;
+
+// Guards the sidecar files.
+static LLGlobalMutex sIndexMutex;
+// Serializes update().
+static LLGlobalMutex sUpdateMutex;
+
+namespace
+{
+	struct Header
+	{
+		U32 mMagic;
+		U32 mFormatVersion;
+		U64 mIndexedSize;		// bytes of the log covered by the offsets
+		U64 mHeadHash;			// of the first HEAD_HASH_BYTES covered
+	};
+
+	// Logs can outgrow the 2 GB that long offsets reach on Windows.
+	int seek64(LLFILE* fp, S64 offset, int origin)
+	{
+#if LL_WINDOWS
+		return _fseeki64(fp, offset, origin);
+#else
+		return fseeko(fp, (off_t)offset, origin);
+#endif
+	}
+
+	S64 file_size(LLFILE* fp)
+	{
+		if (seek64(fp, 0, SEEK_END)) return -1;
+#if LL_WINDOWS
+		return _ftelli64(fp);
+#else
+		return (S64)ftello(fp);
+#endif
+	}
+
+	U64 head_hash(LLFILE* log, U64 indexed_size)
+	{
+		char buffer[HEAD_HASH_BYTES];
+		const size_t size = (size_t)llmin((U64)HEAD_HASH_BYTES, indexed_size);
+		if (!size || seek64(log, 0, SEEK_SET) || fread(buffer, 1, size, log) != size)
+		{
+			return 0;
+		}
+		return HBXXH64::digest(buffer, size);
+	}
+
+	void strip_line(std::string& line)
+	{
+		while (!line.empty() && (line.back() == '\r' || line.back() == '\n'))
+		{
+			line.pop_back();
+		}
+	}
+
+	// Reads the header and line count of the sidecar of log, an open log of
+	// log_size bytes; sIndexMutex must be locked. Returns false when the
+	// sidecar is missing or does not belong to this log.
+	bool read_index_locked(const std::string& log_filename, LLFILE* log, S64 log_size,
+						   Header& header, U32& count)
+	{
+		LLFILE* idx = LLFile::fopen(LLLogChatIndex::getIndexFilename(log_filename), "rb");
+		if (!idx)
+		{
+			return false;
+		}
+		bool valid = false;
+		const S64 idx_size = file_size(idx);
+		if (idx_size >= (S64)sizeof(Header)
+			&& (idx_size - sizeof(Header)) % sizeof(U64) == 0
+			&& !seek64(idx, 0, SEEK_SET)
+			&& fread(&header, sizeof(Header), 1, idx) == 1
+			&& header.mMagic == LOG_INDEX_MAGIC
+			&& header.mFormatVersion == LLLogChatIndex::FORMAT_VERSION
+			&& header.mIndexedSize <= (U64)log_size)
+		{
+			count = (U32)((idx_size - sizeof(Header)) / sizeof(U64));
+			U64 last_end = 0;
+			bool read_ok = true;
+			if (count)
+			{
+				read_ok = !seek64(idx, -(S64)sizeof(U64), SEEK_END)
+					&& fread(&last_end, sizeof(U64), 1, idx) == 1;
+			}
+			// A truncated, replaced or half written log or sidecar fails
+			// one of these.
+			valid = read_ok && last_end == header.mIndexedSize
+				&& head_hash(log, header.mIndexedSize) == header.mHeadHash;
+		}
+		LLFile::close(idx);
+		return valid;
+	}
+
+	// Number of complete lines in the log according to its sidecar, or -1
+	// when the sidecar is not usable as is; sIndexMutex must be locked.
+	S32 indexed_line_count_locked(const std::string& log_filename)
+	{
+		LLFILE* log = LLFile::fopen(log_filename, "rb");
+		if (!log)
+		{
+			return -1;
+		}
+		const S64 log_size = file_size(log);
+		Header header;
+		U32 count = 0;
+		bool valid = log_size >= 0 && read_index_locked(log_filename, log, log_size, header, count);
+		const U64 tail = valid ? (U64)log_size - header.mIndexedSize : 0;
+		if (tail)
+		{
+			// Bytes past the last indexed line are fine as long as they do
+			// not complete a line.
+			char buffer[MAX_UNINDEXED_TAIL];
+			valid = tail <= MAX_UNINDEXED_TAIL
+				&& !seek64(log, (S64)header.mIndexedSize, SEEK_SET)
+				&& fread(buffer, 1, (size_t)tail, log) == (size_t)tail
+				&& !memchr(buffer, '\n', (size_t)tail);
+		}
+		LLFile::close(log);
+		return valid ? (S32)count : -1;
+	}
+}
+
+//static
+std::string LLLogChatIndex::getIndexFilename(const std::string& log_filename)
+{
+	return log_filename + ".idx";
+}
+
+//static
+bool LLLogChatIndex::update(const std::string& log_filename)
+{
+	// One update at a time; readers only wait while the sidecar is read or
+	// written, not while the log is scanned.
+	LLMutexLock update_lock(sUpdateMutex);
+
+	LLFILE* log = LLFile::fopen(log_filename, "rb");
+	if (!log)
+	{
+		return false;
+	}
+	const S64 log_size = file_size(log);
+	if (log_size < 0)
+	{
+		LLFile::close(log);
+		return false;
+	}
+
+	Header header;
+	U32 count = 0;
+	bool valid;
+	{
+		LLMutexLock lock(sIndexMutex);
+		valid = read_index_locked(log_filename, log, log_size, header, count);
+	}
+	if (!valid)
+	{
+		header.mMagic = LOG_INDEX_MAGIC;
+		header.mFormatVersion = FORMAT_VERSION;
+		header.mIndexedSize = 0;
+		header.mHeadHash = 0;
+		count = 0;
+	}
+
+	std::vector<U64> ends;
+	if ((U64)log_size > header.mIndexedSize)
+	{
+		std::vector<char> buffer(SCAN_BUFFER_SIZE);
+		U64 pos = header.mIndexedSize;
+		seek64(log, (S64)pos, SEEK_SET);
+		while (pos < (U64)log_size)
+		{
+			const size_t wanted = (size_t)llmin((U64)SCAN_BUFFER_SIZE, (U64)log_size - pos);
+			const size_t read = fread(&buffer[0], 1, wanted, log);
+			if (!read) break;
+			for (const char* p = (const char*)memchr(&buffer[0], '\n', read); p;
+				 p = (const char*)memchr(p + 1, '\n', read - (p + 1 - &buffer[0])))
+			{
+				ends.push_back(pos + (p - &buffer[0]) + 1);
+			}
+			pos += read;
+		}
+	}
+	const U64 hash = ends.empty() ? header.mHeadHash : head_hash(log, ends.back());
+	LLFile::close(log);
+	if (valid && ends.empty())
+	{
+		return true;
+	}
+
+	LLMutexLock lock(sIndexMutex);
+	LLFILE* idx = LLFile::fopen(getIndexFilename(log_filename), valid ? "r+b" : "w+b");
+	if (!idx)
+	{
+		return false;
+	}
+	bool success = true;
+	if (!ends.empty())
+	{
+		success = !seek64(idx, (S64)(sizeof(Header) + (U64)count * sizeof(U64)), SEEK_SET)
+			&& fwrite(&ends[0], sizeof(U64), ends.size(), idx) == ends.size();
+		header.mIndexedSize = ends.back();
+		header.mHeadHash = hash;
+	}
+	// Written last: a crash before this leaves a sidecar that fails
+	// validation and is rebuilt.
+	success = success && !seek64(idx, 0, SEEK_SET) && fwrite(&header, sizeof(Header), 1, idx) == 1;
+	success = (LLFile::close(idx) == 0) && success;
+	return success;
+}
+
+//static
+S32 LLLogChatIndex::getLineCount(const std::string& log_filename)
+{
+	LLMutexLock lock(sIndexMutex);
+	return indexed_line_count_locked(log_filename);
+}
+
+//static
+U32 LLLogChatIndex::readLines(const std::string& log_filename, U32 first, U32 count,
+							  const line_callback_t& callback)
+{
+	LLMutexLock lock(sIndexMutex);
+	const S32 total = indexed_line_count_locked(log_filename);
+	if (total <= 0 || first >= (U32)total || !count)
+	{
+		return 0;
+	}
+	count = llmin(count, (U32)total - first);
+
+	// The end offsets of the line before first and of the last line wanted
+	// bound the bytes to read.
+	LLFILE* idx = LLFile::fopen(getIndexFilename(log_filename), "rb");
+	if (!idx)
+	{
+		return 0;
+	}
+	U64 start = 0;
+	U64 end = 0;
+	bool success = true;
+	if (first)
+	{
+		success = !seek64(idx, (S64)(sizeof(Header) + (U64)(first - 1) * sizeof(U64)), SEEK_SET)
+			&& fread(&start, sizeof(U64), 1, idx) == 1;
+	}
+	success = success
+		&& !seek64(idx, (S64)(sizeof(Header) + (U64)(first + count - 1) * sizeof(U64)), SEEK_SET)
+		&& fread(&end, sizeof(U64), 1, idx) == 1;
+	LLFile::close(idx);
+	if (!success || end <= start)
+	{
+		return 0;
+	}
+
+	std::string text;
+	LLFILE* log = LLFile::fopen(log_filename, "rb");
+	if (log)
+	{
+		text.resize((size_t)(end - start));
+		success = !seek64(log, (S64)start, SEEK_SET)
+			&& fread(&text[0], 1, text.size(), log) == text.size();
+		LLFile::close(log);
+	}
+	if (!log || !success)
+	{
+		return 0;
+	}
+
+	U32 line = first;
+	std::string::size_type pos = 0;
+	while (pos < text.size() && line < first + count)
+	{
+		std::string::size_type eol = text.find('\n', pos);
+		if (eol == std::string::npos) eol = text.size();
+		std::string str(text, pos, eol - pos);
+		strip_line(str);
+		callback(line++, str);
+		pos = eol + 1;
+	}
+	return line - first;
+}
+
+//static
+U32 LLLogChatIndex::search(const std::string& log_filename, const std::string& text,
+						   U32 max_results, const line_callback_t& callback)
+{
+	Search search(log_filename, text, max_results);
+	while (!search.step(SCAN_BUFFER_SIZE))
+	{
+	}
+
+	const Search::match_deque_t& matches = search.getMatches();
+	for (Search::match_deque_t::const_iterator it = matches.begin(); it != matches.end(); ++it)
+	{
+		callback(it->first, it->second);
+	}
+	return (U32)matches.size();
+}
+
+LLLogChatIndex::Search::Search(const std::string& log_filename, const std::string& text,
+							   U32 max_results, U64 log_size)
+:	mFile(NULL),
+	mUpperText(text),
+	mMaxResults(max_results),
+	mBytesLeft(log_size),
+	mLine(0)
+{
+	if (!text.empty() && max_results && log_size)
+	{
+		mFile = LLFile::fopen(log_filename, "rb");
+	}
+	LLStringUtil::toUpper(mUpperText);
+}
+
+LLLogChatIndex::Search::~Search()
+{
+	if (mFile)
+	{
+		LLFile::close(mFile);
+	}
+}
+
+bool LLLogChatIndex::Search::step(size_t max_bytes)
+{
+	if (!mFile)
+	{
+		return true;
+	}
+
+	mBuffer.resize(llclamp(max_bytes, (size_t)1, SCAN_BUFFER_SIZE));
+	size_t scanned = 0;
+	size_t read = 0;
+	while (scanned < max_bytes && mBytesLeft
+		   && (read = fread(&mBuffer[0], 1, (size_t)llmin((U64)mBuffer.size(), mBytesLeft), mFile)) > 0)
+	{
+		scanned += read;
+		mBytesLeft -= read;
+		const char* begin = &mBuffer[0];
+		const char* end = begin + read;
+		for (const char* eol; (eol = (const char*)memchr(begin, '\n', end - begin)); begin = eol + 1)
+		{
+			mPartial.append(begin, eol - begin);
+			mUpperLine = mPartial;
+			LLStringUtil::toUpper(mUpperLine);
+			if (mUpperLine.find(mUpperText) != std::string::npos)
+			{
+				strip_line(mPartial);
+				mMatches.push_back(std::make_pair(mLine, mPartial));
+				if (mMatches.size() > mMaxResults)
+				{
+					mMatches.pop_front();
+				}
+			}
+			mPartial.clear();
+			++mLine;
+		}
+		// A line straddling two reads, or still being written
+		mPartial.append(begin, end - begin);
+	}
+
+	if (scanned < max_bytes || !mBytesLeft)
+	{
+		// End of the log, or of what there was of it when the search
+		// started.
+		LLFile::close(mFile);
+		mFile = NULL;
+		return true;
+	}
+	return false;
+}
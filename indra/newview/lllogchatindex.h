@@ -0,0 +1,116 @@
+/**
+ * @file lllogchatindex.h
+ * @brief Line offset index kept next to each chat and IM log.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLLOGCHATINDEX_H
+#define LL_LLLOGCHATINDEX_H
+
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <vector>
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLLogChatIndex
+//
+//   "name.txt" gets a "name.txt.idx" sidecar holding the end offset of every
+//   complete line of the log, so any page of history is one seek away no
+//   matter how large the log grew. The sidecar also records how much of the
+//   log it covers and a hash of the log's first bytes: update() only scans
+//   what was appended since, and rebuilds the sidecar when the log was
+//   truncated or replaced.
+//
+//   Only update() reads a log through, and only the log writer thread calls
+//   it: as it flushes, and when a reader found a log without a usable
+//   sidecar. Readers never scan: getLineCount() and readLines() only use a
+//   sidecar that covers every complete line of the log, and fail otherwise. The sidecar is
+//   only locked while it is read or written, not while update() scans.
+//   All methods are thread safe.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLLogChatIndex
+{
+public:
+	// Bump whenever the sidecar layout changes.
+	enum { FORMAT_VERSION = 1 };
+
+	typedef std::function<void(U32 line, const std::string& text)> line_callback_t;
+
+	static std::string getIndexFilename(const std::string& log_filename);
+
+	// Brings the sidecar up to date, scanning as much of the log as needed.
+	// Returns false when the log can not be read or the sidecar written.
+	static bool update(const std::string& log_filename);
+
+	// Number of complete lines in the log, or -1 when the sidecar is
+	// missing, invalid or behind the log and needs an update().
+	static S32 getLineCount(const std::string& log_filename);
+
+	// Calls back, oldest first, for the lines [first, first + count) that
+	// exist. Returns the number of lines read: none when getLineCount()
+	// would fail.
+	static U32 readLines(const std::string& log_filename, U32 first, U32 count,
+						 const line_callback_t& callback);
+
+	// Case insensitive search of the whole log. Calls back, oldest first,
+	// for the newest max_results matching lines and returns their number.
+	static U32 search(const std::string& log_filename, const std::string& text,
+					  U32 max_results, const line_callback_t& callback);
+
+	// The same search, done a slice at a time so that it can be spread over
+	// frames. It needs no sidecar. Only the first log_size bytes are looked
+	// at, which keeps lines appended after the search started out of it.
+	class Search
+	{
+	public:
+		typedef std::deque<std::pair<U32, std::string> > match_deque_t;
+
+		Search(const std::string& log_filename, const std::string& text,
+			   U32 max_results, U64 log_size = std::numeric_limits<U64>::max());
+		~Search();
+
+		// Scans up to about max_bytes more of the log. Returns true once
+		// the search is over.
+		bool step(size_t max_bytes);
+
+		// Line number and text of the newest matches so far, oldest first.
+		const match_deque_t& getMatches() const	{ return mMatches; }
+		// Complete lines looked at so far.
+		U32 getLineCount() const					{ return mLine; }
+
+	private:
+		LLFILE*				mFile;
+		std::string			mUpperText;
+		U32					mMaxResults;
+		U64					mBytesLeft;
+		U32					mLine;
+		std::string			mPartial;
+		std::string			mUpperLine;
+		std::vector<char>	mBuffer;
+		match_deque_t		mMatches;
+	};
+};
+
+#endif // LL_LLLOGCHATINDEX_H
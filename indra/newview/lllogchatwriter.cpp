@@ -0,0 +1,434 @@
+/**
+ * @file lllogchatwriter.cpp
+ * @brief Background writer for the chat and IM logs.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include "llviewerprecompiledheaders.h"
+
+#include "lllogchatwriter.h"
+
+#include "lllogchatindex.h"
+#include "llsqlmgr.h"
+#include "lltimer.h"
+
+// Conversations are often short lived: cap the handles kept open and close
+// the ones nothing was written to for a while.
+static const U32 MAX_OPEN_LOG_FILES = 32;
+static const F64 OPEN_LOG_FILE_IDLE_TIME = 300.0;
+
+// Sleep granularity of the writer thread while it has unflushed data.
+static const U32 WRITER_POLL_MS = 50;
+
+static const char* UPSERT_TIMESTAMP_SQL = "INSERT INTO LOG_HISTORY_TIMESTAMP (ID,TIMESTAMP) VALUES (?,?) ON CONFLICT(ID) DO UPDATE SET TIMESTAMP = excluded.TIMESTAMP";
+
+LLLogChatWriter::LLLogChatWriter(F32 flush_interval)
+:	LLThread("chat log writer"),
+	mFlushInterval(flush_interval),
+	mFlushSeq(0),
+	mAbandoned(false),
+	mDB(NULL),
+	mUpsert(NULL)
+{
+}
+
+LLLogChatWriter::~LLLogChatWriter()
+{
+	llassert(mFiles.empty());
+	if (mUpsert)
+	{
+		sqlite3_finalize(mUpsert);
+	}
+}
+
+void LLLogChatWriter::append(const std::string& filename, const std::string& line)
+{
+	Line entry;
+	entry.mFilename = filename;
+	entry.mText = line;
+	mCondition.lock();
+	mLines.push_back(entry);
+	mPendingLines[filename].push_back(line);
+	mCondition.signal();
+	mCondition.unlock();
+}
+
+void LLLogChatWriter::setTimestamp(const std::string& label, U32 timestamp)
+{
+	mCondition.lock();
+	mTimestamps[label] = timestamp;
+	mCondition.signal();
+	mCondition.unlock();
+}
+
+void LLLogChatWriter::setFlushInterval(F32 seconds)
+{
+	LLMutexLock lock(mCondition);
+	mFlushInterval = seconds;
+}
+
+void LLLogChatWriter::commitTimestamps()
+{
+	LLSqlMgr& sql_mgr = LLSqlMgr::instance();
+	if (!sql_mgr.isInit())
+	{
+		// Not logged in yet: keep them for later.
+		return;
+	}
+
+	timestamp_map_t timestamps;
+	{
+		LLMutexLock lock(mCondition);
+		if (mFlushedTimestamps.empty()) return;
+		timestamps.swap(mFlushedTimestamps);
+	}
+
+	sqlite3* db = sql_mgr.getDB();
+	if (mUpsert && db != mDB)
+	{
+		sqlite3_finalize(mUpsert);
+		mUpsert = NULL;
+	}
+	if (!mUpsert)
+	{
+		mDB = db;
+		if (sqlite3_prepare_v2(db, UPSERT_TIMESTAMP_SQL, -1, &mUpsert, NULL) != SQLITE_OK)
+		{
+			LL_WARNS() << "Can't prepare log history timestamp update: " << sqlite3_errmsg(db) << LL_ENDL;
+			mUpsert = NULL;
+			return;
+		}
+	}
+
+	sqlite3_exec(db, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+	for (timestamp_map_t::const_iterator it = timestamps.begin(); it != timestamps.end(); ++it)
+	{
+		sqlite3_bind_text(mUpsert, 1, it->first.c_str(), (int)it->first.size(), SQLITE_TRANSIENT);
+		sqlite3_bind_int(mUpsert, 2, it->second);
+		sqlite3_step(mUpsert);
+		sqlite3_reset(mUpsert);
+	}
+	sqlite3_exec(db, "COMMIT;", NULL, NULL, NULL);
+}
+
+void LLLogChatWriter::updateIndex(const std::string& filename)
+{
+	mCondition.lock();
+	mIndexRequests.insert(filename);
+	mCondition.signal();
+	mCondition.unlock();
+}
+
+U32 LLLogChatWriter::getPendingLines(const std::string& filename, string_vec_t& lines)
+{
+	LLMutexLock lock(mCondition);
+	pending_map_t::const_iterator it = mPendingLines.find(filename);
+	if (it != mPendingLines.end())
+	{
+		lines = it->second;
+	}
+	else
+	{
+		lines.clear();
+	}
+	return mFlushSeq;
+}
+
+bool LLLogChatWriter::isFlushSeq(U32 seq)
+{
+	LLMutexLock lock(mCondition);
+	return !(seq & 1) && seq == mFlushSeq;
+}
+
+void LLLogChatWriter::flushOnCrash()
+{
+	// The writer may be the crashing thread, or be stuck holding the lock:
+	// never wait for it.
+	if (!mCondition.try_lock()) return;
+
+	pending_map_t pending;
+	if (mFlushSeq & 1)
+	{
+		// The writer is appending its buffers right now; only the lines it
+		// did not take yet can be written without doubling any.
+		for (line_vec_t::const_iterator it = mLines.begin(); it != mLines.end(); ++it)
+		{
+			pending[it->mFilename].push_back(it->mText);
+		}
+	}
+	else
+	{
+		pending.swap(mPendingLines);
+	}
+	mLines.clear();
+	mAbandoned = true;
+	mCondition.unlock();
+
+	for (pending_map_t::const_iterator it = pending.begin(); it != pending.end(); ++it)
+	{
+		LLFILE* fp = LLFile::fopen(it->first, "a");		/*Flawfinder: ignore*/
+		if (!fp) continue;
+		for (string_vec_t::const_iterator line = it->second.begin(); line != it->second.end(); ++line)
+		{
+			fprintf(fp, "%s\n", line->c_str());
+		}
+		fclose(fp);
+	}
+}
+
+void LLLogChatWriter::shutdown()
+{
+	// run() drains the queue before returning.
+	setQuitting();
+	mCondition.lock();
+	mCondition.signal();
+	mCondition.unlock();
+	LLThread::shutdown();
+}
+
+void LLLogChatWriter::run()
+{
+	LLTimer flush_timer;
+	bool dirty = false;
+	while (true)
+	{
+		line_vec_t lines;
+		timestamp_map_t timestamps;
+		string_set_t index_requests;
+		mCondition.lock();
+		while (mLines.empty() && mTimestamps.empty() && mIndexRequests.empty() && !dirty && !isQuitting())
+		{
+			mCondition.wait();
+		}
+		lines.swap(mLines);
+		timestamps.swap(mTimestamps);
+		index_requests.swap(mIndexRequests);
+		const F32 flush_interval = mFlushInterval;
+		const bool quitting = isQuitting();
+		mCondition.unlock();
+
+		if (!lines.empty())
+		{
+			bufferLines(lines);
+			dirty = true;
+		}
+		if (!timestamps.empty())
+		{
+			for (timestamp_map_t::const_iterator it = timestamps.begin(); it != timestamps.end(); ++it)
+			{
+				mUnsavedTimestamps[it->first] = it->second;
+			}
+			dirty = true;
+		}
+
+		const F32 elapsed = flush_timer.getElapsedTimeF32();
+		if (dirty && (quitting || elapsed >= flush_interval))
+		{
+			flushFiles(!quitting);
+			dirty = false;
+			flush_timer.reset();
+		}
+		if (!quitting)
+		{
+			// Whole logs may have to be read: never while quitting.
+			for (string_set_t::const_iterator it = index_requests.begin(); it != index_requests.end(); ++it)
+			{
+				LLLogChatIndex::update(*it);
+			}
+		}
+
+		if (quitting)
+		{
+			LLMutexLock lock(mCondition);
+			if (mLines.empty() && mTimestamps.empty())
+			{
+				break;
+			}
+		}
+		else if (dirty)
+		{
+			ms_sleep(llclamp((U32)((flush_interval - elapsed) * 1000.f), (U32)1, WRITER_POLL_MS));
+		}
+	}
+
+	closeFiles();
+}
+
+void LLLogChatWriter::bufferLines(const line_vec_t& lines)
+{
+	for (line_vec_t::const_iterator it = lines.begin(); it != lines.end(); ++it)
+	{
+		Buffer& buffer = mBuffers[it->mFilename];
+		buffer.mText += it->mText;
+		buffer.mText += '\n';
+		++buffer.mLines;
+	}
+}
+
+LLFILE* LLLogChatWriter::getFile(const std::string& filename)
+{
+	const F64 now = LLTimer::getTotalSeconds();
+	file_map_t::iterator it = mFiles.find(filename);
+	if (it != mFiles.end())
+	{
+		it->second.mLastUsed = now;
+		return it->second.mFile;
+	}
+
+	if (mFiles.size() >= MAX_OPEN_LOG_FILES)
+	{
+		file_map_t::iterator oldest = mFiles.begin();
+		for (file_map_t::iterator fit = mFiles.begin(); fit != mFiles.end(); ++fit)
+		{
+			if (fit->second.mLastUsed < oldest->second.mLastUsed)
+			{
+				oldest = fit;
+			}
+		}
+		LLFile::close(oldest->second.mFile);
+		mFiles.erase(oldest);
+	}
+
+	LLFILE* fp = LLFile::fopen(filename, "a");		/*Flawfinder: ignore*/
+	if (fp)
+	{
+		OpenFile& file = mFiles[filename];
+		file.mFile = fp;
+		file.mLastUsed = now;
+	}
+	return fp;
+}
+
+void LLLogChatWriter::flushFiles(bool close_idle)
+{
+	{
+		LLMutexLock lock(mCondition);
+		if (mAbandoned)
+		{
+			mBuffers.clear();
+			return;
+		}
+		// Readers of the log files retry until this is even again.
+		++mFlushSeq;
+	}
+
+	for (buffer_map_t::const_iterator it = mBuffers.begin(); it != mBuffers.end(); ++it)
+	{
+		if (!it->second.mLines) continue;
+		LLFILE* fp = getFile(it->first);
+		if (!fp)
+		{
+			LL_INFOS() << "Couldn't open chat history log!" << LL_ENDL;
+			continue;
+		}
+		fwrite(it->second.mText.data(), 1, it->second.mText.size(), fp);
+	}
+
+	const F64 now = LLTimer::getTotalSeconds();
+	for (file_map_t::iterator it = mFiles.begin(); it != mFiles.end(); )
+	{
+		if (close_idle && now - it->second.mLastUsed > OPEN_LOG_FILE_IDLE_TIME)
+		{
+			LLFile::close(it->second.mFile);
+			it = mFiles.erase(it);
+		}
+		else
+		{
+			fflush(it->second.mFile);
+			++it;
+		}
+	}
+	for (buffer_map_t::const_iterator it = mBuffers.begin(); it != mBuffers.end(); ++it)
+	{
+		if (it->second.mLines)
+		{
+			LLLogChatIndex::update(it->first);
+		}
+	}
+
+	{
+		LLMutexLock lock(mCondition);
+		for (buffer_map_t::iterator it = mBuffers.begin(); it != mBuffers.end(); ++it)
+		{
+			pending_map_t::iterator pending = mPendingLines.find(it->first);
+			if (pending != mPendingLines.end())
+			{
+				string_vec_t& lines = pending->second;
+				lines.erase(lines.begin(), lines.begin() + llmin((size_t)it->second.mLines, lines.size()));
+				if (lines.empty())
+				{
+					mPendingLines.erase(pending);
+				}
+			}
+			it->second.mText.clear();
+			it->second.mLines = 0;
+		}
+		++mFlushSeq;
+
+		for (timestamp_map_t::const_iterator it = mUnsavedTimestamps.begin(); it != mUnsavedTimestamps.end(); ++it)
+		{
+			mFlushedTimestamps[it->first] = it->second;
+		}
+	}
+	mUnsavedTimestamps.clear();
+
+	// Keep the buffers of busy logs around rather than reallocating them.
+	if (mBuffers.size() > MAX_OPEN_LOG_FILES)
+	{
+		mBuffers.clear();
+	}
+}
+
+void LLLogChatWriter::closeFiles()
+{
+	for (file_map_t::iterator it = mFiles.begin(); it != mFiles.end(); ++it)
+	{
+		LLFile::close(it->second.mFile);
+	}
+	mFiles.clear();
+}
+
+//static
+bool LLLogChatWriter::writeLine(const std::string& filename, const std::string& line)
+{
+	LLFILE* fp = LLFile::fopen(filename, "a");		/*Flawfinder: ignore*/
+	if (!fp)
+	{
+		return false;
+	}
+	fprintf(fp, "%s\n", line.c_str());
+	fclose(fp);
+	return true;
+}
+
+//static
+void LLLogChatWriter::writeTimestamp(const std::string& label, U32 timestamp)
+{
+	sqlite3* db = LLSqlMgr::instance().getDB();
+	sqlite3_stmt* stmt;
+	sqlite3_prepare_v2(db, UPSERT_TIMESTAMP_SQL, -1, &stmt, NULL);
+	sqlite3_bind_text(stmt, 1, label.c_str(), (int)label.size(), SQLITE_TRANSIENT);
+	sqlite3_bind_int(stmt, 2, timestamp);
+	sqlite3_step(stmt);
+	sqlite3_finalize(stmt);
+}
@@ -0,0 +1,149 @@
+/**
+ * @file lllogchatwriter.h
+ * @brief Background writer for the chat and IM logs.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#ifndef LL_LLLOGCHATWRITER_H
+#define LL_LLLOGCHATWRITER_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "llthread.h"
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+// Class LLLogChatWriter
+//
+//   Owned by LLLogChat. The main thread queues lines and history timestamps;
+//   the writer thread buffers the lines and every flush interval appends
+//   them to the log files it keeps open, bringing the LLLogChatIndex sidecar
+//   of each log written to up to date. The log files only change during
+//   such a flush. Readers that found a log without a usable sidecar ask
+//   for it with updateIndex(), and the writer thread builds it between
+//   flushes.
+//
+//   Lines stay readable through getPendingLines() until they are on disk,
+//   so readers never have to wait for the writer. Timestamps are handed
+//   back once their lines were flushed, and the main thread stores them in
+//   a single sqlite transaction from commitTimestamps(): the agent database
+//   connection is not shared with the writer thread.
+//
+//   shutdown() writes everything still queued. flushOnCrash() never waits
+//   for the writer: it writes the pending lines itself if it can take the
+//   lock at once.
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+class LLLogChatWriter : public LLThread
+{
+public:
+	typedef std::vector<std::string> string_vec_t;
+
+	LLLogChatWriter(F32 flush_interval);
+	~LLLogChatWriter();
+
+	// Main thread
+	void append(const std::string& filename, const std::string& line);
+	void setTimestamp(const std::string& label, U32 timestamp);
+	void setFlushInterval(F32 seconds);
+	// Stores the timestamps of the flushed lines; call once per frame.
+	void commitTimestamps();
+	// Has the LLLogChatIndex sidecar of filename brought up to date.
+	void updateIndex(const std::string& filename);
+
+	// Copies the lines of filename not on disk yet, oldest first, and
+	// returns the flush sequence number. If isFlushSeq() still returns true
+	// for it after reading the log file, the file and the copied lines
+	// together are the whole log, without overlap.
+	U32 getPendingLines(const std::string& filename, string_vec_t& lines);
+	bool isFlushSeq(U32 seq);
+
+	// Best effort from a crash handler; see above.
+	void flushOnCrash();
+
+	/*virtual*/ void shutdown();
+
+	// Direct writes, used when there is no writer thread.
+	static bool writeLine(const std::string& filename, const std::string& line);
+	static void writeTimestamp(const std::string& label, U32 timestamp);
+
+protected:
+	/*virtual*/ void run();
+
+private:
+	struct Line
+	{
+		std::string	mFilename;
+		std::string	mText;
+	};
+	typedef std::vector<Line> line_vec_t;
+	typedef std::map<std::string, U32> timestamp_map_t;
+	typedef std::map<std::string, string_vec_t> pending_map_t;
+	typedef std::set<std::string> string_set_t;
+
+	struct OpenFile
+	{
+		LLFILE*	mFile;
+		F64		mLastUsed;
+	};
+	typedef std::map<std::string, OpenFile> file_map_t;
+
+	struct Buffer
+	{
+		Buffer() : mLines(0) {}
+		std::string	mText;
+		U32			mLines;
+	};
+	typedef std::map<std::string, Buffer> buffer_map_t;
+
+	// Writer thread
+	void bufferLines(const line_vec_t& lines);
+	LLFILE* getFile(const std::string& filename);
+	void flushFiles(bool close_idle);
+	void closeFiles();
+
+	LLCondition			mCondition;			// guards everything down to mAbandoned
+	line_vec_t			mLines;
+	pending_map_t		mPendingLines;		// queued or buffered, per log file
+	timestamp_map_t		mTimestamps;
+	timestamp_map_t		mFlushedTimestamps;	// for commitTimestamps()
+	string_set_t		mIndexRequests;		// logs to index
+	F32					mFlushInterval;
+	U32					mFlushSeq;			// odd while the log files are being written
+	bool				mAbandoned;			// flushOnCrash() took over
+
+	// Writer thread only
+	file_map_t			mFiles;
+	buffer_map_t		mBuffers;
+	timestamp_map_t		mUnsavedTimestamps;
+
+	// Main thread only
+	sqlite3*			mDB;
+	sqlite3_stmt*		mUpsert;
+};
+
+#endif // LL_LLLOGCHATWRITER_H
@@ -39,6 +39,7 @@
 #include "llfasttimer.h"
 #include "llfloaterperms.h"
 #include "llimagej2c.h"
+#include "llmemtag.h"
 #include "llhost.h"
 #include "llnotificationsutil.h"
 #include "llsd.h"
@@ -660,6 +661,11 @@ void LLMeshRepoThread::runSet(uuid_set_t& set, std::function<bool(const LLUUID&
 	}
 }
 
+static LLTrace::BlockTimerStatHandle FTM_MESH_REPO_REQUESTS("Mesh Requests");
+static LLTraceCounter sTraceMeshRequests("Mesh HTTP Requests");
+static LLTrace::BlockTimerStatHandle FTM_MESH_HEADER_RECEIVED("Mesh Header Parse");
+static LLTrace::BlockTimerStatHandle FTM_MESH_LOD_RECEIVED("Mesh LOD Parse");
+
 void LLMeshRepoThread::run()
 {
 	LLCDResult res = LLConvexDecomposition::initThread();
@@ -673,6 +679,7 @@ void LLMeshRepoThread::run()
 	{
 		if (!LLApp::isQuitting())
 		{
+			LL_RECORD_BLOCK_TIME(FTM_MESH_REPO_REQUESTS);
 			static U32 count = 0;
 
 			static F32 last_hundred = gFrameTimeSeconds;
@@ -874,6 +881,7 @@ bool LLMeshRepoThread::fetchMeshSkinInfo(const LLUUID& mesh_id)
 				new LLMeshSkinInfoResponder(mesh_id, info.mOffset, info.mSize)))
 				return false;
 			LLMeshRepository::sHTTPRequestCount++;
+			sTraceMeshRequests.add(1);
 		}
 	}
 
@@ -904,6 +912,7 @@ bool LLMeshRepoThread::fetchMeshDecomposition(const LLUUID& mesh_id)
 				new LLMeshDecompositionResponder(mesh_id, info.mOffset, info.mSize)))
 				return false;
 			LLMeshRepository::sHTTPRequestCount++;
+			sTraceMeshRequests.add(1);
 		}
 	}
 
@@ -936,6 +945,7 @@ bool LLMeshRepoThread::fetchMeshPhysicsShape(const LLUUID& mesh_id)
 					new LLMeshPhysicsShapeResponder(mesh_id, info.mOffset, info.mSize)))
 					return false;
 				LLMeshRepository::sHTTPRequestCount++;
+				sTraceMeshRequests.add(1);
 			}
 		}
 		else
@@ -1012,6 +1022,7 @@ bool LLMeshRepoThread::fetchMeshHeader(const LLVolumeParams& mesh_params, U32& c
 		if (retval)
 		{
 			LLMeshRepository::sHTTPRequestCount++;
+			sTraceMeshRequests.add(1);
 		}
 		count++;
 	}
@@ -1048,6 +1059,7 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 						new LLMeshLODResponder(mesh_params, lod, info.mOffset, info.mSize)))
 					return false;
 				LLMeshRepository::sHTTPRequestCount++;
+				sTraceMeshRequests.add(1);
 			
 			}
 			else
@@ -1066,31 +1078,34 @@ bool LLMeshRepoThread::fetchMeshLOD(const LLVolumeParams& mesh_params, S32 lod,
 
 bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* data, S32 data_size)
 {
+	LL_RECORD_BLOCK_TIME(FTM_MESH_HEADER_RECEIVED);
 	LLSD header;
 	
 	U32 header_size = 0;
 	if (data_size > 0)
 	{
-		std::string res_str((char*) data, data_size);
+		const char* res = (const char*)data;
+		size_t res_size = data_size;
 
-		std::string deprecated_header("<? LLSD/Binary ?>");
+		static const char deprecated_header[] = "<? LLSD/Binary ?>";
+		const size_t deprecated_size = sizeof(deprecated_header) - 1;
 
-		if (res_str.substr(0, deprecated_header.size()) == deprecated_header)
+		if (res_size >= deprecated_size && !memcmp(res, deprecated_header, deprecated_size))
 		{
-			res_str = res_str.substr(deprecated_header.size()+1, data_size);
-			header_size = deprecated_header.size()+1;
+			header_size = llmin(deprecated_size + 1, res_size);
+			res += header_size;
+			res_size -= header_size;
 		}
-		data_size = res_str.size();
-
-		std::istringstream stream(res_str);
 
-		if (!LLSDSerialize::fromBinary(header, stream, data_size))
+		// The header is parsed in place, the asset data follows it.
+		LLSDBufferParser parser(LLSDBufferParser::BINARY);
+		if (!parser.parse(res, res_size, header, (S32)res_size))
 		{
 			LL_WARNS() << "Mesh header parse error.  Not a valid mesh asset!" << LL_ENDL;
 			return false;
 		}
 
-		header_size += stream.tellg();
+		header_size += parser.getBytesRead();
 	}
 	else
 	{
@@ -1128,6 +1143,7 @@ bool LLMeshRepoThread::headerReceived(const LLVolumeParams& mesh_params, U8* dat
 
 bool LLMeshRepoThread::lodReceived(const LLVolumeParams& mesh_params, S32 lod, U8* data, S32 data_size)
 {
+	LL_RECORD_BLOCK_TIME(FTM_MESH_LOD_RECEIVED);
 	AIStateMachine::StateTimer timer("lodReceived");
 	LLPointer<LLVolume> volume = new LLVolume(mesh_params, LLVolumeLODGroup::getVolumeScaleFromDetail(lod));
 	std::string mesh_string((char*) data, data_size);
@@ -1159,11 +1175,7 @@ bool LLMeshRepoThread::skinInfoReceived(const LLUUID& mesh_id, U8* data, S32 dat
 
 	if (data_size > 0)
 	{
-		std::string res_str((char*) data, data_size);
-
-		std::istringstream stream(res_str);
-
-		if (!unzip_llsd(skin, stream, data_size))
+		if (!unzip_llsd(skin, data, data_size))
 		{
 			LL_WARNS() << "Mesh skin info parse error.  Not a valid mesh asset!" << LL_ENDL;
 			return false;
@@ -1189,11 +1201,7 @@ bool LLMeshRepoThread::decompositionReceived(const LLUUID& mesh_id, U8* data, S3
 
 	if (data_size > 0)
 	{ 
-		std::string res_str((char*) data, data_size);
-
-		std::istringstream stream(res_str);
-
-		if (!unzip_llsd(decomp, stream, data_size))
+		if (!unzip_llsd(decomp, data, data_size))
 		{
 			LL_WARNS() << "Mesh decomposition parse error.  Not a valid mesh asset!" << LL_ENDL;
 			return false;
@@ -2706,8 +2714,22 @@ void LLMeshRepository::notifyLoadedMeshes()
 	mThread->mSignal->signal();
 }
 
+// What a skin info kept in mSkinMap costs, roughly.
+static S64 skin_info_bytes(const LLMeshSkinInfo& info)
+{
+	return sizeof(LLMeshSkinInfo) +
+		   info.mJointNames.size() * (sizeof(std::string) + sizeof(S32)) +
+		   (info.mInvBindMatrix.size() + info.mAlternateBindMatrix.size()) * sizeof(LLMatrix4);
+}
+
 void LLMeshRepository::notifySkinInfoReceived(LLMeshSkinInfo& info)
 {
+	const auto old = mSkinMap.find(info.mMeshID);
+	if (old != mSkinMap.end())
+	{
+		LLMemTag::sub(LLMemTag::MT_MESH, skin_info_bytes(old->second));
+	}
+	LLMemTag::add(LLMemTag::MT_MESH, skin_info_bytes(info));
 	mSkinMap.insert_or_assign(info.mMeshID, info);
 
 	skin_load_map::iterator iter = mLoadingSkins.find(info.mMeshID);
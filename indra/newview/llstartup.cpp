@@ -171,6 +171,7 @@
 #include "lltoolmgr.h"
 #include "lltrans.h"
 #include "llui.h"
+#include "llxuicache.h"
 #include "llurldispatcher.h"
 #include "llurlhistory.h"
 #include "llurlwhitelist.h"
@@ -2835,6 +2836,12 @@ bool idle_startup()
 		// Clean up the userauth stuff.
 		LLUserAuth::getInstance()->reset();
 
+		// Parse the floaters and panels ahead of their first opening.
+		if (gSavedSettings.getBOOL("XUICacheWarmUp"))
+		{
+			LLXUICache::startWarmUp();
+		}
+
 		LLStartUp::setStartupState( STATE_STARTED );
 		display_startup();
 
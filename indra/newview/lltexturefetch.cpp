@@ -75,6 +75,9 @@ extern AIHTTPTimeoutPolicy assetReportHandler_timeout;
 LLStat LLTextureFetch::sCacheHitRate("texture_cache_hits", 128);
 LLStat LLTextureFetch::sCacheReadLatency("texture_cache_read_latency", 128);
 
+// Received over HTTP, for the trace recorder
+static LLTraceCounter sTraceTextureBytes("Texture Bytes");
+
 //////////////////////////////////////////////////////////////////////////////
 // Log scope
 static const char * const LOG_TXT = "Texture";
@@ -455,6 +458,7 @@ public:
 				}
 			}
 			S32BytesImplicit data_size = worker->callbackHttpGet(mReplyOffset, mReplyLength, channels, buffer, partial, success);
+			sTraceTextureBytes.add(data_size.value());
 			
 			if(log_texture_traffic && data_size > 0)
 			{
@@ -1038,9 +1042,12 @@ void LLTextureFetchWorker::startWork(S32 param)
 
 #include "llviewertexturelist.h" // debug
 
+static LLTrace::BlockTimerStatHandle FTM_TEXTURE_FETCH_WORK("Texture Fetch Work");
+
 // Called from LLWorkerThread::processRequest()
 bool LLTextureFetchWorker::doWork(S32 param)
 {
+	LL_RECORD_BLOCK_TIME(FTM_TEXTURE_FETCH_WORK);
 	LLMutexLock lock(&mWorkMutex);
 	//LL_INFOS() << "mState" << mState << LL_ENDL;
 	if ((mFetcher->isQuitting() || getFlags(LLWorkerClass::WCF_DELETE_REQUESTED)))
@@ -79,6 +79,8 @@
 #include "lldrawpoolwlsky.h"
 #include "llwlparammanager.h"
 #include "aistatemachine.h"
+#include "llhitchrecorder.h"
+#include "lltracerecorder.h"
 #include "aithreadsafe.h"
 #include "lldrawpoolbump.h"
 #include "aicurl.h"
@@ -149,6 +151,30 @@ bool handleStateMachineMaxTimeChanged(const LLSD& newvalue)
 	return true;
 }
 
+static bool handleHitchCaptureFramesChanged(const LLSD& newvalue)
+{
+	LLHitchRecorder::setHistorySize(newvalue.asInteger());
+	return true;
+}
+
+static bool handleHitchCaptureThresholdChanged(const LLSD& newvalue)
+{
+	LLHitchRecorder::setThreshold(newvalue.asFloat());
+	return true;
+}
+
+static bool handleTraceRecorderEnabledChanged(const LLSD& newvalue)
+{
+	LLTraceRecorder::setActive(newvalue.asBoolean());
+	return true;
+}
+
+static bool handleTraceRecorderSpikeChanged(const LLSD& newvalue)
+{
+	LLTraceRecorder::setSpikeThreshold(newvalue.asFloat());
+	return true;
+}
+
 extern bool sInwlfPanelUpdate;
 static bool handleAvatarHoverOffsetChanged(const LLSD& newvalue)
 {
@@ -709,6 +735,10 @@ void settings_setup_listeners()
 {
 	gSavedSettings.getControl("FirstPersonAvatarVisible")->getSignal()->connect(boost::bind(&handleRenderAvatarMouselookChanged, _2));
 	gSavedSettings.getControl("RenderFarClip")->getSignal()->connect(boost::bind(&handleRenderFarClipChanged, _2));
+	gSavedSettings.getControl("HitchCaptureFrames")->getSignal()->connect(boost::bind(&handleHitchCaptureFramesChanged, _2));
+	gSavedSettings.getControl("HitchCaptureThresholdMs")->getSignal()->connect(boost::bind(&handleHitchCaptureThresholdChanged, _2));
+	gSavedSettings.getControl("TraceRecorderEnabled")->getSignal()->connect(boost::bind(&handleTraceRecorderEnabledChanged, _2));
+	gSavedSettings.getControl("TraceRecorderSpikeMs")->getSignal()->connect(boost::bind(&handleTraceRecorderSpikeChanged, _2));
 	gSavedSettings.getControl("RenderTerrainDetail")->getSignal()->connect(boost::bind(&handleTerrainDetailChanged, _2));
 	gSavedSettings.getControl("RenderTerrainScale")->getSignal()->connect(boost::bind(&handleTerrainScaleChanged, _2));
 	gSavedSettings.getControl("OctreeStaticObjectSizeFactor")->getSignal()->connect(boost::bind(&handleRepartition, _2));
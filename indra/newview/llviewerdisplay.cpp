@@ -51,6 +51,7 @@
 #include "llhudmanager.h"
 #include "llimagebmp.h"
 #include "llimagegl.h"
+#include "llmemtag.h"
 #include "lloctree.h"
 #include "llselectmgr.h"
 #include "llsky.h"
@@ -244,6 +245,7 @@ void display_stats()
 		LL_INFOS() << "MEMORY: " << memory << LL_ENDL;
 		LL_INFOS() << "THREADS: "<< LLThread::getCount() << LL_ENDL;
 		LL_INFOS() << "MALLOC: " << SGMemStat::getPrintableStat() <<LL_ENDL;
+		LLMemTag::dumpToLog();
 		LLMemory::logMemoryInfo(TRUE) ;
 		gRecentMemoryTime.reset();
 	}
@@ -94,6 +94,7 @@
 #include "llfloatertools.h"
 #include "llfloaterworldmap.h"
 #include "llfloatermemleak.h"
+#include "llfloatermemorytags.h"
 #include "llframestats.h"
 #include "llavataractions.h"
 #include "llgivemoney.h"
@@ -120,6 +121,7 @@
 #include "lltoolmgr.h"
 #include "lltoolpie.h"
 #include "lltoolselectland.h"
+#include "lltracerecorder.h"
 #include "lltrans.h"
 #include "lluictrlfactory.h"
 #include "llvelocitybar.h"
@@ -267,6 +269,7 @@ void handle_show_notifications_console(void*);
 void handle_region_dump_settings(void*);
 void handle_region_dump_temp_asset_data(void*);
 void handle_region_clear_temp_asset_data(void*);
+void handle_export_trace(void*);
 
 // Object pie menu
 BOOL sitting_on_selection();
@@ -844,6 +847,14 @@ void init_client_menu(LLMenuGL* menu)
 										&get_visibility,
 										(void*)gDebugView->mFastTimerView,
 										  '9', MASK_CONTROL|MASK_SHIFT ) );
+		sub->addChild(new LLMenuItemCheckGL("Record Trace Events",
+										&menu_toggle_control,
+										nullptr,
+										&menu_check_control,
+										(void*)"TraceRecorderEnabled"));
+		sub->addChild(new LLMenuItemCallGL("Export Trace",
+			&handle_export_trace, nullptr, nullptr));
+		sub->addChild(new LLMenuItemCheckGL("Memory Accounting", handle_singleton_toggle<LLFloaterMemoryTags>, nullptr, handle_singleton_check<LLFloaterMemoryTags>, nullptr));
 		
 		sub->addSeparator();
 		
@@ -3573,6 +3584,21 @@ void handle_dump_capabilities_info(void *)
 	}
 }
 
+void handle_export_trace(void*)
+{
+	LLSD args;
+	const std::string filename = LLTraceRecorder::exportTrace();
+	if (filename.empty())
+	{
+		args["MESSAGE"] = "No trace events recorded. Enable Advanced > Consoles > Record Trace Events first.";
+	}
+	else
+	{
+		args["MESSAGE"] = "Writing trace to " + filename;
+	}
+	LLNotificationsUtil::add("SystemMessageTip", args);
+}
+
 void handle_dump_region_object_cache(void*)
 {
 	LLViewerRegion* regionp = gAgent.getRegion();
@@ -915,6 +915,13 @@ void LLViewerObject::addChild(LLViewerObject *childp)
 	{
 		mChildList.push_back(childp);
 		childp->afterReparent();
+
+		// a prim linked to an attachment adds to its render cost
+		LLVOVolume* volp = childp->asVolume();
+		if (volp && !isAvatar())
+		{
+			volp->updateVisualComplexity();
+		}
 	}
 }
 
@@ -943,6 +950,13 @@ void LLViewerObject::removeChild(LLViewerObject *childp)
 			{
 				childp->setParent(NULL);
 			}
+
+			// so does unlinking one from it
+			LLVOVolume* volp = asVolume();
+			if (volp && !childp->isAvatar())
+			{
+				volp->updateVisualComplexity();
+			}
 			break;
 		}
 	}
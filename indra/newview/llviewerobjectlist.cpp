@@ -337,6 +337,8 @@ void LLViewerObjectList::processUpdateCore(LLViewerObject* objectp,
 
 static LLTrace::BlockTimerStatHandle FTM_PROCESS_OBJECTS("Process Objects");
 
+static LLTraceCounter sTraceObjectUpdates("Object Updates");
+
 void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 											 void **user_data,
 											 const EObjectUpdateType update_type,
@@ -356,6 +358,7 @@ void LLViewerObjectList::processObjectUpdate(LLMessageSystem *mesgsys,
 	// Until we get region-locality working on viewer we
 	// have to transform to absolute coordinates.
 	num_objects = mesgsys->getNumberOfBlocksFast(_PREHASH_ObjectData);
+	sTraceObjectUpdates.add(num_objects);
 
 	// I don't think this case is ever hit.  TODO* Test this.
 	if (!cached && !compressed && update_type != OUT_FULL)
@@ -1000,6 +1003,7 @@ void LLViewerObjectList::update(LLAgent &agent, LLWorld &world)
 	static const LLCachedControl<bool> freeze_time("FreezeTime",0);
 	if (freeze_time)
 	{
+		LLVOAvatar::beginAnimationBatch();
 		for (std::vector<LLViewerObject*>::iterator iter = idle_list.begin();
 			iter != idle_end; iter++)
 		{
@@ -1013,9 +1017,12 @@ void LLViewerObjectList::update(LLAgent &agent, LLWorld &world)
 				objectp->idleUpdate(agent, world, frame_time);
 			}
 		}
+		LLVOAvatar::endAnimationBatch();
 	}
 	else
 	{
+		// Avatar animations are evaluated together at the end of the loop.
+		LLVOAvatar::beginAnimationBatch();
 		for (std::vector<LLViewerObject*>::iterator idle_iter = idle_list.begin();
 			idle_iter != idle_end; idle_iter++)
 		{
@@ -1024,6 +1031,7 @@ void LLViewerObjectList::update(LLAgent &agent, LLWorld &world)
 			objectp->idleUpdate(agent, world, frame_time);
 
 		}
+		LLVOAvatar::endAnimationBatch();
 
 		//update flexible objects
 		LLVolumeImplFlexible::updateClass();
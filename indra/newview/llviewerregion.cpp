@@ -1610,6 +1610,9 @@ LLViewerRegion::eCacheUpdateResult LLViewerRegion::cacheFullUpdate(LLViewerObjec
 	U32 local_id = objectp->getLocalID();
 	U32 crc = objectp->getCRC();
 
+	// Whatever we asked for has arrived.
+	mCacheMissRequested.erase(local_id);
+
 	LLVOCacheEntry* entry = get_if_there(mImpl->mCacheMap, local_id, (LLVOCacheEntry*)NULL);
 
 	if (entry)
@@ -1677,65 +1680,180 @@ LLDataPacker *LLViewerRegion::getDP(U32 local_id, U32 crc, U8 &cache_miss_type)
 		{
 			// LL_INFOS() << "CRC miss for " << local_id << LL_ENDL;
 		cache_miss_type = CACHE_MISS_TYPE_CRC;
-			mCacheMissCRC.push_back(local_id);
+			addCacheMiss(local_id, CACHE_MISS_TYPE_CRC);
 		}
 	}
 	else
 	{
 		// LL_INFOS() << "Cache miss for " << local_id << LL_ENDL;
 	cache_miss_type = CACHE_MISS_TYPE_FULL;
-		mCacheMissFull.push_back(local_id);
+		addCacheMiss(local_id, CACHE_MISS_TYPE_FULL);
 	}
 
 	return NULL;
 }
 
+void LLViewerRegion::addCacheMiss(U32 local_id, U8 miss_type)
+{
+	// The simulator tends to repeat ObjectUpdateCached for the same objects
+	// while we are still waiting on the answer; don't ask twice.
+	if (mCacheMissRequested.find(local_id) != mCacheMissRequested.end())
+	{
+		return;
+	}
+
+	cache_miss_map_t::iterator iter = mCacheMissList.find(local_id);
+	if (iter == mCacheMissList.end())
+	{
+		mCacheMissList[local_id] = miss_type;
+	}
+	else if (miss_type < iter->second)
+	{
+		// A full miss supersedes a CRC miss.
+		iter->second = miss_type;
+	}
+}
+
 void LLViewerRegion::addCacheMissFull(const U32 local_id)
 {
-	mCacheMissFull.push_back(local_id);
+	// Explicit re-requests (the object was just killed) bypass the
+	// in-flight filter.
+	mCacheMissRequested.erase(local_id);
+	mCacheMissList[local_id] = CACHE_MISS_TYPE_FULL;
 }
 
-void LLViewerRegion::requestCacheMisses()
+// Finds where an object is, either from its live viewer object or from
+// the stale cache entry that caused the CRC miss. Children of linksets
+// and attachments are resolved through their parent, ignoring rotation,
+// which is close enough for ordering requests.
+bool LLViewerRegion::getCacheMissPosition(U32 local_id, LLVector3& pos_agent, F32& radius, S32 depth) const
 {
-	S32 full_count = mCacheMissFull.size();
-	S32 crc_count = mCacheMissCRC.size();
-	if (full_count == 0 && crc_count == 0) return;
+	LLUUID id;
+	LLViewerObjectList::getUUIDFromLocal(id, local_id, getHost().getAddress(), getHost().getPort());
+	LLViewerObject* objectp = id.notNull() ? gObjectList.findObject(id) : NULL;
+	if (objectp && !objectp->isDead())
+	{
+		pos_agent = objectp->getPositionAgent();
+		radius = objectp->getScale().magVec() * 0.5f;
+		return true;
+	}
 
-	LLMessageSystem* msg = gMessageSystem;
-	BOOL start_new_message = TRUE;
-	S32 blocks = 0;
-	S32 i;
+	LLVOCacheEntry* entry = get_if_there(mImpl->mCacheMap, local_id, (LLVOCacheEntry*)NULL);
+	LLVector3 pos, scale;
+	U32 parent_id = 0;
+	if (!entry || !entry->getPlacement(pos, scale, parent_id))
+	{
+		return false;
+	}
 
-	// Send full cache miss updates.  For these, we KNOW we don't
-	// have a viewer object.
-	for (i = 0; i < full_count; i++)
+	radius = scale.magVec() * 0.5f;
+	if (!parent_id)
 	{
-		if (start_new_message)
+		pos_agent = getPosAgentFromRegion(pos);
+		return true;
+	}
+
+	F32 parent_radius;
+	if (depth > 0 && getCacheMissPosition(parent_id, pos_agent, parent_radius, depth - 1))
+	{
+		pos_agent += pos;
+		return true;
+	}
+	return false;
+}
+
+void LLViewerRegion::calcCacheMissPriority(CacheMissItem& item) const
+{
+	// Distance bands in meters; anything past the draw distance comes last.
+	static const F32 DISTANCE_BANDS[] = { 32.f, 64.f, 128.f };
+	static const S32 NUM_DISTANCE_BANDS = LL_ARRAY_SIZE(DISTANCE_BANDS);
+	static const S32 BUCKET_UNKNOWN = NUM_DISTANCE_BANDS + 1;
+	static const S32 BUCKET_FAR = NUM_DISTANCE_BANDS + 2;
+
+	LLVector3 pos_agent;
+	F32 radius = 0.f;
+	if (!getCacheMissPosition(item.mLocalID, pos_agent, radius, 2))
+	{
+		// Nothing known about it yet: after what we can see nearby,
+		// before what is beyond the draw distance.
+		item.mBucket = BUCKET_UNKNOWN;
+		item.mPriority = 0.f;
+		return;
+	}
+
+	F32 distance = llmax((pos_agent - gAgentCamera.getCameraPositionAgent()).magVec() - radius, 0.f);
+	item.mPriority = radius / llmax(distance, 1.f);
+
+	S32 distance_bucket = NUM_DISTANCE_BANDS;
+	for (S32 i = 0; i < NUM_DISTANCE_BANDS; ++i)
+	{
+		if (distance < DISTANCE_BANDS[i])
 		{
-			msg->newMessageFast(_PREHASH_RequestMultipleObjects);
-			msg->nextBlockFast(_PREHASH_AgentData);
-			msg->addUUIDFast(_PREHASH_AgentID, gAgent.getID());
-			msg->addUUIDFast(_PREHASH_SessionID, gAgent.getSessionID());
-			start_new_message = FALSE;
+			distance_bucket = i;
+			break;
 		}
+	}
+	if (distance_bucket == NUM_DISTANCE_BANDS && distance > gAgentCamera.mDrawDistance)
+	{
+		distance_bucket = BUCKET_FAR;
+	}
 
-		msg->nextBlockFast(_PREHASH_ObjectData);
-		msg->addU8Fast(_PREHASH_CacheMissType, CACHE_MISS_TYPE_FULL);
-		msg->addU32Fast(_PREHASH_ID, mCacheMissFull[i]);
-		blocks++;
+	// Large objects are promoted regardless of distance: every halving of
+	// the apparent size drops one band.
+	S32 size_bucket = NUM_DISTANCE_BANDS;
+	if (item.mPriority > 0.f)
+	{
+		size_bucket = llclamp(ll_round(-logf(item.mPriority) / F_LN2), 0, NUM_DISTANCE_BANDS);
+	}
+
+	item.mBucket = llmin(distance_bucket, size_bucket);
+}
 
-		if (blocks >= 255)
+void LLViewerRegion::requestCacheMisses()
+{
+	// Requests are reliable, but don't wait forever on an answer that never
+	// comes through the cache path (e.g. the sim sent a plain full update).
+	const F64 CACHE_MISS_REQUEST_TIMEOUT = 10.0;
+	F64 now = LLFrameTimer::getTotalSeconds();
+	for (cache_miss_time_map_t::iterator iter = mCacheMissRequested.begin(); iter != mCacheMissRequested.end(); )
+	{
+		if (now - iter->second > CACHE_MISS_REQUEST_TIMEOUT)
 		{
-			sendReliableMessage();
-			start_new_message = TRUE;
-			blocks = 0;
+			mCacheMissRequested.erase(iter++);
+		}
+		else
+		{
+			++iter;
 		}
 	}
 
-	// Send CRC miss updates.  For these, we _might_ have a viewer object,
-	// but probably not.
-	for (i = 0; i < crc_count; i++)
+	if (mCacheMissList.empty()) return;
+
+	// Rank everything pending so the nearest and largest objects are
+	// requested first, then send as much as this frame's budget allows.
+	std::vector<CacheMissItem> misses;
+	misses.reserve(mCacheMissList.size());
+	for (cache_miss_map_t::const_iterator iter = mCacheMissList.begin(); iter != mCacheMissList.end(); ++iter)
 	{
+		misses.push_back(CacheMissItem(iter->first, iter->second));
+		calcCacheMissPriority(misses.back());
+	}
+	std::sort(misses.begin(), misses.end());
+
+	static LLCachedControl<U32> max_packets(gSavedSettings, "ObjectCacheMissPacketsPerFrame", 4);
+	const S32 MAX_BLOCKS = 255;
+	S32 max_requests = max_packets ? (S32)max_packets * MAX_BLOCKS : (S32)misses.size();
+	S32 request_count = llmin((S32)misses.size(), max_requests);
+
+	LLMessageSystem* msg = gMessageSystem;
+	BOOL start_new_message = TRUE;
+	S32 blocks = 0;
+	S32 full_count = 0;
+	S32 crc_count = 0;
+
+	for (S32 i = 0; i < request_count; i++)
+	{
+		const CacheMissItem& item = misses[i];
 		if (start_new_message)
 		{
 			msg->newMessageFast(_PREHASH_RequestMultipleObjects);
@@ -1745,12 +1863,25 @@ void LLViewerRegion::requestCacheMisses()
 			start_new_message = FALSE;
 		}
 
+		// For full misses we KNOW we don't have a viewer object, for CRC
+		// misses we _might_ have one, but probably not.
 		msg->nextBlockFast(_PREHASH_ObjectData);
-		msg->addU8Fast(_PREHASH_CacheMissType, CACHE_MISS_TYPE_CRC);
-		msg->addU32Fast(_PREHASH_ID, mCacheMissCRC[i]);
+		msg->addU8Fast(_PREHASH_CacheMissType, item.mType);
+		msg->addU32Fast(_PREHASH_ID, item.mLocalID);
 		blocks++;
 
-		if (blocks >= 255)
+		if (item.mType == CACHE_MISS_TYPE_FULL)
+		{
+			full_count++;
+		}
+		else
+		{
+			crc_count++;
+		}
+		mCacheMissList.erase(item.mLocalID);
+		mCacheMissRequested[item.mLocalID] = now;
+
+		if (blocks >= MAX_BLOCKS)
 		{
 			sendReliableMessage();
 			start_new_message = TRUE;
@@ -1763,11 +1894,9 @@ void LLViewerRegion::requestCacheMisses()
 	{
 		sendReliableMessage();
 	}
-	mCacheMissFull.clear();
-	mCacheMissCRC.clear();
 
 	mCacheDirty = TRUE ;
-	// LL_INFOS() << "KILLDEBUG Sent cache miss full " << full_count << " crc " << crc_count << LL_ENDL;
+	// LL_INFOS() << "KILLDEBUG Sent cache miss full " << full_count << " crc " << crc_count << " pending " << mCacheMissList.size() << LL_ENDL;
 	LLViewerStatsRecorder::instance().requestCacheMissesEvent(full_count + crc_count);
 	LLViewerStatsRecorder::instance().log(0.2f);
 }
@@ -364,6 +364,7 @@ public:
 	LLDataPacker *getDP(U32 local_id, U32 crc, U8 &cache_miss_type);
 	void requestCacheMisses();
 	void addCacheMissFull(const U32 local_id);
+	S32 getPendingCacheMissCount() const { return (S32)mCacheMissList.size(); }
 
 	void clearCachedVisibleObjects();
 	void dumpCache();
@@ -418,6 +419,30 @@ protected:
 	void initStats();
 	void initPartitions();
 
+	// A pending RequestMultipleObjects entry, ranked at flush time.
+	struct CacheMissItem
+	{
+		CacheMissItem(U32 local_id, U8 miss_type)
+		:	mLocalID(local_id), mType(miss_type), mBucket(0), mPriority(0.f)
+		{}
+
+		bool operator<(const CacheMissItem& rhs) const
+		{
+			if (mBucket != rhs.mBucket) return mBucket < rhs.mBucket;
+			if (mPriority != rhs.mPriority) return mPriority > rhs.mPriority;
+			return mLocalID < rhs.mLocalID;
+		}
+
+		U32 mLocalID;
+		U8	mType;
+		S32 mBucket;	// coarse distance/screen size band, lower is sent first
+		F32 mPriority;	// approximate screen size within a bucket
+	};
+
+	void addCacheMiss(U32 local_id, U8 miss_type);
+	void calcCacheMissPriority(CacheMissItem& item) const;
+	bool getCacheMissPosition(U32 local_id, LLVector3& pos_agent, F32& radius, S32 depth) const;
+
 public:
 	LLWind  mWind;
 #if ENABLE_CLASSIC_CLOUDS
@@ -491,8 +516,13 @@ private:
 	BOOL									mCacheLoaded;
 	BOOL                                    mCacheDirty;
 
-	std::vector<U32>						mCacheMissFull;
-	std::vector<U32>						mCacheMissCRC;
+	// Cache misses waiting to be requested, local id -> eCacheMissType.
+	// Keyed so repeated ObjectUpdateCached bursts collapse to one request.
+	typedef std::map<U32, U8> cache_miss_map_t;
+	cache_miss_map_t						mCacheMissList;
+	// Cache misses already requested, local id -> time of the request.
+	typedef std::map<U32, F64> cache_miss_time_map_t;
+	cache_miss_time_map_t					mCacheMissRequested;
 
 // [SL:KB] - Patch: World-MinimapOverlay | Checked: 2012-07-26 (Catznip-3.3)
 	mutable tex_matrix_t mWorldMapTiles;
@@ -233,6 +233,11 @@ LLViewerStats::LLViewerStats() :
 	mActualInKBitStat("actualinkbitstat"),
 	mActualOutKBitStat("actualoutkbitstat"),
 	mTrianglesDrawnStat("trianglesdrawnstat"),
+	mImpostorsRefreshedStat("impostorsrefreshedstat"),
+	mImpostorsSkippedStat("impostorsskippedstat"),
+	mImpostorMsecStat("impostormsecstat"),
+	mVisualParamsCheckedStat("visualparamscheckedstat"),
+	mVisualParamsAppliedStat("visualparamsappliedstat"),
 	mSimTimeDilation("simtimedilation"),
 	mSimFPS("simfps"),
 	mSimPhysicsFPS("simphysicsfps"),
@@ -60,6 +60,11 @@ public:
 			mActualInKBitStat,	// From the packet ring (when faking a bad connection)
 			mActualOutKBitStat,	// From the packet ring (when faking a bad connection)
 			mTrianglesDrawnStat,
+			mImpostorsRefreshedStat,
+			mImpostorsSkippedStat,
+			mImpostorMsecStat,
+			mVisualParamsCheckedStat,
+			mVisualParamsAppliedStat,
 			mMallocStat;
 
 	// Simulator stats
@@ -348,6 +348,24 @@ class LLViewerTextureManagerBridge : public LLTextureManagerBridge
 	{
 		return LLViewerTextureManager::getFetchedTexture(image_id);
 	}
+
+	/*virtual*/ LLImageRaw* getRawImage(LLGLTexture* tex, bool request_save)
+	{
+		LLViewerFetchedTexture* fetched = LLViewerTextureManager::staticCastToFetchedTexture(tex);
+		if (!fetched)
+		{
+			return NULL;
+		}
+		if (fetched->hasSavedRawImage())
+		{
+			return fetched->getSavedRawImage();
+		}
+		if (request_save)
+		{
+			fetched->forceToSaveRawImage(0);
+		}
+		return fetched->isCachedRawImageReady() ? fetched->getCachedRawImage() : NULL;
+	}
 };
 
 
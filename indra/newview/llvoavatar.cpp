@@ -39,6 +39,7 @@
 #include "llagentbenefits.h"
 #include "llagentcamera.h"
 #include "llagentwearables.h"
+#include "llanimationpool.h"
 #include "llanimationstates.h"
 #include "llavataractions.h"
 #include "llavatarnamecache.h"
@@ -307,6 +308,7 @@ const F32 UNDERWATER_EFFECT_STRENGTH = 0.1f;
 const F32 UNDERWATER_FREQUENCY_DAMP = 0.33f;
 const F32 APPEARANCE_MORPH_TIME = 0.65f;
 const F32 TIME_BEFORE_MESH_CLEANUP = 5.f; // seconds
+const F32 IMPOSTOR_REFRESH_SECONDS = 0.05f; // times mUpdatePeriod
 const S32 AVATAR_RELEASE_THRESHOLD = 10; // number of avatar instances before releasing memory
 const F32 FOOT_GROUND_COLLISION_TOLERANCE = 0.25f;
 const F32 AVATAR_LOD_TWEAK_RANGE = 0.7f;
@@ -1118,6 +1120,11 @@ F32 LLVOAvatar::sLODFactor = 1.f;
 F32 LLVOAvatar::sPhysicsLODFactor = 1.f;
 bool LLVOAvatar::sUseImpostors = false;
 BOOL LLVOAvatar::sJointDebug = false;
+bool LLVOAvatar::sAnimationBatch = false;
+U32 LLVOAvatar::sImpostorsRefreshed = 0;
+U32 LLVOAvatar::sImpostorsSkipped = 0;
+F32 LLVOAvatar::sImpostorMsec = 0.f;
+std::vector<LLPointer<LLVOAvatar> > LLVOAvatar::sPendingAnimations;
 F32 LLVOAvatar::sUnbakedTime = 0.f;
 F32 LLVOAvatar::sUnbakedUpdateTime = 0.f;
 F32 LLVOAvatar::sGreyTime = 0.f;
@@ -1174,9 +1181,12 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 	mCulled( FALSE ),
 	mVisibilityRank(0),
 	mNeedsSkin(FALSE),
+	mAnimationPending(false),
+	mPendingSitGroundConstrained(false),
 	mLastSkinTime(0.f),
 	mUpdatePeriod(1),
 	mVisualComplexityStale(true),
+	mComplexityPass(0),
 	mFirstFullyVisible(TRUE),
 	mFullyLoaded(FALSE),
 	mPreviousFullyLoaded(FALSE),
@@ -1215,6 +1225,11 @@ LLVOAvatar::LLVOAvatar(const LLUUID& id,
 
 	mPelvisp = NULL;
 
+	mOverrideBatchDepth = 0;
+	mOverridePelvisRecalc = false;
+	mOverridesDeferred = false;
+	mAttachmentOverridesDirty = false;
+
 	mDirtyMesh = 2;	// Dirty geometry, need to regenerate.
 	mMeshTexturesDirty = FALSE;
 	mHeadp = NULL;
@@ -1662,6 +1677,7 @@ void LLVOAvatar::initInstance()
 	if (LLCharacter::sInstances.size() == 1)
 	{
 		LLKeyframeMotion::setVFS(gStaticVFS);
+		LLKeyframeDataCache::setRetainLimit(gSavedSettings.getU32("AnimationCacheRetainMB") * 1024 * 1024);
 		registerMotion(ANIM_AGENT_DO_NOT_DISTURB,			LLNullMotion::create );
 		registerMotion( ANIM_AGENT_CROUCH,					LLKeyframeStandMotion::create );
 		registerMotion( ANIM_AGENT_CROUCHWALK,				LLKeyframeWalkMotion::create );
@@ -3011,6 +3027,18 @@ void LLVOAvatar::idleUpdate(LLAgent &agent, LLWorld &world, const F64 &time)
 		return;
 	}	
 
+	// Resolve the attachment overrides changed since the last frame
+	if (mAttachmentOverridesDirty)
+	{
+		mAttachmentOverridesDirty = false;
+		updateAttachmentOverrides();
+	}
+	if (mOverridesDeferred)
+	{
+		mOverridesDeferred = false;
+		endAttachmentOverrides();
+	}
+
 	if (!(gPipeline.hasRenderType(LLPipeline::RENDER_TYPE_AVATAR)))
 	{
 		return;
@@ -3100,6 +3128,20 @@ void LLVOAvatar::idleUpdate(LLAgent &agent, LLWorld &world, const F64 &time)
 		LL_RECORD_BLOCK_TIME(FTM_CHARACTER_UPDATE);
 		detailed_update = updateCharacter(agent);
 	}
+	if (mAnimationPending)
+	{
+		// endAnimationBatch() does the rest.
+		return;
+	}
+	idleUpdateAfterCharacter(detailed_update);
+}
+
+//------------------------------------------------------------------------
+// idleUpdateAfterCharacter()
+// The part of idleUpdate() that needs the evaluated skeleton.
+//------------------------------------------------------------------------
+void LLVOAvatar::idleUpdateAfterCharacter(bool detailed_update)
+{
 	if (gNoRender)
 	{
 		return;
@@ -5191,9 +5233,29 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 	}
 	else
 	{
-		updateMotions(LLCharacter::NORMAL_UPDATE);
+		// Our own avatar is left out of the batch: the agent and the camera
+		// rely on its skeleton right after this.
+		updateMotions(LLCharacter::NORMAL_UPDATE, sAnimationBatch && !isSelf());
+	}
+
+	if (isEvaluationPending())
+	{
+		mAnimationPending = true;
+		mPendingSitGroundConstrained = was_sit_ground_constrained;
+		sPendingAnimations.push_back(this);
+		return TRUE;
 	}
 
+	finishCharacterUpdate(was_sit_ground_constrained);
+	return TRUE;
+}
+
+//------------------------------------------------------------------------
+// finishCharacterUpdate()
+// What updateCharacter() does once the motions are evaluated.
+//------------------------------------------------------------------------
+void LLVOAvatar::finishCharacterUpdate(bool was_sit_ground_constrained)
+{
 	// Special handling for sitting on ground.
 	if (!getParent() && (isSitting() || was_sit_ground_constrained))
 	{
@@ -5213,13 +5275,95 @@ BOOL LLVOAvatar::updateCharacter(LLAgent &agent)
 	// Generate footstep sounds when feet hit the ground
     updateFootstepSounds();
 
-	// Update child joints as needed.
+	// Update child joints as needed. After a batched evaluation, only the
+	// ground sitting offset above can have left anything to do.
 	mRoot->updateWorldMatrixChildren();
 
 	//mesh vertices need to be reskinned
 	mNeedsSkin = TRUE;
+}
 
-	return TRUE;
+//------------------------------------------------------------------------
+// beginAnimationBatch()
+//------------------------------------------------------------------------
+//static
+void LLVOAvatar::beginAnimationBatch()
+{
+	// Without worker threads, batching only delays the work.
+	sAnimationBatch = LLAnimationPool::getThreadCount() > 0;
+}
+
+//------------------------------------------------------------------------
+// endAnimationBatch()
+//------------------------------------------------------------------------
+static LLTrace::BlockTimerStatHandle FTM_ANIMATION_BATCH("Animation Batch");
+static LLTrace::BlockTimerStatHandle FTM_MORPH_BATCH("Morph Batch");
+
+static void apply_pending_morphs(LLCharacter* character)
+{
+	static_cast<LLAvatarAppearance*>(character)->applyPendingMorphs();
+}
+
+//static
+void LLVOAvatar::endAnimationBatch()
+{
+	if (sAnimationBatch)
+	{
+		// Vertex morphs queued by appearance changes, before anything
+		// renders the meshes. Without worker threads, rendering does it.
+		static std::vector<LLCharacter*> morphed;
+		morphed.clear();
+		for (std::vector<LLCharacter*>::iterator it = LLCharacter::sInstances.begin();
+			 it != LLCharacter::sInstances.end(); ++it)
+		{
+			LLVOAvatar* avatar = static_cast<LLVOAvatar*>(*it);
+			if (!avatar->isDead() && avatar->hasPendingMorphs())
+			{
+				morphed.push_back(avatar);
+			}
+		}
+		if (!morphed.empty())
+		{
+			LL_RECORD_BLOCK_TIME(FTM_MORPH_BATCH);
+			LLAnimationPool::process(morphed, apply_pending_morphs);
+		}
+	}
+
+	sAnimationBatch = false;
+	if (sPendingAnimations.empty())
+	{
+		return;
+	}
+
+	LL_RECORD_BLOCK_TIME(FTM_ANIMATION_BATCH);
+
+	static std::vector<LLCharacter*> characters;
+	characters.clear();
+	for (std::vector<LLPointer<LLVOAvatar> >::iterator it = sPendingAnimations.begin();
+		 it != sPendingAnimations.end(); ++it)
+	{
+		if (!(*it)->isDead())
+		{
+			characters.push_back(*it);
+		}
+	}
+	LLAnimationPool::evaluate(characters);
+
+	// Serially, in the order the avatars were updated in.
+	for (std::vector<LLPointer<LLVOAvatar> >::iterator it = sPendingAnimations.begin();
+		 it != sPendingAnimations.end(); ++it)
+	{
+		LLVOAvatar* avatar = *it;
+		avatar->mAnimationPending = false;
+		if (avatar->isDead())
+		{
+			continue;
+		}
+		LL_RECORD_BLOCK_TIME(FTM_AVATAR_UPDATE);
+		avatar->finishCharacterUpdate(avatar->mPendingSitGroundConstrained);
+		avatar->idleUpdateAfterCharacter(true);
+	}
+	sPendingAnimations.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -6853,8 +6997,61 @@ bool LLVOAvatar::jointIsRiggedTo(const LLJoint *joint) const
     return false;
 }
 
+//-----------------------------------------------------------------------------
+// beginAttachmentOverrides
+//-----------------------------------------------------------------------------
+void LLVOAvatar::beginAttachmentOverrides()
+{
+	++mOverrideBatchDepth;
+}
+
+//-----------------------------------------------------------------------------
+// deferAttachmentOverrides
+//-----------------------------------------------------------------------------
+void LLVOAvatar::deferAttachmentOverrides()
+{
+	if (!mOverridesDeferred)
+	{
+		mOverridesDeferred = true;
+		beginAttachmentOverrides();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// endAttachmentOverrides
+//
+// Moves the joints whose overrides changed since the outermost
+// beginAttachmentOverrides() to their winning override, and rebuilds the
+// body data once if the pelvis was set.
+//-----------------------------------------------------------------------------
+void LLVOAvatar::endAttachmentOverrides()
+{
+	llassert(mOverrideBatchDepth > 0);
+	if (--mOverrideBatchDepth > 0)
+	{
+		return;
+	}
+
+	const std::string av_string = avString();
+	for (S32 joint_num = 0; joint_num < LL_CHARACTER_MAX_ANIMATED_JOINTS; joint_num++)
+	{
+		LLJoint *pJoint = getJoint(joint_num);
+		if (pJoint)
+		{
+			pJoint->resolveAttachmentOverrides(av_string);
+		}
+	}
+
+	if (mOverridePelvisRecalc)
+	{
+		mOverridePelvisRecalc = false;
+		postPelvisSetRecalc();
+	}
+}
+
 void LLVOAvatar::clearAttachmentOverrides()
 {
+    beginAttachmentOverrides();
     for (S32 i=0; i<LL_CHARACTER_MAX_ANIMATED_JOINTS; i++)
     {
         LLJoint *pJoint = getJoint(i);
@@ -6873,11 +7070,12 @@ void LLVOAvatar::clearAttachmentOverrides()
         {
 			pJointPelvis->setPosition( LLVector3( 0.0f, 0.0f, 0.0f) );
         }
-        postPelvisSetRecalc();	
+        mOverridePelvisRecalc = true;
     }
 
     mActiveOverrideMeshes.clear();
     onActiveOverrideMeshesChanged();
+    endAttachmentOverrides();
 }
 
 //-----------------------------------------------------------------------------
@@ -6885,6 +7083,7 @@ void LLVOAvatar::clearAttachmentOverrides()
 //-----------------------------------------------------------------------------
 void LLVOAvatar::rebuildAttachmentOverrides()
 {
+    beginAttachmentOverrides();
     clearAttachmentOverrides();
 
     // Handle the case that we're resetting the skeleton of an animated object.
@@ -6927,6 +7126,7 @@ void LLVOAvatar::rebuildAttachmentOverrides()
 			}
 		}
 	}
+    endAttachmentOverrides();
 }
 
 //-----------------------------------------------------------------------------
@@ -6939,6 +7139,7 @@ void LLVOAvatar::updateAttachmentOverrides()
 {
     LL_DEBUGS("AnimatedObjects") << "updating" << LL_ENDL;
 
+    beginAttachmentOverrides();
     uuid_set_t meshes_seen;
     
     // Handle the case that we're updating the skeleton of an animated object.
@@ -6992,6 +7193,7 @@ void LLVOAvatar::updateAttachmentOverrides()
             removeAttachmentOverridesForObject(*it);
         }
     }
+    endAttachmentOverrides();
 }
 // addAttachmentPosOverridesForObject
 //-----------------------------------------------------------------------------
@@ -7005,6 +7207,8 @@ void LLVOAvatar::addAttachmentOverridesForObject(LLViewerObject *vo, uuid_set_t*
 
     LL_DEBUGS("AnimatedObjects") << "adding" << LL_ENDL;
     
+    beginAttachmentOverrides();
+
 	// Process all children
     if (recursive)
     {
@@ -7052,7 +7256,7 @@ void LLVOAvatar::addAttachmentOverridesForObject(LLViewerObject *vo, uuid_set_t*
 						if (pJoint->aboveJointPosThreshold(jointPos))
 						{
 							bool override_changed;
-							pJoint->addAttachmentPosOverride( jointPos, mesh_id, avString(), override_changed );
+							pJoint->addAttachmentPosOverride( jointPos, mesh_id, avString(), override_changed, true );
 
 							if (override_changed)
 							{
@@ -7066,7 +7270,7 @@ void LLVOAvatar::addAttachmentOverridesForObject(LLViewerObject *vo, uuid_set_t*
 							{
 								// Note that unlike positions, there's no threshold check here,
 								// just a lock at the default value.
-								pJoint->addAttachmentScaleOverride(pJoint->getDefaultScale(), mesh_id, avString());
+								pJoint->addAttachmentScaleOverride(pJoint->getDefaultScale(), mesh_id, avString(), true);
 							}
 						}
 					}
@@ -7091,9 +7295,11 @@ void LLVOAvatar::addAttachmentOverridesForObject(LLViewerObject *vo, uuid_set_t*
 		//Rebuild body data if we altered joints/pelvis
 		if (pelvisGotSet)
 		{
-			postPelvisSetRecalc();
+			mOverridePelvisRecalc = true;
 		}
 	}
+
+	endAttachmentOverrides();
 }
 
 //-----------------------------------------------------------------------------
@@ -7220,6 +7426,8 @@ void LLVOAvatar::removeAttachmentOverridesForObject(LLViewerObject *vo)
         return;
 	}
 		
+	beginAttachmentOverrides();
+
 	// Process all children
 	LLViewerObject::const_child_list_t& children = vo->getChildren();
 	for (LLViewerObject::const_child_list_t::const_iterator it = children.begin();
@@ -7235,6 +7443,8 @@ void LLVOAvatar::removeAttachmentOverridesForObject(LLViewerObject *vo)
 	{
 		removeAttachmentOverridesForObject(mesh_id);
 	}
+
+	endAttachmentOverrides();
 }
 
 //-----------------------------------------------------------------------------
@@ -7242,6 +7452,8 @@ void LLVOAvatar::removeAttachmentOverridesForObject(LLViewerObject *vo)
 //-----------------------------------------------------------------------------
 void LLVOAvatar::removeAttachmentOverridesForObject(const LLUUID& mesh_id)
 {	
+	beginAttachmentOverrides();
+
 	LLJoint* pJointPelvis = getJoint("mPelvis");
     const std::string av_string = avString();
     for (S32 joint_num = 0; joint_num < LL_CHARACTER_MAX_ANIMATED_JOINTS; joint_num++)
@@ -7250,21 +7462,24 @@ void LLVOAvatar::removeAttachmentOverridesForObject(const LLUUID& mesh_id)
 		if ( pJoint )
 		{			
             bool dummy; // unused
-			pJoint->removeAttachmentPosOverride(mesh_id, av_string, dummy);
-			pJoint->removeAttachmentScaleOverride(mesh_id, av_string);
+			pJoint->removeAttachmentPosOverride(mesh_id, av_string, dummy, true);
+			pJoint->removeAttachmentScaleOverride(mesh_id, av_string, true);
 		}		
 		if ( pJoint && pJoint == pJointPelvis)
 		{
 			removePelvisFixup( mesh_id );
 			// SL-315
+			pJoint->resolveAttachmentOverrides(av_string);
 			pJoint->setPosition( LLVector3( 0.0f, 0.0f, 0.0f) );
 		}		
 	}	
 		
-	postPelvisSetRecalc();	
+	mOverridePelvisRecalc = true;
 
     mActiveOverrideMeshes.erase(mesh_id);
     onActiveOverrideMeshesChanged();
+
+	endAttachmentOverrides();
 }
 //-----------------------------------------------------------------------------
 // getCharacterPosition()
@@ -7857,10 +8072,12 @@ const LLViewerJointAttachment *LLVOAvatar::attachObject(LLViewerObject *viewer_o
 
     if (!viewer_object->isAnimatedObject())
     {
-        updateAttachmentOverrides();
+        // Matched up once for all the attachments of the frame, in idleUpdate()
+        mAttachmentOverridesDirty = true;
+        deferAttachmentOverrides();
     }
 
-	updateVisualComplexity();
+	updateAttachmentComplexity(viewer_object);
 
 	if (viewer_object->isSelected())
 	{
@@ -8074,7 +8291,7 @@ BOOL LLVOAvatar::detachObject(LLViewerObject *viewer_object)
 		
 		if (attachment->isObjectAttached(viewer_object))
 		{
-			updateVisualComplexity();
+			updateAttachmentComplexity(viewer_object);
 			vector_replace_with_last(mAttachedObjectsVector,std::make_pair(viewer_object,attachment));
 			bool is_animated_object = viewer_object->isAnimatedObject();
 			cleanupAttachedMesh( viewer_object );
@@ -9817,7 +10034,7 @@ void LLVOAvatar::applyParsedAppearanceMessage(LLAppearanceMessageContents& conte
 
 	if (applyParsedTEMessage(contents.mTEContents) > 0 && isChanged(TEXTURE))
 	{
-		updateVisualComplexity();
+		updateAttachmentComplexity(NULL);
 	}
 
 	// prevent the overwriting of valid baked textures with invalid baked textures
@@ -10813,20 +11030,106 @@ U32 LLVOAvatar::getPartitionType() const
 	return LLViewerRegion::PARTITION_ATTACHMENT;
 }
 
+static LLTrace::BlockTimerStatHandle FTM_IMPOSTOR_UPDATES("Impostor Updates");
+
 //static
 void LLVOAvatar::updateImpostors()
 {
+	LL_RECORD_BLOCK_TIME(FTM_IMPOSTOR_UPDATES);
+
+	static LLCachedControl<F32> budget_ms(gSavedSettings, "RenderImpostorBudgetMs", 2.f);
+
 	LLViewerCamera::sCurCameraID = LLViewerCamera::CAMERA_WORLD;
-	std::vector<LLCharacter*> instances_copy = LLCharacter::sInstances;
-	for (std::vector<LLCharacter*>::iterator iter = instances_copy.begin();
-		iter != instances_copy.end(); ++iter)
+
+	// Rank the impostors waiting for an update by how overdue they are,
+	// relative to their refresh interval, and by their size on screen.
+	typedef std::pair<F32, LLPointer<LLVOAvatar> > ranked_avatar_t;
+	static std::vector<ranked_avatar_t> ranked;
+	ranked.clear();
+	for (std::vector<LLCharacter*>::iterator iter = LLCharacter::sInstances.begin();
+		iter != LLCharacter::sInstances.end(); ++iter)
 	{
 		LLVOAvatar* avatar = (LLVOAvatar*) *iter;
-		if (!avatar->isDead() && avatar->needsImpostorUpdate() && avatar->isVisible() && avatar->isImpostor())
+		if (avatar->isDead() || !avatar->needsImpostorUpdate() || !avatar->isVisible() || !avatar->isImpostor())
+		{
+			continue;
+		}
+
+		F32 priority;
+		if (!avatar->mImpostor.isComplete())
+		{
+			// Nothing to show yet.
+			priority = F32_MAX;
+		}
+		else
+		{
+			F32 staleness = gFrameTimeSeconds - avatar->mLastImpostorUpdateFrameTime;
+			F32 urgency = staleness / avatar->getImpostorRefreshInterval();
+			priority = urgency * sqrtf(llmax(avatar->mImpostorPixelArea, 1.f));
+			if (urgency < 1.f)
+			{
+				++sImpostorsSkipped;
+				continue;
+			}
+		}
+		ranked.push_back(ranked_avatar_t(priority, avatar));
+	}
+	std::stable_sort(ranked.begin(), ranked.end(),
+					 [](const ranked_avatar_t& a, const ranked_avatar_t& b) { return a.first > b.first; });
+
+	LLTimer timer;
+	for (std::vector<ranked_avatar_t>::iterator iter = ranked.begin(); iter != ranked.end(); ++iter)
+	{
+		// Always make progress, and never leave an avatar without impostor.
+		if (iter->first != F32_MAX && sImpostorsRefreshed > 0
+			&& timer.getElapsedTimeF32() * 1000.f >= budget_ms)
+		{
+			sImpostorsSkipped += (U32)(ranked.end() - iter);
+			break;
+		}
+		LLVOAvatar* avatar = iter->second;
+		if (!avatar->isDead())
 		{
 			gPipeline.generateImpostor(avatar);
+			++sImpostorsRefreshed;
 		}
 	}
+	ranked.clear();
+	sImpostorMsec = timer.getElapsedTimeF32() * 1000.f;
+}
+
+//static
+void LLVOAvatar::updateImpostorStats()
+{
+	LLViewerStats* stats = LLViewerStats::getInstance();
+	stats->mImpostorsRefreshedStat.addValue(sImpostorsRefreshed);
+	stats->mImpostorsSkippedStat.addValue(sImpostorsSkipped);
+	stats->mImpostorMsecStat.addValue(sImpostorMsec);
+	sImpostorsRefreshed = 0;
+	sImpostorsSkipped = 0;
+	sImpostorMsec = 0.f;
+}
+
+void LLVOAvatar::updateVisualParamStats()
+{
+	LLViewerStats* stats = LLViewerStats::getInstance();
+	stats->mVisualParamsCheckedStat.addValue(LLCharacter::sVisualParamsChecked);
+	stats->mVisualParamsAppliedStat.addValue(LLCharacter::sVisualParamsApplied);
+	LLCharacter::sVisualParamsChecked = 0;
+	LLCharacter::sVisualParamsApplied = 0;
+}
+
+F32 LLVOAvatar::getImpostorRefreshInterval() const
+{
+	// mUpdatePeriod already grows with the distance and the visibility
+	// rank: from 0.1 second for the nearest impostors to 0.8 for the
+	// background ones. An impostor that moves goes stale sooner.
+	F32 interval = IMPOSTOR_REFRESH_SECONDS * (F32)mUpdatePeriod;
+	if (getVelocity().lengthSquared() > 0.01f)
+	{
+		interval *= 0.5f;
+	}
+	return interval;
 }
 
 BOOL LLVOAvatar::isImpostor() const
@@ -10983,6 +11286,31 @@ void LLVOAvatar::updateVisualComplexity()
 	LL_DEBUGS("AvatarRender") << "avatar " << getID() << " appearance changed" << LL_ENDL;
 	// Set the cache time to in the past so it's updated ASAP
 	mVisualComplexityStale = true;
+	mAttachmentComplexity.clear();
+}
+
+void LLVOAvatar::updateAttachmentComplexity(const LLViewerObject* object)
+{
+	mVisualComplexityStale = true;
+	if (object)
+	{
+		attachment_complexity_map_t::iterator it = mAttachmentComplexity.find(object->getRootEdit()->getID());
+		if (it != mAttachmentComplexity.end())
+		{
+			it->second.mStale = true;
+		}
+	}
+}
+
+LLVOAvatar::AttachmentComplexity::AttachmentComplexity()
+:	mCost(0.f),
+	mHasCost(false),
+	mVisibleTriangles(0),
+	mEstTriangles(0.f),
+	mSurfaceArea(0.f),
+	mStale(true),
+	mPass(0)
+{
 }
 
 // Account for the complexity of a single top-level object associated
@@ -10990,16 +11318,15 @@ void LLVOAvatar::updateVisualComplexity()
 // object.
 void LLVOAvatar::accountRenderComplexityForObject(
 	const LLViewerObject *attached_object,
-	const F32 max_attachment_complexity,
 	LLVOVolume::texture_cost_t& textures,
-	U32& cost/*,
+	AttachmentComplexity& complexity/*,
 	hud_complexity_list_t& hud_complexity_list*/)
 {
 	if (attached_object && !attached_object->isHUDAttachment())
 	{
-		mAttachmentVisibleTriangleCount += attached_object->recursiveGetTriangleCount();
-		mAttachmentEstTriangleCount += attached_object->recursiveGetEstTrianglesMax();
-		mAttachmentSurfaceArea += attached_object->recursiveGetScaledSurfaceArea();
+		complexity.mVisibleTriangles += attached_object->recursiveGetTriangleCount();
+		complexity.mEstTriangles += attached_object->recursiveGetEstTrianglesMax();
+		complexity.mSurfaceArea += attached_object->recursiveGetScaledSurfaceArea();
 
 		textures.clear();
 		const LLDrawable* drawable = attached_object->mDrawable;
@@ -11048,8 +11375,8 @@ void LLVOAvatar::accountRenderComplexityForObject(
 					<< ", " << volume->numChildren()
 					<< " children: " << attachment_children_cost
 					<< LL_ENDL;
-				// Limit attachment complexity to avoid signed integer flipping of the wearer's ACI
-				cost += (U32)llclamp(attachment_total_cost, MIN_ATTACHMENT_COMPLEXITY, max_attachment_complexity);
+				complexity.mCost += attachment_total_cost;
+				complexity.mHasCost = true;
 			}
 		}
 	}
@@ -11061,7 +11388,7 @@ void LLVOAvatar::accountRenderComplexityForObject(
 	{
 		textures.clear();
 
-		mAttachmentSurfaceArea += attached_object->recursiveGetScaledSurfaceArea();
+		complexity.mSurfaceArea += attached_object->recursiveGetScaledSurfaceArea();
 
 #if 0
 		const LLVOVolume* volume = attached_object->mDrawable->getVOVolume();
@@ -11159,6 +11486,12 @@ void LLVOAvatar::calculateUpdateRenderComplexity()
 		mAttachmentEstTriangleCount = 0.f;
 		mAttachmentSurfaceArea = 0.f;
 
+		// Only the objects that changed since the last pass are walked
+		// again; entries of objects no longer there are dropped below.
+		const U32 pass = ++mComplexityPass;
+		U32 recalculated = 0;
+		std::vector<const LLViewerObject*> objects;
+
 		// A standalone animated object needs to be accounted for
 		// using its associated volume. Attached animated objects
 		// will be covered by the subsequent loop over attachments.
@@ -11168,8 +11501,7 @@ void LLVOAvatar::calculateUpdateRenderComplexity()
 			LLVOVolume *volp = control_av->mRootVolp;
 			if (volp && !volp->isAttachment())
 			{
-				accountRenderComplexityForObject(volp, max_attachment_complexity,
-												 textures, cost/*, hud_complexity_list*/);
+				objects.push_back(volp);
 			}
 		}
 
@@ -11190,10 +11522,47 @@ void LLVOAvatar::calculateUpdateRenderComplexity()
 		{{
 				const LLViewerObject* attached_object = iter.first;
 #endif
-				accountRenderComplexityForObject(attached_object, max_attachment_complexity,
-												 textures, cost/*, hud_complexity_list*/);
+				if (attached_object)
+				{
+					objects.push_back(attached_object);
+				}
+			}
+		}
+
+		for (std::vector<const LLViewerObject*>::iterator it = objects.begin(); it != objects.end(); ++it)
+		{
+			AttachmentComplexity& complexity = mAttachmentComplexity[(*it)->getID()];
+			if (complexity.mStale)
+			{
+				complexity = AttachmentComplexity();
+				accountRenderComplexityForObject(*it, textures, complexity/*, hud_complexity_list*/);
+				complexity.mStale = false;
+				++recalculated;
+			}
+			complexity.mPass = pass;
+
+			mAttachmentVisibleTriangleCount += complexity.mVisibleTriangles;
+			mAttachmentEstTriangleCount += complexity.mEstTriangles;
+			mAttachmentSurfaceArea += complexity.mSurfaceArea;
+			if (complexity.mHasCost)
+			{
+				// Limit attachment complexity to avoid signed integer flipping of the wearer's ACI
+				cost += (U32)llclamp(complexity.mCost, MIN_ATTACHMENT_COMPLEXITY, max_attachment_complexity);
+			}
+		}
+
+		for (attachment_complexity_map_t::iterator it = mAttachmentComplexity.begin(); it != mAttachmentComplexity.end(); )
+		{
+			if (it->second.mPass != pass)
+			{
+				it = mAttachmentComplexity.erase(it);
+			}
+			else
+			{
+				++it;
 			}
 		}
+		LL_DEBUGS("ARCdetail") << "Recalculated " << recalculated << " of " << objects.size() << " attachments" << LL_ENDL;
 
 		// Diagnostic output to identify all avatar-related textures.
 		// Does not affect rendering cost calculation.
@@ -274,6 +274,13 @@ public:
 	void					clearAttachmentOverrides();
 	void					rebuildAttachmentOverrides();
 	void					updateAttachmentOverrides();
+	// Override changes between these are resolved once per joint by the
+	// outermost endAttachmentOverrides().
+	void					beginAttachmentOverrides();
+	void					endAttachmentOverrides();
+	// Keeps a batch open until the next idleUpdate(), so that the overrides
+	// of everything attached or loaded in a frame are resolved together.
+	void					deferAttachmentOverrides();
 	void					showAttachmentOverrides(bool verbose = false) const;
 	void					getAttachmentOverrideNames(	std::set<std::string>& pos_names, 
 														std::set<std::string>& scale_names) const;
@@ -287,6 +294,12 @@ public:
 	
     uuid_set_t		mActiveOverrideMeshes;
     virtual void			onActiveOverrideMeshesChanged();
+private:
+	S32						mOverrideBatchDepth;
+	bool					mOverridePelvisRecalc;
+	bool					mOverridesDeferred;			// batch open until idleUpdate()
+	bool					mAttachmentOverridesDirty;	// updateAttachmentOverrides() in idleUpdate()
+public:
     
 	/*virtual*/ const LLUUID&	getID() const;
 	/*virtual*/ void			addDebugText(const std::string& text);
@@ -332,6 +345,22 @@ public:
     void			updateOrientation(LLAgent &agent, F32 speed, F32 delta_time);
     void			updateTimeStep();
     void			updateRootPositionAndRotation(LLAgent &agent, F32 speed, bool was_sit_ground_constrained);
+
+	// In between, updateCharacter() leaves evaluating the motions of other
+	// avatars to LLAnimationPool. endAnimationBatch() evaluates them all at
+	// once, then finishes their idle updates. It also applies the pending
+	// morphs of all avatars on the pool.
+	static void		beginAnimationBatch();
+	static void		endAnimationBatch();
+private:
+	void			finishCharacterUpdate(bool was_sit_ground_constrained);
+	void			idleUpdateAfterCharacter(bool detailed_update);
+
+	bool			mAnimationPending;
+	bool			mPendingSitGroundConstrained;
+	static bool		sAnimationBatch;
+	static std::vector<LLPointer<LLVOAvatar> > sPendingAnimations;
+public:
     
 	void 			idleUpdateVoiceVisualizer(bool voice_enabled);
 	void 			idleUpdateMisc(bool detailed_update);
@@ -350,14 +379,31 @@ public:
 	static void		invalidateNameTags();
 	void			addNameTagLine(const std::string& line, const LLColor4& color, S32 style, const LLFontGL* font);
 	void 			idleUpdateRenderComplexity();
+	// What one attachment, or the volume of an animated object, adds to
+	// the complexity of the avatar. Kept until the object changes.
+	struct AttachmentComplexity
+	{
+		AttachmentComplexity();
+
+		F32		mCost;				// before the MaxAttachmentComplexity clamp
+		bool	mHasCost;
+		U32		mVisibleTriangles;
+		F32		mEstTriangles;
+		F32		mSurfaceArea;
+		bool	mStale;
+		U32		mPass;				// last calculateUpdateRenderComplexity() that used it
+	};
     void 			accountRenderComplexityForObject(const LLViewerObject *attached_object,
-                                                     const F32 max_attachment_complexity,
                                                      LLVOVolume::texture_cost_t& textures,
-                                                     U32& cost/*,
+                                                     AttachmentComplexity& complexity/*,
                                                      hud_complexity_list_t& hud_complexity_list*/);
 	void			calculateUpdateRenderComplexity();
 	static const U32 VISUAL_COMPLEXITY_UNKNOWN;
+	// Recalculates everything.
 	void			updateVisualComplexity();
+	// Only recalculates what object, any prim of an attachment, adds. NULL
+	// when only the avatar's own textures changed.
+	void			updateAttachmentComplexity(const LLViewerObject* object);
 
 	U32				getVisualComplexity()			{ return mVisualComplexity;				};		// Numbers calculated here by rendering AV
 	F32				getAttachmentSurfaceArea()		{ return mAttachmentSurfaceArea;		};		// estimated surface area of attachments
@@ -517,6 +563,10 @@ private:
 	// the isTooComplex method uses these mutable values to avoid recalculating too frequently
 	mutable U32  mVisualComplexity;
 	mutable bool mVisualComplexityStale;
+	// keyed by the ID of the root prim
+	typedef std::map<LLUUID, AttachmentComplexity> attachment_complexity_map_t;
+	attachment_complexity_map_t mAttachmentComplexity;
+	U32			 mComplexityPass;
 	U32			 mReportedVisualComplexity; // from other viewers through the simulator
 
 	//--------------------------------------------------------------------
@@ -574,7 +624,16 @@ public:
 	void 		cacheImpostorValues();
 	void 		setImpostorDim(const LLVector2& dim);
 	static void	resetImpostors();
+	// Regenerates the impostors that need it within RenderImpostorBudgetMs,
+	// most overdue and largest on screen first.
 	static void updateImpostors();
+	// Once per frame, passes the counts of updateImpostors() to LLViewerStats.
+	static void updateImpostorStats();
+	// Once per frame, passes the LLCharacter::updateVisualParams() counts
+	// to LLViewerStats.
+	static void updateVisualParamStats();
+	// Minimum time between two regenerations of this impostor.
+	F32			getImpostorRefreshInterval() const;
 	LLRenderTarget mImpostor;
 	BOOL		mNeedsImpostorUpdate;
 	F32SecondsImplicit mLastImpostorUpdateFrameTime;
@@ -592,6 +651,11 @@ private:
 	LLVector3	mLastAnimExtents[2];  
 	LLVector3	mLastAnimBasePos;
 
+	// updateImpostors() counts since the last updateImpostorStats()
+	static U32	sImpostorsRefreshed;
+	static U32	sImpostorsSkipped;
+	static F32	sImpostorMsec;
+
 	//--------------------------------------------------------------------
 	// Wind rippling in clothes
 	//--------------------------------------------------------------------
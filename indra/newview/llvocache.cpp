@@ -176,6 +176,50 @@ LLDataPackerBinaryBuffer *LLVOCacheEntry::getDP(U32 crc)
 	return &mDP;
 }
 
+// Peeks at the placement stored in the cached update, even when its CRC is
+// stale. Used to prioritize cache misses before the fresh update arrives.
+BOOL LLVOCacheEntry::getPlacement(LLVector3& pos, LLVector3& scale, U32& parent_id)
+{
+	if (mDP.getBufferSize() == 0)
+	{
+		return FALSE;
+	}
+
+	LLUUID id;
+	U32 local_id, crc, special_code;
+	U8 pcode, state, material, click_action;
+	LLVector3 rot;
+
+	// Same layout as the OUT_FULL_COMPRESSED branch of
+	// LLViewerObject::processUpdateMessage().
+	mDP.reset();
+	BOOL success = mDP.unpackUUID(id, "ID") &&
+				   mDP.unpackU32(local_id, "LocalID") &&
+				   mDP.unpackU8(pcode, "PCode") &&
+				   mDP.unpackU8(state, "State") &&
+				   mDP.unpackU32(crc, "CRC") &&
+				   mDP.unpackU8(material, "Material") &&
+				   mDP.unpackU8(click_action, "ClickAction") &&
+				   mDP.unpackVector3(scale, "Scale") &&
+				   mDP.unpackVector3(pos, "Pos") &&
+				   mDP.unpackVector3(rot, "Rot") &&
+				   mDP.unpackU32(special_code, "SpecialCode") &&
+				   mDP.unpackUUID(id, "Owner");
+
+	parent_id = 0;
+	if (success && (special_code & 0x80))
+	{
+		LLVector3 omega;
+		success = mDP.unpackVector3(omega, "Omega");
+	}
+	if (success && (special_code & 0x20))
+	{
+		success = mDP.unpackU32(parent_id, "ParentID");
+	}
+	mDP.reset();
+
+	return success;
+}
 
 void LLVOCacheEntry::recordHit()
 {
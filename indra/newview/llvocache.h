@@ -37,6 +37,8 @@
 #include "lldatapacker.h"
 #include "lldir.h"
 
+class LLAPRFile;
+
 
 //---------------------------------------------------------------------------
 // Cache entries
@@ -59,6 +61,7 @@ public:
 	BOOL writeToFile(LLAPRFile* apr_file) const;
 	void assignCRC(U32 crc, LLDataPackerBinaryBuffer &dp);
 	LLDataPackerBinaryBuffer *getDP(U32 crc);
+	BOOL getPlacement(LLVector3& pos, LLVector3& scale, U32& parent_id);
 	void recordHit();
 	void recordDupe() { mDupeCount++; }
 
@@ -1141,12 +1141,12 @@ void LLVOVolume::updateVisualComplexity()
     LLVOAvatar* avatar = getAvatarAncestor();
     if (avatar)
     {
-        avatar->updateVisualComplexity();
+        avatar->updateAttachmentComplexity(this);
     }
     LLVOAvatar* rigged_avatar = getAvatar();
     if(rigged_avatar && (rigged_avatar != avatar))
     {
-        rigged_avatar->updateVisualComplexity();
+        rigged_avatar->updateAttachmentComplexity(this);
     }
 }
 
@@ -1157,10 +1157,12 @@ void LLVOVolume::notifyMeshLoaded()
 
     if (getAvatar() && !isAnimatedObject())
     {
+        getAvatar()->deferAttachmentOverrides();
         getAvatar()->addAttachmentOverridesForObject(this);
     }
     if (getControlAvatar() && isAnimatedObject())
     {
+        getControlAvatar()->deferAttachmentOverrides();
         getControlAvatar()->addAttachmentOverridesForObject(this);
     }
     updateVisualComplexity();
@@ -1751,7 +1753,8 @@ bool LLVOVolume::lodOrSculptChanged(LLDrawable *drawable, BOOL &compiled)
 
 		if ((new_lod != old_lod) || mSculptChanged)
 		{
-        if (mDrawable->isState(LLDrawable::RIGGED))
+        // Attached prims are cached per attachment, rigged or not
+        if (mDrawable->isState(LLDrawable::RIGGED) || getAvatarAncestor())
         {
             updateVisualComplexity();
         }
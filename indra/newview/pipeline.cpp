@@ -1806,6 +1806,8 @@ void LLPipeline::resetFrameStats()
 	sCompiles = 0;
 
 	LLViewerStats::getInstance()->mTrianglesDrawnStat.addValue(mTrianglesDrawn/1000.f);
+	LLVOAvatar::updateImpostorStats();
+	LLVOAvatar::updateVisualParamStats();
 
 	if (mBatchCount > 0)
 	{
@@ -0,0 +1,328 @@
+/**
+ * @file llanimationpool_tut.cpp
+ * @brief Deferred, pooled evaluation of character motions.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include <vector>
+
+#include "linden_common.h"
+#include "llanimationpool.h"
+#include "llcharacter.h"
+#include "lldatapacker.h"
+#include "llformat.h"
+#include "llframetimer.h"
+#include "llkeyframemotion.h"
+#include "llrand.h"
+#include "lltimer.h"
+#include "lltut.h"
+
+namespace tut
+{
+	// A bare skeleton: a pelvis with a few chains of joints below it.
+	class TestCharacter : public LLCharacter
+	{
+	public:
+		enum { CHAINS = 4, CHAIN_LENGTH = 10 };
+
+		TestCharacter()
+		{
+			mID.generate();
+			LLJoint* root = new LLJoint("mPelvis");
+			root->setJointNum(0);
+			mJoints.push_back(root);
+			for (S32 chain = 0; chain < CHAINS; ++chain)
+			{
+				LLJoint* parent = root;
+				for (S32 link = 0; link < CHAIN_LENGTH; ++link)
+				{
+					LLJoint* joint = new LLJoint(llformat("mJoint%d_%d", chain, link), parent);
+					joint->setJointNum((S32)mJoints.size());
+					joint->setPosition(LLVector3(0.f, 0.f, 0.1f));
+					mJoints.push_back(joint);
+					parent = joint;
+				}
+			}
+		}
+
+		~TestCharacter()
+		{
+			// The active motions and the pose blender point to the joints.
+			deactivateAllMotions();
+			for (std::vector<LLJoint*>::reverse_iterator it = mJoints.rbegin(); it != mJoints.rend(); ++it)
+			{
+				delete *it;
+			}
+		}
+
+		const std::vector<LLJoint*>& getJoints() const	{ return mJoints; }
+
+		/*virtual*/ const char* getAnimationPrefix()		{ return "avatar"; }
+		/*virtual*/ LLJoint* getRootJoint()					{ return mJoints[0]; }
+		/*virtual*/ LLVector3 getCharacterPosition()		{ return LLVector3::zero; }
+		/*virtual*/ LLQuaternion getCharacterRotation()	{ return LLQuaternion::DEFAULT; }
+		/*virtual*/ LLVector3 getCharacterVelocity()		{ return LLVector3::zero; }
+		/*virtual*/ LLVector3 getCharacterAngularVelocity()	{ return LLVector3::zero; }
+		/*virtual*/ void getGround(const LLVector3& in_pos, LLVector3& out_pos, LLVector3& out_norm)
+		{
+			out_pos = in_pos;
+			out_pos.mV[VZ] = 0.f;
+			out_norm = LLVector3::z_axis;
+		}
+		/*virtual*/ LLJoint* getCharacterJoint(U32 i)		{ return i < mJoints.size() ? mJoints[i] : NULL; }
+		/*virtual*/ F32 getTimeDilation()					{ return 1.f; }
+		/*virtual*/ F32 getPixelArea() const				{ return 1000000.f; }
+		/*virtual*/ LLPolyMesh* getHeadMesh()				{ return NULL; }
+		/*virtual*/ LLPolyMesh* getUpperBodyMesh()			{ return NULL; }
+		/*virtual*/ LLVector3d getPosGlobalFromAgent(const LLVector3& position)	{ return LLVector3d(position); }
+		/*virtual*/ LLVector3 getPosAgentFromGlobal(const LLVector3d& position)	{ return LLVector3(position); }
+		/*virtual*/ void addDebugText(const std::string& text) {}
+		/*virtual*/ const LLUUID& getID() const				{ return mID; }
+
+	private:
+		LLUUID					mID;
+		std::vector<LLJoint*>	mJoints;
+	};
+
+	// Decodes an animation into LLKeyframeDataCache, where it stays for as
+	// long as this object lives.
+	class CachedAnimation : public LLKeyframeMotion
+	{
+	public:
+		CachedAnimation(const LLUUID& id, LLCharacter* character)
+		:	LLKeyframeMotion(id, NULL)
+		{
+			mCharacter = character;
+		}
+
+		bool load(std::vector<U8>& buffer)
+		{
+			LLDataPackerBinaryBuffer dp(&buffer[0], (S32)buffer.size());
+			return deserialize(dp, getID());
+		}
+	};
+
+	struct animationpool_data
+	{
+		enum { ANIMATIONS = 4, KEYS = 12 };
+
+		TestCharacter mModel;
+		std::vector<CachedAnimation*> mAnimations;
+
+		animationpool_data()
+		{
+			for (S32 i = 0; i < ANIMATIONS; ++i)
+			{
+				LLUUID id;
+				id.generate();
+				std::vector<U8> buffer = makeAnimation(i);
+				CachedAnimation* animation = new CachedAnimation(id, &mModel);
+				ensure("animation decodes", animation->load(buffer));
+				mAnimations.push_back(animation);
+			}
+		}
+
+		~animationpool_data()
+		{
+			for (std::vector<CachedAnimation*>::iterator it = mAnimations.begin(); it != mAnimations.end(); ++it)
+			{
+				delete *it;
+			}
+			LLAnimationPool::cleanupClass();
+		}
+
+		// A looping animation of every joint in the .anim format, with
+		// random rotations and positions.
+		std::vector<U8> makeAnimation(S32 seed)
+		{
+			const S32 joint_count = (S32)mModel.getJoints().size();
+			std::vector<U8> buffer(256 + joint_count * (64 + KEYS * 16));
+			LLDataPackerBinaryBuffer dp(&buffer[0], (S32)buffer.size());
+			dp.packU16(1, "version");
+			dp.packU16(0, "sub_version");
+			dp.packS32(2, "base_priority");
+			dp.packF32(2.f + seed, "duration");
+			dp.packString(std::string(), "emote_name");
+			dp.packF32(0.f, "loop_in_point");
+			dp.packF32(2.f + seed, "loop_out_point");
+			dp.packS32(1, "loop");
+			dp.packF32(0.3f, "ease_in_duration");
+			dp.packF32(0.3f, "ease_out_duration");
+			dp.packU32(1, "hand_pose");
+			dp.packU32(joint_count, "num_joints");
+			for (S32 j = 0; j < joint_count; ++j)
+			{
+				dp.packString(mModel.getJoints()[j]->getName(), "joint_name");
+				dp.packS32(seed, "joint_priority");
+				for (S32 curve = 0; curve < 2; ++curve)
+				{
+					dp.packS32(KEYS, "num_keys");
+					for (S32 k = 0; k < KEYS; ++k)
+					{
+						dp.packU16((U16)(k * 65535 / (KEYS - 1)), "time");
+						dp.packU16((U16)(ll_rand() & 0xffff), "x");
+						dp.packU16((U16)(ll_rand() & 0xffff), "y");
+						dp.packU16((U16)(ll_rand() & 0xffff), "z");
+					}
+				}
+			}
+			dp.packS32(0, "num_constraints");
+			buffer.resize(dp.getCurrentSize());
+			return buffer;
+		}
+
+		void startAnimations(std::vector<TestCharacter*>& characters)
+		{
+			for (std::vector<TestCharacter*>::iterator it = characters.begin(); it != characters.end(); ++it)
+			{
+				for (std::vector<CachedAnimation*>::iterator anim = mAnimations.begin(); anim != mAnimations.end(); ++anim)
+				{
+					(*it)->startMotion((*anim)->getID());
+				}
+			}
+		}
+
+		// One frame the way LLVOAvatar::updateCharacter() did it.
+		static void updateImmediate(std::vector<TestCharacter*>& characters)
+		{
+			for (std::vector<TestCharacter*>::iterator it = characters.begin(); it != characters.end(); ++it)
+			{
+				(*it)->updateMotions(LLCharacter::NORMAL_UPDATE);
+				(*it)->getRootJoint()->updateWorldMatrixChildren();
+			}
+		}
+
+		// One frame as an LLVOAvatar animation batch.
+		static void updateDeferred(std::vector<TestCharacter*>& characters)
+		{
+			std::vector<LLCharacter*> batch;
+			for (std::vector<TestCharacter*>::iterator it = characters.begin(); it != characters.end(); ++it)
+			{
+				(*it)->updateMotions(LLCharacter::NORMAL_UPDATE, true);
+				if ((*it)->isEvaluationPending())
+				{
+					batch.push_back(*it);
+				}
+			}
+			LLAnimationPool::evaluate(batch);
+		}
+
+		static void deleteAll(std::vector<TestCharacter*>& characters)
+		{
+			for (std::vector<TestCharacter*>::iterator it = characters.begin(); it != characters.end(); ++it)
+			{
+				delete *it;
+			}
+			characters.clear();
+		}
+	};
+	typedef test_group<animationpool_data> animationpool_test;
+	typedef animationpool_test::object animationpool_object;
+	tut::animationpool_test animationpool_testcase("animation_pool");
+
+	template<> template<>
+	void animationpool_object::test<1>()
+	{
+		// The pool computes the same poses as the serial update.
+		LLAnimationPool::initClass(3);
+
+		std::vector<TestCharacter*> serial, pooled;
+		for (S32 i = 0; i < 8; ++i)
+		{
+			serial.push_back(new TestCharacter);
+			pooled.push_back(new TestCharacter);
+		}
+		startAnimations(serial);
+		startAnimations(pooled);
+
+		for (S32 frame = 0; frame < 20; ++frame)
+		{
+			ms_sleep(10);
+			LLFrameTimer::updateFrameTime();
+			updateImmediate(serial);
+			updateDeferred(pooled);
+
+			for (size_t c = 0; c < serial.size(); ++c)
+			{
+				ensure("evaluation done", !pooled[c]->isEvaluationPending());
+				const std::vector<LLJoint*>& expected = serial[c]->getJoints();
+				const std::vector<LLJoint*>& actual = pooled[c]->getJoints();
+				for (size_t j = 0; j < expected.size(); ++j)
+				{
+					ensure("same joint matrix",
+						   !memcmp(expected[j]->getWorldMatrix().getF32ptr(),
+								   actual[j]->getWorldMatrix().getF32ptr(), sizeof(LLMatrix4a)));
+				}
+			}
+		}
+		ensure("poses were animated", !serial[0]->getJoints()[1]->getRotation().isIdentity());
+
+		deleteAll(serial);
+		deleteAll(pooled);
+	}
+
+	template<> template<>
+	void animationpool_object::test<2>()
+	{
+		// Stopping, removing or deleting motions with an evaluation pending.
+		std::vector<TestCharacter*> characters;
+		for (S32 i = 0; i < 3; ++i)
+		{
+			characters.push_back(new TestCharacter);
+		}
+		startAnimations(characters);
+		for (S32 frame = 0; frame < 3; ++frame)
+		{
+			ms_sleep(10);
+			LLFrameTimer::updateFrameTime();
+			updateDeferred(characters);
+		}
+
+		ms_sleep(10);
+		LLFrameTimer::updateFrameTime();
+		for (std::vector<TestCharacter*>::iterator it = characters.begin(); it != characters.end(); ++it)
+		{
+			(*it)->updateMotions(LLCharacter::NORMAL_UPDATE, true);
+			ensure("evaluation pending", (*it)->isEvaluationPending());
+		}
+
+		// Finished by the next update.
+		characters[0]->stopMotion(mAnimations[0]->getID(), TRUE);
+		characters[0]->updateMotions(LLCharacter::NORMAL_UPDATE);
+		ensure("finished by the update", !characters[0]->isEvaluationPending());
+
+		// Dropped with the motions.
+		characters[1]->removeMotion(mAnimations[1]->getID());
+		characters[1]->flushAllMotions();
+		ensure("dropped by the flush", !characters[1]->isEvaluationPending());
+
+		// Evaluated without the removed motion.
+		characters[2]->removeMotion(mAnimations[2]->getID());
+		characters[2]->evaluateMotions();
+		ensure("evaluated", !characters[2]->isEvaluationPending());
+
+		deleteAll(characters);
+	}
+}
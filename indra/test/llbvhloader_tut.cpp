@@ -0,0 +1,334 @@
+/**
+ * @file llbvhloader_tut.cpp
+ * @brief LLBVHLoader tests against the output of the line by line loader.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llbvhloader.h"
+#include "lldatapacker.h"
+#include "lldir.h"
+#include "llfile.h"
+#include "llmd5.h"
+#include "lltut.h"
+
+namespace tut
+{
+	// Written to the app settings directory for the loader to read. Besides
+	// the usual joint frames it has the root output as mPelvis relative to
+	// the first key, an ignored joint, an ignored joint merged with from both
+	// sides, an offset matrix and global settings, all of which go into the
+	// output.
+	static const char* TRANSLATIONS = "bvhloader_test.ini";
+	static const char* TRANSLATION_TABLE =
+		"Translations 1.0\n"
+		"\n"
+		"[GLOBALS]\n"
+		"\tpriority = 3\n"
+		"\teasein = 0.5 sec\n"
+		"\teaseout = 0.8 sec\n"
+		"\thand = 1\n"
+		"\n"
+		"[hip]\n"
+		"\trelativepos = firstkey\n"
+		"\trelativerot = firstkey\n"
+		"\toutname = mPelvis\n"
+		"\tframe = 0 1 0, 0 0 1, 1 0 0\n"
+		"\n"
+		"[abdomen]\n"
+		"\toutname = mTorso\n"
+		"\tmergechild = chest\n"
+		"\tframe = 0 1 0, 0 0 1, 1 0 0\n"
+		"\n"
+		"[chest]\n"
+		"\tignore = true\n"
+		"\tframe = 0 1 0, 0 0 1, 1 0 0\n"
+		"\n"
+		"[neck]\n"
+		"\toutname = mNeck\n"
+		"\tmergeparent = chest\n"
+		"\tframe = 0 1 0, 0 0 1, 1 0 0\n"
+		"\n"
+		"# Not merged with, so left out altogether\n"
+		"[head]\n"
+		"\tignore = true\n"
+		"\tframe = 0 1 0, 0 0 1, 1 0 0\n"
+		"\n"
+		"[lCollar]\n"
+		"\toutname = mCollarLeft\n"
+		"\tframe = 0 1 0, 0 0 1, 1 0 0\n"
+		"\n"
+		"[lShldr]\n"
+		"\toutname = mShoulderLeft\n"
+		"\tframe = 0 1 0, 0 0 1, 1 0 0\n"
+		"\toffset = 1 0 0, 0 0 1, 0 -1 0\n"
+		"\n"
+		"[lForeArm]\n"
+		"\toutname = mElbowLeft\n"
+		"\trelativerot = firstkey\n"
+		"\tframe = 0 1 0, 0 0 1, 1 0 0\n";
+
+	struct bvhloader_data
+	{
+		bvhloader_data()
+		:	mSettingsDir(gDirUtilp->getExpandedFilename(LL_PATH_APP_SETTINGS, "")),
+			mCreatedDir(false)
+		{
+			if (!LLFile::isdir(mSettingsDir))
+			{
+				mCreatedDir = LLFile::mkdir(mSettingsDir) == 0;
+			}
+			LLFILE* fp = LLFile::fopen(gDirUtilp->getExpandedFilename(LL_PATH_APP_SETTINGS, TRANSLATIONS), "wb");
+			if (fp)
+			{
+				fputs(TRANSLATION_TABLE, fp);
+				LLFile::close(fp);
+			}
+		}
+
+		~bvhloader_data()
+		{
+			LLFile::remove_nowarn(gDirUtilp->getExpandedFilename(LL_PATH_APP_SETTINGS, TRANSLATIONS));
+			if (mCreatedDir)
+			{
+				LLFile::rmdir(mSettingsDir);
+			}
+		}
+
+		std::string mSettingsDir;
+		bool mCreatedDir;
+
+		struct Corpus
+		{
+			const char*	mName;
+			const char*	mOrders;	// one rotation order per joint
+			S32			mFrames;
+			const char*	mEOL;
+			const char*	mSeparator;
+			bool		mBlankLines;
+			bool		mMoving;
+			// What the loader that tokenized the file line by line and
+			// converted the keys one at a time wrote for the same file.
+			S32			mSize;
+			const char*	mDigest;
+		};
+
+		// A triangle wave between -20 and 20 with a period of 4000 / speed
+		// frames, exact in three decimals so the text is the same everywhere.
+		static F64 wave(S32 frame, S32 speed, S32 phase)
+		{
+			S32 v = (frame * speed * 10 + phase) % 4000;
+			return (F64)((v < 2000 ? v : 4000 - v) - 1000) / 50.0;
+		}
+
+		static std::string makeBVH(const Corpus& corpus)
+		{
+			static const char* names[] = { "hip", "abdomen", "chest", "neck", "head", "lCollar", "lShldr", "lForeArm" };
+			static const S32 parents[] = { -1, 0, 1, 2, 3, 2, 5, 6 };
+			const S32 joints = (S32)strlen(corpus.mOrders) / 3;
+			const std::string eol(corpus.mEOL);
+
+			std::string bvh = "HIERARCHY" + eol;
+			std::vector<S32> open;
+			for (S32 j = 0; j < joints; ++j)
+			{
+				while (!open.empty() && open.back() != parents[j])
+				{
+					open.pop_back();
+					bvh += std::string(open.size(), '\t') + "}" + eol;
+				}
+				const std::string indent(open.size(), '\t');
+				bvh += indent + (j ? "JOINT " : "ROOT ") + names[j] + eol;
+				bvh += indent + "{" + eol;
+				bvh += indent + llformat("\tOFFSET %.2f %.2f %.2f", 0.5f * j, 2.f + j, -0.25f * j) + eol;
+				const char* order = corpus.mOrders + 3 * j;
+				std::string channels = j ? "\tCHANNELS 3" : "\tCHANNELS 6 Xposition Yposition Zposition";
+				for (S32 i = 0; i < 3; ++i)
+				{
+					channels += llformat(" %crotation", order[i]);
+				}
+				bvh += indent + channels + eol;
+				if (j + 1 == joints || parents[j + 1] != j)
+				{
+					bvh += indent + "\tEnd Site" + eol;
+					bvh += indent + "\t{" + eol;
+					bvh += indent + "\t\tOFFSET 0.00 1.00 0.00" + eol;
+					bvh += indent + "\t}" + eol;
+				}
+				open.push_back(j);
+			}
+			while (!open.empty())
+			{
+				open.pop_back();
+				bvh += std::string(open.size(), '\t') + "}" + eol;
+			}
+
+			bvh += "MOTION" + eol;
+			bvh += llformat("Frames: %d", corpus.mFrames) + eol;
+			bvh += "Frame Time: 0.033333" + eol;
+			for (S32 f = 0; f < corpus.mFrames; ++f)
+			{
+				S32 t = corpus.mMoving ? f : 0;
+				std::string line = llformat("%.3f%s%.3f%s%.3f", wave(t, 3, 0) * 0.5, corpus.mSeparator,
+											40.0 + wave(t, 5, 700) * 0.1, corpus.mSeparator, wave(t, 2, 1300) * 0.2);
+				for (S32 j = 0; j < joints; ++j)
+				{
+					for (S32 i = 0; i < 3; ++i)
+					{
+						line += corpus.mSeparator + llformat("%.3f", 5.0 * i + wave(t, j + i + 2, 1000 * i) * 2.0);
+					}
+				}
+				bvh += line + eol;
+				if (corpus.mBlankLines)
+				{
+					bvh += eol;
+				}
+			}
+			return bvh;
+		}
+
+		// Goes through the steps of the loader constructor, with the test
+		// translation table in place of anim.ini.
+		static ELoadStatus load(const std::string& bvh, S32& size, std::string& digest,
+								LLBVHProgress* progress = NULL)
+		{
+			ELoadStatus status = E_ST_OK;
+			S32 line = 0;
+			LLBVHLoader loader(bvh.c_str(), status, line, progress);
+			status = loader.loadTranslationTable(TRANSLATIONS);
+			if (status != E_ST_OK)
+			{
+				return status;
+			}
+
+			char error_text[128];		/* Flawfinder: ignore */
+			status = loader.loadBVHFile(bvh.c_str(), error_text, line);
+			if (status != E_ST_OK)
+			{
+				return status;
+			}
+			loader.applyTranslations();
+			loader.optimize();
+
+			size = loader.getOutputSize();
+			std::vector<U8> buffer(size);
+			LLDataPackerBinaryBuffer dp(&buffer[0], size);
+			loader.serialize(dp);
+
+			LLMD5 md5;
+			md5.update(&buffer[0], size);
+			md5.finalize();
+			char hex[33];		/* Flawfinder: ignore */
+			md5.hex_digest(hex);
+			digest = hex;
+			return status;
+		}
+	};
+	typedef test_group<bvhloader_data> bvhloader_test;
+	typedef bvhloader_test::object bvhloader_object;
+	tut::bvhloader_test bvhloader_testcase("bvhloader");
+
+	template<> template<>
+	void bvhloader_object::test<1>()
+	{
+		// The corpus comes out byte for byte as before.
+		static const Corpus corpus[] =
+		{
+			{ "basic", "ZXYZXYZXYZXYZXYZXY", 30, "\n", " ", false, true, 438, "7e626712d83e6392913057ecb618f67b" },
+			{ "orders", "XYZYZXZXYXZYYXZZYXXYZZXY", 60, "\r\n", "\t", false, true, 1215, "5d1d37940f9dfb798be53f8803b4a3b5" },
+			{ "blank lines", "ZYXZYXZYXZYXZYX", 45, "\n", "  ", true, true, 358, "5b2616cd9b546d757a757a51ed716cf2" },
+			{ "single frame", "ZXYZXYZXYZXY", 1, "\n", " ", false, true, 134, "094b019d42b76be813e262ae64a58dd7" },
+			{ "still", "ZXYZXYZXY", 20, "\n", " ", false, false, 45, "ea6e6f5d2d5d8e51aa38455f2881ee72" },
+			{ "long", "ZXYZXYZXYZXYZXYZXYZXYZXY", 3000, "\r\n", " ", false, true, 51087, "a60e047852e30a6cdf89deb480614008" },
+		};
+
+		for (size_t i = 0; i < LL_ARRAY_SIZE(corpus); ++i)
+		{
+			S32 size = 0;
+			std::string digest;
+			ELoadStatus status = load(makeBVH(corpus[i]), size, digest);
+			ensure_equals(std::string(corpus[i].mName) + " status", status, E_ST_OK);
+			ensure_equals(std::string(corpus[i].mName) + " size", size, corpus[i].mSize);
+			ensure_equals(std::string(corpus[i].mName) + " output", digest, std::string(corpus[i].mDigest));
+		}
+	}
+
+	template<> template<>
+	void bvhloader_object::test<2>()
+	{
+		// Broken files fail the way they did.
+		const Corpus base = { "base", "ZXYZXYZXY", 10, "\n", " ", false, true, 0, "" };
+		const std::string bvh = makeBVH(base);
+		S32 size = 0;
+		std::string digest;
+
+		ensure_equals("no hierarchy", load("MOTION\n" + bvh, size, digest), E_ST_NO_HIER);
+
+		std::string bad_root = bvh;
+		bad_root.replace(bad_root.find("hip"), 3, "pelvis");
+		ensure_equals("bad root", load(bad_root, size, digest), E_ST_BAD_ROOT);
+
+		std::string no_axis = bvh;
+		no_axis.replace(no_axis.find("Zrotation"), 1, "Q");
+		ensure_equals("no axis", load(no_axis, size, digest), E_ST_NO_AXIS);
+
+		std::string no_frames = bvh;
+		no_frames.replace(no_frames.find("Frames: 10"), 10, "Frames: many");
+		ensure_equals("no frames", load(no_frames, size, digest), E_ST_NO_FRAMES);
+
+		// Fewer lines than frames
+		std::string truncated = bvh.substr(0, bvh.rfind('\n', bvh.size() - 2) + 1);
+		ensure_equals("truncated", load(truncated, size, digest), E_ST_EOF);
+
+		// A frame that misses its last rotation
+		std::string short_frame = bvh;
+		size_t last = short_frame.rfind(' ');
+		short_frame.erase(last, short_frame.size() - 1 - last);
+		ensure_equals("short frame", load(short_frame, size, digest), E_ST_NO_ROT);
+
+		std::string short_root = bvh;
+		size_t frame = short_root.find("0.033333\n") + 9;
+		short_root.replace(frame, short_root.find('\n', frame) - frame, "1.0 2.0");
+		ensure_equals("short root", load(short_root, size, digest), E_ST_NO_POS);
+	}
+
+	template<> template<>
+	void bvhloader_object::test<3>()
+	{
+		// Progress is reported up to serializing, and a cancelled load fails.
+		const Corpus base = { "base", "ZXYZXYZXY", 1000, "\n", " ", false, true, 0, "" };
+		const std::string bvh = makeBVH(base);
+		S32 size = 0;
+		std::string digest;
+
+		LLBVHProgress progress;
+		ensure_equals("loaded", load(bvh, size, digest, &progress), E_ST_OK);
+		ensure("progress", progress.mFraction > 0.5f && progress.mFraction < 1.f);
+
+		LLBVHProgress cancelled;
+		cancelled.mCancel = true;
+		ensure_equals("cancelled", load(bvh, size, digest, &cancelled), E_ST_EOF);
+	}
+}
@@ -0,0 +1,226 @@
+/**
+ * @file llimagecompositor_tut.cpp
+ * @brief LLImageCompositor tests against the blend equations.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llimagecompositor.h"
+#include "lltimer.h"
+#include "lltut.h"
+
+namespace tut
+{
+	struct imagecompositor_data
+	{
+		// The blend equations in floats, rounded at the end.
+		static U8 reference(LLImageCompositor::EBlend blend, const U8* dst, const U8* src,
+							const LLColor4U& color, S32 c)
+		{
+			F32 s[4];
+			for (S32 i = 0; i < 4; ++i)
+			{
+				s[i] = (src ? src[i] / 255.f : 1.f) * color.mV[i] / 255.f;
+			}
+			// Round the modulated color the way the blender sees it
+			for (S32 i = 0; i < 4; ++i)
+			{
+				s[i] = ll_round(s[i] * 255.f) / 255.f;
+			}
+			const F32 d = dst[c] / 255.f;
+			const F32 d_alpha = dst[3] / 255.f;
+			F32 n = 0.f;
+			switch (blend)
+			{
+			case LLImageCompositor::BLEND_ALPHA:
+				n = s[c] * s[3] + d * (1.f - s[3]);
+				break;
+			case LLImageCompositor::BLEND_DEST_ALPHA:
+				n = s[c] * d_alpha + d * (1.f - d_alpha);
+				break;
+			case LLImageCompositor::BLEND_REPLACE:
+				n = s[c];
+				break;
+			case LLImageCompositor::BLEND_ADD:
+				n = llmin(s[c] + d, 1.f);
+				break;
+			case LLImageCompositor::BLEND_MULT_ALPHA:
+				n = s[c] * d_alpha;
+				break;
+			}
+			return (U8)ll_round(n * 255.f);
+		}
+
+		static U8 random_byte(U32& seed)
+		{
+			seed = seed * 1103515245 + 12345;
+			return (U8)(seed >> 16);
+		}
+	};
+	typedef test_group<imagecompositor_data> imagecompositor_test;
+	typedef imagecompositor_test::object imagecompositor_object;
+	tut::imagecompositor_test imagecompositor_testcase("imagecompositor");
+
+	template<> template<>
+	void imagecompositor_object::test<1>()
+	{
+		// Every kernel, with and without an image, alpha test and color
+		// mask, over a length that leaves a scalar tail.
+		const S32 pixels = 67;
+		U32 seed = 1;
+		std::vector<U8> src(pixels * 4), dst(pixels * 4), out;
+		for (S32 i = 0; i < pixels * 4; ++i)
+		{
+			src[i] = random_byte(seed);
+			dst[i] = random_byte(seed);
+		}
+		// A few fragments at the alpha test threshold
+		src[3] = 0;
+		src[7] = 1;
+		src[11] = 2;
+		const LLColor4U color(200, 255, 17, 230);
+
+		for (S32 blend = LLImageCompositor::BLEND_ALPHA; blend <= LLImageCompositor::BLEND_MULT_ALPHA; ++blend)
+		{
+			for (S32 flags = 0; flags < 8; ++flags)
+			{
+				const bool with_image = flags & 1;
+				const bool alpha_test = flags & 2;
+				const bool alpha_only = flags & 4;
+				const U8* src_data = with_image ? &src[0] : NULL;
+				const LLColor4U& op_color = with_image ? color : LLColor4U(10, 20, 30, (U8)(flags & 2 ? 1 : 77));
+
+				out = dst;
+				LLImageCompositor::blendRow((LLImageCompositor::EBlend)blend, &out[0], src_data, op_color,
+											pixels, alpha_test, alpha_only);
+				for (S32 p = 0; p < pixels; ++p)
+				{
+					const U8* d = &dst[p * 4];
+					const U8* s = src_data ? src_data + p * 4 : NULL;
+					const U8 s_alpha = (U8)ll_round((s ? s[3] : 255) * op_color.mV[3] / 255.f);
+					const bool dropped = alpha_test && s_alpha < 2;
+					for (S32 c = 0; c < 4; ++c)
+					{
+						U8 expected = d[c];
+						if (!dropped && (!alpha_only || c == 3))
+						{
+							expected = reference((LLImageCompositor::EBlend)blend, d, s, op_color, c);
+						}
+						const S32 diff = llabs((S32)out[p * 4 + c] - (S32)expected);
+						ensure(llformat("blend %d flags %d pixel %d channel %d: %d, expected %d",
+										blend, flags, p, c, out[p * 4 + c], expected), diff <= 1);
+					}
+				}
+			}
+		}
+	}
+
+	template<> template<>
+	void imagecompositor_object::test<2>()
+	{
+		// The alpha mask gathering is exact.
+		const S32 count = 1000;
+		U32 seed = 7;
+		std::vector<U8> data(count), mask(count), out;
+		for (S32 i = 0; i < count; ++i)
+		{
+			data[i] = random_byte(seed);
+			mask[i] = random_byte(seed);
+		}
+		mask[0] = 0;
+		mask[1] = 255;
+		out = data;
+		LLImageCompositor::scaleMask(&out[0], &mask[0], count);
+		for (S32 i = 0; i < count; ++i)
+		{
+			ensure_equals(llformat("mask %d", i), (S32)out[i], ((S32)data[i] * ((S32)mask[i] + 1)) >> 8);
+		}
+	}
+
+	template<> template<>
+	void imagecompositor_object::test<3>()
+	{
+		// A morph mask the way a tex layer builds it: cleared alpha, a
+		// weight, a stretched one component mask and the layer color's
+		// alpha, captured before the layer color is drawn through it.
+		const S32 width = 8;
+		const S32 height = 4;
+		LLPointer<LLImageRaw> mask = new LLImageRaw(4, 2, 1);
+		memset(mask->getData(), 128, 8);
+		mask->getData()[0] = 255;
+
+		LLImageCompositor compositor(width, height);
+		compositor.addRect(LLColor4U(0, 0, 0, 255), LLImageCompositor::BLEND_REPLACE, false);
+		compositor.addRect(LLColor4U(0, 0, 0, 0), LLImageCompositor::BLEND_REPLACE, false, true);
+		compositor.addRect(LLColor4U(0, 0, 0, 255), LLImageCompositor::BLEND_ADD, false, true);
+		compositor.addImage(mask, LLColor4U::white, LLImageCompositor::BLEND_MULT_ALPHA, false, true, true);
+		compositor.addRect(LLColor4U(255, 255, 255, 128), LLImageCompositor::BLEND_MULT_ALPHA, false, true);
+		S32 capture = compositor.addCapture();
+		compositor.addRect(LLColor4U(255, 0, 0, 255), LLImageCompositor::BLEND_DEST_ALPHA);
+		compositor.composite();
+
+		const U8* alpha = compositor.getCapture(capture);
+		ensure_equals("corner", (S32)alpha[0], 128);
+		ensure_equals("inside", (S32)alpha[width * height - 1], 64);
+
+		const U8* rgba = compositor.getResult()->getData();
+		ensure_equals("blended red", (S32)rgba[(width * height - 1) * 4], 64);
+		ensure_equals("black under", (S32)rgba[(width * height - 1) * 4 + 1], 0);
+		ensure_equals("ops", compositor.getOpCount(), (U32)7);
+	}
+
+	template<> template<>
+	void imagecompositor_object::test<4>()
+	{
+		// The worker thread comes up with the same image.
+		const S32 size = 64;
+		LLPointer<LLImageRaw> layer = new LLImageRaw(32, 32, 3);
+		U32 seed = 3;
+		for (S32 i = 0; i < 32 * 32 * 3; ++i)
+		{
+			layer->getData()[i] = random_byte(seed);
+		}
+
+		LLImageCompositor* threaded = new LLImageCompositor(size, size);
+		LLImageCompositor direct(size, size);
+		LLImageCompositor* compositors[] = { threaded, &direct };
+		for (S32 i = 0; i < 2; ++i)
+		{
+			compositors[i]->addRect(LLColor4U(0, 0, 0, 255), LLImageCompositor::BLEND_REPLACE, false);
+			compositors[i]->addImage(layer, LLColor4U(255, 128, 64, 200), LLImageCompositor::BLEND_ALPHA);
+		}
+
+		LLImageCompositeThread* thread = new LLImageCompositeThread(threaded);
+		thread->start();
+		direct.composite();
+		while (!thread->isStopped())
+		{
+			ms_sleep(1);
+		}
+		ensure("same result", !memcmp(thread->getCompositor()->getResult()->getData(),
+									  direct.getResult()->getData(), size * size * 4));
+		delete thread;
+	}
+}
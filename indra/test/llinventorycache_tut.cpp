@@ -0,0 +1,247 @@
+/**
+ * @file llinventorycache_tut.cpp
+ * @brief Tests and load benchmark for the binary inventory cache.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+#include "linden_common.h"
+#include "lltut.h"
+#include "llinventory.h"
+#include "llinventorycache.h"
+#include "llfile.h"
+#include "lltimer.h"
+
+namespace tut
+{
+	struct llinventorycache_data
+	{
+		llinventorycache_data()
+		:	mTextFile("inventory_cache_test.inv"),
+			mBinaryFile("inventory_cache_test.inv.bin")
+		{
+		}
+
+		~llinventorycache_data()
+		{
+			LLFile::remove_nowarn(mTextFile);
+			LLFile::remove_nowarn(mBinaryFile);
+		}
+
+		// A plausible inventory: every item lives in one of a few thousand
+		// folders and has a name, a description and its own asset.
+		void makeInventory(S32 cat_count, S32 item_count)
+		{
+			LLUUID owner_id;
+			owner_id.generate();
+			for (S32 i = 0; i < cat_count; ++i)
+			{
+				LLUUID cat_id;
+				cat_id.generate();
+				mCategories.push_back(new LLInventoryCategory(cat_id,
+					i ? mCategories[0]->getUUID() : LLUUID::null,
+					LLFolderType::FT_NONE, llformat("Folder %d", i)));
+			}
+			for (S32 i = 0; i < item_count; ++i)
+			{
+				LLUUID item_id, asset_id, creator_id;
+				item_id.generate();
+				asset_id.generate();
+				creator_id.generate();
+				LLPermissions perm;
+				perm.init(creator_id, owner_id, LLUUID::null, LLUUID::null);
+				perm.initMasks(PERM_ALL, PERM_ALL, PERM_NONE, PERM_NONE, PERM_MOVE | PERM_TRANSFER);
+				mItems.push_back(new LLInventoryItem(item_id,
+					mCategories[i % cat_count]->getUUID(),
+					perm,
+					asset_id,
+					LLAssetType::AT_OBJECT,
+					LLInventoryType::IT_OBJECT,
+					llformat("Item %d", i),
+					llformat("Description of item %d", i),
+					LLSaleInfo(LLSaleInfo::FS_NOT, 0),
+					i,
+					1500000000 + i));
+			}
+			mOwnerID = owner_id;
+		}
+
+		std::string mTextFile;
+		std::string mBinaryFile;
+		LLUUID mOwnerID;
+		LLInventoryCategory::cat_array_t mCategories;
+		LLInventoryItem::item_array_t mItems;
+	};
+	typedef test_group<llinventorycache_data> llinventorycache_test;
+	typedef llinventorycache_test::object llinventorycache_object;
+	tut::llinventorycache_test llinventorycache("llinventorycache");
+
+	template<> template<>
+	void llinventorycache_object::test<1>()
+	{
+		// Round trip every field we cache.
+		makeInventory(4, 32);
+		LLInventoryCache::Writer writer(2);
+		for (size_t i = 0; i < mCategories.size(); ++i)
+		{
+			writer.addCategory(mCategories[i], mOwnerID, (S32)i + 1);
+		}
+		for (size_t i = 0; i < mItems.size(); ++i)
+		{
+			writer.addItem(mItems[i]);
+		}
+		ensure("write failed", writer.write(mBinaryFile));
+
+		LLInventoryCache::Reader reader;
+		bool is_obsolete = false;
+		ensure("open failed", reader.open(mBinaryFile, 2, is_obsolete));
+		ensure_equals("category count", reader.getCategoryCount(), (U32)mCategories.size());
+		ensure_equals("item count", reader.getItemCount(), (U32)mItems.size());
+
+		for (U32 i = 0; i < reader.getCategoryCount(); ++i)
+		{
+			LLPointer<LLInventoryCategory> cat = new LLInventoryCategory;
+			LLUUID owner_id;
+			S32 version;
+			reader.getCategory(i, cat, owner_id, version);
+			ensure_equals("category id", cat->getUUID(), mCategories[i]->getUUID());
+			ensure_equals("category parent", cat->getParentUUID(), mCategories[i]->getParentUUID());
+			ensure_equals("category name", cat->getName(), mCategories[i]->getName());
+			ensure_equals("category owner", owner_id, mOwnerID);
+			ensure_equals("category version", version, (S32)i + 1);
+		}
+
+		// Items come back grouped by folder, so match them up by id.
+		std::map<LLUUID, LLPointer<LLInventoryItem> > by_id;
+		for (size_t i = 0; i < mItems.size(); ++i)
+		{
+			by_id[mItems[i]->getUUID()] = mItems[i];
+		}
+		for (U32 i = 0; i < reader.getItemCount(); ++i)
+		{
+			LLPointer<LLInventoryItem> dst = new LLInventoryItem;
+			reader.getItem(i, dst);
+			LLPointer<LLInventoryItem> src = by_id[dst->getUUID()];
+			ensure("unknown item", src.notNull());
+			ensure_equals("parent", dst->getParentUUID(), src->getParentUUID());
+			ensure_equals("permissions", dst->getPermissions(), src->getPermissions());
+			ensure_equals("asset", dst->getAssetUUID(), src->getAssetUUID());
+			ensure_equals("type", dst->getType(), src->getType());
+			ensure_equals("inventory type", dst->getInventoryType(), src->getInventoryType());
+			ensure_equals("name", dst->getName(), src->getName());
+			ensure_equals("description", dst->getDescription(), src->getDescription());
+			ensure_equals("flags", dst->getFlags(), src->getFlags());
+			ensure_equals("creation date", dst->getCreationDate(), src->getCreationDate());
+		}
+
+		// Another cache version must be reported as obsolete, not loaded.
+		ensure("opened obsolete cache", !reader.open(mBinaryFile, 3, is_obsolete));
+		ensure("obsolete not flagged", is_obsolete);
+	}
+
+	template<> template<>
+	void llinventorycache_object::test<2>()
+	{
+		// A corrupted file must be rejected.
+		makeInventory(1, 8);
+		LLInventoryCache::Writer writer(2);
+		writer.addCategory(mCategories[0], mOwnerID, 1);
+		for (size_t i = 0; i < mItems.size(); ++i)
+		{
+			writer.addItem(mItems[i]);
+		}
+		ensure("write failed", writer.write(mBinaryFile));
+
+		LLFILE* fp = LLFile::fopen(mBinaryFile, "r+b");
+		ensure("reopen failed", fp != NULL);
+		fseek(fp, sizeof(LLInventoryCache::Header) + 20, SEEK_SET);
+		fputc(0xff, fp);
+		fclose(fp);
+
+		LLInventoryCache::Reader reader;
+		bool is_obsolete = false;
+		ensure("opened corrupt cache", !reader.open(mBinaryFile, 2, is_obsolete));
+	}
+
+	template<> template<>
+	void llinventorycache_object::test<3>()
+	{
+		// Load benchmark on a synthetic 200k item inventory, text format
+		// (as LLInventoryModel::loadFromFile reads it) against binary.
+		const S32 ITEM_COUNT = 200000;
+		makeInventory(4000, ITEM_COUNT);
+
+		LLFILE* fp = LLFile::fopen(mTextFile, "wb");
+		ensure("text open failed", fp != NULL);
+		for (size_t i = 0; i < mItems.size(); ++i)
+		{
+			mItems[i]->exportFile(fp);
+		}
+		fclose(fp);
+
+		LLInventoryCache::Writer writer(2);
+		for (size_t i = 0; i < mCategories.size(); ++i)
+		{
+			writer.addCategory(mCategories[i], mOwnerID, 1);
+		}
+		for (size_t i = 0; i < mItems.size(); ++i)
+		{
+			writer.addItem(mItems[i]);
+		}
+		ensure("write failed", writer.write(mBinaryFile));
+
+		LLTimer timer;
+		fp = LLFile::fopen(mTextFile, "rb");
+		ensure("text reopen failed", fp != NULL);
+		char buffer[MAX_STRING];		/* Flawfinder: ignore */
+		S32 text_count = 0;
+		while (fgets(buffer, MAX_STRING, fp))
+		{
+			LLPointer<LLInventoryItem> item = new LLInventoryItem;
+			if (item->importFile(fp))
+			{
+				++text_count;
+			}
+		}
+		fclose(fp);
+		F32 text_time = timer.getElapsedTimeF32();
+
+		timer.reset();
+		LLInventoryCache::Reader reader;
+		bool is_obsolete = false;
+		ensure("open failed", reader.open(mBinaryFile, 2, is_obsolete));
+		S32 binary_count = 0;
+		for (U32 i = 0; i < reader.getItemCount(); ++i)
+		{
+			LLPointer<LLInventoryItem> item = new LLInventoryItem;
+			reader.getItem(i, item);
+			++binary_count;
+		}
+		F32 binary_time = timer.getElapsedTimeF32();
+
+		LL_INFOS() << "Loading " << ITEM_COUNT << " inventory items: text " << text_time
+				   << "s, binary " << binary_time << "s" << LL_ENDL;
+		ensure_equals("text item count", text_count, ITEM_COUNT);
+		ensure_equals("binary item count", binary_count, ITEM_COUNT);
+	}
+}
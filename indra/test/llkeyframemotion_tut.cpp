@@ -0,0 +1,196 @@
+/**
+ * @file llkeyframemotion_tut.cpp
+ * @brief Keyframe motion asset round trips and the decoded data cache.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include <vector>
+
+#include "linden_common.h"
+#include "llcharacter.h"
+#include "lldatapacker.h"
+#include "llformat.h"
+#include "llkeyframemotion.h"
+#include "llrand.h"
+#include "lltut.h"
+
+namespace tut
+{
+	// A pelvis and a chain of joints below it, for the animation to name.
+	class KeyframeTestCharacter : public LLCharacter
+	{
+	public:
+		enum { JOINTS = 6 };
+
+		KeyframeTestCharacter()
+		{
+			mID.generate();
+			LLJoint* parent = NULL;
+			for (S32 i = 0; i < JOINTS; ++i)
+			{
+				LLJoint* joint = i ? new LLJoint(llformat("mJoint%d", i), parent) : new LLJoint("mPelvis");
+				joint->setJointNum(i);
+				mJoints.push_back(joint);
+				parent = joint;
+			}
+		}
+
+		~KeyframeTestCharacter()
+		{
+			for (std::vector<LLJoint*>::reverse_iterator it = mJoints.rbegin(); it != mJoints.rend(); ++it)
+			{
+				delete *it;
+			}
+		}
+
+		const std::vector<LLJoint*>& getJoints() const	{ return mJoints; }
+
+		/*virtual*/ const char* getAnimationPrefix()		{ return "avatar"; }
+		/*virtual*/ LLJoint* getRootJoint()					{ return mJoints[0]; }
+		/*virtual*/ LLVector3 getCharacterPosition()		{ return LLVector3::zero; }
+		/*virtual*/ LLQuaternion getCharacterRotation()	{ return LLQuaternion::DEFAULT; }
+		/*virtual*/ LLVector3 getCharacterVelocity()		{ return LLVector3::zero; }
+		/*virtual*/ LLVector3 getCharacterAngularVelocity()	{ return LLVector3::zero; }
+		/*virtual*/ void getGround(const LLVector3& in_pos, LLVector3& out_pos, LLVector3& out_norm)
+		{
+			out_pos = in_pos;
+			out_norm = LLVector3::z_axis;
+		}
+		/*virtual*/ LLJoint* getCharacterJoint(U32 i)		{ return i < mJoints.size() ? mJoints[i] : NULL; }
+		/*virtual*/ F32 getTimeDilation()					{ return 1.f; }
+		/*virtual*/ F32 getPixelArea() const				{ return 1000000.f; }
+		/*virtual*/ LLPolyMesh* getHeadMesh()				{ return NULL; }
+		/*virtual*/ LLPolyMesh* getUpperBodyMesh()			{ return NULL; }
+		/*virtual*/ LLVector3d getPosGlobalFromAgent(const LLVector3& position)	{ return LLVector3d(position); }
+		/*virtual*/ LLVector3 getPosAgentFromGlobal(const LLVector3d& position)	{ return LLVector3(position); }
+		/*virtual*/ void addDebugText(const std::string& text) {}
+		/*virtual*/ const LLUUID& getID() const				{ return mID; }
+
+	private:
+		LLUUID					mID;
+		std::vector<LLJoint*>	mJoints;
+	};
+
+	// Decodes an animation into LLKeyframeDataCache, where it stays for as
+	// long as this object lives.
+	class KeyframeTestMotion : public LLKeyframeMotion
+	{
+	public:
+		KeyframeTestMotion(const LLUUID& id, LLCharacter* character)
+		:	LLKeyframeMotion(id, NULL)
+		{
+			mCharacter = character;
+		}
+
+		bool load(std::vector<U8>& buffer)
+		{
+			LLDataPackerBinaryBuffer dp(&buffer[0], (S32)buffer.size());
+			return deserialize(dp, getID());
+		}
+	};
+
+	struct keyframemotion_data
+	{
+		enum { KEYS = 12 };
+
+		KeyframeTestCharacter mModel;
+
+		~keyframemotion_data()
+		{
+			LLKeyframeDataCache::setRetainLimit(8 * 1024 * 1024);
+		}
+
+		// A looping animation of every joint in the .anim format, with
+		// random rotations and positions.
+		std::vector<U8> makeAnimation()
+		{
+			const S32 joint_count = (S32)mModel.getJoints().size();
+			std::vector<U8> buffer(256 + joint_count * (64 + KEYS * 16));
+			LLDataPackerBinaryBuffer dp(&buffer[0], (S32)buffer.size());
+			dp.packU16(1, "version");
+			dp.packU16(0, "sub_version");
+			dp.packS32(2, "base_priority");
+			dp.packF32(2.f, "duration");
+			dp.packString(std::string(), "emote_name");
+			dp.packF32(0.f, "loop_in_point");
+			dp.packF32(2.f, "loop_out_point");
+			dp.packS32(1, "loop");
+			dp.packF32(0.3f, "ease_in_duration");
+			dp.packF32(0.3f, "ease_out_duration");
+			dp.packU32(1, "hand_pose");
+			dp.packU32(joint_count, "num_joints");
+			for (S32 j = 0; j < joint_count; ++j)
+			{
+				dp.packString(mModel.getJoints()[j]->getName(), "joint_name");
+				dp.packS32(2, "joint_priority");
+				for (S32 curve = 0; curve < 2; ++curve)
+				{
+					dp.packS32(KEYS, "num_keys");
+					for (S32 k = 0; k < KEYS; ++k)
+					{
+						dp.packU16((U16)(k * 65535 / (KEYS - 1)), "time");
+						dp.packU16((U16)(ll_rand() & 0xffff), "x");
+						dp.packU16((U16)(ll_rand() & 0xffff), "y");
+						dp.packU16((U16)(ll_rand() & 0xffff), "z");
+					}
+				}
+			}
+			dp.packS32(0, "num_constraints");
+			buffer.resize(dp.getCurrentSize());
+			return buffer;
+		}
+	};
+	typedef test_group<keyframemotion_data> keyframemotion_test;
+	typedef keyframemotion_test::object keyframemotion_object;
+	tut::keyframemotion_test keyframemotion_testcase("keyframe_motion");
+
+	template<> template<>
+	void keyframemotion_object::test<1>()
+	{
+		// Keys are stored as in the asset, so serializing gives back the same bytes.
+		LLUUID id;
+		id.generate();
+		std::vector<U8> buffer = makeAnimation();
+		KeyframeTestMotion* animation = new KeyframeTestMotion(id, &mModel);
+		ensure("animation decodes", animation->load(buffer));
+
+		std::vector<U8> output(animation->getFileSize());
+		LLDataPackerBinaryBuffer dp(&output[0], (S32)output.size());
+		ensure("animation encodes", animation->serialize(dp));
+		output.resize(dp.getCurrentSize());
+		ensure("same asset", output == buffer);
+
+		// Once no motion uses it, the decoded data is retained until the
+		// limit is exceeded.
+		LLKeyframeDataCache::setRetainLimit(1024 * 1024);
+		delete animation;
+		ensure("retained", (bool)LLKeyframeDataCache::getKeyframeData(id));
+		ensure("retained bytes", LLKeyframeDataCache::getRetainedBytes() > 0);
+
+		LLKeyframeDataCache::setRetainLimit(0);
+		ensure("evicted", !LLKeyframeDataCache::getKeyframeData(id));
+		ensure_equals("no retained bytes", LLKeyframeDataCache::getRetainedBytes(), 0U);
+	}
+}
@@ -0,0 +1,214 @@
+/**
+ * @file lllogchatindex_tut.cpp
+ * @brief Tests for the chat log line index.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+#include "linden_common.h"
+#include "lltut.h"
+#include "llfile.h"
+#include "lllogchatindex.h"
+
+namespace tut
+{
+	struct lllogchatindex_data
+	{
+		typedef std::vector<std::pair<U32, std::string> > line_vec_t;
+
+		lllogchatindex_data()
+		:	mLogFile("log_index_test.txt")
+		{
+			removeFiles();
+		}
+
+		~lllogchatindex_data()
+		{
+			removeFiles();
+		}
+
+		void removeFiles()
+		{
+			LLFile::remove_nowarn(mLogFile);
+			LLFile::remove_nowarn(LLLogChatIndex::getIndexFilename(mLogFile));
+		}
+
+		void writeLog(const std::string& text, const char* mode)
+		{
+			LLFILE* fp = LLFile::fopen(mLogFile, mode);
+			ensure("log opened", fp != NULL);
+			ensure_equals("log written", fwrite(text.data(), 1, text.size(), fp), text.size());
+			LLFile::close(fp);
+		}
+
+		line_vec_t readLines(U32 first, U32 count)
+		{
+			line_vec_t lines;
+			LLLogChatIndex::readLines(mLogFile, first, count,
+				[&lines](U32 line, const std::string& text)
+				{
+					lines.push_back(std::make_pair(line, text));
+				});
+			return lines;
+		}
+
+		std::string mLogFile;
+	};
+	typedef test_group<lllogchatindex_data> lllogchatindex_test;
+	typedef lllogchatindex_test::object lllogchatindex_object;
+	tut::lllogchatindex_test lllogchatindex_testcase("lllogchatindex");
+
+	// Building the index of an existing log. Readers never build it.
+	template<> template<>
+	void lllogchatindex_object::test<1>()
+	{
+		writeLog("first\nsecond\r\nthird\n", "wb");
+		ensure_equals("no index yet", LLLogChatIndex::getLineCount(mLogFile), -1);
+		ensure("nothing read without index", readLines(0, 1).empty());
+		ensure("no index built by readers", !LLFile::isfile(LLLogChatIndex::getIndexFilename(mLogFile)));
+
+		ensure("update", LLLogChatIndex::update(mLogFile));
+		ensure_equals("line count", LLLogChatIndex::getLineCount(mLogFile), 3);
+
+		line_vec_t lines = readLines(1, 5);
+		ensure_equals("lines read", lines.size(), (size_t)2);
+		ensure_equals("first line number", lines[0].first, 1U);
+		ensure_equals("CR stripped", lines[0].second, std::string("second"));
+		ensure_equals("last line", lines[1].second, std::string("third"));
+		ensure("past the end", readLines(3, 1).empty());
+	}
+
+	// Appended lines are indexed by the next update; a partial last line
+	// only once it is complete.
+	template<> template<>
+	void lllogchatindex_object::test<2>()
+	{
+		writeLog("one\ntwo\n", "wb");
+		ensure("initial update", LLLogChatIndex::update(mLogFile));
+		ensure_equals("initial count", LLLogChatIndex::getLineCount(mLogFile), 2);
+
+		writeLog("three\nfou", "ab");
+		ensure_equals("index behind", LLLogChatIndex::getLineCount(mLogFile), -1);
+		ensure("update", LLLogChatIndex::update(mLogFile));
+		ensure_equals("partial line not counted", LLLogChatIndex::getLineCount(mLogFile), 3);
+
+		writeLog("r\nfive\n", "ab");
+		ensure_equals("index behind again", LLLogChatIndex::getLineCount(mLogFile), -1);
+		ensure("appended update", LLLogChatIndex::update(mLogFile));
+		ensure_equals("appended count", LLLogChatIndex::getLineCount(mLogFile), 5);
+		line_vec_t lines = readLines(2, 3);
+		ensure_equals("appended lines read", lines.size(), (size_t)3);
+		ensure_equals("line 2", lines[0].second, std::string("three"));
+		ensure_equals("line 3", lines[1].second, std::string("four"));
+		ensure_equals("line 4", lines[2].second, std::string("five"));
+	}
+
+	// A truncated or replaced log gets its index rebuilt.
+	template<> template<>
+	void lllogchatindex_object::test<3>()
+	{
+		writeLog("alpha\nbeta\ngamma\ndelta\n", "wb");
+		ensure("initial update", LLLogChatIndex::update(mLogFile));
+		ensure_equals("initial count", LLLogChatIndex::getLineCount(mLogFile), 4);
+
+		writeLog("short\n", "wb");
+		ensure_equals("truncated index unusable", LLLogChatIndex::getLineCount(mLogFile), -1);
+		ensure("truncated update", LLLogChatIndex::update(mLogFile));
+		ensure_equals("truncated count", LLLogChatIndex::getLineCount(mLogFile), 1);
+		line_vec_t lines = readLines(0, 4);
+		ensure_equals("truncated lines", lines.size(), (size_t)1);
+		ensure_equals("truncated text", lines[0].second, std::string("short"));
+
+		// Longer than before, but a different log altogether.
+		writeLog("other\nlog\nwith\nmore\nlines\n", "wb");
+		ensure_equals("replaced index unusable", LLLogChatIndex::getLineCount(mLogFile), -1);
+		ensure("replaced update", LLLogChatIndex::update(mLogFile));
+		ensure_equals("replaced count", LLLogChatIndex::getLineCount(mLogFile), 5);
+		lines = readLines(0, 5);
+		ensure_equals("replaced lines", lines.size(), (size_t)5);
+		ensure_equals("replaced first", lines[0].second, std::string("other"));
+		ensure_equals("replaced last", lines[4].second, std::string("lines"));
+
+		// A corrupt sidecar is rebuilt too.
+		LLFILE* fp = LLFile::fopen(LLLogChatIndex::getIndexFilename(mLogFile), "wb");
+		ensure("sidecar opened", fp != NULL);
+		fputs("garbage", fp);
+		LLFile::close(fp);
+		ensure_equals("corrupt index unusable", LLLogChatIndex::getLineCount(mLogFile), -1);
+		ensure("rebuild", LLLogChatIndex::update(mLogFile));
+		ensure_equals("rebuilt count", LLLogChatIndex::getLineCount(mLogFile), 5);
+		ensure_equals("rebuilt line", readLines(3, 1)[0].second, std::string("more"));
+	}
+
+	// Searching in small slices finds what a whole search does, and stops at
+	// the log size it was given.
+	template<> template<>
+	void lllogchatindex_object::test<4>()
+	{
+		std::string text;
+		size_t first_50_size = 0;
+		for (S32 i = 0; i < 100; ++i)
+		{
+			text += (i % 7) ? llformat("line %d\n", i) : llformat("Match %d\n", i);
+			if (i == 49)
+			{
+				first_50_size = text.size();
+			}
+		}
+		writeLog(text, "wb");
+
+		line_vec_t whole;
+		U32 found = LLLogChatIndex::search(mLogFile, "mATCH", 5,
+			[&whole](U32 line, const std::string& text)
+			{
+				whole.push_back(std::make_pair(line, text));
+			});
+		ensure_equals("whole search count", found, 5U);
+		ensure_equals("whole search results", whole.size(), (size_t)5);
+		ensure_equals("oldest kept match", whole[0].first, 70U);
+		ensure_equals("newest match", whole[4].second, std::string("Match 98"));
+
+		LLLogChatIndex::Search search(mLogFile, "match", 5);
+		S32 steps = 0;
+		while (!search.step(16))
+		{
+			++steps;
+		}
+		ensure("searched in slices", steps > 10);
+		const LLLogChatIndex::Search::match_deque_t& matches = search.getMatches();
+		ensure_equals("sliced search count", matches.size(), whole.size());
+		for (size_t i = 0; i < whole.size(); ++i)
+		{
+			ensure_equals("sliced line", matches[i].first, whole[i].first);
+			ensure_equals("sliced text", matches[i].second, whole[i].second);
+		}
+
+		ensure_equals("sliced line count", search.getLineCount(), 100U);
+
+		LLLogChatIndex::Search limited(mLogFile, "match", 100, first_50_size);
+		while (!limited.step(64));
+		ensure_equals("limited line count", limited.getLineCount(), 50U);
+		ensure_equals("limited count", limited.getMatches().size(), (size_t)8);
+		ensure_equals("limited newest", limited.getMatches().back().first, 49U);
+	}
+}
@@ -0,0 +1,278 @@
+/**
+ * @file llpolymesh_tut.cpp
+ * @brief Batched application of morph targets to a mesh.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include <vector>
+
+#include "linden_common.h"
+#include "lldir.h"
+#include "llfile.h"
+#include "llformat.h"
+#include "llpolymesh.h"
+#include "llpolymorph.h"
+#include "lltut.h"
+
+namespace tut
+{
+	class TestMorphInfo : public LLPolyMorphTargetInfo
+	{
+	public:
+		TestMorphInfo(S32 id, const std::string& morph_name)
+		{
+			mID = id;
+			mName = morph_name;
+			mMorphName = morph_name;
+			mMinWeight = -1.f;
+			mMaxWeight = 1.f;
+		}
+	};
+
+	struct polymesh_data
+	{
+		enum { VERTICES = 16, MORPHS = 3 };
+
+		polymesh_data()
+		:	mCreatedDir(false)
+		{
+			// LLPolyMesh only loads meshes from the character directory.
+			const std::string dir = gDirUtilp->getExpandedFilename(LL_PATH_CHARACTER, "");
+			mCreatedDir = !LLFile::isdir(dir) && LLFile::mkdir(dir) == 0;
+			mFilename = gDirUtilp->getExpandedFilename(LL_PATH_CHARACTER, MESH_NAME);
+			writeMesh();
+
+			for (S32 i = 0; i < MORPHS; ++i)
+			{
+				mInfos.push_back(new TestMorphInfo(i, llformat("morph%d", i)));
+			}
+			mSerialMesh = makeMesh(mSerialMorphs);
+			mBatchedMesh = makeMesh(mBatchedMorphs);
+		}
+
+		~polymesh_data()
+		{
+			// The morphs take themselves off their mesh queue.
+			for (S32 i = 0; i < MORPHS; ++i)
+			{
+				delete mSerialMorphs[i];
+				delete mBatchedMorphs[i];
+				delete mInfos[i];
+			}
+			delete mSerialMesh;
+			delete mBatchedMesh;
+			LLPolyMesh::freeAllMeshes();
+
+			LLFile::remove_nowarn(mFilename);
+			if (mCreatedDir)
+			{
+				LLFile::rmdir(gDirUtilp->getExpandedFilename(LL_PATH_CHARACTER, ""));
+			}
+		}
+
+		template<typename T>
+		static void write(LLFILE* fp, const T& value)
+		{
+			fwrite(&value, sizeof(T), 1, fp);
+		}
+
+		static void writeName(LLFILE* fp, const std::string& name)
+		{
+			char buffer[64];
+			memset(buffer, 0, sizeof(buffer));
+			strncpy(buffer, name.c_str(), sizeof(buffer) - 1);
+			fwrite(buffer, sizeof(buffer), 1, fp);
+		}
+
+		// A strip of quads in the binary .llm format, without skin weights,
+		// and morphs that move overlapping ranges of its vertices.
+		void writeMesh()
+		{
+			LLFILE* fp = LLFile::fopen(mFilename, "wb");
+			ensure("mesh file created", fp != NULL);
+
+			char header[24];
+			memset(header, 0, sizeof(header));
+			strcpy(header, "Linden Binary Mesh 1.0");
+			fwrite(header, sizeof(header), 1, fp);
+			write(fp, (U8)0);						// has weights
+			write(fp, (U8)0);						// has detail tex coords
+			for (S32 i = 0; i < 6; ++i)
+			{
+				write(fp, 0.f);						// position, rotation
+			}
+			write(fp, (U8)0);						// rotation order
+			for (S32 i = 0; i < 3; ++i)
+			{
+				write(fp, 1.f);						// scale
+			}
+
+			write(fp, (U16)VERTICES);
+			for (S32 v = 0; v < VERTICES; ++v)
+			{
+				write(fp, (F32)(v / 2));
+				write(fp, (F32)(v % 2));
+				write(fp, 0.f);
+			}
+			for (S32 v = 0; v < VERTICES; ++v)
+			{
+				write(fp, 0.f);
+				write(fp, 0.f);
+				write(fp, 1.f);
+			}
+			for (S32 v = 0; v < VERTICES; ++v)
+			{
+				write(fp, 1.f);
+				write(fp, 0.f);
+				write(fp, 0.f);
+			}
+			for (S32 v = 0; v < VERTICES; ++v)
+			{
+				write(fp, (F32)(v / 2) / (VERTICES / 2));
+				write(fp, (F32)(v % 2));
+			}
+
+			write(fp, (U16)(VERTICES - 2));
+			for (S32 f = 0; f < VERTICES - 2; ++f)
+			{
+				write(fp, (U16)f);
+				write(fp, (U16)(f + 1));
+				write(fp, (U16)(f + 2));
+			}
+
+			for (S32 m = 0; m < MORPHS; ++m)
+			{
+				writeName(fp, llformat("morph%d", m));
+				const S32 first = m * 4;
+				const S32 count = 8;
+				write(fp, count);
+				for (S32 i = 0; i < count; ++i)
+				{
+					const F32 s = (F32)(m + 1) * 0.1f + (F32)i * 0.01f;
+					write(fp, (U32)(first + i));
+					write(fp, s);					// coords
+					write(fp, -s);
+					write(fp, 2.f * s);
+					write(fp, s);					// normal
+					write(fp, 0.5f * s);
+					write(fp, -s);
+					write(fp, -0.5f * s);			// binormal
+					write(fp, s);
+					write(fp, 0.f);
+					write(fp, 0.1f * s);			// tex coords
+					write(fp, -0.1f * s);
+				}
+			}
+			writeName(fp, "End Morphs");
+			write(fp, (S32)0);						// vertex remaps
+
+			LLFile::close(fp);
+		}
+
+		LLPolyMesh* makeMesh(std::vector<LLPolyMorphTarget*>& morphs)
+		{
+			LLPolyMesh* mesh = LLPolyMesh::getMesh(MESH_NAME);
+			ensure("mesh loads", mesh != NULL);
+			ensure_equals("vertices", (S32)mesh->getNumVertices(), (S32)VERTICES);
+			for (S32 i = 0; i < MORPHS; ++i)
+			{
+				LLPolyMorphTarget* morph = new LLPolyMorphTarget(mesh);
+				ensure("morph found", morph->setInfo(mInfos[i]));
+				morphs.push_back(morph);
+			}
+			return mesh;
+		}
+
+		static void ensureSame(const char* msg, const LLVector4a* actual, const LLVector4a* expected)
+		{
+			for (S32 v = 0; v < VERTICES; ++v)
+			{
+				for (S32 c = 0; c < 3; ++c)
+				{
+					ensure_approximately_equals(msg, actual[v][c], expected[v][c], 16);
+				}
+			}
+		}
+
+		static const std::string MESH_NAME;
+
+		std::string						mFilename;
+		bool							mCreatedDir;
+		std::vector<TestMorphInfo*>		mInfos;
+		LLPolyMesh*						mSerialMesh;
+		LLPolyMesh*						mBatchedMesh;
+		std::vector<LLPolyMorphTarget*>	mSerialMorphs;
+		std::vector<LLPolyMorphTarget*>	mBatchedMorphs;
+	};
+	const std::string polymesh_data::MESH_NAME("polymesh_tut.llm");
+
+	typedef test_group<polymesh_data> polymesh_test;
+	typedef polymesh_test::object polymesh_object;
+	tut::polymesh_test polymesh_testcase("polymesh");
+
+	template<> template<>
+	void polymesh_object::test<1>()
+	{
+		// Morphs applied together, some of them more than once, give the
+		// same vertices as the same morphs applied one at a time.
+		static const S32 steps[][2] = { { 0, 80 }, { 1, -50 }, { 2, 30 }, { 0, 20 }, { 1, 100 }, { 0, -70 } };
+		const S32 step_count = sizeof(steps) / sizeof(steps[0]);
+
+		for (S32 round = 0; round < 2; ++round)
+		{
+			for (S32 i = 0; i < step_count; ++i)
+			{
+				const S32 morph = steps[i][0];
+				const F32 weight = (F32)(steps[i][1] * (round + 1)) / 200.f;
+
+				mSerialMorphs[morph]->setWeight(weight);
+				mSerialMorphs[morph]->apply(SEX_FEMALE);
+				mSerialMesh->getCoords();
+				ensure("serial morph flushed", !mSerialMesh->hasPendingMorphs());
+
+				mBatchedMorphs[morph]->setWeight(weight);
+				mBatchedMorphs[morph]->apply(SEX_FEMALE);
+			}
+			ensure("batched morphs pending", mBatchedMesh->hasPendingMorphs());
+
+			ensureSame("coords", mBatchedMesh->getCoords(), mSerialMesh->getCoords());
+			ensure("batched morphs applied", !mBatchedMesh->hasPendingMorphs());
+			ensureSame("normals", mBatchedMesh->getNormals(), mSerialMesh->getNormals());
+			ensureSame("binormals", mBatchedMesh->getBinormals(), mSerialMesh->getBinormals());
+			ensureSame("scaled normals", mBatchedMesh->getScaledNormals(), mSerialMesh->getScaledNormals());
+			ensureSame("scaled binormals", mBatchedMesh->getScaledBinormals(), mSerialMesh->getScaledBinormals());
+			const LLVector2* batched_uv = mBatchedMesh->getTexCoords();
+			const LLVector2* serial_uv = mSerialMesh->getTexCoords();
+			for (S32 v = 0; v < VERTICES; ++v)
+			{
+				ensure_approximately_equals("tex coords", batched_uv[v].mV[VX], serial_uv[v].mV[VX], 16);
+				ensure_approximately_equals("tex coords", batched_uv[v].mV[VY], serial_uv[v].mV[VY], 16);
+			}
+		}
+
+		// The morphs did move the mesh.
+		ensure("morphed", mBatchedMesh->getCoords()[4][VX] != 2.f);
+	}
+}
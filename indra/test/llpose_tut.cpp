@@ -0,0 +1,133 @@
+/**
+ * @file llpose_tut.cpp
+ * @brief LLPose and LLJointStateBlender tests.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llpose.h"
+#include "lltut.h"
+
+namespace tut
+{
+	struct pose_data
+	{
+		LLJoint mRoot, mNumbered, mUnnumbered;
+
+		pose_data()
+		:	mRoot("mPelvis"),
+			mNumbered("mTorso", &mRoot),
+			mUnnumbered("mScreen", &mRoot)
+		{
+			mRoot.setJointNum(0);
+			mNumbered.setJointNum(5);
+		}
+
+		static LLPointer<LLJointState> makeState(LLJoint* joint, U32 usage, F32 weight)
+		{
+			LLPointer<LLJointState> state = new LLJointState(joint);
+			state->setUsage(usage);
+			state->setWeight(weight);
+			return state;
+		}
+	};
+	typedef test_group<pose_data> pose_test;
+	typedef pose_test::object pose_object;
+	tut::pose_test pose_testcase("pose");
+
+	template<> template<>
+	void pose_object::test<1>()
+	{
+		// Joint states are found by joint, numbered or not, and by name.
+		LLPose pose;
+		LLPointer<LLJointState> root = makeState(&mRoot, LLJointState::ROT, 1.f);
+		LLPointer<LLJointState> numbered = makeState(&mNumbered, LLJointState::ROT, 1.f);
+		LLPointer<LLJointState> unnumbered = makeState(&mUnnumbered, LLJointState::ROT, 1.f);
+		pose.addJointState(root);
+		pose.addJointState(numbered);
+		pose.addJointState(unnumbered);
+		// The first joint state of a joint stays.
+		pose.addJointState(makeState(&mNumbered, LLJointState::POS, 1.f));
+
+		ensure_equals("count", pose.getNumJointStates(), 3);
+		ensure("by joint", pose.findJointState(&mNumbered) == numbered.get());
+		ensure("unnumbered", pose.findJointState(&mUnnumbered) == unnumbered.get());
+		ensure("by name", pose.findJointState("mTorso") == numbered.get());
+		ensure("missing", pose.findJointState("mHead") == NULL);
+
+		pose.removeJointState(root);
+		ensure_equals("removed", pose.getNumJointStates(), 2);
+		ensure("root gone", pose.findJointState(&mRoot) == NULL);
+		ensure("moved one found", pose.findJointState(&mNumbered) == numbered.get());
+		ensure("other one found", pose.findJointState(&mUnnumbered) == unnumbered.get());
+
+		S32 visited = 0;
+		for (LLJointState* state = pose.getFirstJointState(); state; state = pose.getNextJointState())
+		{
+			++visited;
+		}
+		ensure_equals("iterated", visited, 2);
+
+		pose.setWeight(0.5f);
+		ensure_equals("weight", numbered->getWeight(), 0.5f);
+		pose.removeAllJointStates();
+		ensure("empty", pose.getFirstJointState() == NULL);
+	}
+
+	template<> template<>
+	void pose_object::test<2>()
+	{
+		// Blending by priority gives what the scalar lerp and nlerp give.
+		LLPointer<LLJointState> high = makeState(&mNumbered, LLJointState::POS | LLJointState::ROT, 0.25f);
+		high->setPosition(LLVector3(1.f, 2.f, 3.f));
+		high->setRotation(LLQuaternion(0.3f, LLVector3::z_axis));
+		LLPointer<LLJointState> low = makeState(&mNumbered, LLJointState::POS | LLJointState::ROT, 1.f);
+		low->setPosition(LLVector3(-1.f, 0.f, 1.f));
+		low->setRotation(LLQuaternion(-0.2f, LLVector3::x_axis));
+
+		LLJointStateBlender blender;
+		blender.addJointState(low, 1, FALSE);
+		blender.addJointState(high, 4, FALSE);
+		ensure("joint", blender.getJoint() == &mNumbered);
+
+		LLVector4a pos, scale;
+		LLQuaternion2 rot;
+		pos.clear();
+		scale.set(1.f, 1.f, 1.f);
+		rot = LLQuaternion::DEFAULT;
+		ensure("blended", blender.blendJointStates(pos, rot, scale));
+
+		// high first, then low at the remaining weight
+		LLVector3 expected_pos = lerp(low->getPosition(), high->getPosition(), 0.25f);
+		LLQuaternion expected_rot = nlerp(0.25f, low->getRotation(), high->getRotation());
+		ensure("position", dist_vec(LLVector3(pos.getF32ptr()), expected_pos) < 1e-5f);
+		LLQuaternion actual_rot(rot.getVector4a().getF32ptr());
+		ensure("rotation", llabs(dot(actual_rot, expected_rot)) > 0.99999f);
+		ensure("scale untouched", dist_vec(LLVector3(scale.getF32ptr()), LLVector3(1.f, 1.f, 1.f)) < 1e-6f);
+
+		blender.clear();
+		ensure("cleared", !blender.blendJointStates(pos, rot, scale));
+	}
+}
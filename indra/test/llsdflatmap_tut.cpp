@@ -0,0 +1,399 @@
+/**
+ * @file llsdflatmap_tut.cpp
+ * @brief LLSD map container tests and LLSDSerialize benchmark
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+#include <tut/tut.hpp>
+
+#include <map>
+#include <sstream>
+
+#include "linden_common.h"
+#include "llsd.h"
+#include "llsdserialize.h"
+#include "llsdutil.h"
+#include "lltimer.h"
+#include "lltut.h"
+#include "llformat.h"
+#include "llsdflatmap.h"
+
+namespace tut
+{
+	struct flatmap_data
+	{
+		// A seed capability response: some forty cap names mapped to URLs,
+		// as received at each region change.
+		static LLSD makeCapabilities()
+		{
+			static const char* names[] =
+			{
+				"AgentPreferences", "AgentState", "AttachmentResources", "AvatarPickerSearch",
+				"AvatarRenderInfo", "ChatSessionRequest", "CopyInventoryFromNotecard",
+				"CreateInventoryCategory", "DispatchRegionInfo", "EnvironmentSettings",
+				"EstateChangeInfo", "EventQueueGet", "FetchInventory2", "FetchInventoryDescendents2",
+				"FetchLib2", "FetchLibDescendents2", "GetDisplayNames", "GetExperienceInfo",
+				"GetMesh", "GetMesh2", "GetMetadata", "GetObjectCost", "GetObjectPhysicsData",
+				"GetTexture", "GroupMemberData", "HomeLocation", "InventoryAPIv3", "LibraryAPIv3",
+				"MapLayer", "MeshUploadFlag", "NavMeshGenerationStatus", "NewFileAgentInventory",
+				"ObjectMedia", "ObjectNavMeshProperties", "ParcelPropertiesUpdate",
+				"ProductInfoRequest", "RenderMaterials", "ResourceCostSelected",
+				"SimulatorFeatures", "UpdateAgentInformation", "UploadBakedTexture",
+				"ViewerAsset", "ViewerMetrics", "ViewerStats"
+			};
+			LLSD caps;
+			for (U32 i = 0; i < LL_ARRAY_SIZE(names); ++i)
+			{
+				LLUUID id;
+				id.generate();
+				caps[names[i]] = "https://simhost-0a1b2c3d4e5f60718.agni.lindenlab.com:12043/cap/" + id.asString();
+			}
+			return caps;
+		}
+
+		// An AIS inventory update: an embedded map of items keyed by id.
+		static LLSD makeInventoryUpdate(S32 count)
+		{
+			LLSD items;
+			for (S32 i = 0; i < count; ++i)
+			{
+				LLUUID item_id, asset_id, owner_id;
+				item_id.generate();
+				asset_id.generate();
+				owner_id.generate();
+
+				LLSD permissions;
+				permissions["base_mask"] = 0x7fffffff;
+				permissions["creator_id"] = owner_id;
+				permissions["everyone_mask"] = 0;
+				permissions["group_id"] = LLUUID::null;
+				permissions["group_mask"] = 0;
+				permissions["last_owner_id"] = owner_id;
+				permissions["next_owner_mask"] = 0x82000;
+				permissions["owner_id"] = owner_id;
+				permissions["owner_mask"] = 0x7fffffff;
+
+				LLSD sale_info;
+				sale_info["sale_price"] = 10;
+				sale_info["sale_type"] = "not";
+
+				LLSD item;
+				item["asset_id"] = asset_id;
+				item["created_at"] = 1700000000 + i;
+				item["desc"] = "(No Description)";
+				item["flags"] = 0;
+				item["inv_type"] = "object";
+				item["item_id"] = item_id;
+				item["name"] = llformat("Object %d", i);
+				item["parent_id"] = owner_id;
+				item["permissions"] = permissions;
+				item["sale_info"] = sale_info;
+				item["type"] = "object";
+				items[item_id.asString()] = item;
+			}
+			LLSD update;
+			update["_embedded"]["items"] = items;
+			update["_update"]["version"] = 12;
+			return update;
+		}
+
+		// A mesh header: block offsets and sizes per LOD.
+		static LLSD makeMeshHeader()
+		{
+			static const char* blocks[] =
+			{
+				"high_lod", "medium_lod", "low_lod", "lowest_lod",
+				"physics_convex", "physics_mesh", "skin"
+			};
+			LLSD header;
+			LLUUID creator;
+			creator.generate();
+			header["creator"] = creator;
+			header["date"] = LLDate(1700000000.0);
+			header["version"] = 1;
+			S32 offset = 0;
+			for (U32 i = 0; i < LL_ARRAY_SIZE(blocks); ++i)
+			{
+				header[blocks[i]]["offset"] = offset;
+				header[blocks[i]]["size"] = 4096 + (S32)i * 512;
+				offset += 4096 + i * 512;
+			}
+			return header;
+		}
+
+		// Formats and parses sd back repeatedly, logs the time per
+		// iteration and checks the round trip.
+		static void bench(const std::string& name, const LLSD& sd,
+						  LLSDSerialize::ELLSD_Serialize type, S32 iterations)
+		{
+			std::string data;
+			U64 format_time = 0, parse_time = 0;
+			for (S32 i = 0; i < iterations; ++i)
+			{
+				U64 start = LLTimer::getTotalTime();
+				std::ostringstream ostr;
+				LLSDSerialize::serialize(sd, ostr, type);
+				data = ostr.str();
+				U64 formatted = LLTimer::getTotalTime();
+
+				LLSD parsed;
+				std::istringstream istr(data);
+				ensure(name + " parses", LLSDSerialize::deserialize(parsed, istr, data.size()));
+				parse_time += LLTimer::getTotalTime() - formatted;
+				format_time += formatted - start;
+
+				if (!i)
+				{
+					ensure(name + " round trip", llsd_equals(parsed, sd));
+				}
+			}
+			LL_INFOS("LLSDBench") << name << ": " << data.size() << " bytes, format "
+								  << format_time / iterations << " us, parse "
+								  << parse_time / iterations << " us" << LL_ENDL;
+		}
+	};
+	typedef test_group<flatmap_data> flatmap_test;
+	typedef flatmap_test::object flatmap_object;
+	tut::flatmap_test tf("LLSD flat map");
+
+	template<> template<>
+	void flatmap_object::test<1>()
+	{
+		// Iteration and formatting go by key, whatever the insertion order.
+		LLSD sd;
+		sd["c"] = 3;
+		sd["a"] = 1;
+		sd["b"] = 2;
+		std::string keys;
+		for (LLSD::map_const_iterator it = sd.beginMap(); it != sd.endMap(); ++it)
+		{
+			keys += it->first;
+		}
+		ensure_equals("sorted", keys, "abc");
+
+		std::ostringstream ostr;
+		LLSDSerialize::toNotation(sd, ostr);
+		ensure_equals("notation", ostr.str(), "{'a':i1,'b':i2,'c':i3}");
+	}
+
+	template<> template<>
+	void flatmap_object::test<2>()
+	{
+		// References to values outlive insertions, also past the size
+		// at which the map switches to a hash table.
+		LLSD sd;
+		LLSD& first = sd["first"];
+		for (S32 i = 0; i < 100; ++i)
+		{
+			sd[llformat("key%03d", i)] = i;
+		}
+		first = "still here";
+		ensure_equals("reference", sd["first"].asString(), "still here");
+		ensure_equals("size", sd.size(), 101);
+	}
+
+	template<> template<>
+	void flatmap_object::test<3>()
+	{
+		// Same content as a std::map through inserts, lookups and erases
+		// on both sides of the hash table threshold.
+		LLSD sd = LLSD::emptyMap();
+		std::map<std::string, S32> reference;
+		for (S32 i = 0; i < 2000; ++i)
+		{
+			std::string key = llformat("k%d", (i * 7919) % 37);
+			if (i % 3 == 2)
+			{
+				sd.erase(key);
+				reference.erase(key);
+			}
+			else
+			{
+				sd[key] = i;
+				reference[key] = i;
+			}
+			ensure_equals("size", sd.size(), (S32)reference.size());
+			ensure_equals("has", sd.has(key), reference.count(key) != 0);
+		}
+		LLSD::map_const_iterator it = sd.beginMap();
+		for (std::map<std::string, S32>::const_iterator ref = reference.begin(); ref != reference.end(); ++ref, ++it)
+		{
+			ensure_equals("key", it->first, ref->first);
+			ensure_equals("value", it->second.asInteger(), ref->second);
+		}
+		ensure("end", it == sd.endMap());
+	}
+
+	template<> template<>
+	void flatmap_object::test<4>()
+	{
+		// insert() keeps an existing value, copies do not share the map.
+		LLSD sd;
+		sd.insert("a", 1);
+		sd.insert("a", 2);
+		ensure_equals("insert", sd["a"].asInteger(), 1);
+
+		LLSD copy = sd;
+		copy["a"] = 3;
+		copy["b"] = 4;
+		ensure_equals("original", sd["a"].asInteger(), 1);
+		ensure("original keys", !sd.has("b"));
+		ensure_equals("copy", copy["a"].asInteger(), 3);
+	}
+
+	template<> template<>
+	void flatmap_object::test<5>()
+	{
+		// Parse and format timings of typical payloads, see the log.
+		const S32 ITERATIONS = 50;
+		LLSD caps = makeCapabilities();
+		LLSD inventory = makeInventoryUpdate(200);
+		LLSD header = makeMeshHeader();
+
+		bench("capabilities xml", caps, LLSDSerialize::LLSD_XML, ITERATIONS);
+		bench("capabilities binary", caps, LLSDSerialize::LLSD_BINARY, ITERATIONS);
+		bench("inventory xml", inventory, LLSDSerialize::LLSD_XML, ITERATIONS);
+		bench("inventory notation", inventory, LLSDSerialize::LLSD_NOTATION, ITERATIONS);
+		bench("inventory binary", inventory, LLSDSerialize::LLSD_BINARY, ITERATIONS);
+		bench("mesh header binary", header, LLSDSerialize::LLSD_BINARY, ITERATIONS * 10);
+
+		// Lookups by key in the items map, as done when applying the update.
+		const LLSD& items = inventory["_embedded"]["items"];
+		std::vector<std::string> keys;
+		for (LLSD::map_const_iterator it = items.beginMap(); it != items.endMap(); ++it)
+		{
+			keys.push_back(it->first);
+		}
+		S32 found = 0;
+		U64 start = LLTimer::getTotalTime();
+		for (S32 i = 0; i < ITERATIONS; ++i)
+		{
+			for (std::vector<std::string>::const_iterator key = keys.begin(); key != keys.end(); ++key)
+			{
+				found += items[*key].has("item_id");
+			}
+		}
+		U64 lookup_time = LLTimer::getTotalTime() - start;
+		ensure_equals("all found", found, ITERATIONS * (S32)keys.size());
+		LL_INFOS("LLSDBench") << "inventory lookups: " << keys.size() << " keys, "
+							  << lookup_time / ITERATIONS << " us" << LL_ENDL;
+	}
+
+	template<> template<>
+	void flatmap_object::test<6>()
+	{
+		// The container itself against a std::map, with keys added out of
+		// order, erased both by key and while iterating, and iteration in
+		// between.
+		typedef LLSDFlatMap<S32> flat_map_t;
+		flat_map_t flat;
+		std::map<std::string, S32> reference;
+		for (S32 i = 0; i < 5000; ++i)
+		{
+			std::string key = llformat("k%d", (i * 7919) % 1009);
+			if (i % 5 == 4)
+			{
+				ensure_equals("erase", flat.erase(key), reference.erase(key));
+			}
+			else
+			{
+				flat[key] = i;
+				reference[key] = i;
+			}
+			const S32* value = flat.lookup(key);
+			ensure_equals("lookup", value != NULL, reference.count(key) != 0);
+			if (i % 500 == 0)
+			{
+				ensure("sorted", std::equal(flat.begin(), flat.end(), reference.begin()));
+			}
+		}
+		ensure_equals("size", flat.size(), reference.size());
+		ensure("sorted", std::equal(flat.begin(), flat.end(), reference.begin()));
+		ensure("reverse", std::equal(flat.rbegin(), flat.rend(), reference.rbegin()));
+
+		flat_map_t copy(flat);
+		ensure("copy", std::equal(copy.begin(), copy.end(), reference.begin()));
+
+		// Erase every other entry while iterating.
+		const size_t full_size = reference.size();
+		bool odd = false;
+		for (flat_map_t::iterator it = flat.begin(); it != flat.end(); odd = !odd)
+		{
+			if (odd)
+			{
+				it = flat.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		odd = false;
+		for (std::map<std::string, S32>::iterator it = reference.begin(); it != reference.end(); odd = !odd)
+		{
+			if (odd)
+			{
+				it = reference.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+		ensure_equals("erased size", flat.size(), reference.size());
+		ensure("erased", std::equal(flat.begin(), flat.end(), reference.begin()));
+		for (std::map<std::string, S32>::const_iterator it = reference.begin(); it != reference.end(); ++it)
+		{
+			ensure_equals("found", flat.find(it->first)->second, it->second);
+		}
+		ensure_equals("copy kept", copy.size(), flat.size() + full_size / 2);
+	}
+
+	template<> template<>
+	void flatmap_object::test<7>()
+	{
+		// Building a large map in reverse key order and then emptying it,
+		// looking keys up in between, takes about as long as in key order.
+		const S32 COUNT = 50000;
+		U64 times[2];
+		for (S32 reverse = 0; reverse < 2; ++reverse)
+		{
+			U64 start = LLTimer::getTotalTime();
+			LLSD sd = LLSD::emptyMap();
+			for (S32 i = 0; i < COUNT; ++i)
+			{
+				std::string key = llformat("%06d", reverse ? COUNT - i : i);
+				sd[key] = i;
+				ensure("has", sd.has(key));
+			}
+			for (S32 i = 0; i < COUNT; ++i)
+			{
+				sd.erase(llformat("%06d", reverse ? i : COUNT - i));
+			}
+			ensure_equals("emptied", sd.size(), 1);
+			times[reverse] = LLTimer::getTotalTime() - start;
+		}
+		LL_INFOS("LLSDBench") << COUNT << " inserts and erases: in order " << times[0]
+							  << " us, reverse order " << times[1] << " us" << LL_ENDL;
+	}
+}
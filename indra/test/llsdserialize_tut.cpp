@@ -32,6 +32,7 @@
  */
 
 #include <tut/tut.hpp>
+#include <boost/bind.hpp>
 
 #if !LL_WINDOWS
 #include <netinet/in.h>
@@ -39,7 +40,10 @@
 
 #include "linden_common.h"
 #include "llsd.h"
+#include "llsdasync.h"
 #include "llsdserialize.h"
+#include "llsdutil.h"
+#include "lltimer.h"
 #include "lltut.h"
 #include "llformat.h"
 
@@ -1439,6 +1443,447 @@ namespace tut
 		ensureBinaryAndNotation("map", test);
 		ensureBinaryAndXML("map", test);
 	}
+
+	struct TestLLSDPullParser
+	{
+		TestLLSDPullParser()
+		{
+			mDocument = LLSD::emptyMap();
+			mDocument["name"] = "pull";
+			mDocument["skipped"] = LLSD::emptyArray();
+			mDocument["skipped"].append(1);
+			mDocument["skipped"].append(LLSD::emptyMap());
+			mDocument["skipped"][1]["deep"] = 2.5;
+			mDocument["wanted"] = LLSD::emptyArray();
+			mDocument["wanted"].append(LLUUID::generateNewID());
+			mDocument["wanted"].append(LLDate(12345.0));
+			mDocument["wanted"].append(LLSD());
+
+			std::ostringstream ostr;
+			LLSDSerialize::toBinary(mDocument, ostr);
+			mBinary = ostr.str();
+		}
+
+		LLSD mDocument;
+		std::string mBinary;
+	};
+	typedef tut::test_group<TestLLSDPullParser> TestLLSDPullParserGroup;
+	typedef TestLLSDPullParserGroup::object TestLLSDPullParserObject;
+	TestLLSDPullParserGroup gTestLLSDPullParserGroup("llsd binary pull parser");
+
+	template<> template<>
+	void TestLLSDPullParserObject::test<1>()
+	{
+		// Event stream of a whole document
+		std::istringstream istr(mBinary);
+		LLSDBinaryPullParser parser(istr, (S32)mBinary.size());
+		ensure_equals("map begin", parser.next(), LLSDBinaryPullParser::EV_MAP_BEGIN);
+		ensure_equals("map size", parser.getSize(), 3);
+		S32 values = 0;
+		S32 containers = 1;
+		LLSDBinaryPullParser::EEvent event;
+		while ((event = parser.next()) > LLSDBinaryPullParser::EV_END_OF_DOCUMENT)
+		{
+			if (event == LLSDBinaryPullParser::EV_VALUE)
+			{
+				++values;
+				if (parser.getKey() == "name")
+				{
+					ensure_equals("name", parser.getValue().asString(), std::string("pull"));
+				}
+			}
+			else if (event == LLSDBinaryPullParser::EV_MAP_BEGIN
+					 || event == LLSDBinaryPullParser::EV_ARRAY_BEGIN)
+			{
+				++containers;
+			}
+		}
+		ensure_equals("end of document", event, LLSDBinaryPullParser::EV_END_OF_DOCUMENT);
+		ensure_equals("values", values, 6);
+		ensure_equals("containers", containers, 4);
+		ensure_equals("depth", parser.getDepth(), 0);
+		ensure_equals("stays at end", parser.next(), LLSDBinaryPullParser::EV_END_OF_DOCUMENT);
+	}
+
+	template<> template<>
+	void TestLLSDPullParserObject::test<2>()
+	{
+		// Skip one subtree and materialize another
+		std::istringstream istr(mBinary);
+		LLSDBinaryPullParser parser(istr, (S32)mBinary.size());
+		ensure_equals("map begin", parser.next(), LLSDBinaryPullParser::EV_MAP_BEGIN);
+		LLSD wanted;
+		while (parser.next() > LLSDBinaryPullParser::EV_END_OF_DOCUMENT)
+		{
+			if (parser.getDepth() != 2) continue;
+			if (parser.getKey() == "skipped")
+			{
+				ensure("skip", parser.skip());
+				ensure_equals("depth after skip", parser.getDepth(), 1);
+			}
+			else if (parser.getKey() == "wanted")
+			{
+				ensure("read value", parser.readValue(wanted));
+			}
+		}
+		ensure_equals("end of document", parser.getEvent(), LLSDBinaryPullParser::EV_END_OF_DOCUMENT);
+		ensure("wanted", llsd_equals(wanted, mDocument["wanted"]));
+
+		// The root read in one go
+		std::istringstream istr2(mBinary);
+		LLSDBinaryPullParser parser2(istr2, (S32)mBinary.size());
+		parser2.next();
+		LLSD document;
+		ensure("read document", parser2.readValue(document));
+		ensure("document", llsd_equals(document, mDocument));
+	}
+
+	template<> template<>
+	void TestLLSDPullParserObject::test<3>()
+	{
+		// Truncated and size limited input
+		std::string truncated = mBinary.substr(0, mBinary.size() - 4);
+		std::istringstream istr(truncated);
+		LLSDBinaryPullParser parser(istr, LLSDSerialize::SIZE_UNLIMITED);
+		LLSDBinaryPullParser::EEvent event;
+		while ((event = parser.next()) > LLSDBinaryPullParser::EV_END_OF_DOCUMENT);
+		ensure_equals("truncated", event, LLSDBinaryPullParser::EV_ERROR);
+		ensure_equals("stays in error", parser.next(), LLSDBinaryPullParser::EV_ERROR);
+
+		std::istringstream istr2(mBinary);
+		LLSDBinaryPullParser parser2(istr2, 16);
+		parser2.next();
+		LLSD document;
+		ensure("over limit", !parser2.readValue(document));
+	}
+
+	template<> template<>
+	void TestLLSDPullParserObject::test<4>()
+	{
+		// Parse and format jobs, run synchronously without worker threads
+		// and delivered to this thread.
+		struct Results
+		{
+			static void parsed(LLSD* out, bool success, const LLSD& data)
+			{
+				if (success) *out = data;
+			}
+			static void formatted(std::string* out, bool success, const std::string& data)
+			{
+				if (success) *out = data;
+			}
+		};
+
+		LLSDAsyncSerializer::initClass(0);
+		LLSD from_binary, from_xml, from_notation;
+		std::string xml;
+		LLSDAsyncSerializer::parse(mBinary, boost::bind(&Results::parsed, &from_binary, _1, _2));
+		LLSDAsyncSerializer::format(mDocument, LLSDSerialize::LLSD_XML,
+									boost::bind(&Results::formatted, &xml, _1, _2));
+		std::ostringstream notation;
+		LLSDSerialize::toNotation(mDocument, notation);
+		LLSDAsyncSerializer::parse(notation.str(), LLSDSerialize::LLSD_NOTATION,
+								   boost::bind(&Results::parsed, &from_notation, _1, _2));
+		ensure_equals("pending", LLSDAsyncSerializer::getPendingCount(), 3);
+		ensure("not delivered yet", from_binary.isUndefined() && xml.empty());
+		ensure_equals("delivered", LLSDAsyncSerializer::deliver(), 3);
+		ensure_equals("nothing pending", LLSDAsyncSerializer::getPendingCount(), 0);
+		ensure("binary", llsd_equals(from_binary, mDocument));
+		ensure("notation", llsd_equals(from_notation, mDocument));
+
+		ensure("xml", LLSDAsyncSerializer::parseBuffer(xml, from_xml));
+		ensure("xml round trip", llsd_equals(from_xml, mDocument));
+		LLSDAsyncSerializer::cleanupClass();
+	}
+
+	struct TestLLSDBufferParser
+	{
+		TestLLSDBufferParser()
+		{
+			mDocument = LLSD::emptyMap();
+			mDocument["undef"] = LLSD();
+			mDocument["true"] = true;
+			mDocument["false"] = false;
+			mDocument["min"] = (S32)0x80000000;
+			mDocument["max"] = 0x7fffffff;
+			mDocument["third"] = 1.0 / 3.0;
+			mDocument["tiny"] = -1.5e-300;
+			mDocument["id"] = LLUUID::generateNewID();
+			mDocument["date"] = LLDate(1234567890.0);
+			mDocument["uri"] = LLURI("http://example.com/cap/1?x='y'");
+			mDocument["quotes"] = "it's a \"quoted\" \\ string\n\twith escapes";
+			mDocument["long"] = std::string(300, 'x') + "\x01\x7f\xff" + std::string(40, 'y');
+			mDocument[""] = "empty key";
+			LLSD::Binary binary;
+			for (S32 i = 0; i < 256; ++i)
+			{
+				binary.push_back((U8)i);
+			}
+			mDocument["binary"] = binary;
+			LLSD& array = mDocument["array"];
+			for (S32 i = 0; i < 20; ++i)
+			{
+				LLSD item;
+				item["name"] = llformat("item %d", i);
+				item["value"] = i * 0.25;
+				item["nested"].append(i);
+				item["nested"].append(LLSD::emptyMap());
+				array.append(item);
+			}
+
+			std::ostringstream binary_str, notation_str;
+			LLSDSerialize::toBinary(mDocument, binary_str);
+			LLSDSerialize::toNotation(mDocument, notation_str);
+			mBinary = binary_str.str();
+			mNotation = notation_str.str();
+		}
+
+		static S32 parseStream(bool binary, const std::string& text, LLSD& data)
+		{
+			std::istringstream istr(text);
+			return binary ? LLSDSerialize::fromBinary(data, istr, (S32)text.size())
+						  : LLSDSerialize::fromNotation(data, istr, (S32)text.size());
+		}
+
+		static S32 parseBuffer(bool binary, const std::string& text, LLSD& data)
+		{
+			return binary ? LLSDSerialize::fromBinary(data, text.data(), text.size(), (S32)text.size())
+						  : LLSDSerialize::fromNotation(data, text.data(), text.size(), (S32)text.size());
+		}
+
+		// Compares the binary serializations, which also tells apart NaNs
+		// and the types llsd_equals() does not look into.
+		static bool same(const LLSD& a, const LLSD& b)
+		{
+			std::ostringstream astr, bstr;
+			LLSDSerialize::toBinary(a, astr);
+			LLSDSerialize::toBinary(b, bstr);
+			return astr.str() == bstr.str();
+		}
+
+		void ensureSameAsStream(const std::string& msg, bool binary, const std::string& text)
+		{
+			LLSD from_stream, from_buffer;
+			S32 stream_count = parseStream(binary, text, from_stream);
+			S32 buffer_count = parseBuffer(binary, text, from_buffer);
+			ensure_equals(msg + " count", buffer_count, stream_count);
+			ensure(msg + " value", same(from_buffer, from_stream));
+		}
+
+		LLSD mDocument;
+		std::string mBinary;
+		std::string mNotation;
+	};
+	typedef tut::test_group<TestLLSDBufferParser> TestLLSDBufferParserGroup;
+	typedef TestLLSDBufferParserGroup::object TestLLSDBufferParserObject;
+	TestLLSDBufferParserGroup gTestLLSDBufferParserGroup("llsd buffer parser");
+
+	template<> template<>
+	void TestLLSDBufferParserObject::test<1>()
+	{
+		// Round trips, and where the parse stops with data following
+		for (S32 i = 0; i < 2; ++i)
+		{
+			const bool binary = !i;
+			const std::string& text = binary ? mBinary : mNotation;
+			LLSD parsed;
+			ensure("parse", parseBuffer(binary, text, parsed) > 0);
+			// Notation writes reals with six digits.
+			ensure("round trip", llsd_equals(parsed, mDocument, binary ? -1 : 16));
+			ensureSameAsStream("document", binary, text);
+
+			std::string followed = text + "[trailing]";
+			std::istringstream istr(followed);
+			LLSD from_stream;
+			if (binary)
+			{
+				LLSDSerialize::fromBinary(from_stream, istr, (S32)followed.size());
+			}
+			else
+			{
+				LLSDSerialize::fromNotation(from_stream, istr, (S32)followed.size());
+			}
+			LLSDBufferParser parser(binary ? LLSDBufferParser::BINARY : LLSDBufferParser::NOTATION);
+			ensure("parse followed", parser.parse(followed.data(), followed.size(), parsed,
+												   LLSDSerialize::SIZE_UNLIMITED) > 0);
+			ensure_equals("bytes read", (S32)parser.getBytesRead(), (S32)istr.tellg());
+			ensure_equals("whole document", parser.getBytesRead(), text.size());
+
+			// Limited to one byte short
+			ensure_equals("over limit", parser.parse(text.data(), text.size(), parsed,
+													 (S32)text.size() - 1),
+						  (S32)LLSDParser::PARSE_FAILURE);
+			ensure("cleared", parsed.isUndefined());
+		}
+
+		// With a header
+		std::ostringstream ostr;
+		LLSDSerialize::serialize(mDocument, ostr, LLSDSerialize::LLSD_NOTATION);
+		std::string text = ostr.str();
+		LLSD parsed;
+		ensure("deserialize", LLSDSerialize::deserialize(parsed, text.data(), text.size(), (S32)text.size()));
+		ensure("deserialized", llsd_equals(parsed, mDocument, 16));
+	}
+
+	template<> template<>
+	void TestLLSDBufferParserObject::test<2>()
+	{
+		// The spellings the notation fast paths leave to the stream
+		static const char* tokens[] =
+		{
+			"i0", "i-2147483648", "i2147483647", "i2147483648", "i-2147483649", "i +7",
+			"i", "i-", "i12.5", "r1", "r-0.5", "r+2.25", "r1e5", "r1.5E-3", "r.5", "r1.",
+			"r.", "r-", "r0.1", "r123456789012345678901234", "r1e400", "r1e-400", "r1e",
+			"r1e+", "r2.5e3.5", "rnan", "r 3.75", "r9007199254740993", "r1.7976931348623157e308",
+			"u00000000-0000-0000-0000-000000000000", "u 0fd4e1ad-3fa0-4e3a-9b8e-1e7e0f5a9c2b",
+			"u0FD4E1AD-3FA0-4E3A-9B8E-1E7E0F5A9C2B", "u0fd4e1ad 3fa0-4e3a-9b8e-1e7e0f5a9c2b",
+			"u0fd4e1ad-3fa0-4e3a-9b8e-1e7e0f5a9c2", "ubad", "TRUE", "True", "f", "false",
+			"FALSE", "fals", "truex", "t", "T", "0", "1", "!", "'a\\'b\\x41\\n'", "\"\"",
+			"\"say \\\"hi\\\"\"", "'\\x4'", "s(3)\"abc\"", "s(0x3)'abc'", "s(3)\"ab",
+"s\"abc\"", "b(2)\"xy\"", "b(3)\"xy\"", "b64\"aGVsbG8=\"", "b64\"\"",
+			"b16\"48656C6C6F\"", "b16\"\"", "b32\"x\"", "l\"http://x/\"", "l'a'", "l",
+			"d\"2026-01-02T03:04:05Z\"", "d\"bad\"", "x"
+		};
+		for (U32 i = 0; i < LL_ARRAY_SIZE(tokens); ++i)
+		{
+			std::string token(tokens[i]);
+			ensureSameAsStream(token, false, token);
+			ensureSameAsStream("[" + token + "]", false, "[" + token + "]");
+			ensureSameAsStream("{'k':" + token + "}", false, "{'k':" + token + ", 'z':i1}");
+		}
+
+		// Map and array oddities the stream parser tolerates
+		static const char* documents[] =
+		{
+			"{'a':i1,'b':i2}", "{ 'a' : i1 , garbage 'b':i2 }", "{'a'}", "{'a':i1,'a':i2}",
+			"{s(1)'a':i1}", "{'a':i1", "[i1,,i2 ,]", "[i1 i2]", "[", "{", "   ", "",
+			"[[[[]]]]", "{'a':{'b':[{'c':!}]}}"
+		};
+		for (U32 i = 0; i < LL_ARRAY_SIZE(documents); ++i)
+		{
+			ensureSameAsStream(documents[i], false, documents[i]);
+		}
+	}
+
+	template<> template<>
+	void TestLLSDBufferParserObject::test<3>()
+	{
+		// Fuzzing: damaged copies of both documents must parse to the same
+		// thing, or fail the same way, as with the stream parsers.
+		static const char structural[] = "{}[]'\"\\:,sibrlduk!01(). \x00\xff";
+		srand(0x5eed);
+		S32 compared = 0;
+		for (S32 i = 0; i < 4000; ++i)
+		{
+			const bool binary = i & 1;
+			std::string text = binary ? mBinary : mNotation;
+			S32 changes = 1 + rand() % 4;
+			while (changes-- && text.size() > 1)
+			{
+				// The first byte stays: a container at the top level
+				// fails as a whole, where the stream parsers return a
+				// truncated scalar as valid.
+				size_t pos = 1 + rand() % (text.size() - 1);
+				switch (rand() % 4)
+				{
+				case 0:
+					text[pos] = (char)rand();
+					break;
+				case 1:
+					text[pos] = structural[rand() % (sizeof(structural) - 1)];
+					break;
+				case 2:
+					text.erase(pos, 1 + rand() % 8);
+					break;
+				default:
+					text.resize(pos);
+					break;
+				}
+			}
+			if (!binary && text.find("b16") != std::string::npos)
+			{
+				// The stream parser loops forever on unterminated base 16.
+				continue;
+			}
+
+			LLSD from_stream, from_buffer;
+			S32 stream_count;
+			try
+			{
+				stream_count = parseStream(binary, text, from_stream);
+			}
+			catch (...)
+			{
+				// Negative raw sizes make the stream parser resize a
+				// vector past its maximum size.
+				continue;
+			}
+			S32 buffer_count = parseBuffer(binary, text, from_buffer);
+			std::string msg = llformat("%s fuzz %d", binary ? "binary" : "notation", i);
+			ensure_equals(msg + " count", buffer_count, stream_count);
+			ensure(msg + " value", same(from_buffer, from_stream));
+			++compared;
+		}
+		ensure("compared", compared > 3000);
+	}
+
+	template<> template<>
+	void TestLLSDBufferParserObject::test<4>()
+	{
+		// Throughput against the stream parsers, see the log.
+		LLSD items = LLSD::emptyMap();
+		for (S32 i = 0; i < 200; ++i)
+		{
+			LLUUID item_id = LLUUID::generateNewID();
+			LLSD item;
+			item["item_id"] = item_id;
+			item["asset_id"] = LLUUID::generateNewID();
+			item["parent_id"] = LLUUID::generateNewID();
+			item["name"] = llformat("Inventory item number %d", i);
+			item["desc"] = "A \"quoted\" description, long enough to be scanned in blocks";
+			item["type"] = i % 20;
+			item["flags"] = 0x100 * i;
+			item["created_at"] = LLDate(1700000000.0 + i);
+			item["sale_price"] = 10.5 * i;
+			items[item_id.asString()] = item;
+		}
+
+		const S32 ITERATIONS = 20;
+		for (S32 i = 0; i < 2; ++i)
+		{
+			const bool binary = !i;
+			std::ostringstream ostr;
+			if (binary)
+			{
+				LLSDSerialize::toBinary(items, ostr);
+			}
+			else
+			{
+				LLSDSerialize::toNotation(items, ostr);
+			}
+			const std::string text = ostr.str();
+
+			LLSD from_stream, from_buffer;
+			U64 start = LLTimer::getTotalTime();
+			for (S32 j = 0; j < ITERATIONS; ++j)
+			{
+				parseStream(binary, text, from_stream);
+			}
+			U64 stream_time = LLTimer::getTotalTime() - start;
+			start = LLTimer::getTotalTime();
+			for (S32 j = 0; j < ITERATIONS; ++j)
+			{
+				parseBuffer(binary, text, from_buffer);
+			}
+			U64 buffer_time = LLTimer::getTotalTime() - start;
+
+			ensure("same result", same(from_buffer, from_stream));
+			ensure("complete", llsd_equals(from_buffer, items, binary ? -1 : 16));
+			LL_INFOS("LLSDBench") << (binary ? "binary " : "notation ") << text.size()
+								  << " bytes, stream " << stream_time / ITERATIONS
+								  << " us, buffer " << buffer_time / ITERATIONS << " us" << LL_ENDL;
+		}
+	}
 }
 
 #endif
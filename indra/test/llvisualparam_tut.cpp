@@ -0,0 +1,255 @@
+/**
+ * @file llvisualparam_tut.cpp
+ * @brief LLCharacter visual param dirty tracking tests.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include <tut/tut.hpp>
+
+#include <vector>
+
+#include "linden_common.h"
+#include "llcharacter.h"
+#include "llvisualparam.h"
+#include "llformat.h"
+#include "lltut.h"
+#include "v3dmath.h"
+
+namespace tut
+{
+	class TestParamInfo : public LLVisualParamInfo
+	{
+	public:
+		TestParamInfo(S32 id, F32 default_weight, ESex sex)
+		{
+			mID = id;
+			mName = llformat("param%d", id);
+			mDefaultWeight = default_weight;
+			mSex = sex;
+		}
+	};
+
+	// Applies like a morph: remembers the weight it applied, unless told to
+	// wait the way a morph waits for its masks.
+	class TestParam : public LLVisualParam
+	{
+	public:
+		TestParam() : mApplies(0), mDeferred(false), mDriven(NULL) {}
+
+		void setInfo(TestParamInfo* info)
+		{
+			mInfo = info;
+			mID = info->getID();
+			setWeight(getDefaultWeight());
+		}
+
+		/*virtual*/ void apply(ESex avatar_sex)
+		{
+			if (mDeferred)
+			{
+				return;
+			}
+			++mApplies;
+			mLastWeight = (getSex() & avatar_sex) ? mCurWeight : getDefaultWeight();
+		}
+
+		// Drives mDriven at half its own weight, like LLDriverParam.
+		/*virtual*/ void setWeight(F32 weight, bool upload_bake = false)
+		{
+			LLVisualParam::setWeight(weight, upload_bake);
+			if (mDriven)
+			{
+				mDriven->setWeight(getWeight() * 0.5f, upload_bake);
+			}
+		}
+
+		/*virtual*/ char const* getTypeString() const			{ return "test"; }
+		/*virtual*/ std::string getDumpWearableTypeName() const	{ return "test"; }
+
+		S32			mApplies;
+		bool		mDeferred;
+		TestParam*	mDriven;
+	};
+
+	class ParamTestCharacter : public LLCharacter
+	{
+	public:
+		ParamTestCharacter() { mID.generate(); }
+
+		/*virtual*/ const char* getAnimationPrefix()		{ return "avatar"; }
+		/*virtual*/ LLJoint* getRootJoint()					{ return NULL; }
+		/*virtual*/ LLVector3 getCharacterPosition()		{ return LLVector3::zero; }
+		/*virtual*/ LLQuaternion getCharacterRotation()	{ return LLQuaternion::DEFAULT; }
+		/*virtual*/ LLVector3 getCharacterVelocity()		{ return LLVector3::zero; }
+		/*virtual*/ LLVector3 getCharacterAngularVelocity()	{ return LLVector3::zero; }
+		/*virtual*/ void getGround(const LLVector3& in_pos, LLVector3& out_pos, LLVector3& out_norm)
+		{
+			out_pos = in_pos;
+			out_norm = LLVector3::z_axis;
+		}
+		/*virtual*/ LLJoint* getCharacterJoint(U32 i)		{ return NULL; }
+		/*virtual*/ F32 getTimeDilation()					{ return 1.f; }
+		/*virtual*/ F32 getPixelArea() const				{ return 1000000.f; }
+		/*virtual*/ LLPolyMesh* getHeadMesh()				{ return NULL; }
+		/*virtual*/ LLPolyMesh* getUpperBodyMesh()			{ return NULL; }
+		/*virtual*/ LLVector3d getPosGlobalFromAgent(const LLVector3& position)	{ return LLVector3d(position); }
+		/*virtual*/ LLVector3 getPosAgentFromGlobal(const LLVector3d& position)	{ return LLVector3(position); }
+		/*virtual*/ void addDebugText(const std::string& text) {}
+		/*virtual*/ const LLUUID& getID() const				{ return mID; }
+
+	private:
+		LLUUID	mID;
+	};
+
+	struct visualparam_data
+	{
+		enum { PARAMS = 200 };
+
+		visualparam_data()
+		{
+			// Every tenth param has a non zero default, the last ones only
+			// apply to males.
+			for (S32 i = 0; i < PARAMS; ++i)
+			{
+				TestParamInfo* info = new TestParamInfo(i, (i % 10) ? 0.f : 0.5f, i < PARAMS - 5 ? SEX_BOTH : SEX_MALE);
+				mInfos.push_back(info);
+				TestParam* param = new TestParam;
+				param->setInfo(info);
+				mParams.push_back(param);
+				mCharacter.addVisualParam(param);
+			}
+			// param 1 drives param 2, which drives param 3
+			mParams[1]->mDriven = mParams[2];
+			mParams[2]->mDriven = mParams[3];
+		}
+
+		~visualparam_data()
+		{
+			for (size_t i = 0; i < mInfos.size(); ++i)
+			{
+				delete mInfos[i];
+			}
+		}
+
+		// Counts of one update: params checked, params applied
+		std::pair<U32, U32> update()
+		{
+			U32 checked = LLCharacter::sVisualParamsChecked;
+			U32 applied = LLCharacter::sVisualParamsApplied;
+			mCharacter.updateVisualParams();
+			return std::make_pair(LLCharacter::sVisualParamsChecked - checked,
+								  LLCharacter::sVisualParamsApplied - applied);
+		}
+
+		// The character owns and deletes the params.
+		ParamTestCharacter			mCharacter;
+		std::vector<TestParam*>		mParams;
+		std::vector<TestParamInfo*>	mInfos;
+	};
+	typedef test_group<visualparam_data> visualparam_test;
+	typedef visualparam_test::object visualparam_object;
+	tut::visualparam_test visualparam_testcase("visualparam");
+
+	template<> template<>
+	void visualparam_object::test<1>()
+	{
+		// The first update looks at everything, after that only the
+		// changed params and the ones they drive are looked at.
+		std::pair<U32, U32> counts = update();
+		ensure_equals("first checked", counts.first, (U32)PARAMS);
+		ensure_equals("first applied", counts.second, (U32)(PARAMS / 10));
+		ensure_equals("param 10", mParams[10]->getLastWeight(), 0.5f);
+
+		counts = update();
+		ensure_equals("idle checked", counts.first, 0U);
+
+		mCharacter.setVisualParamWeight(mParams[50], 0.25f);
+		counts = update();
+		ensure_equals("one checked", counts.first, 1U);
+		ensure_equals("one applied", counts.second, 1U);
+		ensure_equals("one weight", mParams[50]->getLastWeight(), 0.25f);
+
+		// Same weight again
+		mCharacter.setVisualParamWeight(mParams[50], 0.25f);
+		ensure_equals("same checked", update().first, 0U);
+
+		// A driver and its chain
+		mCharacter.setVisualParamWeight(mParams[1], 0.8f);
+		counts = update();
+		ensure_equals("chain checked", counts.first, 3U);
+		ensure_equals("chain applied", counts.second, 3U);
+		ensure_equals("driven", mParams[2]->getLastWeight(), 0.4f);
+		ensure_equals("driven twice", mParams[3]->getLastWeight(), 0.2f);
+		ensure_equals("driven applies", mParams[3]->mApplies, 1);
+	}
+
+	template<> template<>
+	void visualparam_object::test<2>()
+	{
+		// A change of sex only touches the params for one sex.
+		update();
+		mCharacter.setVisualParamWeight(mParams[PARAMS - 1], 1.f);
+		std::pair<U32, U32> counts = update();
+		ensure_equals("female checked", counts.first, 1U);
+		ensure_equals("female applied", counts.second, 0U);
+
+		mCharacter.setSex(SEX_MALE);
+		counts = update();
+		ensure_equals("male checked", counts.first, 5U);
+		ensure_equals("male applied", counts.second, 1U);
+		ensure_equals("male weight", mParams[PARAMS - 1]->getLastWeight(), 1.f);
+
+		mCharacter.setSex(SEX_FEMALE);
+		update();
+		ensure_equals("female weight", mParams[PARAMS - 1]->getLastWeight(), 0.f);
+	}
+
+	template<> template<>
+	void visualparam_object::test<3>()
+	{
+		// Animating and deferred params wait, and get applied in the end.
+		update();
+		TestParam* animated = mParams[20];
+		animated->setAnimationTarget(1.f);
+		animated->animate(0.5f);
+		std::pair<U32, U32> counts = update();
+		ensure_equals("animating checked", counts.first, 1U);
+		ensure_equals("animating applied", counts.second, 0U);
+		animated->stopAnimating();
+		counts = update();
+		ensure_equals("stopped applied", counts.second, 1U);
+		ensure_equals("stopped weight", animated->getLastWeight(), 1.f);
+
+		TestParam* deferred = mParams[30];
+		deferred->mDeferred = true;
+		mCharacter.setVisualParamWeight(deferred, 0.75f);
+		update();
+		counts = update();
+		ensure_equals("still waiting", counts.first, 1U);
+		deferred->mDeferred = false;
+		update();
+		ensure_equals("deferred weight", deferred->getLastWeight(), 0.75f);
+		ensure_equals("deferred idle", update().first, 0U);
+	}
+}
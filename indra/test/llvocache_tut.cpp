@@ -0,0 +1,120 @@
+/**
+ * @file llvocache_tut.cpp
+ * @brief LLVOCacheEntry tests against compressed object updates.
+ *
+ * $LicenseInfo:firstyear=2026&license=viewerlgpl$
+ * Second Life Viewer Source Code
+ * Copyright (C) 2026, Linden Research, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation;
+ * version 2.1 of the License only.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ *
+ * Linden Research, Inc., 945 Battery Street, San Francisco, CA  94111  USA
+ * $/LicenseInfo$
+ */
+
+
+#include <tut/tut.hpp>
+
+#include "linden_common.h"
+#include "llcontrol.h"
+#include "llvocache.h"
+#include "lltut.h"
+#include "v3math.h"
+
+// Defined by llviewercontrol.cpp in the viewer, read by LLVOCache.
+LLControlGroup gSavedSettings("Global");
+
+namespace tut
+{
+	struct vocache_data
+	{
+		// Packs an update the way the simulator sends OUT_FULL_COMPRESSED
+		// object data, see LLViewerObject::processUpdateMessage().
+		static S32 packUpdate(U8* buffer, S32 size, U32 special_code,
+							  const LLVector3& scale, const LLVector3& pos, U32 parent_id)
+		{
+			LLDataPackerBinaryBuffer dp(buffer, size);
+			LLUUID id;
+			id.generate();
+			dp.packUUID(id, "ID");
+			dp.packU32(1234, "LocalID");
+			dp.packU8(9, "PCode");			// LL_PCODE_VOLUME
+			dp.packU8(7, "State");
+			dp.packU32(0xdeadbeef, "CRC");
+			dp.packU8(3, "Material");		// LL_MCODE_WOOD
+			dp.packU8(1, "ClickAction");
+			dp.packVector3(scale, "Scale");
+			dp.packVector3(pos, "Pos");
+			dp.packVector3(LLVector3(0.f, 0.5f, 0.f), "Rot");
+			dp.packU32(special_code, "SpecialCode");
+			dp.packUUID(id, "Owner");
+			if (special_code & 0x80)
+			{
+				dp.packVector3(LLVector3(0.f, 0.f, 1.f), "Omega");
+			}
+			if (special_code & 0x20)
+			{
+				dp.packU32(parent_id, "ParentID");
+			}
+			// Tree data
+			dp.packU8(3, "TreeData");
+			return dp.getCurrentSize();
+		}
+	};
+	typedef test_group<vocache_data> vocache_test;
+	typedef vocache_test::object vocache_object;
+	tut::vocache_test vocache_testcase("vocache");
+
+	template<> template<>
+	void vocache_object::test<1>()
+	{
+		// The placement comes out of a full update with a parent and spin.
+		const LLVector3 scale(0.5f, 2.f, 3.25f);
+		const LLVector3 pos(128.f, 64.5f, 22.f);
+		U8 buffer[256];
+		S32 size = packUpdate(buffer, sizeof(buffer), 0x80 | 0x20 | 0x2, scale, pos, 98765);
+
+		LLDataPackerBinaryBuffer dp(buffer, size);
+		LLVOCacheEntry entry(1234, 0xdeadbeef, dp);
+		LLVector3 out_pos, out_scale;
+		U32 parent_id = 1;
+		ensure("placement", entry.getPlacement(out_pos, out_scale, parent_id));
+		ensure_equals("pos", out_pos, pos);
+		ensure_equals("scale", out_scale, scale);
+		ensure_equals("parent", parent_id, 98765U);
+	}
+
+	template<> template<>
+	void vocache_object::test<2>()
+	{
+		// Without a parent, and from an entry with nothing in it.
+		const LLVector3 scale(10.f, 10.f, 0.5f);
+		const LLVector3 pos(3.f, 250.f, 4000.f);
+		U8 buffer[256];
+		S32 size = packUpdate(buffer, sizeof(buffer), 0x2, scale, pos, 0);
+
+		LLDataPackerBinaryBuffer dp(buffer, size);
+		LLVOCacheEntry entry(1234, 0xdeadbeef, dp);
+		LLVector3 out_pos, out_scale;
+		U32 parent_id = 1;
+		ensure("placement", entry.getPlacement(out_pos, out_scale, parent_id));
+		ensure_equals("pos", out_pos, pos);
+		ensure_equals("scale", out_scale, scale);
+		ensure_equals("no parent", parent_id, 0U);
+
+		LLVOCacheEntry empty;
+		ensure("empty", !empty.getPlacement(out_pos, out_scale, parent_id));
+	}
+}